@@ -0,0 +1,90 @@
+#ifndef STARTUPORCHESTRATOR_H
+#define STARTUPORCHESTRATOR_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QWaitCondition>
+#include <functional>
+
+class QQuickWindow;
+
+/*
+ * StartupOrchestrator
+ *
+ * 作用：
+ *   把 main() 里的启动步骤按依赖关系编排，能并行的并行，不急的推迟到首帧之后
+ *
+ * 阶段：
+ *   Pool      线程池里跑（文件 IO、日志读回等不碰 GUI 对象的活）
+ *   Main      主线程跑（建 QObject、连信号、启动线程）
+ *   Deferred  首帧显示后在主线程逐个跑，每个之间让出事件循环（打印机 USB、WiFi 监听、Web 等）
+ *
+ * 用法：
+ *   boot.add("journal", Pool, {}, [&] { journal->open(); });
+ *   boot.add("qss", Main, {"qss-read"}, [&] { app.setStyleSheet(qss); });
+ *   boot.run();                 // Pool + Main 全部完成后返回
+ *   engine.load(url);
+ *   boot.startDeferred(window); // 首帧后跑 Deferred，结束时打印启动时间线
+ *
+ * 启动结束打印时间线：每步的开始时刻 / 耗时，首帧时刻和首帧、结束时的 RSS。
+ *
+ * 基准（tests/bench/boot_bench.sh）：
+ *   FQ_BOOT_SERIAL=1  对照组：Pool 步骤在主线程串行跑，Deferred 步骤在首帧之前同步跑完（近似改造前的 main）
+ *   FQ_BOOT_BENCH=1   结束时往 stdout 打一行 "FQ_BOOT_BENCH mode=... first_frame_ms=... ..."，便于脚本汇总
+ *
+ * 依赖名不存在视为已满足（打印警告）；出现环时按登记顺序强制执行并报错，不会卡死启动。
+ */
+class StartupOrchestrator : public QObject {
+    Q_OBJECT
+public:
+    enum Stage { Pool, Main, Deferred };
+
+    explicit StartupOrchestrator(QObject* parent = nullptr);
+
+    void add(const QString& name, Stage stage, const QStringList& deps, std::function<void()> fn);
+
+    // 跑完所有 Pool / Main 步骤
+    void run();
+
+    // window 非空时等它第一次 frameSwapped，否则下一轮事件循环开始
+    void startDeferred(QQuickWindow* window);
+
+    qint64 elapsedMs() const { return m_clock.elapsed(); }
+
+signals:
+    void finished();
+
+private:
+    struct Task {
+        QString name;
+        Stage stage = Main;
+        QStringList deps;
+        std::function<void()> fn;
+        enum State { Pending, Running, Done } state = Pending;
+        qint64 startMs = -1;
+        qint64 costMs = -1;
+    };
+
+    static constexpr int kPoolThreads = 2;  // T113 双核
+
+    bool depsDone(const Task& t);
+    void runNextDeferred();
+    void report() const;
+
+    QVector<Task> m_tasks;
+    QHash<QString, int> m_index;
+    QMutex m_mutex;            // 保护 Pool 任务的 state / costMs
+    QWaitCondition m_doneCond;
+    QElapsedTimer m_clock;
+    qint64 m_firstFrameMs = -1;
+    long m_firstFrameRssKb = -1;
+    bool m_deferredStarted = false;
+    bool m_serial = false;  // FQ_BOOT_SERIAL=1
+};
+
+#endif  // STARTUPORCHESTRATOR_H
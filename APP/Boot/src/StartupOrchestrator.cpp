@@ -0,0 +1,247 @@
+#include "StartupOrchestrator.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QMetaObject>
+#include <QQuickWindow>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QTimer>
+#include <cstdio>
+#include <memory>
+
+namespace {
+
+class FnRunnable : public QRunnable {
+public:
+    explicit FnRunnable(std::function<void()> fn) : m_fn(std::move(fn)) {}
+    void run() override { m_fn(); }
+
+private:
+    std::function<void()> m_fn;
+};
+
+const char* stageName(int stage) {
+    switch (stage) {
+    case StartupOrchestrator::Pool:
+        return "pool";
+    case StartupOrchestrator::Main:
+        return "main";
+    default:
+        return "deferred";
+    }
+}
+
+// 当前常驻内存（/proc/self/status 的 VmRSS，单位 kB），读不到返回 -1
+long rssKb() {
+    QFile f("/proc/self/status");
+    if (!f.open(QIODevice::ReadOnly))
+        return -1;
+    for (const QByteArray& line : f.readAll().split('\n')) {
+        if (line.startsWith("VmRSS:"))
+            return line.mid(6).trimmed().split(' ').value(0).toLong();
+    }
+    return -1;
+}
+
+}  // namespace
+
+StartupOrchestrator::StartupOrchestrator(QObject* parent)
+    : QObject(parent) {
+    m_clock.start();
+    m_serial = qEnvironmentVariableIntValue("FQ_BOOT_SERIAL") == 1;
+    if (m_serial)
+        qInfo() << "[Boot] FQ_BOOT_SERIAL=1: serial baseline, no pool, deferred steps before first frame";
+}
+
+void StartupOrchestrator::add(const QString& name, Stage stage, const QStringList& deps,
+                              std::function<void()> fn) {
+    if (m_index.contains(name)) {
+        qWarning() << "[Boot] duplicate step" << name << ", ignored";
+        return;
+    }
+    Task t;
+    t.name = name;
+    t.stage = stage;
+    t.deps = deps;
+    t.fn = std::move(fn);
+    m_index.insert(name, m_tasks.size());
+    m_tasks.append(t);
+}
+
+// 调用方持有 m_mutex
+bool StartupOrchestrator::depsDone(const Task& t) {
+    for (const QString& d : t.deps) {
+        const auto it = m_index.constFind(d);
+        if (it == m_index.constEnd()) {
+            qWarning() << "[Boot]" << t.name << "depends on unknown step" << d;
+            continue;
+        }
+        if (m_tasks[*it].state != Task::Done)
+            return false;
+    }
+    return true;
+}
+
+// ===== Pool + Main：依赖满足即开跑，主线程步骤就地执行，没事做时等线程池 =====
+void StartupOrchestrator::run() {
+    QThreadPool pool;
+    pool.setMaxThreadCount(kPoolThreads);
+
+    QMutexLocker lock(&m_mutex);
+    for (;;) {
+        int pending = 0;
+        int running = 0;
+        bool progressed = false;
+
+        for (int i = 0; i < m_tasks.size(); ++i) {
+            Task& t = m_tasks[i];  // 运行期间不再 add，引用稳定
+            if (t.stage == Deferred || t.state == Task::Done)
+                continue;
+            if (t.state == Task::Running) {
+                ++running;
+                continue;
+            }
+            if (!depsDone(t)) {
+                ++pending;
+                continue;
+            }
+
+            t.state = Task::Running;
+            t.startMs = m_clock.elapsed();
+            progressed = true;
+            if (t.stage == Pool && !m_serial) {
+                ++running;
+                pool.start(new FnRunnable([this, i]() {
+                    QElapsedTimer e;
+                    e.start();
+                    m_tasks[i].fn();
+                    QMutexLocker l(&m_mutex);
+                    m_tasks[i].costMs = e.elapsed();
+                    m_tasks[i].state = Task::Done;
+                    m_doneCond.wakeAll();
+                }));
+            } else {
+                lock.unlock();
+                QElapsedTimer e;
+                e.start();
+                t.fn();
+                lock.relock();
+                t.costMs = e.elapsed();
+                t.state = Task::Done;
+            }
+        }
+
+        if (pending == 0 && running == 0)
+            break;
+        if (progressed)
+            continue;
+        if (running > 0) {
+            m_doneCond.wait(&m_mutex);
+            continue;
+        }
+        // 没有在跑的、剩下的又都等不到：依赖成环，按登记顺序放行一个
+        for (Task& t : m_tasks) {
+            if (t.stage != Deferred && t.state == Task::Pending) {
+                qCritical() << "[Boot] dependency cycle at" << t.name << ", forcing it";
+                t.deps.clear();
+                break;
+            }
+        }
+    }
+    lock.unlock();
+    pool.waitForDone();
+    qInfo() << "[Boot] blocking steps done at +" << m_clock.elapsed() << "ms";
+}
+
+void StartupOrchestrator::startDeferred(QQuickWindow* window) {
+    if (m_deferredStarted)
+        return;
+    m_deferredStarted = true;
+
+    if (m_serial) {
+        // 对照组：推迟步骤当作主线程步骤，在首帧之前按依赖顺序同步跑完
+        for (Task& t : m_tasks) {
+            if (t.stage == Deferred)
+                t.stage = Main;
+        }
+        run();
+    }
+
+    auto kick = [this]() {
+        m_firstFrameMs = m_clock.elapsed();
+        m_firstFrameRssKb = rssKb();
+        qInfo() << "[Boot] first frame at +" << m_firstFrameMs << "ms, rss" << m_firstFrameRssKb << "kB";
+        QTimer::singleShot(0, this, &StartupOrchestrator::runNextDeferred);
+    };
+    if (!window) {
+        QMetaObject::invokeMethod(this, kick, Qt::QueuedConnection);
+        return;
+    }
+    // 只要第一帧：触发一次后断开
+    auto once = std::make_shared<QMetaObject::Connection>();
+    *once = connect(window, &QQuickWindow::frameSwapped, this, [once, kick]() {
+        QObject::disconnect(*once);
+        kick();
+    });
+}
+
+// 每次只跑一个，跑完让出事件循环，界面在推迟步骤之间保持可响应
+void StartupOrchestrator::runNextDeferred() {
+    for (Task& t : m_tasks) {
+        if (t.stage != Deferred || t.state != Task::Pending)
+            continue;
+        {
+            QMutexLocker lock(&m_mutex);
+            if (!depsDone(t))
+                continue;
+        }
+        t.state = Task::Running;
+        t.startMs = m_clock.elapsed();
+        QElapsedTimer e;
+        e.start();
+        t.fn();
+        t.costMs = e.elapsed();
+        t.state = Task::Done;
+        QTimer::singleShot(0, this, &StartupOrchestrator::runNextDeferred);
+        return;
+    }
+
+    // 依赖没满足的推迟步骤（依赖了不存在 / 后登记的推迟步骤）也不能一直挂着
+    for (Task& t : m_tasks) {
+        if (t.stage == Deferred && t.state == Task::Pending) {
+            qWarning() << "[Boot] deferred step" << t.name << "has unmet deps, forcing it";
+            t.deps.clear();
+            QTimer::singleShot(0, this, &StartupOrchestrator::runNextDeferred);
+            return;
+        }
+    }
+
+    report();
+    emit finished();
+}
+
+// ===== 启动时间线 =====
+void StartupOrchestrator::report() const {
+    qInfo().noquote() << "[Boot] ---- startup timeline (ms since main) ----";
+    for (const Task& t : m_tasks) {
+        qInfo().noquote() << QString("[Boot] %1  +%2  %3ms  %4")
+                                 .arg(QLatin1String(stageName(t.stage)), -8)
+                                 .arg(t.startMs, 5)
+                                 .arg(t.costMs, 4)
+                                 .arg(t.name);
+    }
+    qInfo().noquote() << QString("[Boot] first frame +%1ms (rss %2 kB), all steps done +%3ms (rss %4 kB)")
+                             .arg(m_firstFrameMs)
+                             .arg(m_firstFrameRssKb)
+                             .arg(m_clock.elapsed())
+                             .arg(rssKb());
+
+    // 给 tests/bench/boot_bench.sh 的一行，不经日志系统（日志是异步写文件的）
+    if (qEnvironmentVariableIsSet("FQ_BOOT_BENCH")) {
+        std::printf("FQ_BOOT_BENCH mode=%s first_frame_ms=%lld first_frame_rss_kb=%ld done_ms=%lld done_rss_kb=%ld\n",
+                    m_serial ? "serial" : "staged", static_cast<long long>(m_firstFrameMs), m_firstFrameRssKb,
+                    static_cast<long long>(m_clock.elapsed()), rssKb());
+        std::fflush(stdout);
+    }
+}
@@ -62,8 +62,9 @@ private:
     // ===== 防止重复写 =====
     bool m_fuyuTimeoutSent = false;
     bool m_lastIncubPos[6] = {false, false, false, false, false, false};
-    DeviceStatus m_status;           // 协议层（struct）
-    DeviceStatusObject m_statusObj;  // ★ UI 层（QObject）
+    DeviceStatus m_status;             // 协议层（struct）
+    DeviceStatusSnapshot m_snapshot;   // 工作线程维护的 UI 快照
+    DeviceStatusObject m_statusObj;    // ★ UI 层（QObject）
 
     ModbusRtuClient* m_worker = nullptr;
 
@@ -2,10 +2,36 @@
 #define DEVICESTATUSOBJECT_H
 
 #include <QObject>
+#include <QTimer>
 #include <QtGlobal>
+#include <atomic>
 #include <cstdint>
+#include <mutex>
 
 #include "QDebug"
+
+/* ================= UI 状态快照 =================
+ * 由 DeviceService 工作线程整体构建，交给 GUI 线程做差分，
+ * 只对真正变化的字段发细粒度信号。
+ */
+struct DeviceStatusSnapshot {
+    static constexpr int kSlotCount = 6;
+
+    float currentTemp = 0.0f;
+    float targetTemp = 0.0f;
+
+    int incubState = 0;
+    int motorState = 0;
+
+    bool powerOnHome = false;
+    bool cardHome = false;
+
+    bool incubPos[kSlotCount] = {false, false, false, false, false, false};
+    int incubRemain[kSlotCount] = {0, 0, 0, 0, 0, 0};
+
+    bool incubDone(int i) const { return incubPos[i] && incubRemain[i] == 0; }
+};
+
 class DeviceStatusObject : public QObject {
     Q_OBJECT
 
@@ -13,194 +39,129 @@ class DeviceStatusObject : public QObject {
     Q_PROPERTY(float currentTemp READ currentTemp NOTIFY currentTempChanged)
     Q_PROPERTY(float targetTemp READ targetTemp NOTIFY targetTempChanged)
     /* ===== 原点状态 ===== */
-    Q_PROPERTY(bool powerOnHome READ powerOnHome NOTIFY limitSwitchChanged)
-    Q_PROPERTY(bool cardHome READ cardHome NOTIFY limitSwitchChanged)
+    Q_PROPERTY(bool powerOnHome READ powerOnHome NOTIFY powerOnHomeChanged)
+    Q_PROPERTY(bool cardHome READ cardHome NOTIFY cardHomeChanged)
     /* ===== 孵育状态 ===== */
-    Q_PROPERTY(bool incubPos1 READ incubPos1 NOTIFY limitSwitchChanged)
-    Q_PROPERTY(bool incubPos2 READ incubPos2 NOTIFY limitSwitchChanged)
-    Q_PROPERTY(bool incubPos3 READ incubPos3 NOTIFY limitSwitchChanged)
-    Q_PROPERTY(bool incubPos4 READ incubPos4 NOTIFY limitSwitchChanged)
-    Q_PROPERTY(bool incubPos5 READ incubPos5 NOTIFY limitSwitchChanged)
-    Q_PROPERTY(bool incubPos6 READ incubPos6 NOTIFY limitSwitchChanged)
+    Q_PROPERTY(bool incubPos1 READ incubPos1 NOTIFY incubPos1Changed)
+    Q_PROPERTY(bool incubPos2 READ incubPos2 NOTIFY incubPos2Changed)
+    Q_PROPERTY(bool incubPos3 READ incubPos3 NOTIFY incubPos3Changed)
+    Q_PROPERTY(bool incubPos4 READ incubPos4 NOTIFY incubPos4Changed)
+    Q_PROPERTY(bool incubPos5 READ incubPos5 NOTIFY incubPos5Changed)
+    Q_PROPERTY(bool incubPos6 READ incubPos6 NOTIFY incubPos6Changed)
     /* ===== 孵育状态 ===== */
     Q_PROPERTY(int incubState READ incubState NOTIFY incubStateChanged)
 
     /* ===== 电机 ===== */
     Q_PROPERTY(int motorState READ motorState NOTIFY motorStateChanged)
     /* ===== 孵育剩余时间（秒） ===== */
-    Q_PROPERTY(int incubRemain1 READ incubRemain1 NOTIFY incubRemainChanged)
-    Q_PROPERTY(int incubRemain2 READ incubRemain2 NOTIFY incubRemainChanged)
-    Q_PROPERTY(int incubRemain3 READ incubRemain3 NOTIFY incubRemainChanged)
-    Q_PROPERTY(int incubRemain4 READ incubRemain4 NOTIFY incubRemainChanged)
-    Q_PROPERTY(int incubRemain5 READ incubRemain5 NOTIFY incubRemainChanged)
-    Q_PROPERTY(int incubRemain6 READ incubRemain6 NOTIFY incubRemainChanged)
+    Q_PROPERTY(int incubRemain1 READ incubRemain1 NOTIFY incubRemain1Changed)
+    Q_PROPERTY(int incubRemain2 READ incubRemain2 NOTIFY incubRemain2Changed)
+    Q_PROPERTY(int incubRemain3 READ incubRemain3 NOTIFY incubRemain3Changed)
+    Q_PROPERTY(int incubRemain4 READ incubRemain4 NOTIFY incubRemain4Changed)
+    Q_PROPERTY(int incubRemain5 READ incubRemain5 NOTIFY incubRemain5Changed)
+    Q_PROPERTY(int incubRemain6 READ incubRemain6 NOTIFY incubRemain6Changed)
     /* ===== 孵育完成状态 ===== */
-    Q_PROPERTY(bool incubDone1 READ incubDone1 NOTIFY incubRemainChanged)
-    Q_PROPERTY(bool incubDone2 READ incubDone2 NOTIFY incubRemainChanged)
-    Q_PROPERTY(bool incubDone3 READ incubDone3 NOTIFY incubRemainChanged)
-    Q_PROPERTY(bool incubDone4 READ incubDone4 NOTIFY incubRemainChanged)
-    Q_PROPERTY(bool incubDone5 READ incubDone5 NOTIFY incubRemainChanged)
-    Q_PROPERTY(bool incubDone6 READ incubDone6 NOTIFY incubRemainChanged)
+    Q_PROPERTY(bool incubDone1 READ incubDone1 NOTIFY incubDone1Changed)
+    Q_PROPERTY(bool incubDone2 READ incubDone2 NOTIFY incubDone2Changed)
+    Q_PROPERTY(bool incubDone3 READ incubDone3 NOTIFY incubDone3Changed)
+    Q_PROPERTY(bool incubDone4 READ incubDone4 NOTIFY incubDone4Changed)
+    Q_PROPERTY(bool incubDone5 READ incubDone5 NOTIFY incubDone5Changed)
+    Q_PROPERTY(bool incubDone6 READ incubDone6 NOTIFY incubDone6Changed)
 
 public:
-    explicit DeviceStatusObject(QObject* parent = nullptr)
-        : QObject(parent) {}
-    void dumpStatus() const;
-    /* ===== getters ===== */
-    float currentTemp() const { return m_currentTemp; }
-    float targetTemp() const { return m_targetTemp; }
-
-    bool incubPos1() const { return m_incubPos1; }
-    bool incubPos2() const { return m_incubPos2; }
-    bool incubPos3() const { return m_incubPos3; }
-    bool incubPos4() const { return m_incubPos4; }
-    bool incubPos5() const { return m_incubPos5; }
-    bool incubPos6() const { return m_incubPos6; }
-
-    int incubRemain1() const { return m_incubRemain1; }
-    int incubRemain2() const { return m_incubRemain2; }
-    int incubRemain3() const { return m_incubRemain3; }
-    int incubRemain4() const { return m_incubRemain4; }
-    int incubRemain5() const { return m_incubRemain5; }
-    int incubRemain6() const { return m_incubRemain6; }
-
-    bool incubDone1() const { return m_incubPos1 && m_incubRemain1 == 0; }
-    bool incubDone2() const { return m_incubPos2 && m_incubRemain2 == 0; }
-    bool incubDone3() const { return m_incubPos3 && m_incubRemain3 == 0; }
-    bool incubDone4() const { return m_incubPos4 && m_incubRemain4 == 0; }
-    bool incubDone5() const { return m_incubPos5 && m_incubRemain5 == 0; }
-    bool incubDone6() const { return m_incubPos6 && m_incubRemain6 == 0; }
-    bool powerOnHome() const { return m_powerOnHome; }
-    bool cardHome() const { return m_cardHome; }
-    int incubState() const { return m_incubState; }
-    int motorState() const { return m_motorState; }
-
-    /* ===== setters（C++ 内部调用）===== */
-    void setCurrentTemp(float v) {
-        if (qFuzzyCompare(m_currentTemp, v))
-            return;
-        m_currentTemp = v;
-        emit currentTempChanged();
-    }
-    void setPowerOnHome(bool v) {
-        if (m_powerOnHome == v)
-            return;
-        m_powerOnHome = v;
-        emit limitSwitchChanged();
-    }
-
-    void setCardHome(bool v) {
-        if (m_cardHome == v)
-            return;
-        m_cardHome = v;
-        qDebug() << "cardHome" << v;
-        emit limitSwitchChanged();
-    }
-
-    void setTargetTemp(float v) {
-        if (qFuzzyCompare(m_targetTemp, v))
-            return;
-        m_targetTemp = v;
-        emit targetTempChanged();
-    }
-
-    void setIncubPos(int index, bool v) {
-        bool* arr[6] = {
-            &m_incubPos1, &m_incubPos2, &m_incubPos3,
-            &m_incubPos4, &m_incubPos5, &m_incubPos6};
-
-        if (index < 0 || index >= 6)
-            return;
+    // GUI 侧合并发布的最小间隔（约一帧）
+    static constexpr int kPublishIntervalMs = 16;
 
-        if (*arr[index] == v)
-            return;
-
-        *arr[index] = v;
-        emit limitSwitchChanged();
-    }
-
-    void setIncubRemain(int index, int sec) {
-        if (sec < 0)
-            sec = 0;
-
-        int* arr[6] = {
-            &m_incubRemain1, &m_incubRemain2, &m_incubRemain3,
-            &m_incubRemain4, &m_incubRemain5, &m_incubRemain6};
-
-        if (index < 0 || index >= 6)
-            return;
+    explicit DeviceStatusObject(QObject* parent = nullptr);
+    void dumpStatus() const;
 
-        if (*arr[index] == sec)
-            return;
+    /* ===== 快照发布（任意线程调用）=====
+     * 只保存最新快照；GUI 线程最多每帧取一次并做差分。
+     */
+    void publish(const DeviceStatusSnapshot& snap);
 
-        *arr[index] = sec;
-        emit incubRemainChanged();
-    }
+    /* ===== getters ===== */
+    float currentTemp() const { return m_cur.currentTemp; }
+    float targetTemp() const { return m_cur.targetTemp; }
+
+    bool incubPos1() const { return m_cur.incubPos[0]; }
+    bool incubPos2() const { return m_cur.incubPos[1]; }
+    bool incubPos3() const { return m_cur.incubPos[2]; }
+    bool incubPos4() const { return m_cur.incubPos[3]; }
+    bool incubPos5() const { return m_cur.incubPos[4]; }
+    bool incubPos6() const { return m_cur.incubPos[5]; }
+
+    int incubRemain1() const { return m_cur.incubRemain[0]; }
+    int incubRemain2() const { return m_cur.incubRemain[1]; }
+    int incubRemain3() const { return m_cur.incubRemain[2]; }
+    int incubRemain4() const { return m_cur.incubRemain[3]; }
+    int incubRemain5() const { return m_cur.incubRemain[4]; }
+    int incubRemain6() const { return m_cur.incubRemain[5]; }
+
+    bool incubDone1() const { return m_cur.incubDone(0); }
+    bool incubDone2() const { return m_cur.incubDone(1); }
+    bool incubDone3() const { return m_cur.incubDone(2); }
+    bool incubDone4() const { return m_cur.incubDone(3); }
+    bool incubDone5() const { return m_cur.incubDone(4); }
+    bool incubDone6() const { return m_cur.incubDone(5); }
+    bool powerOnHome() const { return m_cur.powerOnHome; }
+    bool cardHome() const { return m_cur.cardHome; }
+    int incubState() const { return m_cur.incubState; }
+    int motorState() const { return m_cur.motorState; }
 
     int incubRemain(int index) const {
-        switch (index) {
-        case 0:
-            return m_incubRemain1;
-        case 1:
-            return m_incubRemain2;
-        case 2:
-            return m_incubRemain3;
-        case 3:
-            return m_incubRemain4;
-        case 4:
-            return m_incubRemain5;
-        case 5:
-            return m_incubRemain6;
-        default:
+        if (index < 0 || index >= DeviceStatusSnapshot::kSlotCount)
             return 0;
-        }
-    }
-    void setIncubState(int state) {
-        if (m_incubState == state)
-            return;
-
-        m_incubState = state;
-        emit incubStateChanged();
-    }
-    void setMotorState(int state) {
-        if (m_motorState == state)
-            return;
-
-        m_motorState = state;
-        emit motorStateChanged();
+        return m_cur.incubRemain[index];
     }
 
 signals:
     void currentTempChanged();
     void targetTempChanged();
-    void limitSwitchChanged();
-    void incubRemainChanged();
+    void powerOnHomeChanged();
+    void cardHomeChanged();
     void incubStateChanged();
     void motorStateChanged();
 
+    void incubPos1Changed();
+    void incubPos2Changed();
+    void incubPos3Changed();
+    void incubPos4Changed();
+    void incubPos5Changed();
+    void incubPos6Changed();
+
+    void incubRemain1Changed();
+    void incubRemain2Changed();
+    void incubRemain3Changed();
+    void incubRemain4Changed();
+    void incubRemain5Changed();
+    void incubRemain6Changed();
+
+    void incubDone1Changed();
+    void incubDone2Changed();
+    void incubDone3Changed();
+    void incubDone4Changed();
+    void incubDone5Changed();
+    void incubDone6Changed();
+
 private:
-    float m_currentTemp = 0.0f;
-    float m_targetTemp = 0.0f;
-
-    int m_incubState = 0;
-    int m_motorState = 0;
-
-    bool m_powerOnHome = false;
-    bool m_cardHome = false;
-
-    bool m_incubPos1 = false;
-    bool m_incubPos2 = false;
-    bool m_incubPos3 = false;
-    bool m_incubPos4 = false;
-    bool m_incubPos5 = false;
-    bool m_incubPos6 = false;
-
-    int m_incubRemain1 = 0;
-    int m_incubRemain2 = 0;
-    int m_incubRemain3 = 0;
-    int m_incubRemain4 = 0;
-    int m_incubRemain5 = 0;
-    int m_incubRemain6 = 0;
+    // GUI 线程：取出最新快照并与当前值比较，逐字段发信号
+    void flushPending();
+    void applySnapshot(const DeviceStatusSnapshot& next);
+
+    void emitIncubPosChanged(int index);
+    void emitIncubRemainChanged(int index);
+    void emitIncubDoneChanged(int index);
+
+private:
+    DeviceStatusSnapshot m_cur;  // GUI 线程持有的当前值
+
+    std::mutex m_pendingMutex;
+    DeviceStatusSnapshot m_pending;  // 工作线程写入的最新快照
+    bool m_hasPending = false;
+    std::atomic<bool> m_flushQueued{false};
+
+    QTimer m_flushTimer;
 };
 
 #endif
@@ -127,6 +127,7 @@ void DeviceService::threadLoop() {
                 lastSecondTick = now;
 
                 std::vector<int> timeoutSlots;  // 记录哪些槽超时（出锁后再处理）
+                bool changed = false;
 
                 {
                     // ===== 🔒 关键：保护共享状态 =====
@@ -136,12 +137,13 @@ void DeviceService::threadLoop() {
                         if (!m_lastIncubPos[i])
                             continue;
 
-                        int sec = m_statusObj.incubRemain(i);
+                        int sec = m_snapshot.incubRemain[i];
                         if (sec <= 0)
                             continue;
 
                         sec--;
-                        m_statusObj.setIncubRemain(i, sec);
+                        m_snapshot.incubRemain[i] = sec;
+                        changed = true;
 
                         if (sec == 0) {
                             timeoutSlots.push_back(i + 1);
@@ -149,6 +151,10 @@ void DeviceService::threadLoop() {
                     }
                 }  // 🔓 解锁（非常重要）
 
+                // ===== 整体快照交给 GUI 线程合并刷新 =====
+                if (changed)
+                    m_statusObj.publish(m_snapshot);
+
                 // ===== 锁外做“业务动作”（安全）=====
                 for (int slot : timeoutSlots) {
                     qDebug() << "[DeviceService] incub slot" << slot << "finished";
@@ -398,27 +404,6 @@ static void dumpDeviceStatus(const DeviceStatus& s) {
         << "  fluorescence =" << s.fluorescence
         << "\n==================================";
 }
-void DeviceStatusObject::dumpStatus() const {
-    qDebug().noquote()
-        << "\n========== DeviceStatusObject ==========\n"
-        << "Temperature:\n"
-        << "  currentTemp =" << m_currentTemp << "°C\n"
-        << "  targetTemp  =" << m_targetTemp << "°C\n"
-
-        << "Home State:\n"
-        << "  powerOnHome =" << m_powerOnHome << "\n"
-        << "  cardHome    =" << m_cardHome << "\n"
-
-        << "Incub Positions:\n"
-        << "  pos1 =" << m_incubPos1 << " remain1 =" << m_incubRemain1 << "s\n"
-        << "  pos2 =" << m_incubPos2 << " remain2 =" << m_incubRemain2 << "s\n"
-        << "  pos3 =" << m_incubPos3 << " remain3 =" << m_incubRemain3 << "s\n"
-        << "  pos4 =" << m_incubPos4 << " remain4 =" << m_incubRemain4 << "s\n"
-        << "  pos5 =" << m_incubPos5 << " remain5 =" << m_incubRemain5 << "s\n"
-        << "  pos6 =" << m_incubPos6 << " remain6 =" << m_incubRemain6 << "s\n"
-
-        << "=======================================";
-}
 void DeviceService::pollOnceInternal() {
     // pollOnce 一定在工作线程触发
     //  m_statusObj.setCurrentTemp(42.0f);
@@ -562,12 +547,13 @@ void DeviceService::pollOnceInternal() {
         case DevFunc::ReadCurrentTemp:
             m_status.currentTemp = regsToFloat_CDAB(r.out);
             //    qDebug() << "[DEVICE] currentTemp=" << m_status.currentTemp;
-            m_statusObj.setCurrentTemp(m_status.currentTemp);
+            m_snapshot.currentTemp = m_status.currentTemp;
             // emit currentTempUpdated(m_status.currentTemp);
             break;
 
         case DevFunc::SetTargetTemp:
             m_status.targetTemp = regsToFloat_CDAB(r.out);
+            m_snapshot.targetTemp = m_status.targetTemp;
             break;
 
         case DevFunc::ReadLimitSwitch: {
@@ -575,8 +561,8 @@ void DeviceService::pollOnceInternal() {
             m_status.limitSwitch.raw = raw;
             bool powerOnHome = (raw & (1 << 0)) != 0;  // bit0
             bool cardHome = (raw & (1 << 1)) != 0;     // bit1
-            m_statusObj.setPowerOnHome(powerOnHome);
-            m_statusObj.setCardHome(cardHome);
+            m_snapshot.powerOnHome = powerOnHome;
+            m_snapshot.cardHome = cardHome;
             // ===== 解析 6 个孵育槽 bit =====
             bool curr[6] = {
                 raw & (1 << 2),
@@ -589,16 +575,16 @@ void DeviceService::pollOnceInternal() {
 
             for (int i = 0; i < 6; ++i) {
                 // 更新孵育槽是否激活（给 QML）
-                m_statusObj.setIncubPos(i, curr[i]);
+                m_snapshot.incubPos[i] = curr[i];
 
                 // 0 → 1：刚放入孵育槽，启动 6 分钟倒计时
                 if (!m_lastIncubPos[i] && curr[i]) {
-                    m_statusObj.setIncubRemain(i, INCUB_TOTAL_SEC);
+                    m_snapshot.incubRemain[i] = INCUB_TOTAL_SEC;
                 }
 
                 // 1 → 0：移出孵育槽，清空倒计时
                 if (m_lastIncubPos[i] && !curr[i]) {
-                    m_statusObj.setIncubRemain(i, 0);
+                    m_snapshot.incubRemain[i] = 0;
                 }
 
                 m_lastIncubPos[i] = curr[i];
@@ -614,6 +600,7 @@ void DeviceService::pollOnceInternal() {
         case DevFunc::ReadIncubState:
             m_status.incubState =
                 static_cast<IncubState>(r.out[0]);
+            m_snapshot.incubState = r.out[0];
             emit incubStateUpdated(r.out[0]);
             break;
         case DevFunc::incubatetimeout:
@@ -622,7 +609,7 @@ void DeviceService::pollOnceInternal() {
 
         case DevFunc::ReadMotorState:
             m_status.motorState = r.out[0];
-            m_statusObj.setMotorState(m_status.motorState);
+            m_snapshot.motorState = m_status.motorState;
             emit motorStateUpdated(r.out[0]);
             break;
 
@@ -644,4 +631,7 @@ void DeviceService::pollOnceInternal() {
         }
     }
     //  dumpDeviceStatus(m_status);
+
+    // ===== 一次 poll 只发布一个快照，GUI 侧做差分 =====
+    m_statusObj.publish(m_snapshot);
 }
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "DeviceStatusObject.h"
+
+#include <QDebug>
+#include <QMetaObject>
+
+DeviceStatusObject::DeviceStatusObject(QObject* parent)
+    : QObject(parent) {
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(kPublishIntervalMs);
+    connect(&m_flushTimer, &QTimer::timeout, this, &DeviceStatusObject::flushPending);
+}
+
+void DeviceStatusObject::publish(const DeviceStatusSnapshot& snap) {
+    bool needSchedule = false;
+    {
+        std::lock_guard<std::mutex> lk(m_pendingMutex);
+        m_pending = snap;
+        m_hasPending = true;
+        needSchedule = !m_flushQueued.exchange(true);
+    }
+
+    // 一个发布周期内只投递一次，后续快照直接覆盖 m_pending
+    if (needSchedule) {
+        QMetaObject::invokeMethod(
+            this,
+            [this]() {
+                if (!m_flushTimer.isActive())
+                    m_flushTimer.start();
+            },
+            Qt::QueuedConnection);
+    }
+}
+
+void DeviceStatusObject::flushPending() {
+    DeviceStatusSnapshot next;
+    {
+        std::lock_guard<std::mutex> lk(m_pendingMutex);
+        m_flushQueued = false;
+        if (!m_hasPending)
+            return;
+        next = m_pending;
+        m_hasPending = false;
+    }
+    applySnapshot(next);
+}
+
+void DeviceStatusObject::applySnapshot(const DeviceStatusSnapshot& next) {
+    const DeviceStatusSnapshot prev = m_cur;
+    m_cur = next;
+
+    if (!qFuzzyCompare(prev.currentTemp, next.currentTemp))
+        emit currentTempChanged();
+    if (!qFuzzyCompare(prev.targetTemp, next.targetTemp))
+        emit targetTempChanged();
+    if (prev.powerOnHome != next.powerOnHome)
+        emit powerOnHomeChanged();
+    if (prev.cardHome != next.cardHome) {
+        qDebug() << "cardHome" << next.cardHome;
+        emit cardHomeChanged();
+    }
+    if (prev.incubState != next.incubState)
+        emit incubStateChanged();
+    if (prev.motorState != next.motorState)
+        emit motorStateChanged();
+
+    for (int i = 0; i < DeviceStatusSnapshot::kSlotCount; ++i) {
+        if (prev.incubPos[i] != next.incubPos[i])
+            emitIncubPosChanged(i);
+        if (prev.incubRemain[i] != next.incubRemain[i])
+            emitIncubRemainChanged(i);
+        if (prev.incubDone(i) != next.incubDone(i))
+            emitIncubDoneChanged(i);
+    }
+}
+
+void DeviceStatusObject::emitIncubPosChanged(int index) {
+    switch (index) {
+    case 0:
+        emit incubPos1Changed();
+        break;
+    case 1:
+        emit incubPos2Changed();
+        break;
+    case 2:
+        emit incubPos3Changed();
+        break;
+    case 3:
+        emit incubPos4Changed();
+        break;
+    case 4:
+        emit incubPos5Changed();
+        break;
+    case 5:
+        emit incubPos6Changed();
+        break;
+    default:
+        break;
+    }
+}
+
+void DeviceStatusObject::emitIncubRemainChanged(int index) {
+    switch (index) {
+    case 0:
+        emit incubRemain1Changed();
+        break;
+    case 1:
+        emit incubRemain2Changed();
+        break;
+    case 2:
+        emit incubRemain3Changed();
+        break;
+    case 3:
+        emit incubRemain4Changed();
+        break;
+    case 4:
+        emit incubRemain5Changed();
+        break;
+    case 5:
+        emit incubRemain6Changed();
+        break;
+    default:
+        break;
+    }
+}
+
+void DeviceStatusObject::emitIncubDoneChanged(int index) {
+    switch (index) {
+    case 0:
+        emit incubDone1Changed();
+        break;
+    case 1:
+        emit incubDone2Changed();
+        break;
+    case 2:
+        emit incubDone3Changed();
+        break;
+    case 3:
+        emit incubDone4Changed();
+        break;
+    case 4:
+        emit incubDone5Changed();
+        break;
+    case 5:
+        emit incubDone6Changed();
+        break;
+    default:
+        break;
+    }
+}
+
+void DeviceStatusObject::dumpStatus() const {
+    qDebug().noquote()
+        << "\n========== DeviceStatusObject ==========\n"
+        << "Temperature:\n"
+        << "  currentTemp =" << m_cur.currentTemp << "°C\n"
+        << "  targetTemp  =" << m_cur.targetTemp << "°C\n"
+
+        << "Home State:\n"
+        << "  powerOnHome =" << m_cur.powerOnHome << "\n"
+        << "  cardHome    =" << m_cur.cardHome << "\n"
+
+        << "Incub Positions:\n"
+        << "  pos1 =" << m_cur.incubPos[0] << " remain1 =" << m_cur.incubRemain[0] << "s\n"
+        << "  pos2 =" << m_cur.incubPos[1] << " remain2 =" << m_cur.incubRemain[1] << "s\n"
+        << "  pos3 =" << m_cur.incubPos[2] << " remain3 =" << m_cur.incubRemain[2] << "s\n"
+        << "  pos4 =" << m_cur.incubPos[3] << " remain4 =" << m_cur.incubRemain[3] << "s\n"
+        << "  pos5 =" << m_cur.incubPos[4] << " remain5 =" << m_cur.incubRemain[4] << "s\n"
+        << "  pos6 =" << m_cur.incubPos[5] << " remain6 =" << m_cur.incubRemain[5] << "s\n"
+
+        << "=======================================";
+}
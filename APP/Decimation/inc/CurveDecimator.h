@@ -0,0 +1,45 @@
+#ifndef CURVEDECIMATOR_H
+#define CURVEDECIMATOR_H
+
+#include <vector>
+
+/*
+ * CurveDecimator
+ *
+ * 作用：
+ *   把整条 ADC 曲线按目标像素宽度抽稀，只保留需要绘制的原始下标
+ *
+ * 算法：
+ *   - Lttb   : Largest-Triangle-Three-Buckets，点数 ≈ targetPoints
+ *   - MinMax : 每像素保留最小/最大值，点数 ≤ 2 * targetPoints，
+ *              峰谷形状完全保持
+ *
+ * 特点：
+ *   - 不依赖 Qt（QML 组件 / Web 服务共用）
+ *   - 返回原始下标（升序），X 轴仍是采样点序号
+ *   - 任何路径的结果都包含 首点 ∪ pinned（C/T 峰等）∪ 末点
+ *   - 内层循环 NEON / SSE2 向量化，无 SIMD 时退回标量
+ */
+class CurveDecimator {
+public:
+    enum class Mode {
+        Lttb,
+        MinMax
+    };
+
+    // targetPoints <= 0 或 n 已不超过目标点数时，原样返回全部下标
+    static std::vector<int> decimate(const double* y, int n, int targetPoints,
+                                     Mode mode = Mode::MinMax,
+                                     const std::vector<int>& pinned = std::vector<int>());
+
+    static std::vector<int> lttb(const float* y, int n, int threshold,
+                                 const std::vector<int>& pinned = std::vector<int>());
+
+    static std::vector<int> minMax(const float* y, int n, int pixelWidth,
+                                   const std::vector<int>& pinned = std::vector<int>());
+
+    // "lttb" / "minmax"（大小写不敏感），无法识别时返回 fallback
+    static Mode parseMode(const char* name, Mode fallback = Mode::MinMax);
+};
+
+#endif  // CURVEDECIMATOR_H
@@ -0,0 +1,400 @@
+#include "CurveDecimator.h"
+
+#include <strings.h>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CURVE_DECIMATOR_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CURVE_DECIMATOR_SSE2 1
+#endif
+
+namespace {
+
+// pinned 下标：去重、排序、裁剪到 [0, n)
+std::vector<int> normalizePinned(const std::vector<int>& pinned, int n) {
+    std::vector<int> out;
+    out.reserve(pinned.size());
+    for (int idx : pinned) {
+        if (idx >= 0 && idx < n)
+            out.push_back(idx);
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+std::vector<int> allIndices(int n) {
+    std::vector<int> out(static_cast<size_t>(std::max(n, 0)));
+    for (int i = 0; i < n; ++i)
+        out[static_cast<size_t>(i)] = i;
+    return out;
+}
+
+// =========================
+// 在 [begin,end) 内找 |k1*(y[j]-ay) + k2*(j-ax)| 最大的 j（并列取最左）
+// 即 LTTB 中以 a 与下一桶均值为底边的三角形面积最大点
+// =========================
+int argmaxTriangle(const float* y, int begin, int end,
+                   float ax, float ay, float k1, float k2) {
+    int bestIdx = begin;
+    float bestArea = -1.0f;
+    int j = begin;
+
+#if defined(CURVE_DECIMATOR_NEON)
+    if (end - begin >= 8) {
+        const float32x4_t vk1 = vdupq_n_f32(k1);
+        const float32x4_t vk2 = vdupq_n_f32(k2);
+        const float32x4_t vay = vdupq_n_f32(ay);
+        const float32x4_t vstep = vdupq_n_f32(4.0f);
+        const int32x4_t vistep = vdupq_n_s32(4);
+
+        const float dx0 = float(begin) - ax;
+        const float dxInit[4] = {dx0, dx0 + 1.0f, dx0 + 2.0f, dx0 + 3.0f};
+        const int32_t idxInit[4] = {begin, begin + 1, begin + 2, begin + 3};
+        float32x4_t vdx = vld1q_f32(dxInit);
+        int32x4_t vidx = vld1q_s32(idxInit);
+
+        float32x4_t vbest = vdupq_n_f32(-1.0f);
+        int32x4_t vbestIdx = vidx;
+
+        for (; j + 4 <= end; j += 4) {
+            float32x4_t vy = vsubq_f32(vld1q_f32(y + j), vay);
+            float32x4_t area = vmulq_f32(vk1, vy);
+            area = vmlaq_f32(area, vk2, vdx);
+            area = vabsq_f32(area);
+
+            uint32x4_t gt = vcgtq_f32(area, vbest);
+            vbest = vbslq_f32(gt, area, vbest);
+            vbestIdx = vbslq_s32(gt, vidx, vbestIdx);
+
+            vdx = vaddq_f32(vdx, vstep);
+            vidx = vaddq_s32(vidx, vistep);
+        }
+
+        float lanes[4];
+        int32_t lanesIdx[4];
+        vst1q_f32(lanes, vbest);
+        vst1q_s32(lanesIdx, vbestIdx);
+        for (int k = 0; k < 4; ++k) {
+            if (lanes[k] > bestArea || (lanes[k] == bestArea && lanesIdx[k] < bestIdx)) {
+                bestArea = lanes[k];
+                bestIdx = lanesIdx[k];
+            }
+        }
+    }
+#elif defined(CURVE_DECIMATOR_SSE2)
+    if (end - begin >= 8) {
+        const __m128 vk1 = _mm_set1_ps(k1);
+        const __m128 vk2 = _mm_set1_ps(k2);
+        const __m128 vay = _mm_set1_ps(ay);
+        const __m128 vstep = _mm_set1_ps(4.0f);
+        const __m128i vistep = _mm_set1_epi32(4);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+        const float dx0 = float(begin) - ax;
+        __m128 vdx = _mm_setr_ps(dx0, dx0 + 1.0f, dx0 + 2.0f, dx0 + 3.0f);
+        __m128i vidx = _mm_setr_epi32(begin, begin + 1, begin + 2, begin + 3);
+
+        __m128 vbest = _mm_set1_ps(-1.0f);
+        __m128i vbestIdx = vidx;
+
+        for (; j + 4 <= end; j += 4) {
+            __m128 vy = _mm_sub_ps(_mm_loadu_ps(y + j), vay);
+            __m128 area = _mm_add_ps(_mm_mul_ps(vk1, vy), _mm_mul_ps(vk2, vdx));
+            area = _mm_and_ps(area, absMask);
+
+            __m128 gt = _mm_cmpgt_ps(area, vbest);
+            __m128i gti = _mm_castps_si128(gt);
+            vbest = _mm_or_ps(_mm_and_ps(gt, area), _mm_andnot_ps(gt, vbest));
+            vbestIdx = _mm_or_si128(_mm_and_si128(gti, vidx), _mm_andnot_si128(gti, vbestIdx));
+
+            vdx = _mm_add_ps(vdx, vstep);
+            vidx = _mm_add_epi32(vidx, vistep);
+        }
+
+        alignas(16) float lanes[4];
+        alignas(16) int32_t lanesIdx[4];
+        _mm_store_ps(lanes, vbest);
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanesIdx), vbestIdx);
+        for (int k = 0; k < 4; ++k) {
+            if (lanes[k] > bestArea || (lanes[k] == bestArea && lanesIdx[k] < bestIdx)) {
+                bestArea = lanes[k];
+                bestIdx = lanesIdx[k];
+            }
+        }
+    }
+#endif
+
+    // ---- 标量尾部（以及无 SIMD 的平台）----
+    for (; j < end; ++j) {
+        const float area = std::fabs(k1 * (y[j] - ay) + k2 * (float(j) - ax));
+        if (area > bestArea) {
+            bestArea = area;
+            bestIdx = j;
+        }
+    }
+    return bestIdx;
+}
+
+// =========================
+// 在 [begin,end) 内找最小/最大值下标（并列取最左）
+// =========================
+void minMaxRange(const float* y, int begin, int end, int& outMin, int& outMax) {
+    int iMin = begin;
+    int iMax = begin;
+    float vMin = y[begin];
+    float vMax = y[begin];
+    int j = begin;
+
+#if defined(CURVE_DECIMATOR_NEON)
+    if (end - begin >= 8) {
+        const int32x4_t vistep = vdupq_n_s32(4);
+        const int32_t idxInit[4] = {begin, begin + 1, begin + 2, begin + 3};
+        int32x4_t vidx = vld1q_s32(idxInit);
+
+        float32x4_t vmin = vld1q_f32(y + begin);
+        float32x4_t vmax = vmin;
+        int32x4_t vminIdx = vidx;
+        int32x4_t vmaxIdx = vidx;
+        vidx = vaddq_s32(vidx, vistep);
+
+        for (j = begin + 4; j + 4 <= end; j += 4) {
+            float32x4_t v = vld1q_f32(y + j);
+            uint32x4_t lt = vcltq_f32(v, vmin);
+            uint32x4_t gt = vcgtq_f32(v, vmax);
+            vmin = vbslq_f32(lt, v, vmin);
+            vmax = vbslq_f32(gt, v, vmax);
+            vminIdx = vbslq_s32(lt, vidx, vminIdx);
+            vmaxIdx = vbslq_s32(gt, vidx, vmaxIdx);
+            vidx = vaddq_s32(vidx, vistep);
+        }
+
+        float mins[4], maxs[4];
+        int32_t minIdx[4], maxIdx[4];
+        vst1q_f32(mins, vmin);
+        vst1q_f32(maxs, vmax);
+        vst1q_s32(minIdx, vminIdx);
+        vst1q_s32(maxIdx, vmaxIdx);
+        for (int k = 0; k < 4; ++k) {
+            if (mins[k] < vMin || (mins[k] == vMin && minIdx[k] < iMin)) {
+                vMin = mins[k];
+                iMin = minIdx[k];
+            }
+            if (maxs[k] > vMax || (maxs[k] == vMax && maxIdx[k] < iMax)) {
+                vMax = maxs[k];
+                iMax = maxIdx[k];
+            }
+        }
+    }
+#elif defined(CURVE_DECIMATOR_SSE2)
+    if (end - begin >= 8) {
+        const __m128i vistep = _mm_set1_epi32(4);
+        __m128i vidx = _mm_setr_epi32(begin, begin + 1, begin + 2, begin + 3);
+
+        __m128 vmin = _mm_loadu_ps(y + begin);
+        __m128 vmax = vmin;
+        __m128i vminIdx = vidx;
+        __m128i vmaxIdx = vidx;
+        vidx = _mm_add_epi32(vidx, vistep);
+
+        for (j = begin + 4; j + 4 <= end; j += 4) {
+            __m128 v = _mm_loadu_ps(y + j);
+            __m128 lt = _mm_cmplt_ps(v, vmin);
+            __m128 gt = _mm_cmpgt_ps(v, vmax);
+            __m128i lti = _mm_castps_si128(lt);
+            __m128i gti = _mm_castps_si128(gt);
+            vmin = _mm_or_ps(_mm_and_ps(lt, v), _mm_andnot_ps(lt, vmin));
+            vmax = _mm_or_ps(_mm_and_ps(gt, v), _mm_andnot_ps(gt, vmax));
+            vminIdx = _mm_or_si128(_mm_and_si128(lti, vidx), _mm_andnot_si128(lti, vminIdx));
+            vmaxIdx = _mm_or_si128(_mm_and_si128(gti, vidx), _mm_andnot_si128(gti, vmaxIdx));
+            vidx = _mm_add_epi32(vidx, vistep);
+        }
+
+        alignas(16) float mins[4], maxs[4];
+        alignas(16) int32_t minIdx[4], maxIdx[4];
+        _mm_store_ps(mins, vmin);
+        _mm_store_ps(maxs, vmax);
+        _mm_store_si128(reinterpret_cast<__m128i*>(minIdx), vminIdx);
+        _mm_store_si128(reinterpret_cast<__m128i*>(maxIdx), vmaxIdx);
+        for (int k = 0; k < 4; ++k) {
+            if (mins[k] < vMin || (mins[k] == vMin && minIdx[k] < iMin)) {
+                vMin = mins[k];
+                iMin = minIdx[k];
+            }
+            if (maxs[k] > vMax || (maxs[k] == vMax && maxIdx[k] < iMax)) {
+                vMax = maxs[k];
+                iMax = maxIdx[k];
+            }
+        }
+    }
+#endif
+
+    for (; j < end; ++j) {
+        if (y[j] < vMin) {
+            vMin = y[j];
+            iMin = j;
+        }
+        if (y[j] > vMax) {
+            vMax = y[j];
+            iMax = j;
+        }
+    }
+    outMin = iMin;
+    outMax = iMax;
+}
+
+}  // namespace
+
+std::vector<int> CurveDecimator::decimate(const double* y, int n, int targetPoints,
+                                          Mode mode, const std::vector<int>& pinned) {
+    if (!y || n <= 0)
+        return std::vector<int>();
+
+    const int limit = (mode == Mode::MinMax) ? targetPoints * 2 : targetPoints;
+    if (targetPoints <= 0 || n <= limit)
+        return allIndices(n);
+
+    // 统一转 float：ARMv7 NEON 只有单精度向量
+    std::vector<float> yf(static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i)
+        yf[static_cast<size_t>(i)] = static_cast<float>(y[i]);
+
+    if (mode == Mode::Lttb)
+        return lttb(yf.data(), n, targetPoints, pinned);
+    return minMax(yf.data(), n, targetPoints, pinned);
+}
+
+std::vector<int> CurveDecimator::lttb(const float* y, int n, int threshold,
+                                      const std::vector<int>& pinned) {
+    if (!y || n <= 0)
+        return std::vector<int>();
+    if (threshold >= n)
+        return allIndices(n);
+
+    const std::vector<int> pins = normalizePinned(pinned, n);
+
+    // 桶不够分：只留首尾，固定点照样保留
+    if (threshold < 3) {
+        std::vector<int> out;
+        out.reserve(pins.size() + 2);
+        out.push_back(0);
+        out.insert(out.end(), pins.begin(), pins.end());
+        out.push_back(n - 1);
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+        return out;
+    }
+
+    size_t pinPos = 0;
+
+    std::vector<int> out;
+    out.reserve(static_cast<size_t>(threshold) + pins.size());
+    out.push_back(0);
+
+    const double every = double(n - 2) / double(threshold - 2);
+    int a = 0;
+
+    for (int i = 0; i < threshold - 2; ++i) {
+        // ---- 当前桶 [rangeOffs, rangeTo) ----
+        const int rangeOffs = int(std::floor(i * every)) + 1;
+        const int rangeTo = std::min(int(std::floor((i + 1) * every)) + 1, n - 1);
+
+        // ---- 桶内有固定点（C/T 峰）：直接保留，不参与选点 ----
+        while (pinPos < pins.size() && pins[pinPos] < rangeOffs)
+            ++pinPos;
+        bool pinnedHit = false;
+        while (pinPos < pins.size() && pins[pinPos] < rangeTo) {
+            out.push_back(pins[pinPos]);
+            a = pins[pinPos];
+            ++pinPos;
+            pinnedHit = true;
+        }
+        if (pinnedHit || rangeOffs >= rangeTo)
+            continue;
+
+        // ---- 下一桶均值作为三角形第三点 ----
+        const int avgStart = rangeTo;
+        const int avgEnd = std::min(int(std::floor((i + 2) * every)) + 1, n);
+        double avgX = 0.0;
+        double avgY = 0.0;
+        const int avgLen = avgEnd - avgStart;
+        if (avgLen > 0) {
+            for (int k = avgStart; k < avgEnd; ++k)
+                avgY += y[k];
+            avgY /= avgLen;
+            avgX = 0.5 * double(avgStart + avgEnd - 1);
+        } else {
+            avgX = n - 1;
+            avgY = y[n - 1];
+        }
+
+        const float ax = float(a);
+        const float ay = y[a];
+        const float k1 = float(double(a) - avgX);
+        const float k2 = float(avgY - double(ay));
+
+        a = argmaxTriangle(y, rangeOffs, rangeTo, ax, ay, k1, k2);
+        out.push_back(a);
+    }
+
+    // ---- 末尾固定点 + 最后一个点 ----
+    for (; pinPos < pins.size(); ++pinPos)
+        out.push_back(pins[pinPos]);
+    out.push_back(n - 1);
+
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+std::vector<int> CurveDecimator::minMax(const float* y, int n, int pixelWidth,
+                                        const std::vector<int>& pinned) {
+    if (!y || n <= 0)
+        return std::vector<int>();
+    if (pixelWidth <= 0 || n <= pixelWidth * 2)
+        return allIndices(n);
+
+    const std::vector<int> pins = normalizePinned(pinned, n);
+
+    std::vector<int> out;
+    out.reserve(static_cast<size_t>(pixelWidth) * 2 + pins.size() + 2);
+    out.push_back(0);
+
+    for (int p = 0; p < pixelWidth; ++p) {
+        const int begin = int((long long)p * n / pixelWidth);
+        const int end = int((long long)(p + 1) * n / pixelWidth);
+        if (begin >= end)
+            continue;
+
+        int iMin = begin;
+        int iMax = begin;
+        minMaxRange(y, begin, end, iMin, iMax);
+
+        // 按原始顺序输出，折线走向不乱
+        out.push_back(std::min(iMin, iMax));
+        if (iMin != iMax)
+            out.push_back(std::max(iMin, iMax));
+    }
+
+    out.insert(out.end(), pins.begin(), pins.end());
+    out.push_back(n - 1);
+
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+CurveDecimator::Mode CurveDecimator::parseMode(const char* name, Mode fallback) {
+    if (!name || *name == '\0')
+        return fallback;
+    if (strcasecmp(name, "lttb") == 0)
+        return Mode::Lttb;
+    if (strcasecmp(name, "minmax") == 0)
+        return Mode::MinMax;
+    return fallback;
+}
@@ -0,0 +1,56 @@
+#ifndef PRINTTEMPLATE_H_
+#define PRINTTEMPLATE_H_
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <QVector>
+#include <functional>
+
+/*
+ * PrintTemplate
+ *
+ * 作用：
+ *   把打印版式预编译成 ESC/POS 字节流 + 字段槽位，打印时只填值、拼接，整单一次下发
+ *
+ * 模板语法（每个 QString 为一行）：
+ *   "样品编号: {sampleNo}"         字符串字段
+ *   "检测浓度: {detectedConc:2}"   数值字段，保留 2 位小数
+ *   "{qr:sampleNo}"               整行为二维码（居中）
+ *
+ * 编码：
+ *   固定文字在 compile() 时转成打印机编码（CP936），字段值在 render() 时转换，
+ *   转换函数由调用方提供（PrinterManager::encodeText，借打印机库完成 UTF-8 → CP936）
+ */
+class PrintTemplate {
+public:
+    using Encoder = std::function<QByteArray(const QByteArray& utf8)>;
+
+    static PrintTemplate compile(const QStringList& lines, const Encoder& enc);
+
+    bool isEmpty() const { return m_segments.isEmpty(); }
+
+    // 追加一条记录的字节流（不含初始化和走纸，便于批量拼接）
+    void render(const QVariantMap& record, const Encoder& enc, QByteArray& out) const;
+
+    // ESC @ + 选择汉字模式
+    static QByteArray jobHeader();
+    // 走纸 lines 行
+    static QByteArray feed(int lines);
+
+private:
+    struct Segment {
+        enum Kind { Raw, Field, Qr };
+        Kind kind = Raw;
+        QByteArray bytes;  // Raw：已编码的固定内容
+        QString key;       // Field / Qr：记录中的键
+        int decimals = -1; // Field：>=0 时按定点小数格式化
+    };
+
+    static void appendQr(const QByteArray& data, QByteArray& out);
+
+    QVector<Segment> m_segments;
+};
+
+#endif  // PRINTTEMPLATE_H_
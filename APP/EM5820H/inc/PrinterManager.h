@@ -1,6 +1,7 @@
 #ifndef PRINTERMANAGER_H
 #define PRINTERMANAGER_H
 
+#include <QByteArray>
 #include <QObject>
 #include <atomic>
 #include <chrono>
@@ -27,6 +28,12 @@ public:
     printer_t* printer;  // 打印机对象指针
     const printer_t* getPrinter() const { return printer; }
 
+    // 以下两个只能在打印线程（postPrint 的任务里）调用
+    // UTF-8 → 打印机编码（CP936），借库的发送缓冲区取结果，不下发；按固定小段转换，库每次写入有上界
+    QByteArray encodeText(const QByteArray& utf8);
+    // 整段 ESC/POS 字节一次 USB 批量下发
+    bool sendRaw(const QByteArray& data);
+
 private:
     PrinterManager();
     ~PrinterManager();
@@ -1,23 +1,52 @@
 #ifndef PRINTERDEVICECONTROLLER_H_
 #define PRINTERDEVICECONTROLLER_H_
+#include <QHash>
 #include <QObject>
+#include <QVariantList>
 
+#include "PrintTemplate.h"
 #include "PrinterManager.h"
 class SettingsViewModel;
 class PrinterDeviceController : public QObject {
     Q_OBJECT
+    // 结果单末尾附样品编号二维码
+    Q_PROPERTY(bool printQrCode READ printQrCode WRITE setPrintQrCode NOTIFY printQrCodeChanged)
 public:
     explicit PrinterDeviceController(SettingsViewModel* settings, QObject* parent = nullptr);
     Q_INVOKABLE void printText(const QString& text);
     Q_INVOKABLE void printRecord(const QVariantMap& record);
+    // 多条结果拼成一个作业，一次 USB 下发（历史页批量打印 / 当日汇总）
+    Q_INVOKABLE void printRecords(const QVariantList& records);
+
+    bool printQrCode() const { return m_printQrCode; }
+    void setPrintQrCode(bool on);
 
     void start();
     void stop();
     void test();
     int a, b, c;
 
+signals:
+    void printQrCodeChanged();
+
 private:
+    // 版式开关（打印设置 + 二维码）压成位掩码，作为模板缓存键
+    enum LayoutFlag {
+        ShowSampleSource = 1 << 0,
+        ShowReferenceValue = 1 << 1,
+        ShowDetectedPerson = 1 << 2,
+        ShowDilutionInfo = 1 << 3,
+        ShowManufacturer = 1 << 4,
+        ShowQrCode = 1 << 5,
+    };
+    int layoutFlags() const;
+    static QStringList templateLines(int flags);
+    // 仅在打印线程调用
+    const PrintTemplate& templateFor(int flags);
+
     PrinterManager& redar1;
     SettingsViewModel* m_settings = nullptr;
+    bool m_printQrCode = false;
+    QHash<int, PrintTemplate> m_templates;  // 仅打印线程访问
 };
 #endif  // PRINTERDEVICECONTROLLER_H_
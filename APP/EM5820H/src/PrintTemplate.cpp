@@ -0,0 +1,113 @@
+#include "PrintTemplate.h"
+
+#include <QRegularExpression>
+
+namespace {
+
+const char ESC = 0x1B;
+const char FS = 0x1C;
+const char GS = 0x1D;
+const int kQrMaxData = 256;  // 样品编号等短文本足够
+
+}  // namespace
+
+PrintTemplate PrintTemplate::compile(const QStringList& lines, const Encoder& enc) {
+    static const QRegularExpression kField(QStringLiteral("\\{([A-Za-z_][A-Za-z0-9_]*)(?::(\\d))?\\}"));
+    static const QRegularExpression kQrLine(QStringLiteral("^\\{qr:([A-Za-z_][A-Za-z0-9_]*)\\}$"));
+
+    PrintTemplate t;
+    QString pending;  // 连续固定文字合并后一次编码
+    auto flushRaw = [&]() {
+        if (pending.isEmpty())
+            return;
+        Segment s;
+        s.bytes = enc(pending.toUtf8());
+        t.m_segments.append(s);
+        pending.clear();
+    };
+
+    for (const QString& line : lines) {
+        const QRegularExpressionMatch qr = kQrLine.match(line);
+        if (qr.hasMatch()) {
+            flushRaw();
+            Segment s;
+            s.kind = Segment::Qr;
+            s.key = qr.captured(1);
+            t.m_segments.append(s);
+            continue;
+        }
+
+        int pos = 0;
+        QRegularExpressionMatchIterator it = kField.globalMatch(line);
+        while (it.hasNext()) {
+            const QRegularExpressionMatch m = it.next();
+            pending += line.mid(pos, m.capturedStart() - pos);
+            flushRaw();
+            Segment s;
+            s.kind = Segment::Field;
+            s.key = m.captured(1);
+            s.decimals = m.captured(2).isEmpty() ? -1 : m.captured(2).toInt();
+            t.m_segments.append(s);
+            pos = m.capturedEnd();
+        }
+        pending += line.mid(pos);
+        pending += QLatin1Char('\n');
+    }
+    flushRaw();
+    return t;
+}
+
+void PrintTemplate::render(const QVariantMap& record, const Encoder& enc, QByteArray& out) const {
+    for (const Segment& s : m_segments) {
+        switch (s.kind) {
+        case Segment::Raw:
+            out += s.bytes;
+            break;
+        case Segment::Field: {
+            const QVariant v = record.value(s.key);
+            const QString text = s.decimals >= 0 ? QString::number(v.toDouble(), 'f', s.decimals)
+                                                 : v.toString();
+            if (!text.isEmpty())
+                out += enc(text.toUtf8());
+            break;
+        }
+        case Segment::Qr:
+            appendQr(record.value(s.key).toString().toUtf8(), out);
+            break;
+        }
+    }
+}
+
+QByteArray PrintTemplate::jobHeader() {
+    QByteArray h;
+    h.append(ESC).append('@');  // 初始化
+    h.append(FS).append('&');   // 汉字模式
+    return h;
+}
+
+QByteArray PrintTemplate::feed(int lines) {
+    QByteArray f;
+    f.append(ESC).append('d').append(char(qBound(0, lines, 255)));
+    return f;
+}
+
+// ===== GS ( k：Model 2，模块 5 点，纠错 M =====
+void PrintTemplate::appendQr(const QByteArray& data, QByteArray& out) {
+    if (data.isEmpty())
+        return;
+    const QByteArray d = data.left(kQrMaxData);
+    auto fn = [&out](const QByteArray& body) {
+        out.append(GS).append('(').append('k');
+        out.append(char(body.size() & 0xFF)).append(char((body.size() >> 8) & 0xFF));
+        out.append(body);
+    };
+
+    out.append(ESC).append('a').append(char(1));  // 居中
+    fn(QByteArray("\x31\x41\x32\x00", 4));         // 选择 Model 2
+    fn(QByteArray("\x31\x43\x05", 3));             // 模块大小
+    fn(QByteArray("\x31\x45\x31", 3));             // 纠错等级 M
+    fn(QByteArray("\x31\x50\x30", 3) + d);         // 写入数据
+    fn(QByteArray("\x31\x51\x30", 3));             // 打印
+    out.append('\n');
+    out.append(ESC).append('a').append(char(0));  // 恢复左对齐
+}
@@ -5,9 +5,19 @@
 #include <unistd.h>
 
 #include <QDebug>
+#include <vector>
 
 #include "printer_lib.h"
 #include "printer_type.h"
+
+namespace {
+// encodeText 每次交给库转换的 UTF-8 上限。get_send() 不带缓冲区长度，库也不提供待发送长度，
+// 写多少只能靠输入限住：CP936 里每个字符都不比它的 UTF-8 长，一段的输出 ≤ 段长 + 编码切换指令，
+// 缓冲区按固定的 2 倍段长 + 余量开。这个段长上限是唯一的保证，get_send() 返回后再查长度已经晚了
+const int kEncodeChunk = 240;
+const size_t kEncodeOutCap = kEncodeChunk * 2 + 64;
+}  // namespace
+
 PrinterManager::PrinterManager()
     : printer(nullptr), running(false) {
 }
@@ -149,6 +159,53 @@ void PrinterManager::testBarcode() {
     // qDebug() << "printer " << printer;
 }
 
+// ---------------- 原始字节 ----------------
+QByteArray PrinterManager::encodeText(const QByteArray& utf8) {
+    if (!printer || utf8.isEmpty())
+        return QByteArray();
+
+    QByteArray result;
+    result.reserve(utf8.size() + 16);
+    uint8_t in[kEncodeChunk + 1];
+    std::vector<uint8_t> out(kEncodeOutCap);
+    buffer_t* buf = printer->buffer();
+
+    // 按 UTF-8 字符边界切段，逐段转换后拼接
+    for (int pos = 0; pos < utf8.size();) {
+        const int maxLen = qMin(kEncodeChunk, utf8.size() - pos);
+        int len = maxLen;
+        while (len > 0 && pos + len < utf8.size() && (uchar(utf8[pos + len]) & 0xC0) == 0x80)
+            --len;
+        if (len == 0)
+            len = maxLen;  // 非法 UTF-8（整段都是续字节）：照长度切，不死循环
+        memcpy(in, utf8.constData() + pos, size_t(len));
+        in[len] = 0;
+        pos += len;
+
+        buf->clean_send();
+        printer->text()->encoding(ENCODING_CP936)->utf8_text(in);
+        const int n = buf->get_send(out.data());
+        buf->clean_send();
+        if (n > 0)
+            result.append(reinterpret_cast<const char*>(out.data()), n);
+    }
+    return result;
+}
+
+bool PrinterManager::sendRaw(const QByteArray& data) {
+    if (!printer || data.isEmpty())
+        return false;
+    // 超时随数据量放宽：EM5820H 约 50 mm/s，一整天的汇总可能要打几十秒
+    const int timeoutMs = 5000 + data.size() / 4;
+    const int n = printer->raw()->send(reinterpret_cast<uint8_t*>(const_cast<char*>(data.constData())),
+                                       data.size(), timeoutMs);
+    if (n != data.size()) {
+        qWarning() << "[PrinterManager] raw send" << n << "/" << data.size();
+        return false;
+    }
+    return true;
+}
+
 // ---------------- 卸载 ----------------
 void PrinterManager::deinitPrinter() {
     if (printer) {
@@ -39,64 +39,98 @@ void PrinterDeviceController::printText(const QString& text) {
             ->print();
     });
 }
-void PrinterDeviceController::printRecord(const QVariantMap& record) {
-    PrinterManager& mgr = PrinterManager::instance();
-    auto* p = PrinterManager::instance().getPrinter();
-    qDebug() << "PrinterManager::instance().getPrinter()" << p;
-    if (!p) {
-        qWarning() << "❌ Printer not initialized!";
+void PrinterDeviceController::setPrintQrCode(bool on) {
+    if (m_printQrCode == on)
         return;
+    m_printQrCode = on;
+    emit printQrCodeChanged();
+}
+
+int PrinterDeviceController::layoutFlags() const {
+    int f = m_printQrCode ? ShowQrCode : 0;
+    if (m_settings) {
+        if (m_settings->printSampleSource())
+            f |= ShowSampleSource;
+        if (m_settings->printReferenceValue())
+            f |= ShowReferenceValue;
+        if (m_settings->printDetectedPerson())
+            f |= ShowDetectedPerson;
+        if (m_settings->printDilutionInfo())
+            f |= ShowDilutionInfo;
+        if (m_settings->manufacturerPrint())
+            f |= ShowManufacturer;
     }
+    return f;
+}
 
+// ===== 结果单版式 =====
+QStringList PrinterDeviceController::templateLines(int flags) {
     QStringList lines;
-
     lines << "******** 检测结果 ********";
-    lines << ("项目名称: " + record.value("projectName").toString());
-    lines << ("样品编号: " + record.value("sampleNo").toString());
-    if (m_settings && m_settings->printSampleSource()) {
-        lines << ("样品来源: " + record.value("sampleSource").toString());
-    }
-    lines << ("样品名称: " + record.value("sampleName").toString());
-    lines << ("标准曲线: " + record.value("standardCurve").toString());
-    lines << ("批次编码: " + record.value("batchCode").toString());
-
-    lines << QString("检测结果: %1")
-                 .arg(record.value("result").toString());
-
-    lines << QString("检测浓度: %1 %2 ug/kg")
-                 .arg(record.value("detectedConc").toDouble(), 0, 'f', 2)
-                 .arg(record.value("detectedUnit").toString());
-    if (m_settings && m_settings->printReferenceValue()) {
-        lines << QString("参考值: %1 %2")
-                     .arg(record.value("referenceValue").toDouble(), 0, 'f', 2)
-                     .arg(record.value("detectedUnit").toString());
-    }
-    lines << ("检测时间: " + record.value("detectedTime").toString());
-    if (m_settings && m_settings->printDetectedPerson()) {
-        lines << ("检测人员: " + record.value("detectedPerson").toString());
-    }
-    if (m_settings && m_settings->printDilutionInfo()) {
-        lines << ("稀释倍数: " + record.value("dilutionInfo").toString());
-    }
-    if (m_settings && m_settings->manufacturerPrint()) {
-        lines << ("青岛普瑞邦生物工程有限公司");
-    }
+    lines << "项目名称: {projectName}";
+    lines << "样品编号: {sampleNo}";
+    if (flags & ShowSampleSource)
+        lines << "样品来源: {sampleSource}";
+    lines << "样品名称: {sampleName}";
+    lines << "标准曲线: {standardCurve}";
+    lines << "批次编码: {batchCode}";
+    lines << "检测结果: {result}";
+    lines << "检测浓度: {detectedConc:2} {detectedUnit} ug/kg";
+    if (flags & ShowReferenceValue)
+        lines << "参考值: {referenceValue:2} {detectedUnit}";
+    lines << "检测时间: {detectedTime}";
+    if (flags & ShowDetectedPerson)
+        lines << "检测人员: {detectedPerson}";
+    if (flags & ShowDilutionInfo)
+        lines << "稀释倍数: {dilutionInfo}";
+    if (flags & ShowManufacturer)
+        lines << "青岛普瑞邦生物工程有限公司";
+    if (flags & ShowQrCode)
+        lines << "{qr:sampleNo}";
     lines << "******************************";
     lines << "******************************";
-    // ---- 严格按你的打印格式处理 ----
-    for (int i = 0; i < lines.size(); i++) {
-        QByteArray utf8 = lines[i].toUtf8();
+    return lines;
+}
 
-        // ⭐ 必须生成 uint8_t 数组，否则无法传给 utf8_text()
-        std::vector<uint8_t> buf(utf8.begin(), utf8.end());
-        buf.push_back(0);  // null-terminator
+const PrintTemplate& PrinterDeviceController::templateFor(int flags) {
+    auto it = m_templates.find(flags);
+    if (it == m_templates.end()) {
+        PrinterManager& mgr = PrinterManager::instance();
+        it = m_templates.insert(flags, PrintTemplate::compile(templateLines(flags), [&mgr](const QByteArray& u) {
+                                    return mgr.encodeText(u);
+                                }));
+        qDebug() << "[PrinterDeviceController] template compiled, flags =" << flags;
+    }
+    return it.value();
+}
+
+void PrinterDeviceController::printRecord(const QVariantMap& record) {
+    printRecords(QVariantList{record});
+}
 
-        uint8_t* ptr = buf.data();
+void PrinterDeviceController::printRecords(const QVariantList& records) {
+    if (records.isEmpty())
+        return;
+    // 设置在 GUI 线程读取，随任务带走
+    const int flags = layoutFlags();
 
-        if (i < lines.size() - 1) {
-            p->text()->encoding(ENCODING_CP936)->utf8_text(ptr)->newline();
-        } else {
-            p->text()->encoding(ENCODING_CP936)->utf8_text(ptr)->print();
+    redar1.postPrint([this, records, flags]() {
+        PrinterManager& mgr = PrinterManager::instance();
+        if (!mgr.printer) {
+            qWarning() << "❌ Printer not initialized!";
+            return;
         }
-    }
+        const PrintTemplate& tpl = templateFor(flags);
+        const PrintTemplate::Encoder enc = [&mgr](const QByteArray& u) { return mgr.encodeText(u); };
+
+        QByteArray job = PrintTemplate::jobHeader();
+        job.reserve(records.size() * 512);
+        for (const QVariant& r : records)
+            tpl.render(r.toMap(), enc, job);
+        job += PrintTemplate::feed(3);
+
+        const bool ok = mgr.sendRaw(job);
+        qDebug() << "[PrinterDeviceController] printed" << records.size() << "record(s)," << job.size()
+                 << "bytes, ok =" << ok;
+    });
 }
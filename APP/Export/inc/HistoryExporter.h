@@ -0,0 +1,96 @@
+#ifndef HISTORYEXPORTER_H
+#define HISTORYEXPORTER_H
+
+#include <QByteArray>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+
+/*
+ * 导出输出端（文件 / HTTP 分块响应）
+ * write 返回 false 表示写失败或对端已断开，导出随即终止
+ */
+class ExportSink {
+public:
+    virtual ~ExportSink() = default;
+    virtual bool write(const char* data, qint64 size) = 0;
+};
+
+/*
+ * HistoryExporter
+ *
+ * 作用：
+ *   按块流式导出 project_info（可带 adc_data 曲线），每块最多 chunkRows 行
+ *
+ * 特点：
+ *   - 键集游标（id < lastId ORDER BY id DESC），块与块之间不持有查询 / 事务，
+ *     调用方可以在两块之间处理别的数据库任务
+ *   - 内存只与块大小有关，与总行数无关
+ *   - CSV：UTF-8 BOM + RFC 4180 转义；曲线为一列，点之间用 ';' 分隔
+ *   - Bundle（.fqx）：按块列存的二进制包，见下方格式说明
+ *
+ * Bundle 格式（小端）：
+ *   "FQX1" u16 version=1 u16 flags(bit0=含曲线) u32 columnCount
+ *   每列：u8 type u8 nameLen name[nameLen]
+ *         type 1 = i32，2 = f64，3 = utf8 字符串，4 = f32 数组（曲线）
+ *   每块："RGRP" u32 rows，随后按列顺序：
+ *         i32 / f64：rows 个定长值
+ *         utf8     ：u32 offsets[rows + 1]（字节偏移）+ 字节
+ *         f32 数组 ：u32 offsets[rows + 1]（元素偏移）+ f32 值
+ *   结尾："DONE" u64 totalRows
+ */
+class HistoryExporter {
+public:
+    enum class Format {
+        Csv,
+        Bundle
+    };
+
+    struct Options {
+        Format format = Format::Csv;
+        bool includeTraces = false;
+        int chunkRows = 200;
+        QString fromTime;  // detectedTime 下限（含），空 = 不限
+        QString toTime;    // detectedTime 上限（含），空 = 不限
+    };
+
+    // "csv" / "bundle"|"fqx"（大小写不敏感），无法识别时返回 fallback
+    static Format parseFormat(const QString& name, Format fallback = Format::Csv);
+    static const char* contentType(Format f);
+    static const char* fileSuffix(Format f);
+
+    explicit HistoryExporter(const Options& opt);
+
+    // 统计待导出行数（可选；只用于进度显示）
+    bool prepare(QSqlDatabase& db, QString& err);
+
+    // 写出下一块；首块前写文件头，最后一块后写文件尾并置 finished()
+    bool step(QSqlDatabase& db, ExportSink& out, QString& err);
+
+    bool finished() const { return m_finished; }
+    qint64 rowsWritten() const { return m_written; }
+    qint64 totalRows() const { return m_total; }  // prepare 之前为 -1
+
+private:
+    QString whereClause(bool withCursor) const;
+    void bindRange(QSqlQuery& q) const;
+    bool loadTrace(QSqlDatabase& db, const QString& sampleNo, QByteArray& csvOut,
+                   QVector<float>* valuesOut, QString& err);
+
+    void writeHeader();
+    bool writeCsvChunk(QSqlDatabase& db, QSqlQuery& q, int& rows, QString& err);
+    bool writeBundleChunk(QSqlDatabase& db, QSqlQuery& q, int& rows, QString& err);
+
+private:
+    Options m_opt;
+    qint64 m_total = -1;
+    qint64 m_written = 0;
+    int m_lastId = 0;  // 已写出的最小 id（0 = 尚未开始）
+    bool m_headerDone = false;
+    bool m_finished = false;
+    QByteArray m_buf;  // 块缓冲（复用）
+};
+
+#endif  // HISTORYEXPORTER_H
@@ -0,0 +1,393 @@
+#include "HistoryExporter.h"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QList>
+#include <QSqlError>
+#include <QStringList>
+#include <QVariant>
+#include <QtEndian>
+#include <cstring>
+
+#include "AdcArchive.h"
+
+namespace {
+
+enum ColType : char {
+    ColI32 = 1,
+    ColF64 = 2,
+    ColText = 3,
+    ColTrace = 4
+};
+
+struct Column {
+    const char* sql;      // SELECT 列
+    const char* csvName;  // CSV 表头 / Bundle 列名
+    ColType type;
+};
+
+// 顺序即 SELECT 顺序
+const Column kColumns[] = {
+    {"id", "ID", ColI32},
+    {"projectId", "ProjectId", ColI32},
+    {"projectName", "ProjectName", ColText},
+    {"sampleNo", "SampleNo", ColText},
+    {"sampleSource", "SampleSource", ColText},
+    {"sampleName", "SampleName", ColText},
+    {"standardCurve", "StandardCurve", ColText},
+    {"batchCode", "BatchCode", ColText},
+    {"detectedConc", "DetectedConc", ColF64},
+    {"referenceValue", "ReferenceValue", ColF64},
+    {"result", "Result", ColText},
+    {"detectedTime", "DetectedTime", ColText},
+    {"detectedUnit", "DetectedUnit", ColText},
+    {"detectedPerson", "DetectedPerson", ColText},
+    {"dilutionInfo", "DilutionInfo", ColText},
+    {"\"C\"", "C", ColF64},
+    {"\"T\"", "T", ColF64},
+    {"ratio", "Ratio", ColF64},
+};
+constexpr int kColumnCount = sizeof(kColumns) / sizeof(kColumns[0]);
+constexpr int kSampleNoCol = 3;
+const char kTraceName[] = "AdcValues";
+
+QString selectList() {
+    QString s;
+    for (int i = 0; i < kColumnCount; ++i) {
+        if (i)
+            s += ", ";
+        s += QLatin1String(kColumns[i].sql);
+    }
+    return s;
+}
+
+// ===== 小端写入 =====
+void put_u8(QByteArray& b, quint8 v) {
+    b.append(static_cast<char>(v));
+}
+void put_u16(QByteArray& b, quint16 v) {
+    char tmp[2];
+    qToLittleEndian(v, tmp);
+    b.append(tmp, 2);
+}
+void put_u32(QByteArray& b, quint32 v) {
+    char tmp[4];
+    qToLittleEndian(v, tmp);
+    b.append(tmp, 4);
+}
+void put_u64(QByteArray& b, quint64 v) {
+    char tmp[8];
+    qToLittleEndian(v, tmp);
+    b.append(tmp, 8);
+}
+void put_f64(QByteArray& b, double v) {
+    quint64 bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    put_u64(b, bits);
+}
+void put_f32(QByteArray& b, float v) {
+    quint32 bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    put_u32(b, bits);
+}
+
+// ===== CSV 字段（RFC 4180）=====
+void put_csv_text(QByteArray& b, const QString& s) {
+    const QByteArray u8 = s.toUtf8();
+    bool quote = false;
+    for (char c : u8) {
+        if (c == ',' || c == '"' || c == '\n' || c == '\r') {
+            quote = true;
+            break;
+        }
+    }
+    if (!quote) {
+        b.append(u8);
+        return;
+    }
+    b.append('"');
+    for (char c : u8) {
+        if (c == '"')
+            b.append('"');
+        b.append(c);
+    }
+    b.append('"');
+}
+
+}  // namespace
+
+// ======================== 工具 ========================
+
+HistoryExporter::Format HistoryExporter::parseFormat(const QString& name, Format fallback) {
+    const QString n = name.trimmed().toLower();
+    if (n == QLatin1String("csv"))
+        return Format::Csv;
+    if (n == QLatin1String("bundle") || n == QLatin1String("fqx"))
+        return Format::Bundle;
+    return fallback;
+}
+
+const char* HistoryExporter::contentType(Format f) {
+    return f == Format::Csv ? "text/csv; charset=utf-8" : "application/x-fq-bundle";
+}
+
+const char* HistoryExporter::fileSuffix(Format f) {
+    return f == Format::Csv ? "csv" : "fqx";
+}
+
+HistoryExporter::HistoryExporter(const Options& opt) : m_opt(opt) {
+    if (m_opt.chunkRows < 1)
+        m_opt.chunkRows = 1;
+}
+
+// WHERE 子句：时间范围在前，游标在后（与 bindRange / step 的绑定顺序一致）
+QString HistoryExporter::whereClause(bool withCursor) const {
+    QStringList conds;
+    if (!m_opt.fromTime.isEmpty())
+        conds << "detectedTime >= ?";
+    if (!m_opt.toTime.isEmpty())
+        conds << "detectedTime <= ?";
+    if (withCursor)
+        conds << "id < ?";
+    return conds.isEmpty() ? QString() : " WHERE " + conds.join(" AND ");
+}
+
+void HistoryExporter::bindRange(QSqlQuery& q) const {
+    if (!m_opt.fromTime.isEmpty())
+        q.addBindValue(m_opt.fromTime);
+    if (!m_opt.toTime.isEmpty())
+        q.addBindValue(m_opt.toTime);
+}
+
+bool HistoryExporter::prepare(QSqlDatabase& db, QString& err) {
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    q.prepare("SELECT COUNT(1) FROM project_info" + whereClause(false));
+    bindRange(q);
+    if (!q.exec() || !q.next()) {
+        err = q.lastError().text();
+        return false;
+    }
+    m_total = q.value(0).toLongLong();
+    return true;
+}
+
+// ======================== 主流程 ========================
+
+bool HistoryExporter::step(QSqlDatabase& db, ExportSink& out, QString& err) {
+    if (m_finished)
+        return true;
+
+    m_buf.clear();
+    if (!m_headerDone) {
+        writeHeader();
+        m_headerDone = true;
+    }
+
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    q.prepare(QString("SELECT %1 FROM project_info%2 ORDER BY id DESC LIMIT ?")
+                  .arg(selectList(), whereClause(m_lastId > 0)));
+    bindRange(q);
+    if (m_lastId > 0)
+        q.addBindValue(m_lastId);
+    q.addBindValue(m_opt.chunkRows);
+    if (!q.exec()) {
+        err = q.lastError().text();
+        return false;
+    }
+
+    int rows = 0;
+    const bool ok = (m_opt.format == Format::Csv) ? writeCsvChunk(db, q, rows, err)
+                                                  : writeBundleChunk(db, q, rows, err);
+    if (!ok)
+        return false;
+    m_written += rows;
+
+    if (rows < m_opt.chunkRows) {
+        if (m_opt.format == Format::Bundle) {
+            m_buf.append("DONE", 4);
+            put_u64(m_buf, static_cast<quint64>(m_written));
+        }
+        m_finished = true;
+    }
+
+    if (!m_buf.isEmpty() && !out.write(m_buf.constData(), m_buf.size())) {
+        err = QStringLiteral("写出失败");
+        return false;
+    }
+    return true;
+}
+
+void HistoryExporter::writeHeader() {
+    if (m_opt.format == Format::Csv) {
+        m_buf.append("\xEF\xBB\xBF");  // BOM：Excel 按 UTF-8 打开中文
+        for (int i = 0; i < kColumnCount; ++i) {
+            if (i)
+                m_buf.append(',');
+            m_buf.append(kColumns[i].csvName);
+        }
+        if (m_opt.includeTraces) {
+            m_buf.append(',');
+            m_buf.append(kTraceName);
+        }
+        m_buf.append("\r\n");
+        return;
+    }
+
+    m_buf.append("FQX1", 4);
+    put_u16(m_buf, 1);
+    put_u16(m_buf, m_opt.includeTraces ? 1 : 0);
+    put_u32(m_buf, static_cast<quint32>(kColumnCount + (m_opt.includeTraces ? 1 : 0)));
+    for (int i = 0; i < kColumnCount; ++i) {
+        const auto len = static_cast<quint8>(std::strlen(kColumns[i].csvName));
+        put_u8(m_buf, static_cast<quint8>(kColumns[i].type));
+        put_u8(m_buf, len);
+        m_buf.append(kColumns[i].csvName, len);
+    }
+    if (m_opt.includeTraces) {
+        put_u8(m_buf, ColTrace);
+        put_u8(m_buf, static_cast<quint8>(sizeof(kTraceName) - 1));
+        m_buf.append(kTraceName, sizeof(kTraceName) - 1);
+    }
+}
+
+// ======================== 曲线 ========================
+
+// adc_data 按插入顺序拼接（已归档的从段文件读回）；CSV 直接改写 JSON 文本（不解析），Bundle 解析成 f32
+bool HistoryExporter::loadTrace(QSqlDatabase& db, const QString& sampleNo, QByteArray& csvOut,
+                                QVector<float>* valuesOut, QString& err) {
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    q.prepare("SELECT adcValues FROM adc_data WHERE sampleNo = ? ORDER BY id ASC");
+    q.addBindValue(sampleNo);
+    if (!q.exec()) {
+        err = q.lastError().text();
+        return false;
+    }
+    QList<QByteArray> texts;
+    while (q.next())
+        texts << q.value(0).toByteArray();
+    if (texts.isEmpty())
+        AdcArchive::readTrace(db, sampleNo, texts);  // 已归档的样品从段文件读回
+    for (const QByteArray& text : texts) {
+        if (valuesOut) {
+            const QJsonArray arr = QJsonDocument::fromJson(text).array();
+            for (const auto& v : arr)
+                valuesOut->append(static_cast<float>(v.toDouble()));
+            continue;
+        }
+        for (char c : text) {
+            if (c == '[' || c == ']' || c == ' ' || c == '\n' || c == '\r' || c == '\t')
+                continue;
+            if (c == ',')
+                c = ';';
+            if (c == ';' && (csvOut.isEmpty() || csvOut.endsWith(';')))
+                continue;
+            csvOut.append(c);
+        }
+        if (!csvOut.isEmpty() && !csvOut.endsWith(';'))
+            csvOut.append(';');
+    }
+    if (csvOut.endsWith(';'))
+        csvOut.chop(1);
+    return true;
+}
+
+// ======================== CSV ========================
+
+bool HistoryExporter::writeCsvChunk(QSqlDatabase& db, QSqlQuery& q, int& rows, QString& err) {
+    QByteArray trace;
+    while (q.next()) {
+        for (int i = 0; i < kColumnCount; ++i) {
+            if (i)
+                m_buf.append(',');
+            const QVariant v = q.value(i);
+            switch (kColumns[i].type) {
+            case ColI32:
+                m_buf.append(QByteArray::number(v.toInt()));
+                break;
+            case ColF64:
+                m_buf.append(QByteArray::number(v.toDouble(), 'f', 3));
+                break;
+            default:
+                put_csv_text(m_buf, v.toString());
+                break;
+            }
+        }
+        if (m_opt.includeTraces) {
+            trace.clear();
+            if (!loadTrace(db, q.value(kSampleNoCol).toString(), trace, nullptr, err))
+                return false;
+            m_buf.append(',');
+            m_buf.append(trace);
+        }
+        m_buf.append("\r\n");
+        m_lastId = q.value(0).toInt();
+        ++rows;
+    }
+    return true;
+}
+
+// ======================== Bundle（按块列存）========================
+
+bool HistoryExporter::writeBundleChunk(QSqlDatabase& db, QSqlQuery& q, int& rows, QString& err) {
+    QVector<QVariant> cells;
+    cells.reserve(m_opt.chunkRows * kColumnCount);
+    QVector<quint32> traceOffsets;
+    QVector<float> traceValues;
+    QByteArray unused;
+    if (m_opt.includeTraces)
+        traceOffsets.append(0);
+
+    while (q.next()) {
+        for (int i = 0; i < kColumnCount; ++i)
+            cells.append(q.value(i));
+        if (m_opt.includeTraces) {
+            if (!loadTrace(db, q.value(kSampleNoCol).toString(), unused, &traceValues, err))
+                return false;
+            traceOffsets.append(static_cast<quint32>(traceValues.size()));
+        }
+        m_lastId = q.value(0).toInt();
+        ++rows;
+    }
+    if (rows == 0)
+        return true;
+
+    m_buf.append("RGRP", 4);
+    put_u32(m_buf, static_cast<quint32>(rows));
+    for (int c = 0; c < kColumnCount; ++c) {
+        switch (kColumns[c].type) {
+        case ColI32:
+            for (int r = 0; r < rows; ++r)
+                put_u32(m_buf, static_cast<quint32>(cells[r * kColumnCount + c].toInt()));
+            break;
+        case ColF64:
+            for (int r = 0; r < rows; ++r)
+                put_f64(m_buf, cells[r * kColumnCount + c].toDouble());
+            break;
+        default: {
+            QVector<QByteArray> texts;
+            texts.reserve(rows);
+            quint32 off = 0;
+            put_u32(m_buf, 0);
+            for (int r = 0; r < rows; ++r) {
+                texts.append(cells[r * kColumnCount + c].toString().toUtf8());
+                off += static_cast<quint32>(texts.last().size());
+                put_u32(m_buf, off);
+            }
+            for (const auto& t : texts)
+                m_buf.append(t);
+            break;
+        }
+        }
+    }
+    if (m_opt.includeTraces) {
+        for (quint32 off : traceOffsets)
+            put_u32(m_buf, off);
+        for (float v : traceValues)
+            put_f32(m_buf, v);
+    }
+    return true;
+}
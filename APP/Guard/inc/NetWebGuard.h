@@ -1,15 +1,14 @@
 #pragma once
 
 #include <QObject>
-#include <QThread>
-#include <QTimer>
 
 namespace embedded {
 class EmbeddedWebServer;
 }
 
 class WiFiController;
-class WifiDetectWorker;
+
+// WiFi 在线 → 启动 Web 服务，掉线 → 停止（跟随 WiFiController::linkStateChanged，不轮询）
 
 class NetWebGuard : public QObject {
     Q_OBJECT
@@ -27,8 +26,4 @@ private:
     embedded::EmbeddedWebServer* m_web;
     bool m_lastWifiConnected;
     bool m_webStarted;
-
-    QThread m_thread;
-    WifiDetectWorker* m_worker;
-    QTimer* m_timer;
 };
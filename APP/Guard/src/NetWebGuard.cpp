@@ -2,9 +2,7 @@
 
 #include <QDebug>
 
-#include "NetWebGuard.h"
 #include "WiFiController.h"
-#include "WifiDetectWorker.h"
 #include "embedded_web_server.h"  // ★ 你这个文件
 NetWebGuard::NetWebGuard(WiFiController* wifi,
                          embedded::EmbeddedWebServer* web,
@@ -13,48 +11,18 @@ NetWebGuard::NetWebGuard(WiFiController* wifi,
       m_wifi(wifi),
       m_web(web),
       m_lastWifiConnected(false),
-      m_webStarted(false),
-      m_worker(nullptr),
-      m_timer(nullptr) {
-    // ===== 1. 创建 worker（只负责 WiFi 检测）=====
-    m_worker = new WifiDetectWorker(m_wifi);
-    m_worker->moveToThread(&m_thread);
-
-    // ===== 2. 创建定时器（在子线程）=====
-    m_timer = new QTimer;
-    m_timer->setInterval(2000);  // 2 秒检测一次
-    m_timer->setSingleShot(false);
-    m_timer->moveToThread(&m_thread);
-
-    // ===== 3. 线程启动后启动定时器 =====
-    connect(&m_thread, &QThread::started,
-            m_timer, QOverload<>::of(&QTimer::start));
-
-    // ===== 4. 定时器 → worker（子线程调用阻塞函数）=====
-    connect(m_timer, &QTimer::timeout,
-            m_worker, &WifiDetectWorker::check);
+      m_webStarted(false) {
+    // WiFiController 内部由 wpa_supplicant 事件 + rtnetlink 驱动，状态变化时才通知
+    connect(m_wifi, &WiFiController::linkStateChanged,
+            this, &NetWebGuard::onWifiState);
 
-    // ===== 5. worker → guard（回主线程）=====
-    connect(m_worker, &WifiDetectWorker::wifiState,
-            this, &NetWebGuard::onWifiState,
-            Qt::QueuedConnection);
-
-    // ===== 6. 线程结束时清理 =====
-    connect(&m_thread, &QThread::finished,
-            m_worker, &QObject::deleteLater);
-    connect(&m_thread, &QThread::finished,
-            m_timer, &QObject::deleteLater);
-
-    // ===== 7. 启动线程 =====
-    m_thread.start();
+    // 启动时已在线（WiFi 先于本对象连上）
+    onWifiState(m_wifi->isWifiConnected());
 
     qInfo() << "[NetWebGuard] started";
 }
 
 NetWebGuard::~NetWebGuard() {
-    m_thread.quit();
-    m_thread.wait();
-
     if (m_webStarted) {
         m_web->stop();
         m_webStarted = false;
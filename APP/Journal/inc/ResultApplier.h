@@ -0,0 +1,51 @@
+#ifndef RESULTAPPLIER_H
+#define RESULTAPPLIER_H
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QTimer>
+#include <QVariantMap>
+
+class DBWorker;
+class LabKeyService;
+class ResultJournal;
+
+/*
+ * ResultApplier
+ *
+ * 作用：
+ *   把日志里已 fsync 的检测结果落到 project_info，上传记录同一事务进 upload_outbox
+ *
+ * 特点：
+ *   - 以记录里的 journalUid 为键，DBWorker 侧按 project_info.journalUid 去重，重放不会重复插入
+ *     （日志序号在日志截断后会重复，不能当键）
+ *   - 落库失败的条目保留在内存里，kRetryMs 后整体重投；日志里也还在，重启同样会重放
+ *   - 只有落库成功后才写“已应用”记录，并唤醒 LabKeyService 发件箱
+ */
+class ResultApplier : public QObject {
+    Q_OBJECT
+public:
+    ResultApplier(ResultJournal* journal, DBWorker* db, LabKeyService* labkey, QObject* parent = nullptr);
+
+private:
+    struct Pending {
+        QVariantMap record;
+        QVariantMap upload;
+    };
+
+    static constexpr int kRetryMs = 5000;
+
+    void onCommitted(qint64 seq, const QVariantMap& record, const QVariantMap& upload);
+    void onApplied(qint64 seq, bool ok);
+    void retryFailed();
+
+    ResultJournal* m_journal;
+    DBWorker* m_db;
+    LabKeyService* m_labkey;
+    QHash<qint64, Pending> m_pending;  // 已投递、等待落库结果
+    QList<qint64> m_failed;
+    QTimer m_retry;
+};
+
+#endif  // RESULTAPPLIER_H
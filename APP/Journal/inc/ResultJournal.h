@@ -0,0 +1,96 @@
+#ifndef RESULTJOURNAL_H
+#define RESULTJOURNAL_H
+
+#include <QObject>
+#include <QString>
+#include <QVariantMap>
+#include <QVector>
+#include <QtGlobal>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+
+/*
+ * ResultJournal
+ *
+ * 作用：
+ *   检测结果先写只追加的二进制日志再落库，界面不再等 SQLite
+ *
+ * 特点：
+ *   - submit() 只入队，立即返回；独立写线程攒批（最多等 kBatchWindowMs）后一次 fdatasync
+ *   - 每条记录带 CRC32；启动时顺序读回，遇到残尾（掉电写了一半）截掉
+ *   - 结果记录 fsync 之后按序发 committed()，由 ResultApplier 落库 + 上传
+ *   - 落库成功后 markApplied() 追加一条“已应用”记录；全部应用完且文件变大时截断
+ *   - 启动时 replay() 把还没应用的结果重新发一遍
+ *   - submit() 给每条结果补一个 record["journalUid"]（UUID），落库按它去重；
+ *     seq 只在当前日志文件内单调，日志截断 / 打不开后会从头再数
+ *
+ * 记录格式（小端）：
+ *   u32 magic "FQJ1" | u8 type | u8 pad[3] | i64 seq | u32 payloadLen | u32 crc | payload
+ *   crc = CRC32(type..payloadLen 共 16 字节 + payload)
+ *   type 1 = 结果，payload = QDataStream(Qt_5_6) << record << upload
+ *   type 2 = 已应用，payload 为空
+ */
+class ResultJournal : public QObject {
+    Q_OBJECT
+public:
+    explicit ResultJournal(const QString& dir, QObject* parent = nullptr);
+    ~ResultJournal() override;
+
+    // 读回日志、截掉残尾并启动写线程；失败时 submit() 仍可用，但不再持久化
+    bool open();
+
+    // QML：提交一条检测结果（record 落 project_info，upload 交给 LabKey）
+    Q_INVOKABLE bool submit(const QVariantMap& record, const QVariantMap& upload);
+
+    // 应用方落库成功后调用（任意线程）
+    void markApplied(qint64 seq);
+
+    // 把启动时读回的未应用结果重新发 committed()（数据库就绪后调用一次）
+    void replay();
+
+    int pendingCount() const;
+
+signals:
+    // 已 fsync；seq 在本次运行内单调递增，record 里带 journalUid
+    void committed(qint64 seq, const QVariantMap& record, const QVariantMap& upload);
+
+private:
+    enum RecordType : quint8 {
+        Result = 1,
+        Applied = 2
+    };
+
+    struct Entry {
+        quint8 type = Result;
+        qint64 seq = 0;
+        QVariantMap record;
+        QVariantMap upload;
+    };
+
+    static constexpr int kBatchWindowMs = 10;             // 攒批窗口
+    static constexpr qint64 kCompactBytes = 256 * 1024;   // 全部应用后超过这个大小就截断
+
+    bool readBack();
+    void writerLoop();
+    static QByteArray encode(const Entry& e);
+
+    QString m_path;
+    int m_fd = -1;
+    qint64 m_size = 0;  // 仅写线程 / open() 访问
+
+    // m_nextSeq / m_queue / m_outstanding / m_replay / m_running 受 m_mutex 保护
+    // （open() 在启动线程池上跑，submit() 在 GUI 线程）
+    mutable std::mutex m_mutex;
+    qint64 m_nextSeq = 1;
+    std::condition_variable m_cv;
+    std::deque<Entry> m_queue;
+    std::set<qint64> m_outstanding;  // 已写入但未应用的结果
+    QVector<Entry> m_replay;         // 启动时读回的未应用结果
+    bool m_running = false;
+    std::thread m_thread;
+};
+
+#endif  // RESULTJOURNAL_H
@@ -0,0 +1,52 @@
+#include "ResultApplier.h"
+
+#include <QDebug>
+
+#include "DBWorker.h"
+#include "LabKeyService.h"
+#include "ResultJournal.h"
+
+ResultApplier::ResultApplier(ResultJournal* journal, DBWorker* db, LabKeyService* labkey, QObject* parent)
+    : QObject(parent), m_journal(journal), m_db(db), m_labkey(labkey) {
+    m_retry.setSingleShot(true);
+    m_retry.setInterval(kRetryMs);
+    connect(&m_retry, &QTimer::timeout, this, &ResultApplier::retryFailed);
+
+    connect(m_journal, &ResultJournal::committed, this, &ResultApplier::onCommitted);
+    connect(m_db, &DBWorker::journalResultApplied, this, &ResultApplier::onApplied);
+}
+
+void ResultApplier::onCommitted(qint64 seq, const QVariantMap& record, const QVariantMap& upload) {
+    m_pending.insert(seq, Pending{record, upload});
+    m_db->postApplyJournalResult(seq, record, upload);
+}
+
+void ResultApplier::onApplied(qint64 seq, bool ok) {
+    auto it = m_pending.find(seq);
+    if (it == m_pending.end())
+        return;
+
+    if (!ok) {
+        qWarning() << "[Applier] apply failed, seq =" << seq << "retry in" << kRetryMs << "ms";
+        m_failed.append(seq);
+        if (!m_retry.isActive())
+            m_retry.start();
+        return;
+    }
+
+    m_pending.erase(it);
+    m_journal->markApplied(seq);
+    // 上传记录已随落库事务进了 upload_outbox，这里只负责唤醒发送
+    if (m_labkey)
+        m_labkey->kickOutbox();
+}
+
+void ResultApplier::retryFailed() {
+    const QList<qint64> seqs = m_failed;
+    m_failed.clear();
+    for (qint64 seq : seqs) {
+        auto it = m_pending.constFind(seq);
+        if (it != m_pending.constEnd())
+            m_db->postApplyJournalResult(seq, it->record, it->upload);
+    }
+}
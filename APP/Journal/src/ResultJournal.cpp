@@ -0,0 +1,307 @@
+#include "ResultJournal.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QMap>
+#include <QUuid>
+#include <QtEndian>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+const char kMagic[4] = {'F', 'Q', 'J', '1'};
+const int kHeaderSize = 24;                       // magic 4 + (type/pad/seq/len) 16 + crc 4
+const quint32 kMaxPayload = 4u * 1024u * 1024u;   // 单条结果远小于此，超过即视为损坏
+
+// CRC32（IEEE 802.3，反射多项式 0xEDB88320），crc 传上一段的返回值即可续算
+quint32 crc32(quint32 crc, const uchar* p, size_t n) {
+    static quint32 table[256];
+    static bool ready = false;
+    if (!ready) {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : (c >> 1);
+            table[i] = c;
+        }
+        ready = true;
+    }
+    crc = ~crc;
+    while (n--)
+        crc = table[(crc ^ *p++) & 0xFFu] ^ (crc >> 8);
+    return ~crc;
+}
+
+bool writeAll(int fd, const QByteArray& buf) {
+    const char* p = buf.constData();
+    qint64 left = buf.size();
+    while (left > 0) {
+        const ssize_t n = ::write(fd, p, size_t(left));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        p += n;
+        left -= n;
+    }
+    return true;
+}
+
+}  // namespace
+
+ResultJournal::ResultJournal(const QString& dir, QObject* parent)
+    : QObject(parent), m_path(QDir(dir).absoluteFilePath("results.jnl")) {
+    QDir().mkpath(dir);
+    // 首次使用前建表，crc32() 之后只读
+    crc32(0, nullptr, 0);
+}
+
+ResultJournal::~ResultJournal() {
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_running = false;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable())
+        m_thread.join();  // 写线程退出前会把队列里剩下的都落盘
+    if (m_fd >= 0)
+        ::close(m_fd);
+}
+
+bool ResultJournal::open() {
+    m_fd = ::open(QFile::encodeName(m_path).constData(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (m_fd < 0) {
+        qWarning() << "[Journal] open failed:" << m_path << strerror(errno);
+        return false;
+    }
+    if (!readBack())
+        qWarning() << "[Journal] read back failed, continue with empty journal";
+
+    int pending = 0;
+    qint64 nextSeq = 0;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_running = true;
+        pending = m_replay.size();
+        nextSeq = m_nextSeq;
+    }
+    m_thread = std::thread([this]() { writerLoop(); });
+    qInfo() << "[Journal] open" << m_path << "size =" << m_size << "pending =" << pending << "nextSeq =" << nextSeq;
+    return true;
+}
+
+// ===== 启动时读回：有效前缀之后的残尾直接截掉 =====
+bool ResultJournal::readBack() {
+    QFile f(m_path);
+    if (!f.open(QIODevice::ReadOnly))
+        return false;
+    const QByteArray all = f.readAll();
+    f.close();
+
+    QMap<qint64, Entry> results;
+    std::set<qint64> applied;
+    qint64 maxSeq = 0;
+    int pos = 0;
+    while (pos + kHeaderSize <= all.size()) {
+        const uchar* p = reinterpret_cast<const uchar*>(all.constData()) + pos;
+        if (memcmp(p, kMagic, 4) != 0)
+            break;
+        const quint8 type = p[4];
+        const qint64 seq = qFromLittleEndian<qint64>(p + 8);
+        const quint32 len = qFromLittleEndian<quint32>(p + 16);
+        const quint32 crc = qFromLittleEndian<quint32>(p + 20);
+        if (len > kMaxPayload || pos + kHeaderSize + int(len) > all.size())
+            break;
+        if (crc32(crc32(0, p + 4, 16), p + kHeaderSize, len) != crc)
+            break;
+
+        if (type == Result) {
+            Entry e;
+            e.type = Result;
+            e.seq = seq;
+            QByteArray payload = QByteArray::fromRawData(all.constData() + pos + kHeaderSize, int(len));
+            QDataStream ds(payload);
+            ds.setVersion(QDataStream::Qt_5_6);
+            ds >> e.record >> e.upload;
+            results.insert(seq, e);
+        } else if (type == Applied) {
+            applied.insert(seq);
+        }
+        maxSeq = qMax(maxSeq, seq);
+        pos += kHeaderSize + int(len);
+    }
+
+    if (pos < all.size()) {
+        qWarning() << "[Journal] torn tail at" << pos << "of" << all.size() << "bytes, truncate";
+        if (::ftruncate(m_fd, pos) != 0 || ::fdatasync(m_fd) != 0)
+            qWarning() << "[Journal] truncate failed:" << strerror(errno);
+    }
+    m_size = pos;
+
+    // open() 在启动线程池上跑，submit() / replay() 可能已在 GUI 线程上来了：这些成员都在锁里改
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_nextSeq = qMax(m_nextSeq, maxSeq + 1);
+    for (auto it = results.cbegin(); it != results.cend(); ++it) {
+        if (applied.count(it.key()))
+            continue;
+        m_replay.append(it.value());
+        m_outstanding.insert(it.key());
+    }
+    return true;
+}
+
+void ResultJournal::replay() {
+    QVector<Entry> entries;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        entries.swap(m_replay);
+    }
+    if (!entries.isEmpty())
+        qInfo() << "[Journal] replay" << entries.size() << "unapplied results";
+    for (const Entry& e : entries)
+        emit committed(e.seq, e.record, e.upload);
+}
+
+bool ResultJournal::submit(const QVariantMap& record, const QVariantMap& upload) {
+    Entry e;
+    e.type = Result;
+    e.record = record;
+    e.upload = upload;
+    // 去重键：随记录写进日志，回放时原样带回；seq 在日志截断 / 打不开时会重复，不能当键
+    if (e.record.value("journalUid").toString().isEmpty())
+        e.record.insert("journalUid", QUuid::createUuid().toString().mid(1, 36));
+    bool persistent = false;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        e.seq = m_nextSeq++;
+        persistent = m_running;
+        if (persistent)
+            m_queue.push_back(e);
+    }
+    if (!persistent) {
+        // 日志不可用（卡只读等）：不阻塞结果，直接交给应用方
+        qWarning() << "[Journal] not open, result seq" << e.seq << "is not journaled";
+        emit committed(e.seq, e.record, e.upload);
+        return true;
+    }
+    m_cv.notify_one();
+    return true;
+}
+
+void ResultJournal::markApplied(qint64 seq) {
+    Entry e;
+    e.type = Applied;
+    e.seq = seq;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if (!m_running) {
+            m_outstanding.erase(seq);
+            return;
+        }
+        m_queue.push_back(e);
+    }
+    m_cv.notify_one();
+}
+
+int ResultJournal::pendingCount() const {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return int(m_outstanding.size());
+}
+
+QByteArray ResultJournal::encode(const Entry& e) {
+    QByteArray payload;
+    if (e.type == Result) {
+        QDataStream ds(&payload, QIODevice::WriteOnly);
+        ds.setVersion(QDataStream::Qt_5_6);
+        ds << e.record << e.upload;
+    }
+
+    uchar head[kHeaderSize];
+    memcpy(head, kMagic, 4);
+    head[4] = e.type;
+    head[5] = head[6] = head[7] = 0;
+    qToLittleEndian<qint64>(e.seq, head + 8);
+    qToLittleEndian<quint32>(quint32(payload.size()), head + 16);
+    const quint32 crc = crc32(crc32(0, head + 4, 16),
+                              reinterpret_cast<const uchar*>(payload.constData()), size_t(payload.size()));
+    qToLittleEndian<quint32>(crc, head + 20);
+
+    QByteArray out(reinterpret_cast<const char*>(head), kHeaderSize);
+    out.append(payload);
+    return out;
+}
+
+// ===== 写线程：攒批 → 一次 write + fdatasync → 按序通知 =====
+void ResultJournal::writerLoop() {
+    qint64 lastSeq = 0;
+    {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        lastSeq = m_nextSeq - 1;
+    }
+    for (;;) {
+        std::vector<Entry> batch;
+        {
+            std::unique_lock<std::mutex> lk(m_mutex);
+            m_cv.wait(lk, [&] { return !m_queue.empty() || !m_running; });
+            if (m_queue.empty())
+                break;  // 已停止且队列已空
+            if (m_running)
+                m_cv.wait_for(lk, std::chrono::milliseconds(kBatchWindowMs), [&] { return !m_running; });
+            batch.assign(std::make_move_iterator(m_queue.begin()), std::make_move_iterator(m_queue.end()));
+            m_queue.clear();
+        }
+
+        QByteArray buf;
+        for (const Entry& e : batch)
+            buf.append(encode(e));
+        if (writeAll(m_fd, buf) && ::fdatasync(m_fd) == 0) {
+            m_size += buf.size();
+        } else {
+            // 结果照样交出去（数据库是第二份），只是这一批掉电不保
+            qWarning() << "[Journal] write failed:" << strerror(errno) << "batch =" << batch.size();
+        }
+
+        for (const Entry& e : batch) {
+            lastSeq = qMax(lastSeq, e.seq);
+            if (e.type == Result) {
+                {
+                    std::lock_guard<std::mutex> lk(m_mutex);
+                    m_outstanding.insert(e.seq);
+                }
+                emit committed(e.seq, e.record, e.upload);
+            } else {
+                std::lock_guard<std::mutex> lk(m_mutex);
+                m_outstanding.erase(e.seq);
+            }
+        }
+
+        // 全部应用完：截断，只留一条“已应用”记录保住序号
+        bool idle = false;
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            idle = m_outstanding.empty() && m_queue.empty();
+        }
+        if (idle && m_size > kCompactBytes) {
+            Entry mark;
+            mark.type = Applied;
+            mark.seq = lastSeq;
+            const QByteArray rec = encode(mark);
+            if (::ftruncate(m_fd, 0) == 0 && writeAll(m_fd, rec) && ::fdatasync(m_fd) == 0) {
+                qInfo() << "[Journal] compacted," << m_size << "bytes dropped";
+                m_size = rec.size();
+            } else {
+                qWarning() << "[Journal] compact failed:" << strerror(errno);
+            }
+        }
+    }
+}
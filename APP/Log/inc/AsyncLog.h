@@ -0,0 +1,120 @@
+#ifndef ASYNCLOG_H
+#define ASYNCLOG_H
+
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/*
+ * AsyncLog
+ *
+ * 作用：
+ *   用 qInstallMessageHandler 接管 qDebug/qInfo/qWarning/...，调用线程只做：
+ *     分类判定 + 限速 + 把定长二进制记录拷进无锁环形缓冲
+ *   格式化、写文件（按大小轮转）、回显串口都在后台线程做，热路径不再被串口 IO 拖住。
+ *
+ * 分类：
+ *   沿用仓库里的 "[Tag] xxx" 前缀：第一个 [...] 即分类名；没有前缀时用 QLoggingCategory 名，
+ *   再没有归为 "misc"。每个分类可以运行时开关（只影响 debug/info），以及每秒条数上限，
+ *   被限掉的条数在下一条放行的记录后面注明 "(+N suppressed)"。
+ *
+ * 说明：
+ *   - 环满时丢弃并计数，不阻塞调用方
+ *   - critical 不受分类开关 / 限速影响；fatal 同步写 stderr，并等写线程把这条记录刷进文件后再返回
+ *   - 串口只回显 warning 及以上（环境变量 FQ_LOG_CONSOLE=1 时全部回显）
+ */
+class AsyncLog {
+public:
+    static AsyncLog& instance();
+
+    // 安装消息处理函数并启动写线程（dir 不存在会创建），重复调用无副作用
+    void install(const QString& dir);
+    // 刷完缓冲、停写线程、恢复 Qt 默认处理
+    void shutdown();
+
+    // ===== 运行时分类控制（线程安全）=====
+    QStringList categories() const;
+    bool categoryEnabled(const QString& name) const;
+    void setCategoryEnabled(const QString& name, bool on);
+    int rateLimit(const QString& name) const;        // 每秒条数，0 = 不限
+    void setRateLimit(const QString& name, int perSec);
+    quint64 droppedCount() const { return m_overflow.load(std::memory_order_relaxed); }
+    QString logFilePath() const;
+
+private:
+    static constexpr int kSlots = 1024;  // 2 的幂
+    static constexpr int kTextMax = 232;
+    static constexpr int kMaxCategories = 64;
+    static constexpr int kNameMax = 24;
+    static constexpr int kDefaultRateLimit = 20;
+    static constexpr long kMaxFileBytes = 1024 * 1024;
+    static constexpr int kKeepFiles = 3;
+
+    struct Record {
+        qint64 tsMs;
+        quint32 tid;
+        quint32 suppressed;  // 该分类在这条之前被限掉的条数
+        quint16 len;
+        quint8 type;
+        quint8 cat;
+        char text[kTextMax];
+    };
+    struct Slot {
+        std::atomic<quint32> seq;
+        Record rec;
+    };
+    struct Category {
+        char name[kNameMax];
+        std::atomic<bool> enabled{true};
+        std::atomic<int> limit{kDefaultRateLimit};
+        std::atomic<qint64> windowSec{0};
+        std::atomic<int> count{0};
+        std::atomic<quint32> suppressed{0};
+    };
+
+    AsyncLog();
+    ~AsyncLog();
+    AsyncLog(const AsyncLog&) = delete;
+    AsyncLog& operator=(const AsyncLog&) = delete;
+
+    static void messageHandler(QtMsgType type, const QMessageLogContext& ctx, const QString& msg);
+    void push(QtMsgType type, const QMessageLogContext& ctx, const QString& msg);
+    int findCategory(const char* name, int len) const;
+    int categoryIndex(const char* name, int len);
+    bool admit(Category& c, QtMsgType type, qint64 nowSec);
+
+    void writerLoop();
+    void drain();
+    void writeRecord(const Record& r);
+    void openFile();
+    void rotate();
+
+    Slot m_slots[kSlots];
+    std::atomic<quint32> m_head{0};  // 生产者（任意线程）
+    quint32 m_tail = 0;              // 消费者（写线程）
+    std::atomic<quint64> m_overflow{0};
+
+    Category m_cats[kMaxCategories];
+    std::atomic<int> m_catCount{0};
+    mutable std::mutex m_catMutex;  // 只在新分类登记时用
+
+    std::thread m_thread;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_running{false};
+    std::atomic<quint32> m_flushedPos{0};  // 写线程已写入并 fflush 的记录序号上界（不含）
+
+    std::string m_dir;
+    std::FILE* m_file = nullptr;
+    long m_fileBytes = 0;
+    bool m_echoAll = false;
+    quint64 m_reportedOverflow = 0;
+};
+
+#endif  // ASYNCLOG_H
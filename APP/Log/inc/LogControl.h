@@ -0,0 +1,30 @@
+#ifndef LOGCONTROL_H
+#define LOGCONTROL_H
+
+#include <QObject>
+#include <QVariantList>
+
+/*
+ * LogControl
+ *
+ * 给 QML（工程师菜单）用的日志分类开关：
+ *   logControl.categories()            → [{ name, enabled, limit }, ...]
+ *   logControl.setEnabled("MODBUS", false)
+ *   logControl.setRateLimit("MODBUS", 5)
+ * 实际状态都在 AsyncLog 里，本类不缓存。
+ */
+class LogControl : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(QString logFile READ logFile CONSTANT)
+public:
+    explicit LogControl(QObject* parent = nullptr);
+
+    Q_INVOKABLE QVariantList categories() const;
+    Q_INVOKABLE void setEnabled(const QString& name, bool on);
+    Q_INVOKABLE void setRateLimit(const QString& name, int perSec);
+    Q_INVOKABLE quint64 droppedCount() const;
+
+    QString logFile() const;
+};
+
+#endif  // LOGCONTROL_H
@@ -0,0 +1,375 @@
+#include "AsyncLog.h"
+
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <QByteArray>
+#include <QDir>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+const char kFileName[] = "fq.log";
+
+qint64 nowMs() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+quint32 currentTid() {
+    static thread_local const quint32 tid = quint32(::syscall(SYS_gettid));
+    return tid;
+}
+
+char typeChar(int type) {
+    switch (type) {
+    case QtDebugMsg:
+        return 'D';
+    case QtInfoMsg:
+        return 'I';
+    case QtWarningMsg:
+        return 'W';
+    case QtCriticalMsg:
+        return 'C';
+    default:
+        return 'F';
+    }
+}
+
+// 注意 QtInfoMsg 的枚举值比 QtWarningMsg 大，不能直接比较大小
+bool atLeastWarning(int type) {
+    return type == QtWarningMsg || type == QtCriticalMsg || type == QtFatalMsg;
+}
+
+// "[Tag] ..." → Tag；QString 未加 noquote 时前面多一个引号
+bool tagOf(const QByteArray& text, const char** name, int* len) {
+    int i = 0;
+    if (i < text.size() && text[i] == '"')
+        ++i;
+    if (i >= text.size() || text[i] != '[')
+        return false;
+    const int start = ++i;
+    while (i < text.size() && text[i] != ']' && text[i] != ' ' && i - start < 23)
+        ++i;
+    if (i >= text.size() || text[i] != ']' || i == start)
+        return false;
+    *name = text.constData() + start;
+    *len = i - start;
+    return true;
+}
+
+}  // namespace
+
+AsyncLog& AsyncLog::instance() {
+    static AsyncLog log;
+    return log;
+}
+
+AsyncLog::AsyncLog() {
+    for (int i = 0; i < kSlots; ++i)
+        m_slots[i].seq.store(quint32(i), std::memory_order_relaxed);
+    categoryIndex("misc", 4);  // 0 号分类：无前缀 / 分类表满
+    // 每帧一条的相机计时默认关闭，需要时在工程师菜单里打开
+    setCategoryEnabled("TimeTick", false);
+    setRateLimit("misc", 50);  // 无前缀的日志都落在这里，放宽一些
+}
+
+AsyncLog::~AsyncLog() {
+    shutdown();
+}
+
+void AsyncLog::install(const QString& dir) {
+    if (m_running.exchange(true))
+        return;
+    QDir().mkpath(dir);
+    m_dir = dir.toStdString();
+    m_echoAll = qgetenv("FQ_LOG_CONSOLE") == "1";
+    openFile();
+    m_thread = std::thread(&AsyncLog::writerLoop, this);
+    qInstallMessageHandler(&AsyncLog::messageHandler);
+    qInfo() << "[Log] async logging to" << logFilePath();
+}
+
+void AsyncLog::shutdown() {
+    if (!m_running.exchange(false))
+        return;
+    qInstallMessageHandler(nullptr);
+    m_wake.notify_one();
+    if (m_thread.joinable())
+        m_thread.join();
+    if (m_file) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+QString AsyncLog::logFilePath() const {
+    return QString::fromStdString(m_dir) + "/" + kFileName;
+}
+
+// ===== 分类表 =====
+int AsyncLog::findCategory(const char* name, int len) const {
+    const int n = m_catCount.load(std::memory_order_acquire);
+    for (int i = 0; i < n; ++i) {
+        if (std::strncmp(m_cats[i].name, name, size_t(len)) == 0 && m_cats[i].name[len] == '\0')
+            return i;
+    }
+    return -1;
+}
+
+int AsyncLog::categoryIndex(const char* name, int len) {
+    if (len >= kNameMax)
+        len = kNameMax - 1;
+    int idx = findCategory(name, len);
+    if (idx >= 0)
+        return idx;
+
+    std::lock_guard<std::mutex> lock(m_catMutex);
+    idx = findCategory(name, len);
+    if (idx >= 0)
+        return idx;
+    const int n = m_catCount.load(std::memory_order_relaxed);
+    if (n >= kMaxCategories)
+        return 0;
+    std::memcpy(m_cats[n].name, name, size_t(len));
+    m_cats[n].name[len] = '\0';
+    m_catCount.store(n + 1, std::memory_order_release);
+    return n;
+}
+
+QStringList AsyncLog::categories() const {
+    QStringList out;
+    const int n = m_catCount.load(std::memory_order_acquire);
+    for (int i = 0; i < n; ++i)
+        out << QString::fromLatin1(m_cats[i].name);
+    return out;
+}
+
+bool AsyncLog::categoryEnabled(const QString& name) const {
+    const QByteArray n = name.toLatin1();
+    const int idx = findCategory(n.constData(), n.size());
+    return idx < 0 || m_cats[idx].enabled.load(std::memory_order_relaxed);
+}
+
+void AsyncLog::setCategoryEnabled(const QString& name, bool on) {
+    const QByteArray n = name.toLatin1();
+    m_cats[categoryIndex(n.constData(), n.size())].enabled.store(on, std::memory_order_relaxed);
+}
+
+int AsyncLog::rateLimit(const QString& name) const {
+    const QByteArray n = name.toLatin1();
+    const int idx = findCategory(n.constData(), n.size());
+    return idx < 0 ? kDefaultRateLimit : m_cats[idx].limit.load(std::memory_order_relaxed);
+}
+
+void AsyncLog::setRateLimit(const QString& name, int perSec) {
+    const QByteArray n = name.toLatin1();
+    m_cats[categoryIndex(n.constData(), n.size())].limit.store(qMax(0, perSec),
+                                                                std::memory_order_relaxed);
+}
+
+// 固定 1 秒窗口计数；critical / fatal 不受开关和限速影响
+bool AsyncLog::admit(Category& c, QtMsgType type, qint64 nowSec) {
+    if (type == QtCriticalMsg || type == QtFatalMsg)
+        return true;
+    if ((type == QtDebugMsg || type == QtInfoMsg) && !c.enabled.load(std::memory_order_relaxed))
+        return false;
+    const int limit = c.limit.load(std::memory_order_relaxed);
+    if (limit <= 0)
+        return true;
+    qint64 w = c.windowSec.load(std::memory_order_relaxed);
+    if (w != nowSec && c.windowSec.compare_exchange_strong(w, nowSec, std::memory_order_relaxed))
+        c.count.store(0, std::memory_order_relaxed);
+    if (c.count.fetch_add(1, std::memory_order_relaxed) < limit)
+        return true;
+    c.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+// ===== 生产者：任意线程 =====
+void AsyncLog::messageHandler(QtMsgType type, const QMessageLogContext& ctx, const QString& msg) {
+    instance().push(type, ctx, msg);
+}
+
+void AsyncLog::push(QtMsgType type, const QMessageLogContext& ctx, const QString& msg) {
+    const QByteArray text = msg.toUtf8();
+    const qint64 ts = nowMs();
+
+    const char* name = nullptr;
+    int len = 0;
+    int cat = 0;
+    if (tagOf(text, &name, &len))
+        cat = categoryIndex(name, len);
+    else if (ctx.category && std::strcmp(ctx.category, "default") != 0)
+        cat = categoryIndex(ctx.category, int(std::strlen(ctx.category)));
+
+    Category& c = m_cats[cat];
+    if (!admit(c, type, ts / 1000))
+        return;
+
+    if (type == QtFatalMsg) {
+        // Qt 在处理函数返回后 abort：先同步写到 stderr，入环后再等写线程刷盘
+        std::fprintf(stderr, "F %s\n", text.constData());
+        std::fflush(stderr);
+    }
+
+    // Vyukov 有界队列：抢到位置后独占写该槽，再以 seq 发布给消费者
+    quint32 pos = m_head.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    for (;;) {
+        slot = &m_slots[pos & (kSlots - 1)];
+        const quint32 seq = slot->seq.load(std::memory_order_acquire);
+        const qint32 dif = qint32(seq - pos);
+        if (dif == 0) {
+            if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (dif < 0) {
+            m_overflow.fetch_add(1, std::memory_order_relaxed);  // 环满：丢弃
+            return;
+        } else {
+            pos = m_head.load(std::memory_order_relaxed);
+        }
+    }
+
+    Record& r = slot->rec;
+    r.tsMs = ts;
+    r.tid = currentTid();
+    r.suppressed = c.suppressed.exchange(0, std::memory_order_relaxed);
+    r.type = quint8(type);
+    r.cat = quint8(cat);
+    int n = text.size();
+    if (n > kTextMax) {
+        // 截断在 UTF-8 字符边界上，末尾补 "..."
+        int cut = kTextMax - 3;
+        while (cut > 0 && (uchar(text[cut]) & 0xC0) == 0x80)
+            --cut;
+        std::memcpy(r.text, text.constData(), size_t(cut));
+        std::memcpy(r.text + cut, "...", 3);
+        n = cut + 3;
+    } else {
+        std::memcpy(r.text, text.constData(), size_t(n));
+    }
+    r.len = quint16(n);
+    slot->seq.store(pos + 1, std::memory_order_release);
+
+    if (type == QtFatalMsg) {
+        // 按序号等写线程把这条记录刷进文件再返回（别的线程触发的刷盘不会被误认），最多等 500 ms
+        m_wake.notify_one();
+        for (int i = 0; i < 250; ++i) {
+            if (qint32(m_flushedPos.load(std::memory_order_acquire) - (pos + 1)) >= 0)
+                break;
+            m_wake.notify_one();
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    } else if (atLeastWarning(type)) {
+        m_wake.notify_one();
+    }
+}
+
+// ===== 消费者：写线程 =====
+void AsyncLog::writerLoop() {
+    while (m_running.load()) {
+        {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wake.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        drain();
+    }
+    drain();
+}
+
+void AsyncLog::drain() {
+    bool wrote = false;
+    for (;;) {
+        Slot& slot = m_slots[m_tail & (kSlots - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != m_tail + 1)
+            break;
+        writeRecord(slot.rec);
+        slot.seq.store(m_tail + kSlots, std::memory_order_release);
+        ++m_tail;
+        wrote = true;
+    }
+
+    // 限速窗口已过、之后再没有放行记录的分类：把被限掉的条数补记一行
+    const qint64 nowSec = nowMs() / 1000;
+    const int cats = m_catCount.load(std::memory_order_acquire);
+    for (int i = 0; i < cats && m_file; ++i) {
+        Category& c = m_cats[i];
+        if (c.suppressed.load(std::memory_order_relaxed) == 0 ||
+            c.windowSec.load(std::memory_order_relaxed) >= nowSec)
+            continue;
+        const quint32 n = c.suppressed.exchange(0, std::memory_order_relaxed);
+        if (n) {
+            m_fileBytes += std::fprintf(m_file, "---- [%s] %u messages suppressed by rate limit ----\n",
+                                        c.name, n);
+            wrote = true;
+        }
+    }
+
+    const quint64 overflow = m_overflow.load(std::memory_order_relaxed);
+    if (overflow != m_reportedOverflow && m_file) {
+        m_fileBytes += std::fprintf(m_file, "---- log ring full, %llu records dropped ----\n",
+                                    static_cast<unsigned long long>(overflow - m_reportedOverflow));
+        m_reportedOverflow = overflow;
+        wrote = true;
+    }
+    if (wrote && m_file)
+        std::fflush(m_file);
+    m_flushedPos.store(m_tail, std::memory_order_release);
+
+    // 轮转放在最后：上面补记的限速 / 丢弃汇总行也计入大小；一次最多超出一环的记录
+    if (m_file && m_fileBytes >= kMaxFileBytes)
+        rotate();
+}
+
+void AsyncLog::writeRecord(const Record& r) {
+    const time_t sec = time_t(r.tsMs / 1000);
+    struct tm tmv;
+    localtime_r(&sec, &tmv);
+    char head[48];
+    const int hn = std::snprintf(head, sizeof(head), "%02d-%02d %02d:%02d:%02d.%03d %c %5u ",
+                                 tmv.tm_mon + 1, tmv.tm_mday, tmv.tm_hour, tmv.tm_min, tmv.tm_sec,
+                                 int(r.tsMs % 1000), typeChar(r.type), r.tid);
+
+    if (m_file) {
+        std::fwrite(head, 1, size_t(hn), m_file);
+        std::fwrite(r.text, 1, r.len, m_file);
+        m_fileBytes += hn + r.len + 1;
+        if (r.suppressed)
+            m_fileBytes += std::fprintf(m_file, " (+%u suppressed)", r.suppressed);
+        std::fputc('\n', m_file);
+    }
+
+    // 串口回显（写线程里做，不拖慢调用方）
+    if ((m_echoAll || atLeastWarning(r.type)) && r.type != QtFatalMsg) {
+        std::fwrite(head, 1, size_t(hn), stderr);
+        std::fwrite(r.text, 1, r.len, stderr);
+        std::fputc('\n', stderr);
+    }
+}
+
+// ===== 文件：fq.log → fq.log.1 → ... → fq.log.N =====
+void AsyncLog::openFile() {
+    const std::string path = m_dir + "/" + kFileName;
+    m_file = std::fopen(path.c_str(), "a");
+    if (!m_file) {
+        std::fprintf(stderr, "[Log] open %s failed, console only\n", path.c_str());
+        return;
+    }
+    struct stat st;
+    m_fileBytes = ::stat(path.c_str(), &st) == 0 ? long(st.st_size) : 0;
+}
+
+void AsyncLog::rotate() {
+    std::fclose(m_file);
+    m_file = nullptr;
+    const std::string base = m_dir + "/" + kFileName;
+    for (int i = kKeepFiles - 1; i >= 1; --i)
+        std::rename((base + "." + std::to_string(i)).c_str(), (base + "." + std::to_string(i + 1)).c_str());
+    std::rename(base.c_str(), (base + ".1").c_str());
+    openFile();
+}
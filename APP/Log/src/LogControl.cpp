@@ -0,0 +1,44 @@
+#include "LogControl.h"
+
+#include <QDebug>
+#include <QVariantMap>
+
+#include "AsyncLog.h"
+
+LogControl::LogControl(QObject* parent)
+    : QObject(parent) {
+}
+
+QVariantList LogControl::categories() const {
+    AsyncLog& log = AsyncLog::instance();
+    QStringList names = log.categories();
+    names.sort(Qt::CaseInsensitive);
+
+    QVariantList out;
+    for (const QString& n : names) {
+        QVariantMap m;
+        m["name"] = n;
+        m["enabled"] = log.categoryEnabled(n);
+        m["limit"] = log.rateLimit(n);
+        out << m;
+    }
+    return out;
+}
+
+void LogControl::setEnabled(const QString& name, bool on) {
+    AsyncLog::instance().setCategoryEnabled(name, on);
+    qInfo() << "[Log] category" << name << (on ? "on" : "off");
+}
+
+void LogControl::setRateLimit(const QString& name, int perSec) {
+    AsyncLog::instance().setRateLimit(name, perSec);
+    qInfo() << "[Log] category" << name << "limit" << perSec << "/s";
+}
+
+quint64 LogControl::droppedCount() const {
+    return AsyncLog::instance().droppedCount();
+}
+
+QString LogControl::logFile() const {
+    return AsyncLog::instance().logFilePath();
+}
@@ -5,6 +5,7 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QList>
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QVector>    // QVector 注释
@@ -15,6 +16,7 @@
 #include <cmath>  // std::abs
 #include <thread>
 
+#include "AdcArchive.h"
 #include "IIODeviceController.h"
 
 // =========================
@@ -42,7 +44,7 @@ static double fourPL_inverse(double y, const MainViewModel::FourPLParams& p) {
     const double B = p.B;
     const double C = p.C;
     const double D = p.D;
-    qDebug() << "FourPL: A=" << A << " B=" << B << " C=" << C << " D=" << D;
+    qDebug() << "[4PL] A=" << A << " B=" << B << " C=" << C << " D=" << D;
     // clamp y 到曲线有效区间
     double y_min = std::min(A, D) + eps;
     double y_max = std::max(A, D) - eps;
@@ -101,15 +103,15 @@ MainViewModel::MainViewModel(QObject* parent)
     flushTimer_.setInterval(1000);
     connect(&flushTimer_, &QTimer::timeout, this, &MainViewModel::flushBufferToDb);
 
-    // 启动独立线程用于数据库写入
-    std::thread(&MainViewModel::dbWriterLoop, this).detach();
-    // ⭐⭐ 新增：主线程用来查询曲线的数据库连接 ⭐⭐
-    initReaderDb();
+    // 写入线程和 reader 连接都推迟到第一次用到时再建，开机不碰 SD 卡上的库
+}
+// 主线程查询曲线用的连接：第一次调用时打开
+QSqlDatabase MainViewModel::readerDb() {
+    if (!QSqlDatabase::contains(readerConnName_))
+        initReaderDb();
+    return QSqlDatabase::database(readerConnName_);
 }
 void MainViewModel::initReaderDb() {
-    if (QSqlDatabase::contains(readerConnName_))
-        QSqlDatabase::removeDatabase(readerConnName_);
-
     QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", readerConnName_);
 #ifndef LOCAL_BUILD
     db.setDatabaseName("/mnt/SDCARD/app/db/app.db");
@@ -138,8 +140,14 @@ void MainViewModel::startReading() {
         return;
     }
     buffer_.clear();
+    // 第一次采集才启动独立的数据库写入线程
+    if (!writerStarted_) {
+        writerStarted_ = true;
+        std::thread(&MainViewModel::dbWriterLoop, this).detach();
+    }
     flushTimer_.start();
     deviceController->start();
+    emit acquisitionStarted(currentSampleNo_);
     qDebug() << "🧪 启动连续采集";
 }
 
@@ -147,6 +155,7 @@ void MainViewModel::stopReading() {
     flushTimer_.stop();
     flushBufferToDb();  // 手动刷新
     deviceController->stop();
+    emit acquisitionStopped();
     qDebug() << "⏹ 停止采集";
 }
 
@@ -161,9 +170,25 @@ void MainViewModel::flushBufferToDb() {
         return;
 
     std::lock_guard<std::mutex> lock(queueMutex_);
-    writeQueue_.enqueue(buffer_);
+    writeQueue_.enqueue(WriteJob{currentSampleNo_, buffer_, false});
     buffer_.clear();
 }
+
+void MainViewModel::discardSample(const QString& sampleNo) {
+    if (sampleNo.isEmpty())
+        return;
+    buffer_.clear();
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    // 还没写的直接扔掉；已写入的交给写线程按序删除
+    for (auto it = writeQueue_.begin(); it != writeQueue_.end();) {
+        if (!it->discard && it->sampleNo == sampleNo)
+            it = writeQueue_.erase(it);
+        else
+            ++it;
+    }
+    writeQueue_.enqueue(WriteJob{sampleNo, {}, true});
+    qDebug() << "🗑 丢弃中止样品的采集数据:" << sampleNo;
+}
 // === 独立线程执行数据库写入 ===
 void MainViewModel::dbWriterLoop() {
     // 每个线程必须单独打开自己的数据库连接
@@ -181,13 +206,28 @@ void MainViewModel::dbWriterLoop() {
     qInfo() << "💾 数据库写入线程启动";
 
     while (true) {
-        QVector<double> batch;
+        WriteJob job;
+        bool hasJob = false;
         {
             std::lock_guard<std::mutex> lock(queueMutex_);
-            if (!writeQueue_.isEmpty())
-                batch = writeQueue_.dequeue();
+            if (!writeQueue_.isEmpty()) {
+                job = writeQueue_.dequeue();
+                hasJob = true;
+            }
         }
 
+        if (hasJob && job.discard) {
+            QSqlQuery q(db);
+            q.prepare("DELETE FROM adc_data WHERE sampleNo = ?");
+            q.addBindValue(job.sampleNo);
+            if (!q.exec())
+                qWarning() << "[DBWriter] 删除中止样品数据失败:" << q.lastError().text();
+            else
+                qDebug() << "[DBWriter] 已删除中止样品数据" << job.sampleNo << "行数=" << q.numRowsAffected();
+            continue;
+        }
+
+        const QVector<double>& batch = job.values;
         if (!batch.isEmpty()) {
             // 转 JSON
             QJsonArray arr;
@@ -203,16 +243,16 @@ void MainViewModel::dbWriterLoop() {
             // ✅ 注意字段名 adcValues（不是 values）
             QSqlQuery q(db);
             q.prepare("INSERT INTO adc_data (sampleNo, timestamp, adcValues, avgValue) VALUES (?, ?, ?, ?)");
-            q.addBindValue(currentSampleNo_);
+            q.addBindValue(job.sampleNo);
             q.addBindValue(ts);
             q.addBindValue(jsonStr);
             q.addBindValue(avg);
 
             if (!q.exec()) {
-                qWarning() << "❌ 数据库写入失败:" << q.lastError().text()
+                qWarning() << "[DBWriter] 数据库写入失败:" << q.lastError().text()
                            << " SQL:" << q.lastQuery();
             } else {
-                qDebug() << "💾 数据库写入成功 点数=" << batch.size();
+                qDebug() << "[DBWriter] 写入成功 点数=" << batch.size();
             }
         }
 
@@ -229,7 +269,7 @@ QVariantList MainViewModel::getAdcDataBySample(const QString& sampleNo) {
     }
 
     // ⭐ 使用 reader 连接 ⭐
-    QSqlDatabase db = QSqlDatabase::database(readerConnName_);
+    QSqlDatabase db = readerDb();
     if (!db.isOpen()) {
         qWarning() << "getAdcDataBySample: DB not open!";
         return result;
@@ -246,9 +286,14 @@ QVariantList MainViewModel::getAdcDataBySample(const QString& sampleNo) {
         }
     }
 
-    while (q.next()) {
-        QString json = q.value(0).toString();
-        QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
+    QList<QByteArray> texts;
+    while (q.next())
+        texts << q.value(0).toByteArray();
+    if (texts.isEmpty())
+        AdcArchive::readTrace(db, sampleNo, texts);  // 过期样品已移到归档段
+
+    for (const QByteArray& json : texts) {
+        QJsonDocument doc = QJsonDocument::fromJson(json);
         if (!doc.isArray())
             continue;
 
@@ -269,7 +314,7 @@ QVariantList MainViewModel::getAdcData(const QString& sampleNo) {
         return result;
     }
 
-    QSqlDatabase db = QSqlDatabase::database(readerConnName_);
+    QSqlDatabase db = readerDb();
     if (!db.isOpen()) {
         qWarning() << "[MainViewModel] getAdcData: DB not open";
         return result;
@@ -287,9 +332,14 @@ QVariantList MainViewModel::getAdcData(const QString& sampleNo) {
     }
     {
         ScopedTimer ti("ADC格式转换");
-        while (q.next()) {
-            QString json = q.value(0).toString();
-            QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
+        QList<QByteArray> texts;
+        while (q.next())
+            texts << q.value(0).toByteArray();
+        if (texts.isEmpty())
+            AdcArchive::readTrace(db, sampleNo, texts);  // 过期样品已移到归档段
+
+        for (const QByteArray& json : texts) {
+            QJsonDocument doc = QJsonDocument::fromJson(json);
             if (!doc.isArray())
                 continue;
 
@@ -351,7 +401,7 @@ QVariantList MainViewModel::getAdcData(const QString& sampleNo) {
 // }
 QString MainViewModel::generateSampleNo() {
     QString today = QDate::currentDate().toString("yyyyMMdd");
-    QSqlDatabase db = QSqlDatabase::database(readerConnName_);
+    QSqlDatabase db = readerDb();
     if (!db.isOpen())
         return "";
 
@@ -39,9 +39,13 @@ public slots:
     Q_INVOKABLE QVariantList getAdcDataBySample(const QString& sampleNo);
     Q_INVOKABLE QVariantList getAdcData(const QString& sampleNo);
     Q_INVOKABLE QString generateSampleNo();
+    // 中止的检测：丢掉该样品已写入 / 还在队列里的 adc_data，重测同一编号时曲线不会混进上一次
+    Q_INVOKABLE void discardSample(const QString& sampleNo);
 
 signals:
     void newDataBatch(const QVector<double>& values);
+    void acquisitionStarted(const QString& sampleNo);
+    void acquisitionStopped();
 
 private slots:
     void onNewAdcData(const QVector<double>& values);
@@ -51,14 +55,21 @@ private:
     IIODeviceController* deviceController{nullptr};
     QString readerConnName_ = "reader";
     void initReaderDb();
+    QSqlDatabase readerDb();
     QString currentSampleNo_;
     QVector<double> buffer_;
     QTimer flushTimer_;
 
     // === 新增：数据库线程 ===
     QThread dbThread_;
+    bool writerStarted_ = false;
+    struct WriteJob {
+        QString sampleNo;       // 入队时的样品号，写线程不再读 currentSampleNo_
+        QVector<double> values;
+        bool discard = false;   // true：删除该样品的 adc_data（排在它之前的写入之后执行）
+    };
     std::mutex queueMutex_;
-    QQueue<QVector<double>> writeQueue_;  // 等待写入队列
+    QQueue<WriteJob> writeQueue_;  // 等待写入队列
     QrMethodConfigViewModel* m_methodVm = nullptr;
     void dbWriterLoop();  // 数据库后台写入函数
 };
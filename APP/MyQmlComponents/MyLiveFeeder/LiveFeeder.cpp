@@ -0,0 +1,247 @@
+#include "LiveFeeder.h"
+
+#include <QDebug>
+#include <QVariantMap>
+#include <QtMath>
+#include <algorithm>
+
+#include "../MyPlotView/PlotView.h"
+
+LiveFeeder::LiveFeeder(QObject* parent) : QObject(parent) {
+    m_frameTimer.setInterval(1000 / m_maxFps);
+    connect(&m_frameTimer, &QTimer::timeout, this, &LiveFeeder::flush);
+}
+
+// ===================== 属性 ======================
+
+void LiveFeeder::setSource(QObject* obj) {
+    if (m_source == obj)
+        return;
+    if (m_source)
+        disconnect(m_source, nullptr, this, nullptr);
+    m_source = obj;
+    if (m_source) {
+        // 用字符串签名连接：MainViewModel 与 IIODeviceController 都能直接当数据源
+        const bool ok = connect(m_source, SIGNAL(newDataBatch(QVector<double>)),
+                                this, SLOT(onBatch(QVector<double>)));
+        if (!ok)
+            qWarning() << "[LiveFeeder] source has no newDataBatch(QVector<double>) signal:" << m_source;
+    }
+    emit sourceChanged();
+}
+
+QObject* LiveFeeder::plot() const {
+    return m_plot.data();
+}
+
+void LiveFeeder::setPlot(QObject* obj) {
+    PlotView* p = qobject_cast<PlotView*>(obj);
+    if (obj && !p)
+        qWarning() << "[LiveFeeder] plot must be a PlotView:" << obj;
+    if (m_plot == p)
+        return;
+    m_plot = p;
+    emit plotChanged();
+}
+
+void LiveFeeder::setMaxFps(int fps) {
+    fps = qBound(1, fps, 60);
+    if (m_maxFps == fps)
+        return;
+    m_maxFps = fps;
+    m_frameTimer.setInterval(1000 / m_maxFps);
+    emit maxFpsChanged();
+}
+
+void LiveFeeder::setRelativeProminence(double r) {
+    r = qBound(0.0, r, 1.0);
+    if (qFuzzyCompare(m_relProm, r))
+        return;
+    m_relProm = r;
+    emit peakParamsChanged();
+}
+
+void LiveFeeder::setMinPeakSeparation(int n) {
+    n = qMax(1, n);
+    if (m_minSep == n)
+        return;
+    m_minSep = n;
+    emit peakParamsChanged();
+    selectMainPeaks();
+}
+
+QVariantList LiveFeeder::peaks() const {
+    QVariantList out;
+    out.reserve(m_peaks.size());
+    for (const Peak& p : m_peaks) {
+        QVariantMap m;
+        m["idx"] = p.idx;
+        m["value"] = p.value;
+        m["prom"] = p.prom;
+        out.append(m);
+    }
+    return out;
+}
+
+// ===================== 扫描控制 ======================
+
+void LiveFeeder::start() {
+    m_pending.clear();
+    m_sampleCount = 0;
+    resetDetector();
+
+    if (m_plot) {
+        m_plot->setExpectedCount(m_lastScanCount);
+        m_plot->clear();
+    }
+
+    m_running = true;
+    m_frameTimer.start();
+    emit runningChanged();
+    emit sampleCountChanged();
+    emit peaksChanged();
+}
+
+void LiveFeeder::stop() {
+    if (!m_running)
+        return;
+    flush();
+    m_frameTimer.stop();
+    m_running = false;
+    if (m_sampleCount > 0)
+        m_lastScanCount = m_sampleCount;
+    emit runningChanged();
+    qDebug() << "[LiveFeeder] scan done, samples=" << m_sampleCount
+             << "peaks=" << m_peaks.size() << "C=" << m_peakC << "T=" << m_peakT;
+}
+
+void LiveFeeder::onBatch(const QVector<double>& values) {
+    if (!m_running || values.isEmpty())
+        return;
+    // 只拷贝进待刷缓冲，真正的绘制与判峰放到帧定时器里
+    m_pending += values;
+}
+
+// ===================== 帧刷新 ======================
+
+void LiveFeeder::flush() {
+    if (m_pending.isEmpty())
+        return;
+
+    const int base = m_sampleCount;
+    const int n = m_pending.size();
+
+    if (m_plot)
+        m_plot->appendBatch(m_pending);
+
+    const int peaksBefore = m_peaks.size();
+    detect(m_pending.constData(), n, base);
+
+    m_sampleCount += n;
+    m_pending.clear();  // 保留容量，下一帧不再分配
+    emit sampleCountChanged();
+
+    if (m_peaks.size() != peaksBefore)
+        selectMainPeaks();
+}
+
+// ===================== 流式判峰 ======================
+
+void LiveFeeder::resetDetector() {
+    m_seekMax = true;
+    m_dataMin = 0.0;
+    m_dataMax = 0.0;
+    m_curMax = 0.0;
+    m_curMaxIdx = -1;
+    m_curMin = 0.0;
+    m_leftValley = 0.0;
+    m_peaks.clear();
+    m_peakC = -1;
+    m_peakT = -1;
+}
+
+/*
+ * 滞回判峰（每个样点 O(1)）：
+ *   找峰顶阶段：记录最高点；回落超过 delta 即确认为一个峰
+ *   找谷底阶段：记录最低点；回升超过 delta 即开始找下一个峰
+ * delta = relativeProminence * 已见数据幅度，幅度随扫描增长，早期的小抖动不会被当成峰
+ */
+void LiveFeeder::detect(const double* ys, int n, int base) {
+    for (int k = 0; k < n; ++k) {
+        const double v = ys[k];
+        const int idx = base + k;
+
+        if (m_curMaxIdx < 0) {
+            m_dataMin = m_dataMax = v;
+            m_curMax = m_curMin = m_leftValley = v;
+            m_curMaxIdx = idx;
+            continue;
+        }
+        if (v < m_dataMin)
+            m_dataMin = v;
+        if (v > m_dataMax)
+            m_dataMax = v;
+        const double delta = m_relProm * (m_dataMax - m_dataMin);
+
+        if (m_seekMax) {
+            if (v > m_curMax) {
+                m_curMax = v;
+                m_curMaxIdx = idx;
+            }
+            if (delta > 0.0 && v < m_curMax - delta) {
+                // 右侧已回落 delta，左侧显著性 = 峰顶 - 左谷底
+                const double prom = qMin(m_curMax - m_leftValley, m_curMax - v);
+                if (m_curMax - m_leftValley >= delta) {
+                    m_peaks.append({m_curMaxIdx, m_curMax, prom});
+                    emit peakDetected(m_curMaxIdx, m_curMax);
+                }
+                m_seekMax = false;
+                m_curMin = v;
+            }
+        } else {
+            if (v < m_curMin)
+                m_curMin = v;
+            if (delta > 0.0 && v > m_curMin + delta) {
+                m_seekMax = true;
+                m_leftValley = m_curMin;
+                m_curMax = v;
+                m_curMaxIdx = idx;
+            }
+        }
+    }
+}
+
+// 与 calcTC 一致：按显著性取两个相距 >= minPeakSeparation 的峰，左 C 右 T
+void LiveFeeder::selectMainPeaks() {
+    QVector<Peak> sorted = m_peaks;
+    std::sort(sorted.begin(), sorted.end(), [](const Peak& a, const Peak& b) {
+        if (a.prom != b.prom)
+            return a.prom > b.prom;
+        return a.value > b.value;
+    });
+
+    int p1 = -1;
+    int p2 = -1;
+    for (const Peak& p : sorted) {
+        if (p1 < 0) {
+            p1 = p.idx;
+            continue;
+        }
+        if (qAbs(p.idx - p1) >= m_minSep) {
+            p2 = p.idx;
+            break;
+        }
+    }
+
+    // 只出现一个峰时先当作 C 标出（calcTC 里左峰为 C，扫描先经过左侧）
+    const int c = (p2 < 0) ? p1 : qMin(p1, p2);
+    const int t = (p2 < 0) ? -1 : qMax(p1, p2);
+    m_peakC = c;
+    m_peakT = t;
+
+    if (m_plot) {
+        m_plot->setMarkerC(m_peakC);
+        m_plot->setMarkerT(m_peakT);
+    }
+    emit peaksChanged();
+}
@@ -0,0 +1,121 @@
+#ifndef LIVEFEEDER_H_
+#define LIVEFEEDER_H_
+
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <QVariantList>
+#include <QVector>
+
+class PlotView;
+
+/*
+ * LiveFeeder
+ *
+ * 作用：
+ *   采集过程中把 newDataBatch 直接喂给 PlotView（不经过 SQLite 回读）
+ *
+ * 特点：
+ *   - 批次先攒在内存，按 maxFps 节拍一次性 appendBatch（PlotView 内部按像素列 min/max 抽稀）
+ *   - 流式判峰：滞回（峰高回落超过 prominence 才确认），只看新到的数据
+ *   - 候选峰按显著性取两个相距 >= minPeakSeparation 的峰，左 C 右 T 实时标在曲线上
+ *   - 记住上一次扫描的点数，作为下一次的 X 轴预期长度，避免曲线反复缩放
+ */
+class LiveFeeder : public QObject {
+    Q_OBJECT
+    // 数据源：任意带 newDataBatch(QVector<double>) 信号的对象（MainViewModel / IIODeviceController）
+    Q_PROPERTY(QObject* source READ source WRITE setSource NOTIFY sourceChanged)
+    Q_PROPERTY(QObject* plot READ plot WRITE setPlot NOTIFY plotChanged)
+    Q_PROPERTY(int maxFps READ maxFps WRITE setMaxFps NOTIFY maxFpsChanged)
+    Q_PROPERTY(bool running READ running NOTIFY runningChanged)
+    Q_PROPERTY(int sampleCount READ sampleCount NOTIFY sampleCountChanged)
+
+    // 判峰参数：显著性阈值 = 相对当前数据幅度的比例；两峰最小间隔与 calcTC 的 MIN_SEP 一致
+    Q_PROPERTY(double relativeProminence READ relativeProminence WRITE setRelativeProminence NOTIFY peakParamsChanged)
+    Q_PROPERTY(int minPeakSeparation READ minPeakSeparation WRITE setMinPeakSeparation NOTIFY peakParamsChanged)
+
+    // 已确认的候选峰 [{idx, value, prom}]，以及当前选出的 C/T（-1 = 尚未出现）
+    Q_PROPERTY(QVariantList peaks READ peaks NOTIFY peaksChanged)
+    Q_PROPERTY(int peakC READ peakC NOTIFY peaksChanged)
+    Q_PROPERTY(int peakT READ peakT NOTIFY peaksChanged)
+
+public:
+    explicit LiveFeeder(QObject* parent = nullptr);
+
+    QObject* source() const { return m_source; }
+    void setSource(QObject* obj);
+    QObject* plot() const;
+    void setPlot(QObject* obj);
+
+    int maxFps() const { return m_maxFps; }
+    void setMaxFps(int fps);
+    bool running() const { return m_running; }
+    int sampleCount() const { return m_sampleCount; }
+
+    double relativeProminence() const { return m_relProm; }
+    void setRelativeProminence(double r);
+    int minPeakSeparation() const { return m_minSep; }
+    void setMinPeakSeparation(int n);
+
+    QVariantList peaks() const;
+    int peakC() const { return m_peakC; }
+    int peakT() const { return m_peakT; }
+
+    // 开始一次扫描：清空曲线与判峰状态
+    Q_INVOKABLE void start();
+    // 停止接收（剩余批次立即刷到曲线）
+    Q_INVOKABLE void stop();
+
+public slots:
+    void onBatch(const QVector<double>& values);
+
+signals:
+    void sourceChanged();
+    void plotChanged();
+    void maxFpsChanged();
+    void runningChanged();
+    void sampleCountChanged();
+    void peakParamsChanged();
+    void peaksChanged();
+    void peakDetected(int idx, double value);
+
+private:
+    struct Peak {
+        int idx;
+        double value;
+        double prom;
+    };
+
+    void flush();
+    void resetDetector();
+    void detect(const double* ys, int n, int base);
+    void selectMainPeaks();
+
+private:
+    QPointer<QObject> m_source;
+    QPointer<PlotView> m_plot;
+    QTimer m_frameTimer;
+
+    QVector<double> m_pending;  // 两帧之间攒下的批次
+    int m_maxFps = 20;
+    bool m_running = false;
+    int m_sampleCount = 0;
+    int m_lastScanCount = 0;  // 上一次扫描总点数 → 下一次的 expectedCount
+
+    double m_relProm = 0.1;
+    int m_minSep = 300;
+
+    // ===== 流式判峰状态 =====
+    bool m_seekMax = true;     // true：找峰顶；false：找谷底
+    double m_dataMin = 0.0;    // 已见数据范围（决定绝对显著性阈值）
+    double m_dataMax = 0.0;
+    double m_curMax = 0.0;     // 当前候选峰顶
+    int m_curMaxIdx = -1;
+    double m_curMin = 0.0;     // 当前谷底
+    double m_leftValley = 0.0; // 候选峰左侧谷底
+    QVector<Peak> m_peaks;
+    int m_peakC = -1;
+    int m_peakT = -1;
+};
+
+#endif  // LIVEFEEDER_H_
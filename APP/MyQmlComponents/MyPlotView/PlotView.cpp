@@ -0,0 +1,610 @@
+#include "PlotView.h"
+
+#include <QPainter>
+#include <QQuickWindow>
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QSGRenderNode>
+#include <QSGRendererInterface>
+#include <QtMath>
+#include <climits>
+#include <cmath>
+
+namespace {
+
+// ===================== OpenGL 后端：三个线条节点 ======================
+
+QSGGeometryNode* makeLineNode(unsigned int mode, int vertexCount,
+                              const QColor& color, float width) {
+    auto* geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), vertexCount);
+    geometry->setDrawingMode(mode);
+    geometry->setLineWidth(width);
+
+    auto* material = new QSGFlatColorMaterial;
+    material->setColor(color);
+
+    auto* node = new QSGGeometryNode;
+    node->setGeometry(geometry);
+    node->setFlag(QSGNode::OwnsGeometry);
+    node->setMaterial(material);
+    node->setFlag(QSGNode::OwnsMaterial);
+    return node;
+}
+
+void setNodeColor(QSGGeometryNode* node, const QColor& color) {
+    auto* material = static_cast<QSGFlatColorMaterial*>(node->material());
+    if (material->color() == color)
+        return;
+    material->setColor(color);
+    node->markDirty(QSGNode::DirtyMaterial);
+}
+
+void setLinePoints(QSGGeometryNode* node, const QVector<QPointF>& pts) {
+    QSGGeometry* g = node->geometry();
+    if (g->vertexCount() != pts.size())
+        g->allocate(pts.size());
+    QSGGeometry::Point2D* v = g->vertexDataAsPoint2D();
+    for (int i = 0; i < pts.size(); ++i)
+        v[i].set(float(pts[i].x()), float(pts[i].y()));
+    node->markDirty(QSGNode::DirtyGeometry);
+}
+
+class PlotRootNode : public QSGNode {
+public:
+    QSGGeometryNode* curve = nullptr;
+    QSGGeometryNode* peaks = nullptr;
+    QSGGeometryNode* base = nullptr;
+};
+
+// ===================== software 后端：QPainter 画同一份顶点 ======================
+
+class PlotSoftwareNode : public QSGRenderNode {
+public:
+    explicit PlotSoftwareNode(QQuickWindow* window) : m_window(window) {}
+
+    void render(const RenderState* state) override {
+        QSGRendererInterface* rif = m_window->rendererInterface();
+        auto* p = static_cast<QPainter*>(
+            rif->getResource(m_window, QSGRendererInterface::PainterResource));
+        if (!p)
+            return;
+
+        p->save();
+        p->setTransform(matrix()->toTransform());
+        p->setOpacity(inheritedOpacity());
+        const QRegion* clipRegion = state->clipRegion();
+        if (clipRegion && !clipRegion->isEmpty())
+            p->setClipRegion(*clipRegion, Qt::IntersectClip);
+
+        p->setRenderHint(QPainter::Antialiasing, false);
+        if (curveUsed > 1) {
+            p->setPen(QPen(lineColor, lineWidth));
+            p->drawPolyline(curve.constData(), curveUsed);
+        }
+        if (!peaks.isEmpty()) {
+            p->setPen(QPen(markerColor, 1.0, Qt::DashLine));
+            p->drawLines(peaks.constData(), peaks.size() / 2);
+        }
+        if (!base.isEmpty()) {
+            p->setPen(QPen(baselineColor, 1.0, Qt::DashLine));
+            p->drawLines(base.constData(), base.size() / 2);
+        }
+        p->restore();
+    }
+
+    StateFlags changedStates() const override { return StateFlags(); }
+    RenderingFlags flags() const override { return BoundedRectRendering; }
+    QRectF rect() const override { return bounds; }
+
+    QVector<QPointF> curve;
+    int curveUsed = 0;
+    QVector<QPointF> peaks;
+    QVector<QPointF> base;
+    QColor lineColor;
+    QColor markerColor;
+    QColor baselineColor;
+    qreal lineWidth = 1.0;
+    QRectF bounds;
+
+private:
+    QQuickWindow* m_window;
+};
+
+}  // namespace
+
+PlotView::PlotView(QQuickItem* parent)
+    : QQuickItem(parent) {
+    setFlag(ItemHasContents, true);
+    setClip(true);
+}
+
+// ===================== 属性 ======================
+
+void PlotView::setExpectedCount(int n) {
+    n = qMax(0, n);
+    if (m_expectedCount == n)
+        return;
+    m_expectedCount = n;
+    emit expectedCountChanged();
+
+    m_xMax = qMax(1, qMax(m_expectedCount, m_samples.size()) - 1);
+    emit xRangeChanged();
+    rebuildAll();
+}
+
+void PlotView::setAutoScaleY(bool on) {
+    if (m_autoScaleY == on)
+        return;
+    m_autoScaleY = on;
+    emit autoScaleYChanged();
+    if (on) {
+        recomputeYRange();
+        rebuildAll();
+    }
+}
+
+// 手动设置 Y 范围即关闭自动缩放
+void PlotView::setYMin(double v) {
+    setAutoScaleY(false);
+    if (qFuzzyCompare(m_yMin, v))
+        return;
+    m_yMin = v;
+    emit yRangeChanged();
+    rebuildAll();
+}
+
+void PlotView::setYMax(double v) {
+    setAutoScaleY(false);
+    if (qFuzzyCompare(m_yMax, v))
+        return;
+    m_yMax = v;
+    emit yRangeChanged();
+    rebuildAll();
+}
+
+void PlotView::setLineColor(const QColor& c) {
+    if (m_lineColor == c)
+        return;
+    m_lineColor = c;
+    m_styleDirty = true;
+    emit styleChanged();
+    update();
+}
+
+void PlotView::setLineWidth(qreal w) {
+    if (qFuzzyCompare(m_lineWidth, w))
+        return;
+    m_lineWidth = w;
+    m_styleDirty = true;
+    emit styleChanged();
+    update();
+}
+
+void PlotView::setMarkerColor(const QColor& c) {
+    if (m_markerColor == c)
+        return;
+    m_markerColor = c;
+    m_styleDirty = true;
+    emit styleChanged();
+    update();
+}
+
+void PlotView::setBaselineColor(const QColor& c) {
+    if (m_baselineColor == c)
+        return;
+    m_baselineColor = c;
+    m_styleDirty = true;
+    emit styleChanged();
+    update();
+}
+
+void PlotView::setMarkerC(int idx) {
+    if (m_markerC == idx)
+        return;
+    m_markerC = idx;
+    m_markersDirty = true;
+    emit markersChanged();
+    update();
+}
+
+void PlotView::setMarkerT(int idx) {
+    if (m_markerT == idx)
+        return;
+    m_markerT = idx;
+    m_markersDirty = true;
+    emit markersChanged();
+    update();
+}
+
+void PlotView::setBaseline(double v) {
+    if (qFuzzyCompare(m_baseline, v))
+        return;
+    m_baseline = v;
+    m_markersDirty = true;
+    emit markersChanged();
+    update();
+}
+
+void PlotView::setBaselineVisible(bool on) {
+    if (m_baselineVisible == on)
+        return;
+    m_baselineVisible = on;
+    m_markersDirty = true;
+    emit markersChanged();
+    update();
+}
+
+void PlotView::setPeaks(int idxC, int idxT, double baseline) {
+    m_markerC = idxC;
+    m_markerT = idxT;
+    m_baseline = baseline;
+    m_baselineVisible = true;
+    m_markersDirty = true;
+    emit markersChanged();
+    update();
+}
+
+// ===================== 数据 ======================
+
+void PlotView::setSamples(const QVariantList& ys) {
+    m_samples.clear();
+    m_samples.reserve(ys.size());
+    for (const QVariant& v : ys)
+        m_samples.append(v.toDouble());
+
+    m_xMax = m_expectedCount > 0 ? qMax(m_expectedCount - 1, m_samples.size() - 1)
+                                 : m_samples.size() - 1;
+    m_xMax = qMax(m_xMax, 1.0);
+    emit xRangeChanged();
+
+    if (m_autoScaleY)
+        recomputeYRange();
+    rebuildAll();
+    emit countChanged();
+}
+
+void PlotView::appendSamples(const QVariantList& ys) {
+    QVector<double> buf;
+    buf.reserve(ys.size());
+    for (const QVariant& v : ys)
+        buf.append(v.toDouble());
+    appendInternal(buf.constData(), buf.size());
+}
+
+void PlotView::appendBatch(const QVector<double>& ys) {
+    appendInternal(ys.constData(), ys.size());
+}
+
+void PlotView::clear() {
+    m_samples.clear();
+    m_columns.clear();
+    m_columnVertex.clear();
+    m_vertices.clear();
+    m_xMax = m_expectedCount > 0 ? qMax(m_expectedCount - 1, 1) : 1.0;
+    m_dataMin = 0.0;
+    m_dataMax = 0.0;
+    m_markerC = -1;
+    m_markerT = -1;
+    m_baselineVisible = false;
+    m_markersDirty = true;
+    markCurveDirty(0);
+    emit xRangeChanged();
+    emit markersChanged();
+    emit countChanged();
+    update();
+}
+
+void PlotView::appendInternal(const double* ys, int n) {
+    if (!ys || n <= 0)
+        return;
+
+    const int start = m_samples.size();
+    bool full = false;
+    for (int i = 0; i < n; ++i) {
+        m_samples.append(ys[i]);
+        if (updateYRange(ys[i]))
+            full = true;
+    }
+
+    bool xChanged = false;
+    updateXRange(xChanged);
+    if (xChanged)
+        full = true;
+
+    if (full) {
+        rebuildAll();
+    } else {
+        // ---- 只更新新数据落入的像素列（尾部）----
+        int firstPos = m_columns.size();
+        for (int i = start; i < m_samples.size(); ++i) {
+            const int c = columnOf(i);
+            const double v = m_samples[i];
+            if (!m_columns.isEmpty() && m_columns.last().col == c) {
+                Column& col = m_columns.last();
+                if (v < col.minV) {
+                    col.minV = v;
+                    col.minIdx = i;
+                }
+                if (v > col.maxV) {
+                    col.maxV = v;
+                    col.maxIdx = i;
+                }
+                firstPos = qMin(firstPos, m_columns.size() - 1);
+            } else {
+                m_columns.append(Column{c, i, i, v, v});
+                m_columnVertex.append(-1);
+            }
+        }
+        rebuildFrom(firstPos);
+    }
+
+    emit countChanged();
+    update();
+}
+
+// 追加超出 X 轴时按 1.25 倍扩展，避免每批都整体重映射
+void PlotView::updateXRange(bool& changed) {
+    changed = false;
+    const double last = m_samples.size() - 1;
+    if (last <= m_xMax)
+        return;
+    m_xMax = std::ceil(last * 1.25);
+    changed = true;
+    emit xRangeChanged();
+}
+
+// 自动缩放：超出当前范围时留 10% 余量重新计算，返回是否需要整体重映射
+bool PlotView::updateYRange(double v) {
+    if (m_samples.size() == 1) {
+        m_dataMin = v;
+        m_dataMax = v;
+    } else {
+        m_dataMin = qMin(m_dataMin, v);
+        m_dataMax = qMax(m_dataMax, v);
+    }
+
+    if (!m_autoScaleY)
+        return false;
+    if (m_samples.size() > 1 && v >= m_yMin && v <= m_yMax)
+        return false;
+
+    double span = m_dataMax - m_dataMin;
+    if (span < 1e-9)
+        span = qMax(std::fabs(m_dataMax) * 0.1, 1e-3);
+    m_yMin = m_dataMin - span * 0.1;
+    m_yMax = m_dataMax + span * 0.1;
+    emit yRangeChanged();
+    return true;
+}
+
+void PlotView::recomputeYRange() {
+    if (m_samples.isEmpty())
+        return;
+
+    m_dataMin = m_samples.first();
+    m_dataMax = m_samples.first();
+    for (double v : m_samples) {
+        m_dataMin = qMin(m_dataMin, v);
+        m_dataMax = qMax(m_dataMax, v);
+    }
+
+    double span = m_dataMax - m_dataMin;
+    if (span < 1e-9)
+        span = qMax(std::fabs(m_dataMax) * 0.1, 1e-3);
+    m_yMin = m_dataMin - span * 0.05;
+    m_yMax = m_dataMax + span * 0.05;
+    emit yRangeChanged();
+}
+
+int PlotView::columnCount() const {
+    return qMax(1, int(width()));
+}
+
+int PlotView::columnOf(int idx) const {
+    const int cols = columnCount();
+    const int c = int(double(idx) / m_xMax * cols);
+    return qBound(0, c, cols - 1);
+}
+
+QPointF PlotView::mapPoint(int idx, double v) const {
+    const double span = (m_yMax - m_yMin) > 1e-12 ? (m_yMax - m_yMin) : 1.0;
+    const double x = double(idx) / m_xMax * width();
+    const double y = height() - (v - m_yMin) / span * height();
+    return QPointF(x, y);
+}
+
+void PlotView::markCurveDirty(int vertexPos) {
+    m_dirtyFrom = qMin(m_dirtyFrom, vertexPos);
+}
+
+// ===================== 顶点重建 ======================
+
+void PlotView::rebuildAll() {
+    const int capacity = columnCount() * 2 + 2;
+    if (capacity != m_capacity) {
+        m_capacity = capacity;
+        m_capacityChanged = true;
+        m_vertices.reserve(m_capacity);
+    }
+
+    m_columns.clear();
+    m_columnVertex.clear();
+    for (int i = 0; i < m_samples.size(); ++i) {
+        const int c = columnOf(i);
+        const double v = m_samples[i];
+        if (!m_columns.isEmpty() && m_columns.last().col == c) {
+            Column& col = m_columns.last();
+            if (v < col.minV) {
+                col.minV = v;
+                col.minIdx = i;
+            }
+            if (v > col.maxV) {
+                col.maxV = v;
+                col.maxIdx = i;
+            }
+        } else {
+            m_columns.append(Column{c, i, i, v, v});
+            m_columnVertex.append(-1);
+        }
+    }
+
+    m_vertices.clear();
+    rebuildFrom(0);
+    m_markersDirty = true;
+    update();
+}
+
+void PlotView::rebuildFrom(int columnPos) {
+    if (columnPos >= m_columns.size()) {
+        markCurveDirty(m_vertices.size());
+        return;
+    }
+
+    const int vstart = (m_columnVertex[columnPos] >= 0) ? m_columnVertex[columnPos]
+                                                        : m_vertices.size();
+    m_vertices.resize(vstart);
+
+    for (int k = columnPos; k < m_columns.size(); ++k) {
+        const Column& col = m_columns[k];
+        m_columnVertex[k] = m_vertices.size();
+
+        // 列内 min/max 按原始顺序连接
+        const int first = qMin(col.minIdx, col.maxIdx);
+        const int second = qMax(col.minIdx, col.maxIdx);
+        m_vertices.append(mapPoint(first, m_samples[first]));
+        if (second != first)
+            m_vertices.append(mapPoint(second, m_samples[second]));
+    }
+
+    markCurveDirty(vstart);
+}
+
+void PlotView::buildMarkerLines(QVector<QPointF>& peaks, QVector<QPointF>& base) const {
+    peaks.clear();
+    base.clear();
+    if (m_samples.isEmpty())
+        return;
+
+    const int lastIdx = m_samples.size() - 1;
+    for (int idx : {m_markerC, m_markerT}) {
+        if (idx < 0 || idx > lastIdx)
+            continue;
+        const double x = mapPoint(idx, 0.0).x();
+        peaks.append(QPointF(x, 0.0));
+        peaks.append(QPointF(x, height()));
+    }
+
+    if (m_baselineVisible) {
+        const double y = mapPoint(0, m_baseline).y();
+        base.append(QPointF(0.0, y));
+        base.append(QPointF(width(), y));
+    }
+}
+
+void PlotView::geometryChanged(const QRectF& newGeometry, const QRectF& oldGeometry) {
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size())
+        rebuildAll();
+}
+
+// ===================== 场景图 ======================
+
+QSGNode* PlotView::updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData*) {
+    if (width() <= 0 || height() <= 0) {
+        delete oldNode;
+        return nullptr;
+    }
+
+    const bool software =
+        window()->rendererInterface()->graphicsApi() == QSGRendererInterface::Software;
+    QSGNode* node = software ? updateSoftwareNode(oldNode) : updateGeometryNodes(oldNode);
+
+    m_dirtyFrom = INT_MAX;
+    m_capacityChanged = false;
+    m_markersDirty = false;
+    m_styleDirty = false;
+    return node;
+}
+
+QSGNode* PlotView::updateGeometryNodes(QSGNode* oldNode) {
+    auto* root = static_cast<PlotRootNode*>(oldNode);
+    if (!root) {
+        root = new PlotRootNode;
+        root->curve = makeLineNode(QSGGeometry::DrawLineStrip, m_capacity,
+                                   m_lineColor, float(m_lineWidth));
+        root->peaks = makeLineNode(QSGGeometry::DrawLines, 0, m_markerColor, 1.0f);
+        root->base = makeLineNode(QSGGeometry::DrawLines, 0, m_baselineColor, 1.0f);
+        root->appendChildNode(root->curve);
+        root->appendChildNode(root->peaks);
+        root->appendChildNode(root->base);
+        m_dirtyFrom = 0;
+        m_markersDirty = true;
+    }
+
+    if (m_styleDirty) {
+        setNodeColor(root->curve, m_lineColor);
+        setNodeColor(root->peaks, m_markerColor);
+        setNodeColor(root->base, m_baselineColor);
+        root->curve->geometry()->setLineWidth(float(m_lineWidth));
+        root->curve->markDirty(QSGNode::DirtyGeometry);
+    }
+
+    // ---- 曲线：只拷贝脏区间，尾部用末点填充（零长度线段不出图）----
+    QSGGeometry* g = root->curve->geometry();
+    int from = m_dirtyFrom;
+    if (g->vertexCount() != m_capacity) {
+        g->allocate(m_capacity);
+        from = 0;
+    }
+    if (from != INT_MAX) {
+        QSGGeometry::Point2D* v = g->vertexDataAsPoint2D();
+        const int used = qMin(m_vertices.size(), m_capacity);
+        for (int i = from; i < used; ++i)
+            v[i].set(float(m_vertices[i].x()), float(m_vertices[i].y()));
+
+        const QPointF last = used > 0 ? m_vertices[used - 1] : QPointF();
+        for (int i = used; i < m_capacity; ++i)
+            v[i].set(float(last.x()), float(last.y()));
+        root->curve->markDirty(QSGNode::DirtyGeometry);
+    }
+
+    if (m_markersDirty) {
+        QVector<QPointF> peaks;
+        QVector<QPointF> base;
+        buildMarkerLines(peaks, base);
+        setLinePoints(root->peaks, peaks);
+        setLinePoints(root->base, base);
+    }
+
+    return root;
+}
+
+QSGNode* PlotView::updateSoftwareNode(QSGNode* oldNode) {
+    auto* node = static_cast<PlotSoftwareNode*>(oldNode);
+    if (!node) {
+        node = new PlotSoftwareNode(window());
+        m_dirtyFrom = 0;
+        m_markersDirty = true;
+    }
+
+    node->bounds = boundingRect();
+    node->lineColor = m_lineColor;
+    node->markerColor = m_markerColor;
+    node->baselineColor = m_baselineColor;
+    node->lineWidth = m_lineWidth;
+
+    if (m_dirtyFrom != INT_MAX) {
+        const int used = m_vertices.size();
+        const int from = qMin(m_dirtyFrom, used);
+        node->curve.resize(used);
+        for (int i = from; i < used; ++i)
+            node->curve[i] = m_vertices[i];
+        node->curveUsed = used;
+    }
+
+    if (m_markersDirty)
+        buildMarkerLines(node->peaks, node->base);
+
+    node->markDirty(QSGNode::DirtyMaterial);
+    return node;
+}
@@ -0,0 +1,159 @@
+#ifndef PLOTVIEW_H_
+#define PLOTVIEW_H_
+
+#include <QColor>
+#include <QPointF>
+#include <QQuickItem>
+#include <QVariantList>
+#include <QVector>
+
+/*
+ * PlotView
+ *
+ * 作用：
+ *   直接走 Qt Quick 场景图绘制 ADC 曲线，替代 QtCharts
+ *
+ * 特点：
+ *   - 每像素列保留 min/max（X 为原始采样序号，峰值不丢）
+ *   - 顶点缓冲按像素宽度预分配，追加数据只改写尾部顶点
+ *   - OpenGL 后端：QSGGeometryNode（LineStrip / Lines）
+ *   - software 后端（linuxfb）：QSGRenderNode + QPainter 画同一份顶点
+ *   - C/T 峰位竖线、本底横线标记
+ */
+class PlotView : public QQuickItem {
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    // 预期总点数（>0 时 X 轴固定为 [0, expectedCount-1]，超出后自动扩展）
+    Q_PROPERTY(int expectedCount READ expectedCount WRITE setExpectedCount NOTIFY expectedCountChanged)
+    Q_PROPERTY(double xMax READ xMax NOTIFY xRangeChanged)
+
+    Q_PROPERTY(bool autoScaleY READ autoScaleY WRITE setAutoScaleY NOTIFY autoScaleYChanged)
+    Q_PROPERTY(double yMin READ yMin WRITE setYMin NOTIFY yRangeChanged)
+    Q_PROPERTY(double yMax READ yMax WRITE setYMax NOTIFY yRangeChanged)
+
+    Q_PROPERTY(QColor lineColor READ lineColor WRITE setLineColor NOTIFY styleChanged)
+    Q_PROPERTY(qreal lineWidth READ lineWidth WRITE setLineWidth NOTIFY styleChanged)
+    Q_PROPERTY(QColor markerColor READ markerColor WRITE setMarkerColor NOTIFY styleChanged)
+    Q_PROPERTY(QColor baselineColor READ baselineColor WRITE setBaselineColor NOTIFY styleChanged)
+
+    // C/T 峰位（原始下标，-1 = 不显示）与本底
+    Q_PROPERTY(int markerC READ markerC WRITE setMarkerC NOTIFY markersChanged)
+    Q_PROPERTY(int markerT READ markerT WRITE setMarkerT NOTIFY markersChanged)
+    Q_PROPERTY(double baseline READ baseline WRITE setBaseline NOTIFY markersChanged)
+    Q_PROPERTY(bool baselineVisible READ baselineVisible WRITE setBaselineVisible NOTIFY markersChanged)
+
+public:
+    explicit PlotView(QQuickItem* parent = nullptr);
+
+    int count() const { return m_samples.size(); }
+    int expectedCount() const { return m_expectedCount; }
+    void setExpectedCount(int n);
+    double xMax() const { return m_xMax; }
+
+    bool autoScaleY() const { return m_autoScaleY; }
+    void setAutoScaleY(bool on);
+    double yMin() const { return m_yMin; }
+    void setYMin(double v);
+    double yMax() const { return m_yMax; }
+    void setYMax(double v);
+
+    QColor lineColor() const { return m_lineColor; }
+    void setLineColor(const QColor& c);
+    qreal lineWidth() const { return m_lineWidth; }
+    void setLineWidth(qreal w);
+    QColor markerColor() const { return m_markerColor; }
+    void setMarkerColor(const QColor& c);
+    QColor baselineColor() const { return m_baselineColor; }
+    void setBaselineColor(const QColor& c);
+
+    int markerC() const { return m_markerC; }
+    void setMarkerC(int idx);
+    int markerT() const { return m_markerT; }
+    void setMarkerT(int idx);
+    double baseline() const { return m_baseline; }
+    void setBaseline(double v);
+    bool baselineVisible() const { return m_baselineVisible; }
+    void setBaselineVisible(bool on);
+
+    // === QML：整条替换 / 增量追加 / 清空 ===
+    Q_INVOKABLE void setSamples(const QVariantList& ys);
+    Q_INVOKABLE void appendSamples(const QVariantList& ys);
+    Q_INVOKABLE void clear();
+    // 一次设置 C/T 峰位与本底（calcTC 结果）
+    Q_INVOKABLE void setPeaks(int idxC, int idxT, double baseline);
+
+public slots:
+    // C++：直接连采集批次信号
+    void appendBatch(const QVector<double>& ys);
+
+signals:
+    void countChanged();
+    void expectedCountChanged();
+    void xRangeChanged();
+    void autoScaleYChanged();
+    void yRangeChanged();
+    void styleChanged();
+    void markersChanged();
+
+protected:
+    QSGNode* updatePaintNode(QSGNode* oldNode, UpdatePaintNodeData* data) override;
+    void geometryChanged(const QRectF& newGeometry, const QRectF& oldGeometry) override;
+
+private:
+    // 一个像素列内的极值
+    struct Column {
+        int col;
+        int minIdx;
+        int maxIdx;
+        double minV;
+        double maxV;
+    };
+
+    void appendInternal(const double* ys, int n);
+    void rebuildAll();
+    void rebuildFrom(int columnPos);
+    void updateXRange(bool& changed);
+    bool updateYRange(double v);
+    void recomputeYRange();
+    int columnOf(int idx) const;
+    int columnCount() const;
+    QPointF mapPoint(int idx, double v) const;
+    void markCurveDirty(int vertexPos);
+
+    QSGNode* updateGeometryNodes(QSGNode* oldNode);
+    QSGNode* updateSoftwareNode(QSGNode* oldNode);
+    void buildMarkerLines(QVector<QPointF>& peaks, QVector<QPointF>& base) const;
+
+private:
+    QVector<double> m_samples;
+
+    QVector<Column> m_columns;       // 非空像素列（按列号递增）
+    QVector<int> m_columnVertex;     // 每列在顶点数组中的起始位置
+    QVector<QPointF> m_vertices;     // 曲线顶点（item 坐标），容量按宽度预分配
+    int m_capacity = 0;              // 预分配顶点数 = 2 * 列数 + 2
+    int m_dirtyFrom = 0;             // 尚未同步到场景图的首个顶点
+    bool m_capacityChanged = true;
+
+    int m_expectedCount = 0;
+    double m_xMax = 1.0;
+
+    bool m_autoScaleY = true;
+    double m_yMin = 0.0;
+    double m_yMax = 1.0;
+    double m_dataMin = 0.0;
+    double m_dataMax = 0.0;
+
+    QColor m_lineColor = QColor("#1a5995");
+    qreal m_lineWidth = 1.5;
+    QColor m_markerColor = QColor("#e53935");
+    QColor m_baselineColor = QColor("#43a047");
+
+    int m_markerC = -1;
+    int m_markerT = -1;
+    double m_baseline = 0.0;
+    bool m_baselineVisible = false;
+    bool m_markersDirty = true;
+    bool m_styleDirty = true;
+};
+
+#endif  // PLOTVIEW_H_
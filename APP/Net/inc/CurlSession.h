@@ -0,0 +1,66 @@
+#ifndef CURLSESSION_H_
+#define CURLSESSION_H_
+
+#include <curl/curl.h>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/*
+ * CurlSession
+ *
+ * 作用：
+ *   一个服务端对应一个会话，多次请求共用连接和 TLS 状态
+ *
+ * 内容：
+ *   - CURLSH 共享 DNS / TLS 会话 / 连接池 / Cookie
+ *   - 每个调用线程一个常驻 easy 句柄（easy 句柄不能跨线程并发使用）
+ *   - Cookie 只在内存里，距上次落盘超过 kCookieFlushSec 才写一次 cookieFile
+ *   - HTTPS 协商 HTTP/2（ALPN），服务器不支持时自动回落 1.1
+ *
+ * 用法：
+ *   CURL* c = session.begin();   // 已 reset 并挂好共享和公共选项
+ *   ... 设置 URL / 头 / 回调 ...
+ *   curl_easy_perform(c);
+ *   session.end();               // 按需把 Cookie 落盘
+ */
+class CurlSession {
+public:
+    // cookieFile 为空时不读不写文件，Cookie 仅在本进程内有效
+    explicit CurlSession(const std::string& cookieFile = std::string());
+    ~CurlSession();
+
+    CurlSession(const CurlSession&) = delete;
+    CurlSession& operator=(const CurlSession&) = delete;
+
+    CURL* begin();
+    void end();
+
+    // 立即把内存中的 Cookie 写到 cookieFile
+    void flushCookies();
+
+private:
+    static constexpr int kCookieFlushSec = 60;
+
+    static void lockCb(CURL*, curl_lock_data data, curl_lock_access, void* userptr);
+    static void unlockCb(CURL*, curl_lock_data data, void* userptr);
+
+    CURL* threadHandle();
+
+    CURLSH* m_share = nullptr;
+    std::mutex m_locks[CURL_LOCK_DATA_LAST];  // 按数据类别分锁
+
+    std::mutex m_handlesMutex;
+    std::map<std::thread::id, CURL*> m_handles;
+
+    std::string m_cookieFile;
+    std::mutex m_cookieMutex;
+    bool m_cookieLoaded = false;
+    bool m_cookieDirty = false;
+    std::chrono::steady_clock::time_point m_lastFlush;
+};
+
+#endif  // CURLSESSION_H_
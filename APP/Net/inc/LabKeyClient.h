@@ -2,16 +2,29 @@
 #define LABKEYCLIENT_H_
 
 #include <QJsonObject>
+#include <QList>
 #include <QObject>
 #include <QVariantMap>
 #include <mutex>
 #include <string>
+
+#include "CurlSession.h"
+
+/*
+ * LabKeyClientCurl
+ *
+ *   - 请求都走 CurlSession：连接 / TLS 会话 / DNS / Cookie 共享，每线程一个常驻 easy 句柄，
+ *     只有第一次请求做 TLS 握手，HTTPS 优先 HTTP/2
+ *   - Cookie 在内存里，定期写回 cookieFile，不再每次请求读写文件
+ *   - CSRF 取一次缓存起来，服务器回 401/403 时清掉重取并重试一次
+ */
 class LabKeyClientCurl {
 public:
     LabKeyClientCurl(const std::string& baseUrl,
                      const std::string& projectPath,
                      const std::string& authBasic,
                      const std::string& cookieFile);
+    ~LabKeyClientCurl();
 
     bool fetchToken(std::string& outCsrf, std::string& err);
     bool uploadRun(const QVariantMap& record,
@@ -20,6 +33,13 @@ public:
                    QString* err,
                    QString* outJson);
 
+    // 同一 assayId/name 的多条记录合成一次 assay-importRun（dataRows 多行）
+    bool uploadRuns(const QList<QVariantMap>& records,
+                    int* httpStatus,
+                    QString* rawResp,
+                    QString* err,
+                    QString* outJson);
+
     bool fetchMethodLibrary(const std::string& type,
                             const std::string& serial,
                             QJsonObject& outResp,
@@ -28,20 +48,25 @@ public:
 private:
     bool httpGet(const std::string& url,
                  std::string& response,
-                 std::string& err);
+                 std::string& err,
+                 long* httpCode = nullptr);
 
     bool httpPost(const std::string& url,
                   const std::string& body,
                   std::string& response,
-                  std::string& err);
+                  std::string& err,
+                  long* httpCode = nullptr);
+
+    bool ensureToken(std::string& err);
+    bool postImportRun(const std::string& body, long& httpCode, std::string& response, std::string& err);
 
 private:
     std::string m_baseUrl;
     std::string m_projectPath;
     std::string m_authBasic;
-    std::string m_cookieFile;
     std::string m_csrf;
     std::mutex m_mutex;
+    CurlSession m_session;
 };
 
 #endif  // LABKEYCLIENT
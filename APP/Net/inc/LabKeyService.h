@@ -3,10 +3,27 @@
 
 #include <QJsonObject>
 #include <QObject>
+#include <QTimer>
+#include <atomic>
 
 #include "LabKeyClient.h"
 #include "TaskQueueWorker.h"
 
+/*
+ * LabKeyService
+ *
+ * 上传走发件箱（upload_outbox 表）：
+ *   - 结果先落表（检测结果由 DBWorker 在落库事务里写入；uploadRun() 供其他入口使用）
+ *   - 任务线程按 kBatchSize 条一批合成一次 assay-importRun，成功删除、失败按指数退避改期
+ *   - 断网 / 重启后从表里接着发，不丢结果
+ *
+ * 失败分类：
+ *   - 网络不通：整箱退避，不计入服务端错误次数，断多久都不丢
+ *   - 服务器拒收（4xx 数据类错误 / success:false）：一批里不知道是哪条，对半拆开重发，
+ *     拆到单条仍被拒就转死信，其余照常上传
+ *   - 服务端故障（5xx 等）：退避重试；服务端错误满 kSplitAfterErrors 次后改为逐条发送，
+ *     单条满 kMaxServerErrors 次转死信，一条坏数据不会一直堵住整个发件箱
+ */
 class LabKeyService : public QObject {
     Q_OBJECT
 public:
@@ -17,14 +34,39 @@ public:
     Q_INVOKABLE void fetchMethodLibrary(const QString& type,
                                         const QString& serial);
     Q_INVOKABLE void uploadRun(const QVariantMap& record);
+
+    // DB 迁移完成后调用一次：任务线程打开独立连接，并补发上次没发完的
+    void openOutbox(const QString& dbPath);
+    // 有新条目入箱时唤醒发送（任意线程）
+    void kickOutbox();
+
 signals:
     void methodLibraryReady(const QJsonObject& data);
     void errorOccured(const QString& msg);
     void uploadFinished(bool ok, int status, QString raw, QString err);
+    void outboxPendingChanged(int pending);
+    void retryRequested(int ms);  // 任务线程 → GUI 线程的退避定时器
 
 private:
+    static constexpr int kBatchSize = 20;
+    static constexpr int kBackoffBaseSec = 30;
+    static constexpr int kBackoffMaxSec = 3600;
+    static constexpr int kSplitAfterErrors = 3;
+    static constexpr int kMaxServerErrors = 8;
+
+    enum class SendOutcome { Sent, Rejected, ServerError, NetworkError };
+
+    void drainOutbox();          // 仅任务线程
+    // 发一批；被拒时对半拆开递归重发。返回 false 表示遇到暂时性失败，本轮不再继续
+    bool sendOutboxItems(const QVector<qint64>& ids, const QList<QVariantMap>& records, int serverErrors,
+                         int& sent);
+    void uploadDirect(const QVariantMap& record);
+
     TaskQueueWorker m_worker;
     LabKeyClientCurl* m_client{nullptr};
+    QTimer m_retry;
+    bool m_outboxOpen{false};  // 仅任务线程访问
+    std::atomic<bool> m_drainQueued{false};
 };
 
 #endif
@@ -0,0 +1,114 @@
+#include "CurlSession.h"
+
+#include <QDebug>
+
+CurlSession::CurlSession(const std::string& cookieFile)
+    : m_cookieFile(cookieFile),
+      m_lastFlush(std::chrono::steady_clock::now()) {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    m_share = curl_share_init();
+    if (!m_share) {
+        qWarning() << "[Curl] curl_share_init failed, requests will not share state";
+        return;
+    }
+    curl_share_setopt(m_share, CURLSHOPT_LOCKFUNC, &CurlSession::lockCb);
+    curl_share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, &CurlSession::unlockCb);
+    curl_share_setopt(m_share, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
+}
+
+CurlSession::~CurlSession() {
+    if (m_cookieDirty)
+        flushCookies();
+
+    // 先释放挂在共享上的 easy 句柄，否则 curl_share_cleanup 返回 IN_USE
+    {
+        std::lock_guard<std::mutex> lock(m_handlesMutex);
+        for (auto& kv : m_handles)
+            curl_easy_cleanup(kv.second);
+        m_handles.clear();
+    }
+    if (m_share)
+        curl_share_cleanup(m_share);
+    curl_global_cleanup();
+}
+
+void CurlSession::lockCb(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    static_cast<CurlSession*>(userptr)->m_locks[data].lock();
+}
+
+void CurlSession::unlockCb(CURL*, curl_lock_data data, void* userptr) {
+    static_cast<CurlSession*>(userptr)->m_locks[data].unlock();
+}
+
+CURL* CurlSession::threadHandle() {
+    std::lock_guard<std::mutex> lock(m_handlesMutex);
+    CURL*& h = m_handles[std::this_thread::get_id()];
+    if (!h)
+        h = curl_easy_init();
+    return h;
+}
+
+CURL* CurlSession::begin() {
+    CURL* curl = threadHandle();
+    if (!curl)
+        return nullptr;
+
+    // reset 只清选项；连接、TLS 会话都在共享里，不受影响
+    curl_easy_reset(curl);
+    if (m_share)
+        curl_easy_setopt(curl, CURLOPT_SHARE, m_share);
+
+    // 第一次从文件导入上次保存的 Cookie，之后只打开 Cookie 引擎（空串不读文件）
+    {
+        std::lock_guard<std::mutex> lock(m_cookieMutex);
+        if (!m_cookieLoaded && !m_cookieFile.empty()) {
+            curl_easy_setopt(curl, CURLOPT_COOKIEFILE, m_cookieFile.c_str());
+            m_cookieLoaded = true;
+        } else {
+            curl_easy_setopt(curl, CURLOPT_COOKIEFILE, "");
+        }
+    }
+
+    curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, long(CURL_HTTP_VERSION_2TLS));
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    return curl;
+}
+
+void CurlSession::end() {
+    bool due = false;
+    {
+        std::lock_guard<std::mutex> lock(m_cookieMutex);
+        m_cookieDirty = true;
+        due = !m_cookieFile.empty() &&
+              std::chrono::steady_clock::now() - m_lastFlush >= std::chrono::seconds(kCookieFlushSec);
+    }
+    if (due)
+        flushCookies();
+}
+
+void CurlSession::flushCookies() {
+    if (m_cookieFile.empty() || !m_share)
+        return;
+
+    // 用临时句柄落盘，不占用任何线程正在用的 easy 句柄
+    CURL* tmp = curl_easy_init();
+    if (!tmp)
+        return;
+    curl_easy_setopt(tmp, CURLOPT_SHARE, m_share);
+    curl_easy_setopt(tmp, CURLOPT_COOKIEFILE, "");
+    curl_easy_setopt(tmp, CURLOPT_COOKIEJAR, m_cookieFile.c_str());
+    curl_easy_setopt(tmp, CURLOPT_COOKIELIST, "FLUSH");
+    // 清掉 COOKIEJAR，避免 cleanup 时再写一遍
+    curl_easy_setopt(tmp, CURLOPT_COOKIEJAR, nullptr);
+    curl_easy_cleanup(tmp);
+
+    std::lock_guard<std::mutex> lock(m_cookieMutex);
+    m_cookieDirty = false;
+    m_lastFlush = std::chrono::steady_clock::now();
+}
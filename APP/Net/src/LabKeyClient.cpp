@@ -23,14 +23,18 @@ LabKeyClientCurl::LabKeyClientCurl(const std::string& baseUrl,
     : m_baseUrl(baseUrl),
       m_projectPath(projectPath),
       m_authBasic(authBasic),
-      m_cookieFile(cookieFile) {
-    curl_global_init(CURL_GLOBAL_DEFAULT);
+      m_session(cookieFile) {
+}
+
+LabKeyClientCurl::~LabKeyClientCurl() {
+    m_session.flushCookies();
 }
 
 bool LabKeyClientCurl::httpGet(const std::string& url,
                                std::string& response,
-                               std::string& err) {
-    CURL* curl = curl_easy_init();
+                               std::string& err,
+                               long* httpCode) {
+    CURL* curl = m_session.begin();
     if (!curl) {
         err = "curl_easy_init failed";
         return false;
@@ -49,25 +53,24 @@ bool LabKeyClientCurl::httpGet(const std::string& url,
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);  // -k
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
 
-    curl_easy_setopt(curl, CURLOPT_COOKIEFILE, m_cookieFile.c_str());
-    curl_easy_setopt(curl, CURLOPT_COOKIEJAR, m_cookieFile.c_str());
-
     CURLcode rc = curl_easy_perform(curl);
+    curl_slist_free_all(headers);
+    m_session.end();
+    if (httpCode)
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, httpCode);
     if (rc != CURLE_OK) {
         err = curl_easy_strerror(rc);
-        curl_easy_cleanup(curl);
         return false;
     }
-
-    curl_easy_cleanup(curl);
     return true;
 }
 
 bool LabKeyClientCurl::httpPost(const std::string& url,
                                 const std::string& body,
                                 std::string& response,
-                                std::string& err) {
-    CURL* curl = curl_easy_init();
+                                std::string& err,
+                                long* httpCode) {
+    CURL* curl = m_session.begin();
     if (!curl) {
         err = "curl_easy_init failed";
         return false;
@@ -115,25 +118,21 @@ bool LabKeyClientCurl::httpPost(const std::string& url,
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
     curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
 
-    // =========================
-    // Cookie (-b / -c)
-    // =========================
-    curl_easy_setopt(curl, CURLOPT_COOKIEFILE, m_cookieFile.c_str());
-    curl_easy_setopt(curl, CURLOPT_COOKIEJAR, m_cookieFile.c_str());
-
+    // Cookie 由 CurlSession 在内存中维护（等价 -b / -c，但不每次读写文件）
     CURLcode rc = curl_easy_perform(curl);
+    curl_slist_free_all(headers);
+    m_session.end();
     if (rc != CURLE_OK) {
         err = curl_easy_strerror(rc);
-        curl_easy_cleanup(curl);
         return false;
     }
 
     // ★ 打印 HTTP code，便于你判断
-    long httpCode = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &httpCode);
-    qInfo() << "[LabKey] HTTP code =" << httpCode;
-
-    curl_easy_cleanup(curl);
+    long code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+    qInfo() << "[LabKey] HTTP code =" << code;
+    if (httpCode)
+        *httpCode = code;
     return true;
 }
 
@@ -178,14 +177,43 @@ bool LabKeyClientCurl::fetchMethodLibrary(const std::string& type,
                   .object();
     return true;
 }
-bool LabKeyClientCurl::uploadRun(const QVariantMap& record,
-                                 int* httpStatus,
-                                 QString* rawResp,
-                                 QString* err,
-                                 QString* outJson) {
-    // =========================
-    // 1) 组 JSON
-    // =========================
+// 缓存的 CSRF 为空时才去取
+bool LabKeyClientCurl::ensureToken(std::string& err) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_csrf.empty())
+            return true;
+    }
+    std::string csrf;
+    if (!fetchToken(csrf, err)) {
+        if (err.empty())
+            err = "fetchToken failed";
+        return false;
+    }
+    return true;
+}
+
+bool LabKeyClientCurl::postImportRun(const std::string& body, long& httpCode, std::string& response,
+                                     std::string& err) {
+    const std::string url = m_baseUrl + "/QuantitativeFluorescence/assay-importRun.api";
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (!ensureToken(err))
+            return false;
+        response.clear();
+        httpCode = 0;
+        if (!httpPost(url, body, response, err, &httpCode))
+            return false;
+        if (httpCode != 401 && httpCode != 403)
+            return true;
+        // 会话 / CSRF 过期：清缓存重取一次
+        qInfo() << "[LabKey] HTTP" << httpCode << ", refresh CSRF";
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_csrf.clear();
+    }
+    return true;
+}
+
+static QJsonObject toDataRow(const QVariantMap& record) {
     QJsonObject row;
     row["company"] = record.value("company").toString();
     row["sample"] = record.value("sample").toString();
@@ -199,13 +227,35 @@ bool LabKeyClientCurl::uploadRun(const QVariantMap& record,
     row["serial"] = record.value("serial").toString();
     row["CurveFormula"] = record.value("CurveFormula").toString();
     row["DilutionFactor"] = record.value("DilutionFactor").toDouble();
+    return row;
+}
+
+bool LabKeyClientCurl::uploadRun(const QVariantMap& record,
+                                 int* httpStatus,
+                                 QString* rawResp,
+                                 QString* err,
+                                 QString* outJson) {
+    return uploadRuns(QList<QVariantMap>{record}, httpStatus, rawResp, err, outJson);
+}
 
+bool LabKeyClientCurl::uploadRuns(const QList<QVariantMap>& records,
+                                  int* httpStatus,
+                                  QString* rawResp,
+                                  QString* err,
+                                  QString* outJson) {
+    if (records.isEmpty())
+        return true;
+
+    // =========================
+    // 1) 组 JSON：root 取第一条，dataRows 逐条
+    // =========================
     QJsonArray dataRows;
-    dataRows.append(row);
+    for (const QVariantMap& r : records)
+        dataRows.append(toDataRow(r));
 
     QJsonObject root;
-    root["assayId"] = record.value("assayId").toInt();
-    root["name"] = record.value("name").toString();
+    root["assayId"] = records.first().value("assayId").toInt();
+    root["name"] = records.first().value("name").toString();
     root["dataRows"] = dataRows;
 
     QJsonDocument doc(root);
@@ -215,16 +265,13 @@ bool LabKeyClientCurl::uploadRun(const QVariantMap& record,
         *outJson = jsonStr;  // ★ 回传给 Service
 
     // =========================
-    // 2) HTTP POST
+    // 2) HTTP POST（CSRF 缓存，过期自动重取）
     // =========================
     std::string response;
     std::string httpErr;
+    long code = 0;
 
-    std::string url =
-        m_baseUrl +
-        "/QuantitativeFluorescence/assay-importRun.api";
-
-    bool ok = httpPost(url, jsonStr.toStdString(), response, httpErr);
+    bool ok = postImportRun(jsonStr.toStdString(), code, response, httpErr);
 
     if (!ok) {
         if (err)
@@ -234,9 +281,10 @@ bool LabKeyClientCurl::uploadRun(const QVariantMap& record,
         return false;
     }
 
+    if (httpStatus)
+        *httpStatus = int(code);
     if (rawResp)
         *rawResp = QString::fromStdString(response);
-
     // =========================
     // 3) 解析返回
     // =========================
@@ -245,8 +293,9 @@ bool LabKeyClientCurl::uploadRun(const QVariantMap& record,
         QJsonDocument::fromJson(QByteArray::fromStdString(response), &pe);
 
     if (pe.error != QJsonParseError::NoError || !respDoc.isObject()) {
-        if (httpStatus)
-            *httpStatus = -1;
+        // 保留真实状态码：发件箱据此区分拒收（4xx）和服务端故障（5xx / 网关错误页）
+        if (err)
+            *err = QString("HTTP %1, response is not JSON").arg(code);
         return false;
     }
 
@@ -264,6 +313,9 @@ bool LabKeyClientCurl::uploadRun(const QVariantMap& record,
             << "batchId =" << batchId
             << "url =" << successUrl;
 
+    if (!success && err)
+        *err = respObj.value("exception").toString();
+
     // ★ 唯一成功判定
     return success;
 }
\ No newline at end of file
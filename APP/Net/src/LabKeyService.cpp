@@ -1,10 +1,48 @@
 #include "LabKeyService.h"
 
 #include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "OutboxRepo.h"
+
+namespace {
+const char kOutboxConn[] = "labkey_outbox";
+
+// 401/403 已由 client 重取 CSRF 重试过；404/405 是地址配错，408/429 是限流，
+// 这些对每一条都一样，不能当成数据被拒把整箱转死信
+bool isPermanentReject(int status) {
+    if (status < 400 || status >= 500)
+        return false;
+    switch (status) {
+    case 401:
+    case 403:
+    case 404:
+    case 405:
+    case 408:
+    case 429:
+        return false;
+    default:
+        return true;
+    }
+}
+}  // namespace
+
 LabKeyService::LabKeyService(QObject* parent)
     : QObject(parent) {
     m_worker.start();
 
+    m_retry.setSingleShot(true);
+    connect(&m_retry, &QTimer::timeout, this, &LabKeyService::kickOutbox);
+    connect(this, &LabKeyService::retryRequested, this, [this](int ms) {
+        // 已有更早的定时就不推迟
+        if (!m_retry.isActive() || m_retry.remainingTime() > ms)
+            m_retry.start(ms);
+    });
+
     m_client = new LabKeyClientCurl(
         "https://lims.pribolab.net:13101",
         "/QuantitativeFluorescence",
@@ -15,6 +53,8 @@ LabKeyService::LabKeyService(QObject* parent)
 LabKeyService::~LabKeyService() {
     m_worker.stop();
     delete m_client;
+    if (QSqlDatabase::contains(kOutboxConn))
+        QSqlDatabase::removeDatabase(kOutboxConn);
 }
 
 /*
@@ -58,52 +98,184 @@ void LabKeyService::uploadRun(const QVariantMap& record) {
     const QVariantMap recordCopy = record;
 
     m_worker.pushTask([this, recordCopy]() {
-        qDebug() << "[TASK][LabKey] start";
-
-        std::string csrf;
-        std::string err;
+        if (!m_outboxOpen) {
+            uploadDirect(recordCopy);
+            return;
+        }
+        QSqlDatabase db = QSqlDatabase::database(kOutboxConn);
+        if (!OutboxRepo::enqueue(db, recordCopy)) {
+            uploadDirect(recordCopy);
+            return;
+        }
+        drainOutbox();
+    });
+}
 
-        // =========================
-        // ① fetch CSRF
-        // =========================
-        if (!m_client->fetchToken(csrf, err)) {
-            qWarning() << "[TASK][LabKey] fetchToken FAILED:"
-                       << QString::fromStdString(err);
-            emit uploadFinished(false, -1, "", "fetchToken failed");
+void LabKeyService::openOutbox(const QString& dbPath) {
+    m_worker.pushTask([this, dbPath]() {
+        // 每个线程必须单独打开自己的数据库连接
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", kOutboxConn);
+        db.setDatabaseName(dbPath);
+        if (!db.open()) {
+            qWarning() << "[LabKey] outbox open failed:" << db.lastError().text();
             return;
         }
+        QSqlQuery q(db);
+        q.exec("PRAGMA busy_timeout=5000;");  // 与 DB 线程并发写时等锁而不是立即失败
+        m_outboxOpen = true;
+        const int pending = OutboxRepo::pendingCount(db);
+        qInfo() << "[LabKey] outbox open, pending =" << pending;
+        emit outboxPendingChanged(pending);
+        drainOutbox();
+    });
+}
+
+void LabKeyService::kickOutbox() {
+    // 已有一次排队中的发送就不再重复入队
+    if (m_drainQueued.exchange(true))
+        return;
+    m_worker.pushTask([this]() { drainOutbox(); });
+}
+
+// ===== 发件箱：批量发送 =====
+void LabKeyService::drainOutbox() {
+    m_drainQueued = false;
+    if (!m_outboxOpen)
+        return;
+    QSqlDatabase db = QSqlDatabase::database(kOutboxConn);
+
+    int sent = 0;
+    for (;;) {
+        QVector<OutboxRepo::Item> items;
+        if (!OutboxRepo::takeDue(db, kBatchSize, items) || items.isEmpty())
+            break;
 
-        qDebug() << "[TASK][LabKey] CSRF =" << csrf.c_str();
-
-        // =========================
-        // ② upload
-        // =========================
-        int status = -1;
-        QString rawResp;
-        QString qerr;
-        QString sendJson;  // ★ 新增：拿到真正发出去的 JSON
-
-        bool ok = m_client->uploadRun(
-            recordCopy,
-            &status,
-            &rawResp,
-            &qerr,
-            &sendJson  // ★ 让 client 回传 JSON
-        );
-
-        // =========================
-        // ③ 打印完整链路
-        // =========================
-        qDebug().noquote() << "[TASK][LabKey] SEND JSON =" << sendJson;
-        qDebug() << "[TASK][LabKey] HTTP status =" << status;
-        qDebug().noquote() << "[TASK][LabKey] RAW response =" << rawResp;
-
-        if (ok)
-            qDebug() << "[TASK][LabKey] upload SUCCESS ✅";
+        // assayId / name 是请求级字段：只把与第一条相同的合成一批，其余留给下一轮
+        // 服务端反复出错的条目单独发，拖不累同批的其他结果
+        const OutboxRepo::Item& head = items.first();
+        const bool single = head.serverErrors >= kSplitAfterErrors;
+        QList<QVariantMap> records;
+        QVector<qint64> ids;
+        int serverErrors = 0;
+        for (const OutboxRepo::Item& it : items) {
+            if (it.record.value("assayId") != head.record.value("assayId") ||
+                it.record.value("name") != head.record.value("name"))
+                continue;
+            if (!ids.isEmpty() && (single || it.serverErrors >= kSplitAfterErrors))
+                continue;
+            records.append(it.record);
+            ids.append(it.id);
+            serverErrors = qMax(serverErrors, it.serverErrors);
+        }
+
+        if (!sendOutboxItems(ids, records, serverErrors, sent))
+            break;  // 网络不通 / 服务端故障时整箱一起退避，不逐条撞墙
+    }
+
+    const int pending = OutboxRepo::pendingCount(db);
+    if (sent > 0)
+        qInfo() << "[LabKey] outbox sent" << sent << ", pending =" << pending;
+    emit outboxPendingChanged(pending);
+
+    const qint64 wait = OutboxRepo::secondsUntilNextDue(db);
+    if (wait >= 0)
+        emit retryRequested(int(qMax<qint64>(wait, 5) * 1000));
+}
+
+bool LabKeyService::sendOutboxItems(const QVector<qint64>& ids, const QList<QVariantMap>& records,
+                                    int serverErrors, int& sent) {
+    QSqlDatabase db = QSqlDatabase::database(kOutboxConn);
+
+    int status = -1;
+    QString rawResp;
+    QString qerr;
+    const bool ok = m_client->uploadRuns(records, &status, &rawResp, &qerr, nullptr);
+    emit uploadFinished(ok, status, rawResp, qerr);
+
+    SendOutcome outcome = SendOutcome::Sent;
+    if (!ok) {
+        const QJsonDocument resp = QJsonDocument::fromJson(rawResp.toUtf8());
+        const bool explicitFail = resp.isObject() && resp.object().contains("success") &&
+                                  !resp.object().value("success").toBool();
+        if (status <= 0)
+            outcome = SendOutcome::NetworkError;
+        else if (isPermanentReject(status) || (status < 300 && explicitFail))
+            outcome = SendOutcome::Rejected;
         else
-            qWarning() << "[TASK][LabKey] upload FAILED ❌";
+            outcome = SendOutcome::ServerError;
+    }
 
-        emit uploadFinished(ok, status, rawResp, qerr);
-        qDebug() << "[TASK][LabKey] end";
-    });
+    switch (outcome) {
+    case SendOutcome::Sent:
+        OutboxRepo::remove(db, ids);
+        sent += ids.size();
+        return true;
+
+    case SendOutcome::Rejected:
+        if (ids.size() == 1) {
+            qWarning() << "[LabKey] outbox item" << ids.first() << "rejected, HTTP" << status << qerr
+                       << "-> dead letter";
+            OutboxRepo::markDead(db, ids, QString("rejected HTTP %1: %2").arg(status).arg(qerr));
+            return true;
+        }
+        {
+            // 一批里不知道是哪条被拒：对半拆开各自重发
+            const int half = ids.size() / 2;
+            qWarning() << "[LabKey] outbox batch of" << ids.size() << "rejected, HTTP" << status
+                       << ", split into" << half << "+" << ids.size() - half;
+            return sendOutboxItems(ids.mid(0, half), records.mid(0, half), serverErrors, sent) &&
+                   sendOutboxItems(ids.mid(half), records.mid(half), serverErrors, sent);
+        }
+
+    case SendOutcome::ServerError:
+        if (ids.size() == 1 && serverErrors + 1 >= kMaxServerErrors) {
+            qWarning() << "[LabKey] outbox item" << ids.first() << "failed" << serverErrors + 1
+                       << "times on server side, HTTP" << status << qerr << "-> dead letter";
+            OutboxRepo::markDead(db, ids, QString("gave up, HTTP %1: %2").arg(status).arg(qerr));
+            return true;
+        }
+        qWarning() << "[LabKey] outbox batch of" << ids.size() << "server error:" << status << qerr;
+        OutboxRepo::markFailed(db, ids, qerr, kBackoffBaseSec, kBackoffMaxSec, true);
+        return false;
+
+    case SendOutcome::NetworkError:
+        qWarning() << "[LabKey] outbox batch of" << ids.size() << "network error:" << qerr;
+        OutboxRepo::markFailed(db, ids, qerr, kBackoffBaseSec, kBackoffMaxSec, false);
+        return false;
+    }
+    return false;
+}
+
+// 发件箱未打开时的旧路径：直接发一条，失败即丢
+void LabKeyService::uploadDirect(const QVariantMap& record) {
+    qDebug() << "[TASK][LabKey] start";
+
+    // CSRF 由 client 缓存，过期时自动重取
+    int status = -1;
+    QString rawResp;
+    QString qerr;
+    QString sendJson;  // ★ 新增：拿到真正发出去的 JSON
+
+    bool ok = m_client->uploadRun(
+        record,
+        &status,
+        &rawResp,
+        &qerr,
+        &sendJson  // ★ 让 client 回传 JSON
+    );
+
+    // =========================
+    // 打印完整链路
+    // =========================
+    qDebug().noquote() << "[TASK][LabKey] SEND JSON =" << sendJson;
+    qDebug() << "[TASK][LabKey] HTTP status =" << status;
+    qDebug().noquote() << "[TASK][LabKey] RAW response =" << rawResp;
+
+    if (ok)
+        qDebug() << "[TASK][LabKey] upload SUCCESS ✅";
+    else
+        qWarning() << "[TASK][LabKey] upload FAILED ❌";
+
+    emit uploadFinished(ok, status, rawResp, qerr);
+    qDebug() << "[TASK][LabKey] end";
 }
@@ -0,0 +1,46 @@
+#ifndef DELTAPATCH_H
+#define DELTAPATCH_H
+
+#include <QByteArray>
+#include <QString>
+
+/*
+ * DeltaPatch
+ *
+ * 作用：
+ *   用增量包把“当前已装版本的 payload”重建成新版本 payload，省掉整包下载
+ *
+ * 增量包（zip）内容：
+ *   manifest.json
+ *     {
+ *       "from": "1.0.6", "to": "1.0.7",
+ *       "files": [
+ *         {"path": "bin/FluorescenceQuant", "op": "patch", "src": "patches/bin/FluorescenceQuant.fqp",
+ *          "base_sha256": "...", "sha256": "..."},
+ *         {"path": "qml/New.qml", "op": "add", "src": "files/qml/New.qml", "sha256": "..."},
+ *         {"path": "lib/libold.so", "op": "delete"},
+ *         {"path": "lib/libfoo.so", "op": "same", "sha256": "..."}        // 可选：校验未变文件
+ *       ]
+ *     }
+ *   patches/…、files/…、scripts/apply_update.sh（可选，同整包）
+ *   未列出的文件视为未变化，从基准目录原样拷贝
+ *
+ * 补丁格式（.fqp，bsdiff 控制流语义，各段用 zlib 压缩，与 qCompress 输出一致）：
+ *   "FQPATCH1" | u64 newSize | u32 ctrlLen | u32 diffLen | u32 extraLen | ctrl | diff | extra （小端）
+ *   ctrl 解压后为若干 (i64 add, i64 copy, i64 seek) 三元组：
+ *     new[add 字节] = old[oldPos..] + diff[..]；new[copy 字节] = extra[..]；oldPos += seek
+ */
+class DeltaPatch {
+public:
+    // deltaDir：增量包解压目录；baseDir：当前版本 payload；outDir：生成的新 payload（需为空目录）
+    static bool applyManifest(const QString& deltaDir, const QString& baseDir, const QString& outDir,
+                              QString& err);
+
+    static bool bspatch(const QByteArray& oldData, const QByteArray& patch, QByteArray& out,
+                        QString& err);
+
+    static QString fileSha256(const QString& path);
+    static QString dataSha256(const QByteArray& data);
+};
+
+#endif  // DELTAPATCH_H
@@ -0,0 +1,41 @@
+#ifndef OTADOWNLOADER_H
+#define OTADOWNLOADER_H
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <functional>
+
+/*
+ * OtaDownloader
+ *
+ * 作用：
+ *   libcurl 进程内下载升级包，边收边算 SHA-256，下完即得校验值，不再回读整包
+ *
+ * 特点：
+ *   - 写回调里累积到 kWriteChunk（256 KB）再一次 write()，SD 卡上少碎写
+ *   - 下载中的文件为 <dest>.part，旁边 <dest>.part.key 记录版本 + 校验值；
+ *     key 一致时重算已下部分的哈希后用 Range 续传，Wi-Fi 掉线不必从头来
+ *   - 服务器不认 Range（回 200）时自动截断重下
+ *   - 低速 / 断流按 kMaxAttempts 重试，abort 置位时尽快返回
+ *   - HTTPS 校验证书和主机名；环境变量 FQ_OTA_CA_FILE 指定 CA 包，
+ *     FQ_OTA_INSECURE_TLS=1 才关闭校验（默认关，仅调试用）
+ */
+class OtaDownloader {
+public:
+    using ProgressFn = std::function<void(qint64 received, qint64 total)>;
+
+    explicit OtaDownloader(const std::atomic<bool>* abort = nullptr);
+
+    // 成功时 dest 为完整文件，sha256Hex 为小写十六进制
+    bool download(const QString& url, const QString& dest, const QString& resumeKey,
+                  const ProgressFn& progress, QString& sha256Hex, QString& err);
+
+private:
+    static constexpr size_t kWriteChunk = 256 * 1024;
+    static constexpr int kMaxAttempts = 5;
+
+    const std::atomic<bool>* m_abort;
+};
+
+#endif  // OTADOWNLOADER_H
@@ -38,11 +38,17 @@ private:
     bool queryAttributes();   // 查询 TB 共享属性
     bool downloadPackage();   // 下载 OTA 包
     bool verifyPackage();     // 校验 OTA 包
+    bool stageFullPackage();  // 整包解压到备用槽
+    bool deltaApplicable() const;
+    bool stageDelta();        // 下载增量包并在备用槽重建 payload
     bool applyUpdate();       // 调用升级脚本
+    QString prepareStagingSlot();
     QString currentVersion() const { return curVersion; }
     QString currentTitle() const { return curTitle; }
-    // ===== 工具函数 =====
-    QString exec(const QString& cmd);  // 执行 shell 命令
+    // ===== 工具函数（libcurl，进程内）=====
+    static bool tbRequest(const QString& url, const QByteArray* json, QByteArray& resp, QString& err);
+    void postTelemetry(const QJsonObject& t);
+    void reportState(const QString& state, const QString& err = QString());
 
 private:
     // ===== 本地当前版本 =====
@@ -54,7 +60,15 @@ private:
     QString fwVersion;
     QString fwChecksum;
     QString fwAlgo;
+    QString fwDeltaBase;  // 增量包对应的基准版本
+    QString fwDeltaVersion;
+    QString fwDeltaChecksum;
     bool hasUpdate = false;
+    QString pkgSha256;  // 下载时随数据流算出的哈希
+
+    // ===== A/B 暂存槽（OTA_DIR/slot_a | slot_b）=====
+    QString activeSlot = "a";  // 上次成功升级所用的槽
+    QString stagedSlot;        // 本次解压的槽
     // ===== OTA 工作线程 =====
     std::thread otaThread_;
     std::mutex otaMutex_;
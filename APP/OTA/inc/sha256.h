@@ -1,36 +1,53 @@
-#ifndef _SHA256_H_
-#define _SHA256_H_
-#include <cstdint>
-#include <cstring>
-#include <fstream>
-#include <iomanip>
-#include <iostream>
-#include <sstream>
-#include <string>
-
-class SHA256 {
-public:
-    SHA256();
-
-    void update(const unsigned char* data, size_t length);
-
-    void update(const std::string& data);
-    std::string finalize();
-    // 读取文件并计算其 SHA-256
-    std::string calculateSHA256FromFile(const std::string& filePath);
-    std::string calculateSHA256FromString(const std::string& input);
-
-private:
-    void reset();
-
-    void processBlock(const unsigned char* block);
-
-    uint32_t rotr(uint32_t x, uint32_t n);
-
-    unsigned char m_buffer[64];
-    uint32_t m_hash[8];
-    size_t m_numBytes;
-    uint64_t m_numBits;
-};
-
-#endif  // _SHA256_H_
\ No newline at end of file
+#ifndef _SHA256_H_
+#define _SHA256_H_
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+ * SHA256
+ *
+ * 流式哈希：update() 任意分段喂数据，finalize() 取结果后自动复位可继续复用
+ *
+ * 后端：
+ *   - 定义 FQ_SHA256_OPENSSL（libcrypto 已链接）时走 EVP，OpenSSL 在 ARMv7 上自带 NEON 汇编
+ *   - 否则用本文件的展开版压缩函数（16 字滚动消息表，一次处理多块）
+ *
+ * 文件：hashFile() 按 64 KB 窗口 mmap 顺序读，映射失败时退回 read()
+ */
+class SHA256 {
+public:
+    static constexpr size_t kDigestSize = 32;
+
+    SHA256();
+    ~SHA256();
+    SHA256(const SHA256&) = delete;
+    SHA256& operator=(const SHA256&) = delete;
+
+    void update(const unsigned char* data, size_t length);
+    void update(const std::string& data);
+
+    // 取 32 字节摘要并复位
+    void finalize(unsigned char digest[kDigestSize]);
+    // 取小写十六进制摘要并复位
+    std::string finalize();
+
+    void reset();
+
+    static std::string toHex(const unsigned char* data, size_t length);
+    static bool hashFile(const std::string& filePath, std::string& hex);
+
+    // 读取文件并计算其 SHA-256（失败返回空串）
+    std::string calculateSHA256FromFile(const std::string& filePath);
+    std::string calculateSHA256FromString(const std::string& input);
+
+private:
+    void* m_evp = nullptr;  // EVP_MD_CTX*，为空时用内置实现
+
+    unsigned char m_buffer[64];
+    uint32_t m_hash[8];
+    size_t m_bufLen = 0;
+    uint64_t m_numBytes = 0;
+};
+
+#endif  // _SHA256_H_
@@ -7,5 +7,7 @@ private:
 public:
     ~Unzip() = default;
     static bool extractFile(const std::string &zipData, const std::string &outputDir);
+    // 直接从文件流式解压（不整包读入内存、不删原包），供 OTA A/B 暂存目录使用
+    static bool extractToDir(const std::string &zipFilePath, const std::string &outputDir, std::string &err);
 };
 #endif  // _UNZIP_H_
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include "DeltaPatch.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QtEndian>
+#include <cstring>
+
+#include "sha256.h"
+
+namespace {
+
+const char kPatchMagic[8] = {'F', 'Q', 'P', 'A', 'T', 'C', 'H', '1'};
+const int kPatchHeader = 8 + 8 + 4 + 4 + 4;
+const qint64 kMaxNewSize = 256LL * 1024 * 1024;
+
+// 拒绝绝对路径和 ..，防止增量包写出 payload 目录
+bool safeRelPath(const QString& p) {
+    if (p.isEmpty() || p.startsWith('/') || p.contains('\\'))
+        return false;
+    for (const QString& part : p.split('/')) {
+        if (part.isEmpty() || part == QLatin1String("..") || part == QLatin1String("."))
+            return false;
+    }
+    return true;
+}
+
+bool readAll(const QString& path, QByteArray& out) {
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly))
+        return false;
+    out = f.readAll();
+    return true;
+}
+
+bool writeFile(const QString& path, const QByteArray& data, QFile::Permissions perms) {
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    if (f.write(data) != data.size())
+        return false;
+    f.close();
+    if (perms)
+        f.setPermissions(perms);
+    return true;
+}
+
+bool copyFile(const QString& from, const QString& to) {
+    QDir().mkpath(QFileInfo(to).absolutePath());
+    QFile::remove(to);
+    return QFile::copy(from, to);
+}
+
+}  // namespace
+
+QString DeltaPatch::fileSha256(const QString& path) {
+    std::string hex;
+    if (!SHA256::hashFile(QFile::encodeName(path).toStdString(), hex))
+        return QString();
+    return QString::fromStdString(hex);
+}
+
+QString DeltaPatch::dataSha256(const QByteArray& data) {
+    SHA256 sha;
+    sha.update(reinterpret_cast<const unsigned char*>(data.constData()), size_t(data.size()));
+    return QString::fromStdString(sha.finalize());
+}
+
+// ===== bspatch：控制流三元组驱动 =====
+bool DeltaPatch::bspatch(const QByteArray& oldData, const QByteArray& patch, QByteArray& out,
+                         QString& err) {
+    if (patch.size() < kPatchHeader || memcmp(patch.constData(), kPatchMagic, 8) != 0) {
+        err = "bad patch header";
+        return false;
+    }
+    const uchar* h = reinterpret_cast<const uchar*>(patch.constData());
+    const qint64 newSize = qFromLittleEndian<qint64>(h + 8);
+    const quint32 ctrlLen = qFromLittleEndian<quint32>(h + 16);
+    const quint32 diffLen = qFromLittleEndian<quint32>(h + 20);
+    const quint32 extraLen = qFromLittleEndian<quint32>(h + 24);
+    if (newSize < 0 || newSize > kMaxNewSize ||
+        qint64(kPatchHeader) + ctrlLen + diffLen + extraLen != patch.size()) {
+        err = "bad patch sizes";
+        return false;
+    }
+
+    const char* p = patch.constData() + kPatchHeader;
+    const QByteArray ctrl = qUncompress(reinterpret_cast<const uchar*>(p), int(ctrlLen));
+    const QByteArray diff = qUncompress(reinterpret_cast<const uchar*>(p + ctrlLen), int(diffLen));
+    const QByteArray extra = qUncompress(reinterpret_cast<const uchar*>(p + ctrlLen + diffLen), int(extraLen));
+    if (ctrl.size() % 24 != 0) {
+        err = "bad control block";
+        return false;
+    }
+
+    out.resize(int(newSize));
+    uchar* dst = reinterpret_cast<uchar*>(out.data());
+    const uchar* src = reinterpret_cast<const uchar*>(oldData.constData());
+    const uchar* dif = reinterpret_cast<const uchar*>(diff.constData());
+    const uchar* c = reinterpret_cast<const uchar*>(ctrl.constData());
+    const qint64 oldSize = oldData.size();
+    qint64 newPos = 0;
+    qint64 oldPos = 0;
+    qint64 diffPos = 0;
+    qint64 extraPos = 0;
+
+    // 三元组来自不可信的包：长度先判负，再与“剩余空间”比较（不做 pos + len，防 int64 溢出）；
+    // seek 限制在 ±(oldSize + newSize)，oldPos 也夹在同样范围内，累加同样不会溢出
+    const qint64 seekLimit = oldSize + newSize;
+    for (int i = 0; i < ctrl.size() && newPos < newSize; i += 24) {
+        const qint64 add = qFromLittleEndian<qint64>(c + i);
+        const qint64 copy = qFromLittleEndian<qint64>(c + i + 8);
+        const qint64 seek = qFromLittleEndian<qint64>(c + i + 16);
+        if (add < 0 || copy < 0 || add > newSize - newPos || add > diff.size() - diffPos) {
+            err = "corrupt patch (add)";
+            return false;
+        }
+        for (qint64 k = 0; k < add; ++k) {
+            const qint64 o = oldPos + k;
+            dst[newPos + k] = uchar(dif[diffPos + k] + ((o >= 0 && o < oldSize) ? src[o] : 0));
+        }
+        newPos += add;
+        oldPos += add;
+        diffPos += add;
+
+        if (copy > newSize - newPos || copy > extra.size() - extraPos) {
+            err = "corrupt patch (copy)";
+            return false;
+        }
+        memcpy(dst + newPos, extra.constData() + extraPos, size_t(copy));
+        newPos += copy;
+        extraPos += copy;
+
+        if (seek < -seekLimit || seek > seekLimit) {
+            err = "corrupt patch (seek)";
+            return false;
+        }
+        oldPos += seek;
+        if (oldPos < -seekLimit || oldPos > seekLimit) {
+            err = "corrupt patch (seek)";
+            return false;
+        }
+    }
+    if (newPos != newSize) {
+        err = "patch ended early";
+        return false;
+    }
+    return true;
+}
+
+// ===== 按清单重建 payload =====
+bool DeltaPatch::applyManifest(const QString& deltaDir, const QString& baseDir, const QString& outDir,
+                               QString& err) {
+    QByteArray json;
+    if (!readAll(deltaDir + "/manifest.json", json)) {
+        err = "manifest.json not found";
+        return false;
+    }
+    const QJsonArray files = QJsonDocument::fromJson(json).object().value("files").toArray();
+    if (files.isEmpty()) {
+        err = "manifest has no files";
+        return false;
+    }
+
+    // 1. 清单中提到的路径不从基准拷贝
+    QHash<QString, QJsonObject> entries;
+    for (const QJsonValue& v : files) {
+        const QJsonObject e = v.toObject();
+        const QString path = e.value("path").toString();
+        if (!safeRelPath(path)) {
+            err = "unsafe path in manifest: " + path;
+            return false;
+        }
+        entries.insert(path, e);
+    }
+
+    // 2. 未变化的文件原样拷贝（本地 SD 卡拷贝，远比下载便宜）
+    const QDir base(baseDir);
+    QDirIterator it(baseDir, QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    int copied = 0;
+    while (it.hasNext()) {
+        const QString abs = it.next();
+        const QString rel = base.relativeFilePath(abs);
+        const auto e = entries.constFind(rel);
+        if (e != entries.constEnd() && e->value("op").toString() != QLatin1String("same"))
+            continue;
+        if (!copyFile(abs, outDir + "/" + rel)) {
+            err = "copy failed: " + rel;
+            return false;
+        }
+        ++copied;
+    }
+
+    // 3. 逐条应用，每个产出文件都校验 SHA-256
+    int patched = 0;
+    for (auto e = entries.constBegin(); e != entries.constEnd(); ++e) {
+        const QString& rel = e.key();
+        const QString op = e->value("op").toString();
+        const QString want = e->value("sha256").toString();
+        const QString basePath = baseDir + "/" + rel;
+        const QString outPath = outDir + "/" + rel;
+
+        if (op == QLatin1String("delete"))
+            continue;
+
+        if (op == QLatin1String("same")) {
+            if (!want.isEmpty() && fileSha256(outPath).compare(want, Qt::CaseInsensitive) != 0) {
+                err = "unchanged file mismatch: " + rel;
+                return false;
+            }
+            continue;
+        }
+
+        const QString srcRel = e->value("src").toString();
+        if (!safeRelPath(srcRel)) {
+            err = "unsafe src in manifest: " + srcRel;
+            return false;
+        }
+        const QString srcPath = deltaDir + "/" + srcRel;
+
+        if (op == QLatin1String("add")) {
+            if (!copyFile(srcPath, outPath) || fileSha256(outPath).compare(want, Qt::CaseInsensitive) != 0) {
+                err = "added file mismatch: " + rel;
+                return false;
+            }
+            continue;
+        }
+
+        if (op != QLatin1String("patch")) {
+            err = "unknown op " + op + " for " + rel;
+            return false;
+        }
+        QByteArray oldData;
+        QByteArray patch;
+        if (!readAll(basePath, oldData) || !readAll(srcPath, patch)) {
+            err = "missing base or patch: " + rel;
+            return false;
+        }
+        if (dataSha256(oldData).compare(e->value("base_sha256").toString(), Qt::CaseInsensitive) != 0) {
+            err = "base file differs from delta base: " + rel;
+            return false;
+        }
+        QByteArray newData;
+        QString perr;
+        if (!bspatch(oldData, patch, newData, perr)) {
+            err = rel + ": " + perr;
+            return false;
+        }
+        if (dataSha256(newData).compare(want, Qt::CaseInsensitive) != 0) {
+            err = "patched file mismatch: " + rel;
+            return false;
+        }
+        if (!writeFile(outPath, newData, QFile::permissions(basePath))) {
+            err = "write failed: " + rel;
+            return false;
+        }
+        ++patched;
+    }
+
+    qInfo() << "[OTA] delta applied: copied" << copied << "patched" << patched << "entries" << entries.size();
+    return true;
+}
@@ -0,0 +1,258 @@
+#include "OtaDownloader.h"
+
+#include <curl/curl.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <QDebug>
+#include <QFile>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "sha256.h"
+
+namespace {
+
+struct Sink {
+    CURL* curl = nullptr;
+    int fd = -1;
+    SHA256 sha;
+    std::vector<char> buf;
+    size_t chunk = 0;       // 攒到这么多再 write()
+    qint64 offset = 0;      // 已收字节（含 buf 中未落盘的）
+    qint64 resumeFrom = 0;  // 本次请求的起点
+    bool checked = false;   // 已看过响应码
+    bool ioError = false;
+    long httpCode = 0;
+    const std::atomic<bool>* abort = nullptr;
+    const OtaDownloader::ProgressFn* progress = nullptr;
+    qint64 lastReported = 0;
+};
+
+bool writeAll(int fd, const char* p, size_t n) {
+    while (n > 0) {
+        const ssize_t w = ::write(fd, p, n);
+        if (w < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        p += w;
+        n -= size_t(w);
+    }
+    return true;
+}
+
+bool flush(Sink& s) {
+    if (s.buf.empty())
+        return true;
+    const bool ok = writeAll(s.fd, s.buf.data(), s.buf.size());
+    s.buf.clear();
+    return ok;
+}
+
+// 从头丢弃（服务器不支持续传 / 续传位置非法）
+bool restartFromZero(Sink& s) {
+    s.buf.clear();
+    s.sha.reset();
+    s.offset = 0;
+    s.resumeFrom = 0;
+    return ::ftruncate(s.fd, 0) == 0;
+}
+
+size_t onWrite(char* ptr, size_t size, size_t nmemb, void* userdata) {
+    Sink* s = static_cast<Sink*>(userdata);
+    const size_t n = size * nmemb;
+
+    if (!s->checked) {
+        s->checked = true;
+        curl_easy_getinfo(s->curl, CURLINFO_RESPONSE_CODE, &s->httpCode);
+        if (s->httpCode == 200 && s->resumeFrom > 0) {
+            qInfo() << "[OTA] server ignored Range, restart from 0";
+            if (!restartFromZero(*s)) {
+                s->ioError = true;
+                return 0;
+            }
+        } else if (s->httpCode != 200 && s->httpCode != 206) {
+            return 0;  // 错误页不能写进包里
+        }
+    }
+
+    s->sha.update(reinterpret_cast<const unsigned char*>(ptr), n);
+    s->buf.insert(s->buf.end(), ptr, ptr + n);
+    s->offset += qint64(n);
+    if (s->buf.size() >= s->chunk && !flush(*s)) {
+        s->ioError = true;
+        return 0;
+    }
+    return n;
+}
+
+int onProgress(void* userdata, curl_off_t dltotal, curl_off_t, curl_off_t, curl_off_t) {
+    Sink* s = static_cast<Sink*>(userdata);
+    if (s->abort && s->abort->load())
+        return 1;
+    if (s->progress && *s->progress && s->offset - s->lastReported >= 512 * 1024) {
+        s->lastReported = s->offset;
+        (*s->progress)(s->offset, dltotal > 0 ? s->resumeFrom + qint64(dltotal) : -1);
+    }
+    return 0;
+}
+
+QByteArray readSmall(const QString& path) {
+    QFile f(path);
+    return f.open(QIODevice::ReadOnly) ? f.readAll() : QByteArray();
+}
+
+}  // namespace
+
+OtaDownloader::OtaDownloader(const std::atomic<bool>* abort) : m_abort(abort) {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+}
+
+bool OtaDownloader::download(const QString& url, const QString& dest, const QString& resumeKey,
+                             const ProgressFn& progress, QString& sha256Hex, QString& err) {
+    const QString partPath = dest + ".part";
+    const QString keyPath = dest + ".part.key";
+    const QByteArray partName = QFile::encodeName(partPath);
+
+    Sink s;
+    s.abort = m_abort;
+    s.progress = &progress;
+    s.chunk = kWriteChunk;
+    s.buf.reserve(kWriteChunk + CURL_MAX_WRITE_SIZE);
+
+    // ---- 续传：key 一致才接着用旧 .part ----
+    const bool canResume = QFile::exists(partPath) && readSmall(keyPath) == resumeKey.toUtf8();
+    if (!canResume) {
+        QFile::remove(partPath);
+        QFile k(keyPath);
+        if (!k.open(QIODevice::WriteOnly | QIODevice::Truncate) || k.write(resumeKey.toUtf8()) < 0) {
+            err = QStringLiteral("无法写入 %1").arg(keyPath);
+            return false;
+        }
+    }
+
+    s.fd = ::open(partName.constData(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (s.fd < 0) {
+        err = QStringLiteral("打开 %1 失败: %2").arg(partPath, QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    if (canResume) {
+        // 已下部分重算一遍哈希（顺序读，比重下快得多）
+        std::vector<char> chunk(kWriteChunk);
+        ssize_t n = 0;
+        while ((n = ::pread(s.fd, chunk.data(), chunk.size(), s.offset)) > 0) {
+            s.sha.update(reinterpret_cast<const unsigned char*>(chunk.data()), size_t(n));
+            s.offset += n;
+        }
+        qInfo() << "[OTA] resume from" << s.offset << "bytes";
+    }
+
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        ::close(s.fd);
+        err = QStringLiteral("curl_easy_init failed");
+        return false;
+    }
+    s.curl = curl;
+    const QByteArray urlUtf8 = url.toUtf8();
+    curl_easy_setopt(curl, CURLOPT_URL, urlUtf8.constData());
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, onWrite);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &s);
+    curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, onProgress);
+    curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &s);
+    curl_easy_setopt(curl, CURLOPT_BUFFERSIZE, 64L * 1024L);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 15L);
+    // 30 s 内平均低于 1 KB/s 视为断流，交给重试
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1024L);
+    curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, 30L);
+    // 证书默认校验：校验值和升级包走同一条连接，不验证书等于谁都能推固件。
+    // 板子上 CA 不在默认位置时用 FQ_OTA_CA_FILE 指定；FQ_OTA_INSECURE_TLS=1 仅供内网调试
+    const QByteArray caFile = qgetenv("FQ_OTA_CA_FILE");
+    if (!caFile.isEmpty())
+        curl_easy_setopt(curl, CURLOPT_CAINFO, caFile.constData());
+    if (qgetenv("FQ_OTA_INSECURE_TLS") == "1") {
+        qWarning() << "[OTA] FQ_OTA_INSECURE_TLS=1: TLS certificate verification DISABLED";
+        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
+        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0L);
+    } else {
+        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1L);
+        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 2L);
+    }
+
+    bool done = false;
+    for (int attempt = 1; attempt <= kMaxAttempts && !done; ++attempt) {
+        if (m_abort && m_abort->load()) {
+            err = QStringLiteral("已取消");
+            break;
+        }
+        s.resumeFrom = s.offset;
+        s.checked = false;
+        s.httpCode = 0;
+        curl_easy_setopt(curl, CURLOPT_RESUME_FROM_LARGE, curl_off_t(s.resumeFrom));
+
+        const CURLcode rc = curl_easy_perform(curl);
+        if (!flush(s))
+            s.ioError = true;
+        if (s.ioError) {
+            // 卡满 / 写错：已算的哈希与文件不再对应，下次从头下
+            err = QStringLiteral("写入升级包失败: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+            QFile::remove(keyPath);
+            break;
+        }
+        if (!s.checked)
+            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &s.httpCode);
+
+        if (rc == CURLE_OK && (s.httpCode == 200 || s.httpCode == 206)) {
+            done = true;
+            break;
+        }
+        if (s.httpCode == 416 && s.resumeFrom > 0) {
+            qWarning() << "[OTA] range not satisfiable at" << s.resumeFrom << ", restart from 0";
+            if (!restartFromZero(s)) {
+                err = QStringLiteral("截断升级包失败");
+                break;
+            }
+            continue;
+        }
+        if (s.httpCode >= 400) {
+            err = QStringLiteral("HTTP %1").arg(s.httpCode);
+            break;
+        }
+
+        err = QString::fromLatin1(curl_easy_strerror(rc));
+        qWarning() << "[OTA] download attempt" << attempt << "failed at" << s.offset << "bytes:" << err;
+        // 退避 2/4/8/16 s，期间也响应退出
+        const int waitMs = 1000 << qMin(attempt, 4);
+        for (int t = 0; t < waitMs && !(m_abort && m_abort->load()); t += 100)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    curl_easy_cleanup(curl);
+
+    if (!done) {
+        ::close(s.fd);
+        return false;
+    }
+    const bool synced = ::fdatasync(s.fd) == 0;
+    ::close(s.fd);
+    if (!synced) {
+        err = QStringLiteral("fdatasync failed");
+        return false;
+    }
+
+    QFile::remove(dest);
+    if (::rename(partName.constData(), QFile::encodeName(dest).constData()) != 0) {
+        err = QStringLiteral("rename failed: %1").arg(QString::fromLocal8Bit(strerror(errno)));
+        return false;
+    }
+    QFile::remove(keyPath);
+    sha256Hex = QString::fromStdString(s.sha.finalize());
+    qInfo() << "[OTA] downloaded" << s.offset << "bytes, sha256 =" << sha256Hex;
+    return true;
+}
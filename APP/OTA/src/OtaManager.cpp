@@ -6,14 +6,16 @@
 #include <QFile>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QProcess>
 #include <QStandardPaths>
 #include <QString>
 #include <QStringList>
 #include <climits>
 #include <thread>
 
-#include "sha256.h"
+#include <curl/curl.h>
+
+#include "DeltaPatch.h"
+#include "OtaDownloader.h"
 #include "unzip.h"
 // ================== OTA 调试开关 ==================
 #define OTA_DEBUG 1
@@ -45,7 +47,7 @@ OtaManager::OtaManager(QObject* parent)
     : QObject(parent) {
     OTA_LOG("OtaManager constructed");
     loadLocalVersion();
-    otaThread_ = std::thread(&OtaManager::otaThreadLoop, this);
+    // 工作线程推迟到第一次升级请求时再拉起，开机不多占一个线程
 }
 OtaManager::~OtaManager() {
     otaExit_ = true;
@@ -53,24 +55,63 @@ OtaManager::~OtaManager() {
     if (otaThread_.joinable())
         otaThread_.join();
 }
-// ================== 执行 shell 命令 ==================
-QString OtaManager::exec(const QString& cmd) {
-    OTA_LOG("exec:" << cmd);
-
-    QProcess p;
-    p.start("/bin/sh", {"-c", cmd});
-    p.waitForFinished(-1);
+// ================== ThingsBoard HTTP（libcurl，进程内） ==================
+static size_t appendBody(char* ptr, size_t size, size_t nmemb, void* userdata) {
+    static_cast<QByteArray*>(userdata)->append(ptr, int(size * nmemb));
+    return size * nmemb;
+}
 
-    QString out = QString::fromLocal8Bit(p.readAllStandardOutput());
-    QString err = QString::fromLocal8Bit(p.readAllStandardError());
+// json 为空指针时 GET，否则 POST application/json
+bool OtaManager::tbRequest(const QString& url, const QByteArray* json, QByteArray& resp, QString& err) {
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        err = "curl_easy_init failed";
+        return false;
+    }
+    const QByteArray u = url.toUtf8();
+    struct curl_slist* headers = nullptr;
+    curl_easy_setopt(curl, CURLOPT_URL, u.constData());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, appendBody);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &resp);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 20L);
+    if (json) {
+        headers = curl_slist_append(headers, "Content-Type: application/json");
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, json->constData());
+        curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, long(json->size()));
+    }
+    const CURLcode rc = curl_easy_perform(curl);
+    long code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+    curl_slist_free_all(headers);
+    curl_easy_cleanup(curl);
+    if (rc != CURLE_OK) {
+        err = QString::fromLatin1(curl_easy_strerror(rc));
+        return false;
+    }
+    if (code >= 400) {
+        err = QString("HTTP %1").arg(code);
+        return false;
+    }
+    return true;
+}
 
-    if (!out.isEmpty())
-        OTA_LOG("stdout:" << out.trimmed());
+void OtaManager::postTelemetry(const QJsonObject& t) {
+    const QByteArray body = QJsonDocument(t).toJson(QJsonDocument::Compact);
+    OTA_LOG("telemetry:" << body);
+    QByteArray resp;
+    QString err;
+    if (!tbRequest(QString("%1/api/v1/%2/telemetry").arg(TB_HOST, TB_TOKEN), &body, resp, err))
+        OTA_LOG("telemetry failed:" << err);
+}
 
+void OtaManager::reportState(const QString& state, const QString& err) {
+    QJsonObject t;
+    t["fw_state"] = state;
     if (!err.isEmpty())
-        OTA_LOG("stderr:" << err.trimmed());
-
-    return out;
+        t["fw_error"] = err;
+    postTelemetry(t);
 }
 
 // ================== 读取本地版本 ==================
@@ -101,7 +142,11 @@ bool OtaManager::loadLocalVersion() {
     // curVersion = o.value("version").toString();
     curTitle = APP_TITLE;
     curVersion = APP_VERSION;
-    OTA_LOG("local version:" << curTitle << curVersion);
+    // 版本号以编译期为准，状态文件里只取 A/B 槽位
+    QFile f(OTA_STATE_FILE);
+    if (f.open(QIODevice::ReadOnly))
+        activeSlot = QJsonDocument::fromJson(f.readAll()).object().value("slot").toString("a");
+    OTA_LOG("local version:" << curTitle << curVersion << "slot:" << activeSlot);
     return true;
 }
 
@@ -120,6 +165,7 @@ bool OtaManager::saveLocalVersion() {
     QJsonObject o;
     o["title"] = curTitle;
     o["version"] = curVersion;
+    o["slot"] = activeSlot;
 
     f.write(QJsonDocument(o).toJson(QJsonDocument::Compact));
     f.close();
@@ -253,97 +299,80 @@ void OtaManager::checkUpdate() {
 }
 void OtaManager::startUpdate() {
     emit info("升级中请勿断电");
-    QCoreApplication::processEvents();
+
     // 3. 上报 DOWNLOADING
-    exec(QString(
-             "curl -s -X POST %1/api/v1/%2/telemetry "
-             "-H \"Content-Type: application/json\" "
-             "-d '{\"fw_state\":\"DOWNLOADING\"}'")
-             .arg(TB_HOST, TB_TOKEN));
-
-    // 4. 下载固件包
-    if (!downloadPackage()) {
-        OTA_LOG("download failed");
-
-        exec(QString(
-                 "curl -s -X POST %1/api/v1/%2/telemetry "
-                 "-H \"Content-Type: application/json\" "
-                 "-d '{\"fw_state\":\"FAILED\",\"fw_error\":\"download failed\"}'")
-                 .arg(TB_HOST, TB_TOKEN));
-
-        emit error("下载失败");
-        emit finished(false);
-        return;
+    reportState("DOWNLOADING");
+
+    // 4. 有对应当前版本的增量包时先试增量，任何一步失败都退回整包
+    bool staged = false;
+    if (deltaApplicable()) {
+        staged = stageDelta();
+        if (!staged) {
+            OTA_LOG("delta failed, fallback to full package");
+            emit info("增量升级失败，改用完整升级包");
+        }
     }
 
-    // 5. 上报 DOWNLOADED
-    exec(QString(
-             "curl -s -X POST %1/api/v1/%2/telemetry "
-             "-H \"Content-Type: application/json\" "
-             "-d '{\"fw_state\":\"DOWNLOADED\"}'")
-             .arg(TB_HOST, TB_TOKEN));
-
-    // 6. 校验固件包
-    if (!verifyPackage()) {
-        OTA_LOG("verify failed");
+    if (!staged) {
+        // 4. 下载固件包（边下边算 SHA-256）
+        if (!downloadPackage()) {
+            OTA_LOG("download failed");
+            reportState("FAILED", "download failed");
+            emit error("下载失败");
+            emit finished(false);
+            return;
+        }
+    }
 
-        exec(QString(
-                 "curl -s -X POST %1/api/v1/%2/telemetry "
-                 "-H \"Content-Type: application/json\" "
-                 "-d '{\"fw_state\":\"FAILED\",\"fw_error\":\"verify failed\"}'")
-                 .arg(TB_HOST, TB_TOKEN));
+    // 5. 上报 DOWNLOADED
+    reportState("DOWNLOADED");
 
+    // 6. 校验固件包（增量路径已逐文件校验）
+    if (!staged && !verifyPackage()) {
+        OTA_LOG("verify failed");
+        reportState("FAILED", "verify failed");
         emit error("升级包校验失败");
         emit finished(false);
         return;
     }
 
     // 7. VERIFIED
-    exec(QString(
-             "curl -s -X POST %1/api/v1/%2/telemetry "
-             "-H \"Content-Type: application/json\" "
-             "-d '{\"fw_state\":\"VERIFIED\"}'")
-             .arg(TB_HOST, TB_TOKEN));
+    reportState("VERIFIED");
+
+    if (!staged && !stageFullPackage()) {
+        OTA_LOG("stage full package failed");
+        reportState("FAILED", "extract failed");
+        emit error("升级包解压失败");
+        emit finished(false);
+        return;
+    }
 
     emit info("开始升级，请勿断电");
 
     // 8. UPDATING
-    exec(QString(
-             "curl -s -X POST %1/api/v1/%2/telemetry "
-             "-H \"Content-Type: application/json\" "
-             "-d '{\"fw_state\":\"UPDATING\"}'")
-             .arg(TB_HOST, TB_TOKEN));
+    reportState("UPDATING");
 
     // 9. 执行升级脚本
     if (!applyUpdate()) {
         OTA_LOG("applyUpdate failed");
-
-        exec(QString(
-                 "curl -s -X POST %1/api/v1/%2/telemetry "
-                 "-H \"Content-Type: application/json\" "
-                 "-d '{\"fw_state\":\"FAILED\",\"fw_error\":\"apply failed\"}'")
-                 .arg(TB_HOST, TB_TOKEN));
-
+        reportState("FAILED", "apply failed");
         emit error("升级脚本执行失败");
         emit finished(false);
         return;
     }
     qDebug("startUpdate --------------------------------success");
-    // 10. 升级成功，保存本地版本
+    // 10. 升级成功，保存本地版本和当前槽位
     curTitle = fwTitle;
     curVersion = fwVersion;
+    activeSlot = stagedSlot;
     saveLocalVersion();
     qDebug("saveLocalVersion success");
     // 11. UPDATED
-    exec(QString(
-             "curl -s -X POST %1/api/v1/%2/telemetry "
-             "-H \"Content-Type: application/json\" "
-             "-d '{"
-             "\"fw_state\":\"UPDATED\","
-             "\"current_fw_title\":\"%3\","
-             "\"current_fw_version\":\"%4\""
-             "}'")
-             .arg(TB_HOST, TB_TOKEN, curTitle, curVersion));
+    QJsonObject t;
+    t["fw_state"] = "UPDATED";
+    t["current_fw_title"] = curTitle;
+    t["current_fw_version"] = curVersion;
+    postTelemetry(t);
 
     OTA_LOG("update success");
 
@@ -356,15 +385,21 @@ void OtaManager::startUpdate() {
 bool OtaManager::queryAttributes() {
     OTA_LOG("queryAttributes");
 
-    QString cmd = QString(
-                      "curl -s \"%1/api/v1/%2/attributes?"
-                      "sharedKeys=fw_title,fw_version,fw_checksum,fw_checksum_algorithm\"")
-                      .arg(TB_HOST, TB_TOKEN);
+    const QString url = QString(
+                            "%1/api/v1/%2/attributes?"
+                            "sharedKeys=fw_title,fw_version,fw_checksum,fw_checksum_algorithm,"
+                            "fw_delta_base,fw_delta_version,fw_delta_checksum")
+                            .arg(TB_HOST, TB_TOKEN);
 
-    QString json = exec(cmd);
+    QByteArray json;
+    QString err;
+    if (!tbRequest(url, nullptr, json, err)) {
+        OTA_LOG("query attributes failed:" << err);
+        return false;
+    }
     OTA_LOG("stdout:" << json);
 
-    QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
+    QJsonDocument doc = QJsonDocument::fromJson(json);
     if (!doc.isObject())
         return false;
 
@@ -378,6 +413,10 @@ bool OtaManager::queryAttributes() {
     fwVersion = shared.value("fw_version").toString();
     fwChecksum = shared.value("fw_checksum").toString();
     fwAlgo = shared.value("fw_checksum_algorithm").toString();
+    // 可选：从 fw_delta_base 升到 fw_version 的增量包（TB 上另存为一个版本）
+    fwDeltaBase = shared.value("fw_delta_base").toString();
+    fwDeltaVersion = shared.value("fw_delta_version").toString();
+    fwDeltaChecksum = shared.value("fw_delta_checksum").toString();
 
     OTA_LOG("remote version:" << fwTitle << fwVersion);
 
@@ -393,21 +432,34 @@ bool OtaManager::downloadPackage() {
     OTA_LOG("downloadPackage");
 
     QDir().mkpath(OTA_DIR);
+    pkgSha256.clear();
+
+    const QString url = QString("%1/api/v1/%2/firmware?title=%3&version=%4")
+                            .arg(TB_HOST, TB_TOKEN, fwTitle, fwVersion);
+    // 同一版本 + 校验值才允许续传上次没下完的 .part
+    const QString resumeKey = fwTitle + "|" + fwVersion + "|" + fwChecksum;
+
+    int lastPercent = -1;
+    auto progress = [this, &lastPercent](qint64 received, qint64 total) {
+        if (total <= 0)
+            return;
+        const int percent = int(received * 100 / total);
+        if (percent != lastPercent) {
+            lastPercent = percent;
+            emit info(QString("正在下载 %1%").arg(percent));
+        }
+    };
 
-    QString cmd = QString(
-                      "curl -L "
-                      "-w \"\\nhttp_code=%%{http_code} size=%%{size_download}\\n\" "
-                      "\"%1/api/v1/%2/firmware?title=%3&version=%4\" "
-                      "-o \"%5\"")
-                      .arg(TB_HOST, TB_TOKEN, fwTitle, fwVersion, OTA_PKG);
-
-    QString out = exec(cmd);
-    OTA_LOG("curl out:" << out);
+    OtaDownloader downloader(&otaExit_);
+    QString err;
+    if (!downloader.download(url, OTA_PKG, resumeKey, progress, pkgSha256, err)) {
+        OTA_LOG("download failed:" << err);
+        return false;
+    }
 
     QFile f(OTA_PKG);
     OTA_LOG("pkg exists:" << f.exists() << "size:" << f.size());
-
-    return f.exists() && f.size() > 0;
+    return f.size() > 0;
 }
 
 // ================== 校验 OTA 包 ==================
@@ -418,23 +470,19 @@ bool OtaManager::verifyPackage() {
         OTA_LOG("unsupported checksum algo:" << fwAlgo);
         return false;
     }
-    SHA256 sha;
-    // const std::string filePath = OTA_PKG.toStdString();
-
-    std::string localHash = sha.calculateSHA256FromFile(
-        OTA_PKG.toStdString());
 
-    if (localHash.empty()) {
+    // 哈希已在下载时随数据流算好，这里不再回读整包
+    if (pkgSha256.isEmpty()) {
         OTA_LOG("SHA256 calculate failed");
         return false;
     }
 
-    OTA_LOG("local  sha256:" << QString::fromStdString(localHash));
+    OTA_LOG("local  sha256:" << pkgSha256);
     OTA_LOG("remote sha256:" << fwChecksum);
 
-    if (QString::fromStdString(localHash).compare(
-            fwChecksum, Qt::CaseInsensitive) != 0) {
+    if (pkgSha256.compare(fwChecksum, Qt::CaseInsensitive) != 0) {
         OTA_LOG("SHA256 mismatch");
+        QFile::remove(OTA_PKG);  // 坏包不留，下次从头下
         return false;
     }
 
@@ -442,52 +490,129 @@ bool OtaManager::verifyPackage() {
     return true;
 }
 
-// ================== 执行升级脚本（SD 卡） ==================
+// ================== 备用槽 ==================
+// 当前槽保持上一次成功的 payload 不动，只在备用槽里清理 / 解压，失败不影响已装版本
+QString OtaManager::prepareStagingSlot() {
+    stagedSlot = (activeSlot == "a") ? "b" : "a";
+    const QString slotDir = OTA_DIR + "/slot_" + stagedSlot;
+    QDir(slotDir).removeRecursively();
+    QDir(OTA_WORK).removeRecursively();  // 旧版单目录布局遗留
+    if (!QDir().mkpath(slotDir)) {
+        OTA_LOG("mkpath failed:" << slotDir);
+        return QString();
+    }
+    return slotDir;
+}
 
-bool OtaManager::applyUpdate() {
-    OTA_LOG("applyUpdate begin");
+// ================== 增量升级 ==================
+bool OtaManager::deltaApplicable() const {
+    if (fwDeltaVersion.isEmpty() || fwDeltaBase != curVersion)
+        return false;
+    // 基准是当前槽里上次升级留下的 payload；出厂镜像没有它，只能走整包
+    return QDir(OTA_DIR + "/slot_" + activeSlot + "/payload").exists();
+}
+
+bool OtaManager::stageDelta() {
+    OTA_LOG("stageDelta" << fwDeltaBase << "->" << fwVersion << "pkg" << fwDeltaVersion);
+    emit info("正在下载增量升级包");
+
+    const QString deltaPkg = OTA_DIR + "/delta.zip";
+    const QString url = QString("%1/api/v1/%2/firmware?title=%3&version=%4")
+                            .arg(TB_HOST, TB_TOKEN, fwTitle, fwDeltaVersion);
+    const QString resumeKey = fwTitle + "|" + fwDeltaVersion + "|" + fwDeltaChecksum;
 
-    // 1. 清理并创建工作目录
-    exec("rm -rf " + OTA_WORK);
-    exec("mkdir -p " + OTA_WORK);
+    OtaDownloader downloader(&otaExit_);
+    QString sha;
+    QString err;
+    if (!downloader.download(url, deltaPkg, resumeKey, nullptr, sha, err)) {
+        OTA_LOG("delta download failed:" << err);
+        return false;
+    }
+    if (sha.compare(fwDeltaChecksum, Qt::CaseInsensitive) != 0) {
+        OTA_LOG("delta SHA256 mismatch" << sha << fwDeltaChecksum);
+        QFile::remove(deltaPkg);
+        return false;
+    }
 
-    OTA_LOG("extract zip:" << OTA_PKG << "to" << OTA_WORK);
+    const QString slotDir = prepareStagingSlot();
+    if (slotDir.isEmpty())
+        return false;
+    const QString deltaDir = slotDir + "/delta";
+    std::string zipErr;
+    const bool extracted = Unzip::extractToDir(deltaPkg.toStdString(), deltaDir.toStdString(), zipErr);
+    QFile::remove(deltaPkg);
+    if (!extracted) {
+        OTA_LOG("delta extract failed:" << QString::fromStdString(zipErr));
+        return false;
+    }
 
-    // 2. 解压 ZIP（你已有的 minizip 解压）
-    if (!Unzip::extractFile(OTA_PKG.toStdString(),
-                            OTA_WORK.toStdString())) {
-        OTA_LOG("zip extract failed");
+    // 新 payload = 当前槽 payload + 清单里的补丁 / 新增 / 删除
+    const QString baseDir = OTA_DIR + "/slot_" + activeSlot + "/payload";
+    if (!DeltaPatch::applyManifest(deltaDir, baseDir, slotDir + "/payload", err)) {
+        OTA_LOG("delta apply failed:" << err);
         return false;
     }
+    if (QDir(deltaDir + "/scripts").exists())
+        QDir().rename(deltaDir + "/scripts", slotDir + "/scripts");
+    QDir(deltaDir).removeRecursively();
+    return true;
+}
+
+// ================== 整包解压到备用槽（SD 卡） ==================
+bool OtaManager::stageFullPackage() {
+    OTA_LOG("stageFullPackage begin");
+
+    // 1. 清理备用槽
+    const QString slotDir = prepareStagingSlot();
+    if (slotDir.isEmpty())
+        return false;
+
+    OTA_LOG("extract zip:" << OTA_PKG << "to" << slotDir);
+
+    // 2. 直接从文件流式解压
+    std::string zipErr;
+    if (!Unzip::extractToDir(OTA_PKG.toStdString(), slotDir.toStdString(), zipErr)) {
+        OTA_LOG("zip extract failed:" << QString::fromStdString(zipErr));
+        return false;
+    }
+    QFile::remove(OTA_PKG);  // 已解压，释放 SD 卡空间
 
     // 3. 兼容 ZIP 多一层目录的 payload 路径
-    QString payloadDir = OTA_WORK + "/payload";
-    QString payloadDirAlt = OTA_WORK + "/update/payload";
+    QString payloadDir = slotDir + "/payload";
+    QString payloadDirAlt = slotDir + "/update/payload";
 
     if (QDir(payloadDir).exists()) {
         OTA_LOG("payload dir:" << payloadDir);
     } else if (QDir(payloadDirAlt).exists()) {
         OTA_LOG("payload dir (alt):" << payloadDirAlt);
-
-        // 把 update/payload 挪到 work/payload
-        exec(QString("mv %1 %2")
-                 .arg(payloadDirAlt)
-                 .arg(payloadDir));
+        // 同一文件系统内 rename，不拷贝
+        if (!QDir().rename(payloadDirAlt, payloadDir)) {
+            OTA_LOG("move payload failed");
+            return false;
+        }
     } else {
         OTA_LOG("payload not found");
         return false;
     }
 
     // 4. 同样兼容 scripts 目录（可选）
-    QString scriptsDir = OTA_WORK + "/scripts";
-    QString scriptsDirAlt = OTA_WORK + "/update/scripts";
+    QString scriptsDir = slotDir + "/scripts";
+    QString scriptsDirAlt = slotDir + "/update/scripts";
 
     if (!QDir(scriptsDir).exists() && QDir(scriptsDirAlt).exists()) {
         OTA_LOG("scripts dir (alt):" << scriptsDirAlt);
-        exec(QString("mv %1 %2")
-                 .arg(scriptsDirAlt)
-                 .arg(scriptsDir));
+        QDir().rename(scriptsDirAlt, scriptsDir);
     }
+    return true;
+}
+
+// ================== 执行升级脚本 ==================
+bool OtaManager::applyUpdate() {
+    OTA_LOG("applyUpdate begin");
+
+    const QString slotDir = OTA_DIR + "/slot_" + stagedSlot;
+    const QString payloadDir = slotDir + "/payload";
+    const QString scriptsDir = slotDir + "/scripts";
 
     // 5. 优先使用 ZIP 中自带的升级脚本
     QString scriptPath = OTA_SCRIPTS_DIR + "/apply_update.sh";
@@ -497,25 +622,26 @@ bool OtaManager::applyUpdate() {
         OTA_LOG("found new apply_update.sh in package");
 
         QDir().mkpath(OTA_SCRIPTS_DIR);
-
-        exec(QString("cp %1 %2/apply_update.new")
-                 .arg(newScript)
-                 .arg(OTA_SCRIPTS_DIR));
-
-        exec(QString("chmod +x %1/apply_update.new")
-                 .arg(OTA_SCRIPTS_DIR));
+        const QString staged = OTA_SCRIPTS_DIR + "/apply_update.new";
+        QFile::remove(staged);
+        if (!QFile::copy(newScript, staged)) {
+            OTA_LOG("copy apply_update.sh failed");
+            return false;
+        }
+        QFile::setPermissions(staged, QFile::permissions(staged) | QFileDevice::ExeOwner |
+                                          QFileDevice::ExeGroup | QFileDevice::ExeOther);
 
         // shell 语法检查
-        if (system(QString("sh -n %1/apply_update.new")
-                       .arg(OTA_SCRIPTS_DIR)
-                       .toLocal8Bit()
-                       .constData()) != 0) {
+        if (system(QString("sh -n %1").arg(staged).toLocal8Bit().constData()) != 0) {
             OTA_LOG("apply_update.sh syntax error");
             return false;
         }
 
-        exec(QString("mv %1/apply_update.new %1/apply_update.sh")
-                 .arg(OTA_SCRIPTS_DIR));
+        QFile::remove(scriptPath);
+        if (!QFile::rename(staged, scriptPath)) {
+            OTA_LOG("install apply_update.sh failed");
+            return false;
+        }
     } else {
         OTA_LOG("no script in package, use existing script");
     }
@@ -553,6 +679,9 @@ void OtaManager::requestStartUpdate() {
         std::lock_guard<std::mutex> lock(otaMutex_);
         otaTaskPending_ = true;
     }
+    // 只在 GUI 线程调用，不需要再加锁判断
+    if (!otaThread_.joinable())
+        otaThread_ = std::thread(&OtaManager::otaThreadLoop, this);
     otaCv_.notify_one();
 }
 void OtaManager::otaThreadLoop() {
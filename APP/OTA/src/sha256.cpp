@@ -1,163 +1,275 @@
-#include "sha256.h"
-
-SHA256::SHA256() { reset(); }
-
-void SHA256::update(const unsigned char* data, size_t length) {
-    const size_t blockSize = 64;
-    size_t index = m_numBytes % blockSize;
-    m_numBytes += length;
-    m_numBits += length * 8;
-    size_t partLen = blockSize - index;
-    size_t i = 0;
-
-    if (length >= partLen) {
-        if (index > 0) {
-            memcpy(m_buffer + index, data, partLen);
-            processBlock(m_buffer);
-            i += partLen;
-        }
-
-        for (; i + blockSize <= length; i += blockSize)
-            processBlock(data + i);
-
-        index = 0;
-    }
-
-    memcpy(m_buffer + index, data + i, length - i);
-}
-
-void SHA256::update(const std::string& data) {
-    update(reinterpret_cast<const unsigned char*>(data.c_str()), data.size());
-}
-
-std::string SHA256::finalize() {
-    const unsigned char padding[64] = {0x80};
-    unsigned char lengthBytes[8];
-
-    for (int i = 0; i < 8; ++i) {
-        lengthBytes[7 - i] = static_cast<unsigned char>((m_numBits >> (i * 8)) & 0xFF);
-    }
-
-    size_t index = m_numBytes % 64;
-    size_t padLen = (index < 56) ? (56 - index) : (120 - index);
-
-    update(padding, padLen);
-    update(lengthBytes, 8);
-
-    std::stringstream hash;
-    for (int i = 0; i < 8; ++i) {
-        hash << std::hex << std::setw(8) << std::setfill('0') << m_hash[i];
-    }
-
-    reset();
-    return hash.str();
-}
-void SHA256::reset() {
-    m_numBytes = 0;
-    m_numBits = 0;
-    m_hash[0] = 0x6A09E667;
-    m_hash[1] = 0xBB67AE85;
-    m_hash[2] = 0x3C6EF372;
-    m_hash[3] = 0xA54FF53A;
-    m_hash[4] = 0x510E527F;
-    m_hash[5] = 0x9B05688C;
-    m_hash[6] = 0x1F83D9AB;
-    m_hash[7] = 0x5BE0CD19;
-}
-
-void SHA256::processBlock(const unsigned char* block) {
-    static const uint32_t k[64] =
-        {
-            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
-            0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
-            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
-            0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
-            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
-            0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
-            0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
-            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
-            0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
-            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
-            0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
-            0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
-            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
-            0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
-
-    uint32_t w[64];
-    for (int i = 0; i < 16; ++i) {
-        w[i] = (block[i * 4 + 0] << 24) | (block[i * 4 + 1] << 16) |
-               (block[i * 4 + 2] << 8) | (block[i * 4 + 3] << 0);
-    }
-
-    for (int i = 16; i < 64; ++i) {
-        uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
-        uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
-        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
-    }
-
-    uint32_t a = m_hash[0];
-    uint32_t b = m_hash[1];
-    uint32_t c = m_hash[2];
-    uint32_t d = m_hash[3];
-    uint32_t e = m_hash[4];
-    uint32_t f = m_hash[5];
-    uint32_t g = m_hash[6];
-    uint32_t h = m_hash[7];
-
-    for (int i = 0; i < 64; ++i) {
-        uint32_t S1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
-        uint32_t ch = (e & f) ^ (~e & g);
-        uint32_t temp1 = h + S1 + ch + k[i] + w[i];
-        uint32_t S0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
-        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
-        uint32_t temp2 = S0 + maj;
-
-        h = g;
-        g = f;
-        f = e;
-        e = d + temp1;
-        d = c;
-        c = b;
-        b = a;
-        a = temp1 + temp2;
-    }
-
-    m_hash[0] += a;
-    m_hash[1] += b;
-    m_hash[2] += c;
-    m_hash[3] += d;
-    m_hash[4] += e;
-    m_hash[5] += f;
-    m_hash[6] += g;
-    m_hash[7] += h;
-}
-
-uint32_t SHA256::rotr(uint32_t x, uint32_t n) {
-    return (x >> n) | (x << (32 - n));
-}
-
-// 读取文件并计算其 SHA-256
-std::string SHA256::calculateSHA256FromFile(const std::string& filePath) {
-    std::ifstream file(filePath, std::ios::binary);
-    if (!file) {
-        std::cerr << "无法打开文件: " << filePath << std::endl;
-        return "";
-    }
-
-    char buffer[1024];
-
-    while (file.good()) {
-        file.read(buffer, sizeof(buffer));
-        update(reinterpret_cast<unsigned char*>(buffer), file.gcount());
-    }
-
-    return finalize();
-}
-
-// 计算字符串的 SHA-256
-std::string SHA256::calculateSHA256FromString(const std::string& input) {
-    update(reinterpret_cast<const unsigned char*>(input.c_str()), input.size());
-    return finalize();
-}
\ No newline at end of file
+#include "sha256.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#ifdef FQ_SHA256_OPENSSL
+#include <openssl/evp.h>
+#endif
+
+namespace {
+
+const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+const uint32_t kInit[8] = {0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+                           0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19};
+
+const size_t kFileWindow = 64 * 1024;
+
+inline uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+inline uint32_t loadBe32(const unsigned char* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+#define BSIG0(x) (rotr(x, 2) ^ rotr(x, 13) ^ rotr(x, 22))
+#define BSIG1(x) (rotr(x, 6) ^ rotr(x, 11) ^ rotr(x, 25))
+#define SSIG0(x) (rotr(x, 7) ^ rotr(x, 18) ^ ((x) >> 3))
+#define SSIG1(x) (rotr(x, 17) ^ rotr(x, 19) ^ ((x) >> 10))
+#define CH(x, y, z) ((((y) ^ (z)) & (x)) ^ (z))
+#define MAJ(x, y, z) (((x) & (y)) | ((z) & ((x) | (y))))
+
+// w[i & 15] 原存 W[i-16]，就地更新为 W[i]
+#define SCHED(i) \
+    (w[(i) & 15] += SSIG1(w[((i) + 14) & 15]) + w[((i) + 9) & 15] + SSIG0(w[((i) + 1) & 15]))
+
+#define ROUND(a, b, c, d, e, f, g, h, i, wi)                   \
+    do {                                                       \
+        const uint32_t t1 = h + BSIG1(e) + CH(e, f, g) + K[i] + (wi); \
+        d += t1;                                               \
+        h = t1 + BSIG0(a) + MAJ(a, b, c);                      \
+    } while (0)
+
+// 8 轮一组，变量轮换代替逐轮搬移
+#define ROUND8(i, W)                              \
+    ROUND(a, b, c, d, e, f, g, h, (i) + 0, W((i) + 0)); \
+    ROUND(h, a, b, c, d, e, f, g, (i) + 1, W((i) + 1)); \
+    ROUND(g, h, a, b, c, d, e, f, (i) + 2, W((i) + 2)); \
+    ROUND(f, g, h, a, b, c, d, e, (i) + 3, W((i) + 3)); \
+    ROUND(e, f, g, h, a, b, c, d, (i) + 4, W((i) + 4)); \
+    ROUND(d, e, f, g, h, a, b, c, (i) + 5, W((i) + 5)); \
+    ROUND(c, d, e, f, g, h, a, b, (i) + 6, W((i) + 6)); \
+    ROUND(b, c, d, e, f, g, h, a, (i) + 7, W((i) + 7))
+
+#define W_LOAD(i) w[(i)]
+#define W_NEXT(i) SCHED(i)
+
+void compress(uint32_t state[8], const unsigned char* data, size_t blocks) {
+    uint32_t w[16];
+    while (blocks--) {
+        for (int i = 0; i < 16; ++i)
+            w[i] = loadBe32(data + i * 4);
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+        ROUND8(0, W_LOAD);
+        ROUND8(8, W_LOAD);
+        for (int j = 16; j < 64; j += 16) {
+            // SCHED 以 j 为基准写回 w[j & 15]，K 下标同步偏移
+            ROUND8(j, W_NEXT);
+            ROUND8(j + 8, W_NEXT);
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+        data += 64;
+    }
+}
+
+#undef ROUND8
+#undef ROUND
+#undef SCHED
+#undef W_LOAD
+#undef W_NEXT
+
+bool hashFd(int fd, off_t size, SHA256& sha) {
+    for (off_t off = 0; off < size;) {
+        const size_t len = size_t(size - off < off_t(kFileWindow) ? size - off : off_t(kFileWindow));
+        void* p = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, off);
+        if (p == MAP_FAILED)
+            return false;
+        ::madvise(p, len, MADV_SEQUENTIAL);
+        sha.update(static_cast<const unsigned char*>(p), len);
+        ::munmap(p, len);
+        off += off_t(len);
+    }
+    return true;
+}
+
+bool hashFdRead(int fd, SHA256& sha) {
+    std::vector<unsigned char> buf(kFileWindow);
+    if (::lseek(fd, 0, SEEK_SET) != 0)
+        return false;
+    for (;;) {
+        const ssize_t n = ::read(fd, buf.data(), buf.size());
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        if (n == 0)
+            return true;
+        sha.update(buf.data(), size_t(n));
+    }
+}
+
+}  // namespace
+
+SHA256::SHA256() {
+#ifdef FQ_SHA256_OPENSSL
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    if (ctx && EVP_DigestInit_ex(ctx, EVP_sha256(), nullptr) == 1)
+        m_evp = ctx;
+    else if (ctx)
+        EVP_MD_CTX_free(ctx);
+#endif
+    reset();
+}
+
+SHA256::~SHA256() {
+#ifdef FQ_SHA256_OPENSSL
+    if (m_evp)
+        EVP_MD_CTX_free(static_cast<EVP_MD_CTX*>(m_evp));
+#endif
+}
+
+void SHA256::reset() {
+#ifdef FQ_SHA256_OPENSSL
+    if (m_evp)
+        EVP_DigestInit_ex(static_cast<EVP_MD_CTX*>(m_evp), EVP_sha256(), nullptr);
+#endif
+    memcpy(m_hash, kInit, sizeof(m_hash));
+    m_bufLen = 0;
+    m_numBytes = 0;
+}
+
+void SHA256::update(const unsigned char* data, size_t length) {
+#ifdef FQ_SHA256_OPENSSL
+    if (m_evp) {
+        EVP_DigestUpdate(static_cast<EVP_MD_CTX*>(m_evp), data, length);
+        return;
+    }
+#endif
+    m_numBytes += length;
+    if (m_bufLen > 0) {
+        const size_t take = length < 64 - m_bufLen ? length : 64 - m_bufLen;
+        memcpy(m_buffer + m_bufLen, data, take);
+        m_bufLen += take;
+        data += take;
+        length -= take;
+        if (m_bufLen < 64)
+            return;
+        compress(m_hash, m_buffer, 1);
+        m_bufLen = 0;
+    }
+    // 整块直接在调用方缓冲区上算，不经 m_buffer
+    const size_t blocks = length / 64;
+    if (blocks) {
+        compress(m_hash, data, blocks);
+        data += blocks * 64;
+        length -= blocks * 64;
+    }
+    memcpy(m_buffer, data, length);
+    m_bufLen = length;
+}
+
+void SHA256::update(const std::string& data) {
+    update(reinterpret_cast<const unsigned char*>(data.data()), data.size());
+}
+
+void SHA256::finalize(unsigned char digest[kDigestSize]) {
+#ifdef FQ_SHA256_OPENSSL
+    if (m_evp) {
+        unsigned int n = 0;
+        EVP_DigestFinal_ex(static_cast<EVP_MD_CTX*>(m_evp), digest, &n);
+        reset();
+        return;
+    }
+#endif
+    const uint64_t bits = m_numBytes * 8;
+    m_buffer[m_bufLen++] = 0x80;
+    if (m_bufLen > 56) {
+        memset(m_buffer + m_bufLen, 0, 64 - m_bufLen);
+        compress(m_hash, m_buffer, 1);
+        m_bufLen = 0;
+    }
+    memset(m_buffer + m_bufLen, 0, 56 - m_bufLen);
+    for (int i = 0; i < 8; ++i)
+        m_buffer[56 + i] = static_cast<unsigned char>(bits >> (56 - 8 * i));
+    compress(m_hash, m_buffer, 1);
+
+    for (int i = 0; i < 8; ++i) {
+        digest[i * 4 + 0] = static_cast<unsigned char>(m_hash[i] >> 24);
+        digest[i * 4 + 1] = static_cast<unsigned char>(m_hash[i] >> 16);
+        digest[i * 4 + 2] = static_cast<unsigned char>(m_hash[i] >> 8);
+        digest[i * 4 + 3] = static_cast<unsigned char>(m_hash[i]);
+    }
+    reset();
+}
+
+std::string SHA256::finalize() {
+    unsigned char digest[kDigestSize];
+    finalize(digest);
+    return toHex(digest, kDigestSize);
+}
+
+std::string SHA256::toHex(const unsigned char* data, size_t length) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out(length * 2, '0');
+    for (size_t i = 0; i < length; ++i) {
+        out[i * 2] = digits[data[i] >> 4];
+        out[i * 2 + 1] = digits[data[i] & 0x0F];
+    }
+    return out;
+}
+
+bool SHA256::hashFile(const std::string& filePath, std::string& hex) {
+    const int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    bool ok = ::fstat(fd, &st) == 0;
+    SHA256 sha;
+    if (ok && !hashFd(fd, st.st_size, sha)) {
+        // 某些文件系统不支持 mmap：从头改用 read()
+        sha.reset();
+        ok = hashFdRead(fd, sha);
+    }
+    ::close(fd);
+    if (ok)
+        hex = sha.finalize();
+    return ok;
+}
+
+// 读取文件并计算其 SHA-256
+std::string SHA256::calculateSHA256FromFile(const std::string& filePath) {
+    std::string hex;
+    return hashFile(filePath, hex) ? hex : std::string();
+}
+
+// 计算字符串的 SHA-256
+std::string SHA256::calculateSHA256FromString(const std::string& input) {
+    update(input);
+    return finalize();
+}
@@ -366,3 +366,24 @@ bool Unzip::extractFile(const std::string& zipFilePath, const std::string& outpu
 }
 
 #endif
+
+bool Unzip::extractToDir(const std::string& zipFilePath, const std::string& outputDir, std::string& err) {
+    void* reader = mz_zip_reader_create();
+    if (!reader) {
+        err = "mz_zip_reader_create failed";
+        return false;
+    }
+    int32_t rc = mz_zip_reader_open_file(reader, zipFilePath.c_str());
+    if (rc != MZ_OK) {
+        err = "open zip failed, err=" + std::to_string(rc);
+        mz_zip_reader_delete(&reader);
+        return false;
+    }
+    // save_all 逐条目边读边写，自动建父目录
+    rc = mz_zip_reader_save_all(reader, outputDir.c_str());
+    if (rc != MZ_OK && rc != MZ_END_OF_LIST)
+        err = "extract failed, err=" + std::to_string(rc);
+    mz_zip_reader_close(reader);
+    mz_zip_reader_delete(&reader);
+    return rc == MZ_OK || rc == MZ_END_OF_LIST;
+}
@@ -1,10 +1,10 @@
 #ifndef QRIMAGEPROVIDER_H
 #define QRIMAGEPROVIDER_H
 
+#include <QDebug>
 #include <QQuickImageProvider>
 #include <chrono>
 #include <cstdint>
-#include <cstdio>
 #include <mutex>
 
 #include "QrScanner.h"
@@ -13,6 +13,7 @@
 class TimeTick final {
 public:
     // 每次调用：打印与上次 Tick 的时间差，并更新“上次时间”
+    // 走 qDebug 的 [TimeTick] 分类（异步写、可在工程师菜单开关，默认关闭），不再 printf + fflush
     static void Tick(const char* tag = "Tick") {
         using clock = std::chrono::steady_clock;
         using namespace std::chrono;
@@ -23,19 +24,17 @@ public:
         if (!has_last_()) {
             last_() = now;
             has_last_() = true;
-            std::printf("[TimeTick] %s first\n", tag ? tag : "");
-            std::fflush(stdout);
+            qDebug("[TimeTick] %s first", tag ? tag : "");
             return;
         }
 
         const auto diff_us = duration_cast<microseconds>(now - last_()).count();
         last_() = now;
 
-        std::printf("[TimeTick] %s dt: %lld us (%.3f ms)\n",
-                    tag ? tag : "",
-                    (long long)diff_us,
-                    diff_us / 1000.0);
-        std::fflush(stdout);
+        qDebug("[TimeTick] %s dt: %lld us (%.3f ms)",
+               tag ? tag : "",
+               (long long)diff_us,
+               diff_us / 1000.0);
     }
 
     // 可选：手动重置“上次时间”
@@ -0,0 +1,48 @@
+#ifndef ADCARCHIVE_H
+#define ADCARCHIVE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QSqlDatabase>
+#include <QString>
+#include <QtGlobal>
+
+/*
+ * AdcArchive
+ *
+ * 作用：
+ *   过期样品的 adc_data 曲线移出主库，写入只追加的压缩段文件
+ *
+ * 特点：
+ *   - 段文件按月滚动：<dir>/adc-YYYYMM.seg，只追加、写完 fsync
+ *   - 主库 adc_archive 表记录 sampleNo → 段文件 + 偏移，读取时一次 seek
+ *   - 曲线原样保存（adcValues JSON 文本逐行），读出后调用方按原逻辑解析
+ *
+ * 段记录格式（小端）：
+ *   "FQA1" u32 sampleNoLen sampleNo[utf8] u32 rowCount u32 blobLen blob
+ *   blob = qCompress(各行 adcValues 以 '\n' 连接)
+ *
+ * 段内容不回收：删除历史记录时只删索引行
+ */
+class AdcArchive {
+public:
+    explicit AdcArchive(const QString& dir);
+
+    // 追加一条样品曲线；成功时返回段文件绝对路径与记录偏移
+    bool append(const QString& sampleNo, const QList<QByteArray>& rows,
+                QString& segment, qint64& offset, QString& err);
+
+    // 按 adc_archive 索引读回（adc_data 查不到时的回退）；未归档返回 false
+    static bool readTrace(QSqlDatabase& db, const QString& sampleNo, QList<QByteArray>& rows);
+
+    // 只查索引：行数 + 偏移（用作曲线版本号）
+    static bool lookup(QSqlDatabase& db, const QString& sampleNo, qint64& rows, qint64& offset);
+
+private:
+    static bool readRecord(const QString& segment, qint64 offset, const QString& sampleNo,
+                           QList<QByteArray>& rows);
+
+    QString m_dir;
+};
+
+#endif  // ADCARCHIVE_H
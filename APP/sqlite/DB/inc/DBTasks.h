@@ -1,6 +1,10 @@
 #pragma once
 #include <QString>
+#include <QStringList>
+#include <QVariant>
 #include <QVariantMap>
+#include <atomic>
+#include <memory>
 
 #include "DTO.h"
 enum class DBTaskType {
@@ -20,7 +24,9 @@ enum class DBTaskType {
     InsertHistory,
     DeleteHistory,
     ExportHistory,
+    ExportStep,  // 流式导出的下一块（自动续投到队尾）
     InsertProjectInfo,
+    ApplyJournalResult,  // 结果日志回放：按 journalUid 去重后插入 project_info + upload_outbox
     LookupQrMethodConfig,
     UpsertQrMethodConfig,
     LoadQrMethodConfigs,  // 新增：加载 qr_method_config 列表（每行注释）
@@ -28,15 +34,61 @@ enum class DBTaskType {
 
 };
 
+// 任务优先级通道：界面在等结果的走 Interactive，长任务 / 整表刷新走 Background
+enum class DBLane {
+    Interactive = 0,
+    Background = 1,
+};
+
+// 取消令牌：投递方与 DB 线程共享，置 true 后任务在下一次检查点放弃
+using DBCancelToken = std::shared_ptr<std::atomic<bool>>;
+
+inline DBCancelToken makeCancelToken() {
+    return std::make_shared<std::atomic<bool>>(false);
+}
+
 struct DBTask {
     DBTaskType type = DBTaskType::EnsureAllSchemas;
 
-    // 通用参数位（整型用 p1；字符串用 s1..s4；设置结构体用 settings）
+    // 小参数放 p1/p2/s1；大结构体（AppSettingsRow / HistoryRow / QVariantMap）放 payload
+    // QVariant 隐式共享，入队 / 出队只拷一个指针
     int p1 = 0;
-    QString s1, s2, s3, s4;
-    AppSettingsRow settings;
-    QVariantMap info;  // ✅ 新增字段：用于历史记录插入数据
-    HistoryRow history;
+    int p2 = 0;
+    QString s1;
+    QVariant payload;
+    DBCancelToken cancel;  // 可空
+
+    bool cancelled() const { return cancel && cancel->load(); }
+
+    DBLane lane() const {
+        switch (type) {
+        case DBTaskType::LoadSettings:
+        case DBTaskType::LoadUsers:
+        case DBTaskType::LoadProjects:
+        case DBTaskType::LoadHistory:
+        case DBTaskType::LoadQrMethodConfigs:
+        case DBTaskType::ExportHistory:
+        case DBTaskType::ExportStep:
+            return DBLane::Background;
+        default:
+            return DBLane::Interactive;
+        }
+    }
+
+    // 幂等的整表重载：队列里已有同类任务时只保留最新一条
+    bool coalescible() const {
+        switch (type) {
+        case DBTaskType::LoadSettings:
+        case DBTaskType::LoadUsers:
+        case DBTaskType::LoadProjects:
+        case DBTaskType::LoadHistory:  // VM 只认最后一次请求的游标
+        case DBTaskType::LoadQrMethodConfigs:
+            return true;
+        default:
+            return false;
+        }
+    }
+
     // 便捷构造
     static DBTask ensureAll() {
         DBTask t;
@@ -51,7 +103,7 @@ struct DBTask {
     static DBTask updateSettings(const AppSettingsRow& row) {
         DBTask t;
         t.type = DBTaskType::UpdateSettings;
-        t.settings = row;
+        t.payload = QVariant::fromValue(row);
         return t;
     }
 
@@ -59,7 +111,7 @@ struct DBTask {
         DBTask t;
         t.type = DBTaskType::AuthLogin;
         t.s1 = u;
-        t.s2 = p;
+        t.payload = p;
         return t;
     }
     static DBTask loadUsers() {
@@ -71,9 +123,7 @@ struct DBTask {
         DBTask t;
         t.type = DBTaskType::AddUser;
         t.s1 = u;
-        t.s2 = p;
-        t.s3 = role;
-        t.s4 = note;
+        t.payload = QStringList{p, role, note};
         return t;
     }
     static DBTask deleteUser(const QString& u) {
@@ -86,7 +136,7 @@ struct DBTask {
         DBTask t;
         t.type = DBTaskType::ResetPassword;
         t.s1 = u;
-        t.s2 = p;
+        t.payload = p;
         return t;
     }
 
@@ -105,16 +155,19 @@ struct DBTask {
     // =====================
     // 历史记录任务
     // =====================
-    static DBTask loadHistory() {
+    // p1 = beforeId（0 = 第一页），p2 = 每页条数
+    static DBTask loadHistory(int beforeId, int limit) {
         DBTask t;
         t.type = DBTaskType::LoadHistory;
+        t.p1 = beforeId;
+        t.p2 = limit;
         return t;
     }
 
     static DBTask insertHistory(const HistoryRow& row) {
         DBTask t;
         t.type = DBTaskType::InsertHistory;
-        t.history = row;  // ✅ 直接存结构体
+        t.payload = QVariant::fromValue(row);
         return t;
     }
     static DBTask deleteHistory(int id) {
@@ -124,17 +177,39 @@ struct DBTask {
         return t;
     }
 
-    static DBTask exportHistory(const QString& path) {
+    // p1 = HistoryExporter::Format，p2 = 是否带曲线
+    static DBTask exportHistory(const QString& path, int format, bool includeTraces, const DBCancelToken& token) {
         DBTask t;
         t.type = DBTaskType::ExportHistory;
         t.s1 = path;
+        t.p1 = format;
+        t.p2 = includeTraces ? 1 : 0;
+        t.cancel = token;
+        return t;
+    }
+    static DBTask exportStep(const DBCancelToken& token) {
+        DBTask t;
+        t.type = DBTaskType::ExportStep;
+        t.cancel = token;
         return t;
     }
     // —— 项目详情 —— //
     static DBTask insertProjectInfo(const QVariantMap& m) {
         DBTask t;
         t.type = DBTaskType::InsertProjectInfo;
-        t.info = m;  // 使用你已有的 info 字段
+        t.payload = m;
+        return t;
+    }
+    // upload 非空时在同一事务里写入 upload_outbox
+    static DBTask applyJournalResult(qint64 seq, const QVariantMap& m, const QVariantMap& upload) {
+        DBTask t;
+        t.type = DBTaskType::ApplyJournalResult;
+        QVariantMap info = m;
+        info.insert("journalSeq", seq);
+        QVariantMap payload;
+        payload.insert("record", info);
+        payload.insert("upload", upload);
+        t.payload = payload;
         return t;
     }
     static DBTask lookupQrMethodConfig(const QString& qrText) {  // ✅ 新增：查二维码配置任务构造器
@@ -146,7 +221,7 @@ struct DBTask {
     static DBTask upsertQrMethodConfig(const QVariantMap& cfg) {
         DBTask t;
         t.type = DBTaskType::UpsertQrMethodConfig;
-        t.info = cfg;  // 复用 info 字段承载 cfg
+        t.payload = cfg;
         return t;
     }
     static DBTask loadQrMethodConfigs() {          // 新增：加载列表任务构造器（每行注释）
@@ -4,14 +4,19 @@
 #include <QString>
 #include <QVector>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <deque>
 #include <thread>
 
 #include "DBTasks.h"
 #include "DTO.h"
 #include "HistoryRepo.h"
+class DbMaintenance;
+class HistoryExporter;
+class QFile;
 struct QrMethodConfigRow  // DB 返回行结构体（对标 ProjectRow）
 {
     int id = 0;           // 表主键 id
@@ -52,20 +57,29 @@ public:
     Q_INVOKABLE void postDeleteProject(int id);
 
     // === 历史记录 ===
-    Q_INVOKABLE void postLoadHistory();
+    Q_INVOKABLE void postLoadHistory(int beforeId = 0, int limit = 50);  // 键集分页
     Q_INVOKABLE void postInsertHistory(const HistoryRow& row);
     Q_INVOKABLE void postDeleteHistory(int id);
-    Q_INVOKABLE void postExportHistory(const QString& csvPath);
+    // 流式导出：format 见 HistoryExporter::Format；每次只处理一块，其余任务照常穿插
+    // 同一时刻只允许一个导出：上一个还没结束（含排队中）时拒绝并返回 false，不发 historyExported
+    Q_INVOKABLE bool postExportHistory(const QString& path, int format = 0, bool includeTraces = false);
+    Q_INVOKABLE void cancelExport();  // 任意线程调用，下一块时生效（尚未开始的导出直接作废）
     Q_INVOKABLE void postInsertProjectInfo(const QVariantMap& info);
+    void postApplyJournalResult(qint64 seq, const QVariantMap& info, const QVariantMap& upload);  // ResultApplier 专用
     //
     Q_INVOKABLE void postLookupQrMethodConfig(const QString& qrText);
     Q_INVOKABLE void postSaveQrMethodConfig(const QVariantMap& cfg);
 
+    // 仪器采集中不做空闲维护（任意线程调用）
+    Q_INVOKABLE void setInstrumentBusy(bool busy);
+
 signals:
     void ready();
     void errorOccurred(const QString& msg);
+    void integrityCheckFailed(const QString& report);  // 启动后首轮维护的 quick_check 不通过
 
     void projectInfoInserted(bool ok);
+    void journalResultApplied(qint64 seq, bool ok);
 
     // === Settings ===
     void settingsLoaded(const AppSettingsRow& row);
@@ -83,20 +97,28 @@ signals:
     void projectDeleted(bool ok, int id);
 
     // === History ===
-    void historyLoaded(const QVector<HistoryRow>& rows);
+    // beforeId = 请求时的游标（0 = 第一页）；hasMore = 后面可能还有
+    void historyLoaded(const QVector<HistoryRow>& rows, int beforeId, bool hasMore);
     void historyInserted(bool ok);
+    void historyRowInserted(const HistoryRow& row);  // 新插入的一行（增量更新界面）
     void historyDeleted(bool ok, int id);
     void historyExported(bool ok, const QString& path);
+    void exportProgress(qint64 written, qint64 total);
     // === 二维码识别===
     void qrMethodConfigLookedUp(const QVariantMap& result);  // ✅ 查询完成回调：result 里带 ok / error / 字段
     void saveQrMethodConfigDone(bool ok, const QString& err);
 
-    void qrMethodConfigsLoaded(const QVector<QrMethodConfigRow>& rows);  // 加载完成信号
+    void qrMethodConfigsLoaded(const QVector<QrMethodConfigRow>& rows);  // 加载完成信号（整表）
+    void qrMethodConfigUpserted(const QrMethodConfigRow& row);           // 单行新增 / 覆盖
     void qrMethodConfigDeleted(bool ok, int id);                         // 删除完成信号
 
 private:
     // === 内部逻辑 ===
     void threadLoop();
+    void enqueue(DBTask task);
+    bool takeNext(DBTask& out);  // 需持有 m_
+    bool hasPendingTasks();
+    void runIdleMaintenance();
     bool openDatabaseInThisThread();
     void closeDatabaseInThisThread();
     bool execPragmas();
@@ -113,12 +135,19 @@ private:
     bool deleteProjectInternal(int id);
 
     // === 历史记录 ===
-    bool loadHistoryInternal(QVector<HistoryRow>& out);
+    bool loadHistoryInternal(int beforeId, int limit, QVector<HistoryRow>& out);
+    void emitLastInsertedHistory();
+    void emitInsertedHistory(int id);
     bool insertHistoryInternal(const HistoryRow& row);
     bool deleteHistoryInternal(int id);
-    bool exportHistoryInternal(const QString& csvPath);
+    bool applyJournalResultInternal(const QVariantMap& info, const QVariantMap& upload, qint64& insertedId);
+    bool startExportInternal(const QString& path, int format, bool includeTraces);
+    void exportStepInternal(const DBCancelToken& token);
+    void finishExport(bool ok, const QString& err);
+    void clearExportToken();
     // === 二维码识别===
     bool lookupQrMethodConfigInternal(const QString& qrText, QVariantMap& out);  // ✅ 内部：查 qr_method_config
+    bool selectQrMethodConfigByKey(const QString& projectId, const QString& batchCode, QrMethodConfigRow& out);
 public slots:
     void postLoadQrMethodConfigs();                              // 对外：投递加载任务（你项目里一般用 invokeMethod）
     void postDeleteQrMethodConfig(int id);                       // 对外：投递删除任务
@@ -136,7 +165,27 @@ private:
 
     std::mutex m_;
     std::condition_variable cv_;
-    std::queue<DBTask> q_;
+    // 两条通道：优先取 Interactive；连续 kInteractiveBurst 个之后让 Background 走一个，避免饿死
+    static constexpr int kInteractiveBurst = 8;
+    std::deque<DBTask> lanes_[2];
+    int interactiveStreak_ = 0;
+
+    // === 流式导出状态（仅 DB 线程访问）===
+    std::unique_ptr<HistoryExporter> exporter_;
+    std::unique_ptr<QFile> exportFile_;
+    QString exportPath_;
+    DBCancelToken exportToken_;  // 当前导出（排队中或进行中），结束时清空；受 m_ 保护
+
+    // === 空闲维护（仅 DB 线程访问，instrumentBusy_ 除外）===
+    static constexpr int kIdlePollMs = 5000;           // 队列空时的唤醒周期
+    static constexpr int kIdleBeforeMaintMs = 10000;   // 最后一个任务之后至少空闲这么久
+    static constexpr int kMaintIntervalMin = 60;       // 两轮维护的间隔
+    std::unique_ptr<DbMaintenance> maint_;
+    std::atomic<bool> instrumentBusy_{false};
+    std::chrono::steady_clock::time_point lastTaskAt_;
+    std::chrono::steady_clock::time_point nextMaintAt_;
+    bool maintActive_ = true;  // 本轮还没做完（启动后第一轮立即开始）
+    bool integrityReported_ = false;
 
     AppSettingsRow pendingSettings_;
     bool hasPendingSettings_ = false;
@@ -63,5 +63,11 @@ struct HistoryRow {
     QString detectedUnit;         // 检测单位（默认 μg/kg）
     QString detectedPerson;       // 检测人员
     QString dilutionInfo;         // 稀释倍数（1倍 / 5倍）
+    double valueC = 0.0;          // C 线峰值
+    double valueT = 0.0;          // T 线峰值
+    double ratio = 0.0;           // T/C
+    int idxC = -1;                // C 峰在原始采样里的下标（-1 = 未记录，旧数据）
+    int idxT = -1;                // T 峰下标（无 T 线 / 未记录为 -1）
+    double baseline = 0.0;        // 计算 C/T 时用的本底
 };
 Q_DECLARE_METATYPE(HistoryRow)
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef DBMAINTENANCE_H
+#define DBMAINTENANCE_H
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QtGlobal>
+
+/*
+ * DbMaintenance
+ *
+ * 作用：
+ *   主库的后台维护：完整性检查、过期曲线归档、增量回收、WAL 截断
+ *
+ * 特点：
+ *   - 全部在 DB 线程执行，由 DBWorker 在“队列空闲 + 仪器未采集”时按片调用
+ *   - 每片只做一小步（归档几个样品 / 回收几百页），界面任务随时能插进来
+ *   - 一轮顺序：[启动后首轮] 完整性检查 → 归档 → 增量回收 → WAL 截断
+ *   - auto_vacuum=INCREMENTAL：新库建表前设置；旧库（NONE）较小时空闲期做一次 VACUUM 转换
+ *   - 自动 checkpoint 门限调高，平时只在空闲时 TRUNCATE，采集期间不抢 SD 卡
+ */
+class DbMaintenance {
+public:
+    struct Options {
+        QString archiveDir;          // 归档段目录
+        int retentionDays = 90;      // adc_data 保留天数，<= 0 关闭归档
+        int archiveBatch = 4;        // 每片最多归档的样品数
+        int vacuumPages = 256;       // 每片最多回收的空闲页
+        qint64 maxConvertBytes = 64LL * 1024 * 1024;  // 旧库超过这个大小不自动 VACUUM 转换
+    };
+
+    explicit DbMaintenance(const Options& opt);
+
+    // 打开连接后、建表前调用
+    static void applyPragmas(QSqlDatabase& db);
+
+    // 执行一片维护；返回 true 表示本轮还有活
+    bool runSlice(QSqlDatabase& db);
+
+    // 开始新一轮（完整性检查只在启动后第一轮做）
+    void restart();
+
+    bool integrityOk() const { return m_integrityOk; }
+    const QString& integrityReport() const { return m_integrityReport; }
+
+private:
+    enum class Stage {
+        Integrity,
+        Archive,
+        Vacuum,
+        Checkpoint,
+        Done
+    };
+
+    bool checkIntegrity(QSqlDatabase& db);
+    bool archiveSome(QSqlDatabase& db);  // true = 可能还有过期样品
+    bool vacuumSome(QSqlDatabase& db);   // true = 还有空闲页
+    void checkpoint(QSqlDatabase& db);
+
+    Options m_opt;
+    Stage m_stage = Stage::Integrity;
+    bool m_integrityOk = true;
+    QString m_integrityReport;
+    int m_archived = 0;  // 本轮累计
+    int m_freed = 0;
+};
+
+#endif  // DBMAINTENANCE_H
@@ -0,0 +1,134 @@
+#include "AdcArchive.h"
+
+#include <unistd.h>
+
+#include <QDate>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+const char kMagic[4] = {'F', 'Q', 'A', '1'};
+const quint32 kMaxBlob = 64u * 1024u * 1024u;  // 读回时的合理性上限
+
+void putU32(QByteArray& out, quint32 v) {
+    char b[4];
+    qToLittleEndian<quint32>(v, reinterpret_cast<uchar*>(b));
+    out.append(b, 4);
+}
+
+bool readU32(QFile& f, quint32& v) {
+    char b[4];
+    if (f.read(b, 4) != 4)
+        return false;
+    v = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(b));
+    return true;
+}
+
+}  // namespace
+
+AdcArchive::AdcArchive(const QString& dir) : m_dir(dir) {}
+
+bool AdcArchive::append(const QString& sampleNo, const QList<QByteArray>& rows,
+                        QString& segment, qint64& offset, QString& err) {
+    if (!QDir().mkpath(m_dir)) {
+        err = QStringLiteral("无法创建归档目录 %1").arg(m_dir);
+        return false;
+    }
+
+    QByteArray joined;
+    for (int i = 0; i < rows.size(); ++i) {
+        if (i)
+            joined.append('\n');
+        joined.append(rows.at(i));
+    }
+    const QByteArray blob = qCompress(joined, 9);
+    const QByteArray name = sampleNo.toUtf8();
+
+    QByteArray rec;
+    rec.reserve(16 + name.size() + blob.size());
+    rec.append(kMagic, 4);
+    putU32(rec, quint32(name.size()));
+    rec.append(name);
+    putU32(rec, quint32(rows.size()));
+    putU32(rec, quint32(blob.size()));
+    rec.append(blob);
+
+    segment = QDir(m_dir).absoluteFilePath(
+        QStringLiteral("adc-%1.seg").arg(QDate::currentDate().toString("yyyyMM")));
+    QFile f(segment);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        err = f.errorString();
+        return false;
+    }
+    offset = f.size();
+    const bool ok = f.write(rec) == rec.size() && f.flush() && ::fsync(f.handle()) == 0;
+    if (!ok) {
+        err = f.errorString();
+        f.resize(offset);  // 写了一半（卡满）时截回去，段里不留残记录
+        return false;
+    }
+    return true;
+}
+
+bool AdcArchive::lookup(QSqlDatabase& db, const QString& sampleNo, qint64& rows, qint64& offset) {
+    QSqlQuery q(db);
+    q.prepare("SELECT rows, offset FROM adc_archive WHERE sampleNo = ?");
+    q.addBindValue(sampleNo);
+    if (!q.exec() || !q.next())
+        return false;
+    rows = q.value(0).toLongLong();
+    offset = q.value(1).toLongLong();
+    return true;
+}
+
+bool AdcArchive::readTrace(QSqlDatabase& db, const QString& sampleNo, QList<QByteArray>& rows) {
+    QSqlQuery q(db);
+    q.prepare("SELECT segment, offset FROM adc_archive WHERE sampleNo = ?");
+    q.addBindValue(sampleNo);
+    if (!q.exec() || !q.next())
+        return false;
+    return readRecord(q.value(0).toString(), q.value(1).toLongLong(), sampleNo, rows);
+}
+
+bool AdcArchive::readRecord(const QString& segment, qint64 offset, const QString& sampleNo,
+                            QList<QByteArray>& rows) {
+    QFile f(segment);
+    if (!f.open(QIODevice::ReadOnly) || !f.seek(offset)) {
+        qWarning() << "[Archive] open failed:" << segment << f.errorString();
+        return false;
+    }
+
+    char magic[4];
+    quint32 nameLen = 0;
+    quint32 rowCount = 0;
+    quint32 blobLen = 0;
+    if (f.read(magic, 4) != 4 || memcmp(magic, kMagic, 4) != 0 || !readU32(f, nameLen) || nameLen > 256) {
+        qWarning() << "[Archive] bad record header" << segment << offset;
+        return false;
+    }
+    const QByteArray name = f.read(nameLen);
+    if (name != sampleNo.toUtf8() || !readU32(f, rowCount) || !readU32(f, blobLen) || blobLen > kMaxBlob) {
+        qWarning() << "[Archive] record mismatch" << segment << offset << sampleNo;
+        return false;
+    }
+    const QByteArray blob = f.read(blobLen);
+    if (quint32(blob.size()) != blobLen) {
+        qWarning() << "[Archive] truncated record" << segment << offset;
+        return false;
+    }
+
+    const QByteArray joined = qUncompress(blob);  // zlib 自带 adler32，损坏时返回空
+    if (joined.isEmpty() && rowCount > 0) {
+        qWarning() << "[Archive] corrupt blob" << segment << offset;
+        return false;
+    }
+    rows = joined.split('\n');
+    return true;
+}
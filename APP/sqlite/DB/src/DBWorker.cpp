@@ -1,16 +1,21 @@
 #include "DBWorker.h"
 
+#include <unistd.h>
+
 #include <QDebug>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
 #include <QSqlError>
 #include <QSqlQuery>
-#include <QTextStream>
 #include <QThread>
 
 #include "DBTasks.h"
+#include "DbMaintenance.h"
+#include "HistoryExporter.h"
 #include "HistoryRepo.h"
 #include "Migrations.h"
+#include "OutboxRepo.h"
 #include "ProjectsRepo.h"
 #include "QrRepo.h"
 #include "SettingsRepo.h"
@@ -79,17 +84,29 @@ void DBWorker::initialize() {
         }
         execPragmas();
         ensureAllSchemas();
+        {
+            DbMaintenance::Options opt;
+            opt.archiveDir = QFileInfo(dbPath_).absolutePath() + "/archive";
+            maint_.reset(new DbMaintenance(opt));
+        }
+        lastTaskAt_ = std::chrono::steady_clock::now();
         emit ready();
 
         while (running_.load()) {
             DBTask task;
             {
                 std::unique_lock<std::mutex> lk(m_);
-                cv_.wait(lk, [&] { return !q_.empty() || !running_.load(); });
+                const bool woke = cv_.wait_for(lk, std::chrono::milliseconds(kIdlePollMs), [&] {
+                    return !lanes_[0].empty() || !lanes_[1].empty() || !running_.load();
+                });
                 if (!running_.load())
                     break;
-                task = std::move(q_.front());
-                q_.pop();
+                if (!woke) {
+                    lk.unlock();
+                    runIdleMaintenance();
+                    continue;
+                }
+                takeNext(task);
             }
 
             switch (task.type) {
@@ -104,11 +121,11 @@ void DBWorker::initialize() {
                 break;
             }
             case DBTaskType::UpdateSettings:
-                emit settingsUpdated(updateSettingsInternal(task.settings));
+                emit settingsUpdated(updateSettingsInternal(task.payload.value<AppSettingsRow>()));
                 break;
             case DBTaskType::AuthLogin: {
                 QString role;
-                bool ok = authInternal(task.s1, task.s2, role);
+                bool ok = authInternal(task.s1, task.payload.toString(), role);
                 emit authResult(ok, task.s1, role);
                 break;
             }
@@ -128,8 +145,23 @@ void DBWorker::initialize() {
             }
             case DBTaskType::InsertProjectInfo: {
                 QSqlDatabase db = QSqlDatabase::database(connName_);
-                bool ok = ProjectsRepo::insertProjectInfo(db, task.info);
+                bool ok = ProjectsRepo::insertProjectInfo(db, task.payload.toMap());
                 emit projectInfoInserted(ok);
+                if (ok)
+                    emitLastInsertedHistory();
+                break;
+            }
+
+            case DBTaskType::ApplyJournalResult: {
+                const QVariantMap payload = task.payload.toMap();
+                const QVariantMap info = payload.value("record").toMap();
+                qint64 insertedId = 0;
+                const bool ok = applyJournalResultInternal(info, payload.value("upload").toMap(), insertedId);
+                emit journalResultApplied(info.value("journalSeq").toLongLong(), ok);
+                if (insertedId > 0) {
+                    emit projectInfoInserted(true);
+                    emitInsertedHistory(int(insertedId));  // 事务里还插了发件箱，last_insert_rowid 已不是这条
+                }
                 break;
             }
 
@@ -138,18 +170,32 @@ void DBWorker::initialize() {
                 break;
             case DBTaskType::LoadHistory: {
                 QVector<HistoryRow> rows;
-                bool ok = loadHistoryInternal(rows);
-                emit historyLoaded(rows);
+                bool ok = loadHistoryInternal(task.p1, task.p2, rows);
+                if (!ok)
+                    emit errorOccurred("读取历史记录失败");
+                emit historyLoaded(rows, task.p1, ok && rows.size() >= task.p2);
                 break;
             }
-            case DBTaskType::InsertHistory:
-                emit historyInserted(insertHistoryInternal(task.history));
+            case DBTaskType::InsertHistory: {
+                bool ok = insertHistoryInternal(task.payload.value<HistoryRow>());
+                emit historyInserted(ok);
+                if (ok)
+                    emitLastInsertedHistory();
                 break;
+            }
             case DBTaskType::DeleteHistory:
                 emit historyDeleted(deleteHistoryInternal(task.p1), task.p1);
                 break;
             case DBTaskType::ExportHistory:
-                emit historyExported(exportHistoryInternal(task.s1), task.s1);
+                if (!task.cancelled() && startExportInternal(task.s1, task.p1, task.p2 != 0)) {
+                    exportStepInternal(task.cancel);
+                } else {
+                    clearExportToken();
+                    emit historyExported(false, task.s1);
+                }
+                break;
+            case DBTaskType::ExportStep:
+                exportStepInternal(task.cancel);
                 break;
             case DBTaskType::LookupQrMethodConfig: {
                 QVariantMap out;                                       // 输出
@@ -161,13 +207,21 @@ void DBWorker::initialize() {
             case DBTaskType::UpsertQrMethodConfig: {
                 QString err;
                 QSqlDatabase db = QSqlDatabase::database(connName_);
-                bool ok = QrRepo::upsert(db, task.info);  // task.info 就是 cfg
+                const QVariantMap cfg = task.payload.toMap();
+                bool ok = QrRepo::upsert(db, cfg);
 
                 if (!ok) {
                     err = "写入方法配置失败";
-                    qWarning() << "[DBWorker] upsert failed" << task.info;
+                    qWarning() << "[DBWorker] upsert failed" << cfg;
+                } else {
+                    // 只回传受影响的那一行，VM 原地更新 / 插入
+                    QrMethodConfigRow row;
+                    if (selectQrMethodConfigByKey(cfg.value("projectId").toString().trimmed(),
+                                                  cfg.value("batchCode").toString().trimmed(), row))
+                        emit qrMethodConfigUpserted(row);
+                    else
+                        doLoadQrMethodConfigs();  // 查不到就退回整表刷新
                 }
-                doLoadQrMethodConfigs();
                 emit saveQrMethodConfigDone(ok, err);
                 break;
             }
@@ -184,100 +238,160 @@ void DBWorker::initialize() {
                 qWarning() << "[DB] unknown task:" << int(task.type);
                 break;
             }
+            lastTaskAt_ = std::chrono::steady_clock::now();
         }
 
+        maint_.reset();
         closeDatabaseInThisThread();
         qInfo() << "[DB] worker thread stopped";
     });
 }
 
 // === 外部任务接口 ===
+void DBWorker::enqueue(DBTask task) {
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        std::deque<DBTask>& lane = lanes_[static_cast<int>(task.lane())];
+        if (task.coalescible()) {
+            for (DBTask& pending : lane) {
+                if (pending.type == task.type) {
+                    pending = std::move(task);  // 保留排队位置，参数换成最新的
+                    return;
+                }
+            }
+        }
+        lane.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+bool DBWorker::takeNext(DBTask& out) {
+    std::deque<DBTask>& fg = lanes_[static_cast<int>(DBLane::Interactive)];
+    std::deque<DBTask>& bg = lanes_[static_cast<int>(DBLane::Background)];
+    const bool yieldToBg = !bg.empty() && interactiveStreak_ >= kInteractiveBurst;
+    if (!fg.empty() && !yieldToBg) {
+        out = std::move(fg.front());
+        fg.pop_front();
+        ++interactiveStreak_;
+        return true;
+    }
+    if (!bg.empty()) {
+        out = std::move(bg.front());
+        bg.pop_front();
+        interactiveStreak_ = 0;
+        return true;
+    }
+    return false;
+}
+
 void DBWorker::postLookupQrMethodConfig(const QString& qrText)  // ✅ 投递“查二维码配置”任务
 {
-    std::lock_guard<std::mutex> lk(m_);             // 加锁保护队列
-    q_.push(DBTask::lookupQrMethodConfig(qrText));  // 入队任务
-    cv_.notify_one();                               // 唤醒 worker 线程
+    enqueue(DBTask::lookupQrMethodConfig(qrText));
 }
 void DBWorker::postEnsureAllSchemas() {
-    std::lock_guard<std::mutex> lk(m_);
-    q_.push(DBTask{DBTaskType::EnsureAllSchemas});
-    cv_.notify_one();
+    enqueue(DBTask::ensureAll());
 }
 
 void DBWorker::postLoadSettings() {
-    std::lock_guard<std::mutex> lk(m_);
-    q_.push(DBTask{DBTaskType::LoadSettings});
-    cv_.notify_one();
+    enqueue(DBTask::loadSettings());
 }
 
 void DBWorker::postUpdateSettings(const AppSettingsRow& row) {
-    std::lock_guard<std::mutex> lk(m_);
-    DBTask t;
-    t.type = DBTaskType::UpdateSettings;
-    t.settings = row;
-    q_.push(t);
-    cv_.notify_one();
+    enqueue(DBTask::updateSettings(row));
 }
 
 // === 用户 ===
 void DBWorker::postAuthLogin(const QString& u, const QString& p) {
-    std::lock_guard<std::mutex> lk(m_);
-    q_.push(DBTask::authLogin(u, p));
-    cv_.notify_one();
+    enqueue(DBTask::authLogin(u, p));
 }
 void DBWorker::postLoadUsers() {
-    std::lock_guard<std::mutex> lk(m_);
-    q_.push(DBTask{DBTaskType::LoadUsers});
-    cv_.notify_one();
+    enqueue(DBTask::loadUsers());
 }
 void DBWorker::postAddUser(const QString& u, const QString& p, const QString& role, const QString& note) {
-    std::lock_guard<std::mutex> lk(m_);
-    q_.push(DBTask::addUser(u, p, role, note));
-    cv_.notify_one();
+    enqueue(DBTask::addUser(u, p, role, note));
 }
 void DBWorker::postDeleteUser(const QString& u) {
-    std::lock_guard<std::mutex> lk(m_);
-    q_.push(DBTask::deleteUser(u));
-    cv_.notify_one();
+    enqueue(DBTask::deleteUser(u));
 }
 void DBWorker::postResetPassword(const QString& u, const QString& p) {
-    std::lock_guard<std::mutex> lk(m_);
-    q_.push(DBTask::resetPassword(u, p));
-    cv_.notify_one();
+    enqueue(DBTask::resetPassword(u, p));
 }
 
 // === 项目 ===
 void DBWorker::postLoadProjects() {
-    std::lock_guard<std::mutex> lk(m_);
-    q_.push(DBTask::loadProjects());
-    cv_.notify_one();
+    enqueue(DBTask::loadProjects());
 }
 void DBWorker::postDeleteProject(int id) {
-    std::lock_guard<std::mutex> lk(m_);
-    q_.push(DBTask::deleteProject(id));
-    cv_.notify_one();
+    enqueue(DBTask::deleteProject(id));
 }
 
 // === 历史记录 ===
-void DBWorker::postLoadHistory() {
-    std::lock_guard<std::mutex> lk(m_);
-    q_.push(DBTask::loadHistory());
-    cv_.notify_one();
+void DBWorker::postLoadHistory(int beforeId, int limit) {
+    enqueue(DBTask::loadHistory(beforeId, qMax(1, limit)));
 }
 void DBWorker::postInsertHistory(const HistoryRow& row) {
-    std::lock_guard<std::mutex> lk(m_);
-    q_.push(DBTask::insertHistory(row));
-    cv_.notify_one();
+    enqueue(DBTask::insertHistory(row));
 }
 void DBWorker::postDeleteHistory(int id) {
+    enqueue(DBTask::deleteHistory(id));
+}
+bool DBWorker::postExportHistory(const QString& path, int format, bool includeTraces) {
+    DBCancelToken token = makeCancelToken();
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        // 覆盖令牌会让前一个导出再也取消不了：直接拒绝
+        if (exportToken_) {
+            qWarning() << "[DB] export already in progress, reject" << path;
+            return false;
+        }
+        exportToken_ = token;
+    }
+    enqueue(DBTask::exportHistory(path, format, includeTraces, token));
+    return true;
+}
+
+void DBWorker::setInstrumentBusy(bool busy) {
+    instrumentBusy_.store(busy);
+}
+
+bool DBWorker::hasPendingTasks() {
     std::lock_guard<std::mutex> lk(m_);
-    q_.push(DBTask::deleteHistory(id));
-    cv_.notify_one();
+    return !lanes_[0].empty() || !lanes_[1].empty();
+}
+
+// 队列已空一段时间且仪器未采集：连续执行维护片，有新任务进来就让出
+void DBWorker::runIdleMaintenance() {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point now = Clock::now();
+    if (!maint_ || instrumentBusy_.load() || now - lastTaskAt_ < std::chrono::milliseconds(kIdleBeforeMaintMs))
+        return;
+    if (!maintActive_) {
+        if (now < nextMaintAt_)
+            return;
+        maint_->restart();
+        maintActive_ = true;
+    }
+
+    QSqlDatabase db = QSqlDatabase::database(connName_);
+    while (running_.load() && !instrumentBusy_.load() && !hasPendingTasks()) {
+        const bool more = maint_->runSlice(db);
+        if (!maint_->integrityOk() && !integrityReported_) {
+            integrityReported_ = true;
+            emit integrityCheckFailed(maint_->integrityReport());
+            emit errorOccurred("数据库完整性检查失败");
+        }
+        if (!more) {
+            maintActive_ = false;
+            nextMaintAt_ = Clock::now() + std::chrono::minutes(kMaintIntervalMin);
+            break;
+        }
+    }
 }
-void DBWorker::postExportHistory(const QString& path) {
+
+void DBWorker::cancelExport() {
     std::lock_guard<std::mutex> lk(m_);
-    q_.push(DBTask::exportHistory(path));
-    cv_.notify_one();
+    if (exportToken_)
+        exportToken_->store(true);
 }
 
 // === 内部操作实现 ===
@@ -308,6 +422,7 @@ bool DBWorker::execPragmas() {
     if (!db.isValid() || !db.isOpen())
         return false;
     QSqlQuery q(db);
+    DbMaintenance::applyPragmas(db);  // auto_vacuum 必须在建表前设置
     q.exec("PRAGMA journal_mode=WAL;");
     q.exec("PRAGMA synchronous=FULL;");
     return true;
@@ -343,14 +458,33 @@ bool DBWorker::deleteProjectInternal(int id) {
     QSqlDatabase db = QSqlDatabase::database(connName_);
     return ProjectsRepo::deleteById(db, id);
 }
-bool DBWorker::loadHistoryInternal(QVector<HistoryRow>& out) {
+bool DBWorker::loadHistoryInternal(int beforeId, int limit, QVector<HistoryRow>& out) {
     QSqlDatabase db = QSqlDatabase::database(connName_);
-    return HistoryRepo::selectAll(db, out);
+    return HistoryRepo::selectPage(db, beforeId, limit, out);
+}
+// 刚插入的一行回读给界面，避免整表重载
+void DBWorker::emitLastInsertedHistory() {
+    QSqlDatabase db = QSqlDatabase::database(connName_);
+    QSqlQuery q(db);
+    if (!q.exec("SELECT last_insert_rowid()") || !q.next())
+        return;
+    emitInsertedHistory(q.value(0).toInt());
+}
+void DBWorker::emitInsertedHistory(int id) {
+    QSqlDatabase db = QSqlDatabase::database(connName_);
+    HistoryRow row;
+    if (HistoryRepo::selectById(db, id, row))
+        emit historyRowInserted(row);
 }
 bool DBWorker::insertHistoryInternal(const HistoryRow& row) {
     QSqlDatabase db = QSqlDatabase::database(connName_);
     return HistoryRepo::insert(db, row);
 }
+// 去重 + 插入 + 进上传发件箱见 ProjectsRepo::applyJournalResult
+bool DBWorker::applyJournalResultInternal(const QVariantMap& info, const QVariantMap& upload, qint64& insertedId) {
+    QSqlDatabase db = QSqlDatabase::database(connName_);
+    return ProjectsRepo::applyJournalResult(db, info, upload, insertedId);
+}
 bool DBWorker::deleteHistoryInternal(int id) {
     QSqlDatabase db = QSqlDatabase::database(connName_);
     return HistoryRepo::deleteById(db, id);
@@ -360,46 +494,112 @@ bool DBWorker::lookupQrMethodConfigInternal(const QString& qrText, QVariantMap&
     QSqlDatabase db = QSqlDatabase::database(connName_);  // 取本线程连接
     return QrRepo::existsByQrText(db, qrText, out);
 }
-bool DBWorker::exportHistoryInternal(const QString& csvPath) {
-    QSqlDatabase db = QSqlDatabase::database(connName_);
-    QVector<HistoryRow> rows;
-    if (!HistoryRepo::selectAll(db, rows))
+// =============================
+// 流式导出：先写 .part，完成后 fsync + 改名，U 盘拔出也不会留下半个文件冒充完整导出
+// =============================
+namespace {
+class FileSink : public ExportSink {
+public:
+    explicit FileSink(QFile& f) : f_(f) {}
+    bool write(const char* data, qint64 size) override { return f_.write(data, size) == size; }
+
+private:
+    QFile& f_;
+};
+}  // namespace
+
+bool DBWorker::startExportInternal(const QString& path, int format, bool includeTraces) {
+    if (exporter_) {
+        qWarning() << "[DB] export busy, reject" << path;
         return false;
-
-    QFile f(csvPath);
-    if (!f.open(QIODevice::WriteOnly | QIODevice::Text))
+    }
+    HistoryExporter::Options opt;
+    opt.format = static_cast<HistoryExporter::Format>(format);
+    opt.includeTraces = includeTraces;
+    opt.chunkRows = includeTraces ? 50 : 500;  // 带曲线时每行要多读 adc_data，块小一些
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    exportPath_ = path;
+    exportFile_.reset(new QFile(path + ".part"));
+    if (!exportFile_->open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "[DB] export open failed:" << exportFile_->errorString();
+        exportFile_.reset();
         return false;
+    }
 
-    QTextStream ts(&f);
-    ts << "ID,ProjectId,SampleNo,SampleSource,SampleName,StandardCurve,BatchCode,"
-          "DetectedConc,ReferenceValue,Result,DetectedTime,DetectedUnit,DetectedPerson,DilutionInfo\n";
+    exporter_.reset(new HistoryExporter(opt));
+    QSqlDatabase db = QSqlDatabase::database(connName_);
+    QString err;
+    if (!exporter_->prepare(db, err))
+        qWarning() << "[DB] export count failed:" << err;  // 只影响进度显示
+    emit exportProgress(0, exporter_->totalRows());
+    qInfo() << "[DB] export start ->" << path << "rows =" << exporter_->totalRows();
+    return true;
+}
 
-    for (const auto& r : rows) {
-        ts << r.id << "," << r.projectId << "," << r.sampleNo << ","
-           << r.sampleSource << "," << r.sampleName << "," << r.standardCurve << ","
-           << r.batchCode << "," << r.detectedConc << "," << r.referenceValue << ","
-           << r.result << "," << r.detectedTime << "," << r.detectedUnit << ","
-           << r.detectedPerson << "," << r.dilutionInfo << "\n";
+void DBWorker::exportStepInternal(const DBCancelToken& token) {
+    if (!exporter_)
+        return;
+    if (token && token->load()) {
+        finishExport(false, QStringLiteral("已取消"));
+        return;
     }
-    return true;
+
+    QSqlDatabase db = QSqlDatabase::database(connName_);
+    FileSink sink(*exportFile_);
+    QString err;
+    if (!exporter_->step(db, sink, err)) {
+        finishExport(false, err);
+        return;
+    }
+    emit exportProgress(exporter_->rowsWritten(), exporter_->totalRows());
+
+    if (exporter_->finished()) {
+        finishExport(true, QString());
+        return;
+    }
+    // 续投到后台通道队尾：界面任务总是先执行
+    enqueue(DBTask::exportStep(token));
 }
-void DBWorker::postInsertProjectInfo(const QVariantMap& info) {
+
+void DBWorker::finishExport(bool ok, const QString& err) {
+    const QString partPath = exportFile_->fileName();
+    if (ok) {
+        ok = exportFile_->flush() && ::fsync(exportFile_->handle()) == 0;
+    }
+    exportFile_->close();
+    if (ok) {
+        QFile::remove(exportPath_);
+        ok = QFile::rename(partPath, exportPath_);
+    }
+    if (!ok)
+        QFile::remove(partPath);
+
+    qInfo() << "[DB] export" << (ok ? "done" : "failed") << exportPath_
+            << "rows =" << exporter_->rowsWritten() << err;
+    exporter_.reset();
+    exportFile_.reset();
+    clearExportToken();  // 先放行，收到 historyExported 时就能发起下一次导出
+    emit historyExported(ok, exportPath_);
+}
+
+void DBWorker::clearExportToken() {
     std::lock_guard<std::mutex> lk(m_);
-    q_.push(DBTask::insertProjectInfo(info));
-    cv_.notify_one();
+    exportToken_.reset();
+}
+
+void DBWorker::postInsertProjectInfo(const QVariantMap& info) {
+    enqueue(DBTask::insertProjectInfo(info));
+}
+void DBWorker::postApplyJournalResult(qint64 seq, const QVariantMap& info, const QVariantMap& upload) {
+    enqueue(DBTask::applyJournalResult(seq, info, upload));
 }
 void DBWorker::postSaveQrMethodConfig(const QVariantMap& cfg) {
-    std::lock_guard<std::mutex> lk(m_);
-    q_.push(DBTask::upsertQrMethodConfig(cfg));
-    cv_.notify_one();
+    enqueue(DBTask::upsertQrMethodConfig(cfg));
 }
 void DBWorker::postLoadQrMethodConfigs()  // 对外：投递加载列表任务（每行注释）
 {
-    {                                            // 锁作用域开始（每行注释）
-        std::lock_guard<std::mutex> lk(m_);      // 加锁保护队列（每行注释）
-        q_.push(DBTask::loadQrMethodConfigs());  // 入队：加载列表任务（每行注释）
-    }  // 解锁（每行注释）
-    cv_.notify_one();  // 唤醒 DB 线程（每行注释）
+    enqueue(DBTask::loadQrMethodConfigs());  // 入队：加载列表任务（后台通道，重复请求合并）
 }
 
 // =====================
@@ -407,11 +607,7 @@ void DBWorker::postLoadQrMethodConfigs()  // 对外：投递加载列表任务
 // =====================
 void DBWorker::postDeleteQrMethodConfig(int id)  // 对外：投递删除任务（每行注释）
 {
-    {                                               // 锁作用域开始（每行注释）
-        std::lock_guard<std::mutex> lk(m_);         // 加锁保护队列（每行注释）
-        q_.push(DBTask::deleteQrMethodConfig(id));  // 入队：删除任务（每行注释）
-    }  // 解锁（每行注释）
-    cv_.notify_one();  // 唤醒 DB 线程（每行注释）
+    enqueue(DBTask::deleteQrMethodConfig(id));  // 入队：删除任务（每行注释）
 }
 
 // =====================
@@ -419,11 +615,46 @@ void DBWorker::postDeleteQrMethodConfig(int id)  // 对外：投递删除任务
 // =====================
 void DBWorker::postInsertQrMethodConfigInfo(const QVariantMap& info)  // 对外：投递插入/更新任务（每行注释）
 {
-    {                                                 // 锁作用域开始（每行注释）
-        std::lock_guard<std::mutex> lk(m_);           // 加锁保护队列（每行注释）
-        q_.push(DBTask::upsertQrMethodConfig(info));  // 入队：复用你已有 UpsertQrMethodConfig（每行注释）
-    }  // 解锁（每行注释）
-    cv_.notify_one();  // 唤醒 DB 线程（每行注释）
+    enqueue(DBTask::upsertQrMethodConfig(info));  // 入队：复用你已有 UpsertQrMethodConfig（每行注释）
+}
+
+// 列顺序与 readQrMethodConfigRow() 取值一致
+static const char* const kQrMethodConfigColumns =
+    "id, projectName, batchCode, updated_at, methodData, temperature, timeSec, C1, T1, C2, T2";
+
+static QrMethodConfigRow readQrMethodConfigRow(const QSqlQuery& q) {
+    QrMethodConfigRow r;
+    r.id = q.value(0).toInt();              // id
+    r.projectName = q.value(1).toString();  // projectName
+    r.batchCode = q.value(2).toString();    // batchCode
+    r.updatedAt = q.value(3).toString();    // updated_at
+    r.methodData = q.value(4).toString();   // ★ FourPL JSON
+    r.temperature = q.value(5).toDouble();
+    r.timeSec = q.value(6).toInt();
+    r.C1 = q.value(7).toInt();   // C1
+    r.T1 = q.value(8).toInt();   // T1
+    r.C2 = q.value(9).toInt();   // C2
+    r.T2 = q.value(10).toInt();  // T2
+    return r;
+}
+
+// =====================
+// DB线程：按唯一键取回一行（upsert 之后回传给 VM）
+// =====================
+bool DBWorker::selectQrMethodConfigByKey(const QString& projectId, const QString& batchCode, QrMethodConfigRow& out) {
+    QSqlDatabase db = QSqlDatabase::database(connName_);
+    QSqlQuery q(db);
+    q.prepare(QStringLiteral("SELECT %1 FROM qr_method_config WHERE projectId = :pid AND batchCode = :bc")
+                  .arg(QLatin1String(kQrMethodConfigColumns)));
+    q.bindValue(":pid", projectId);
+    q.bindValue(":bc", batchCode);
+    if (!q.exec() || !q.next()) {
+        qWarning() << "[DB] selectQrMethodConfigByKey failed:" << projectId << batchCode
+                   << q.lastError().text();
+        return false;
+    }
+    out = readQrMethodConfigRow(q);
+    return true;
 }
 
 // =====================
@@ -440,23 +671,11 @@ void DBWorker::doLoadQrMethodConfigs() {
         return;
     }
 
-    // === 2. 构造 SQL（字段必须查全，顺序必须和下面取值一致） ===
-    const QString sql =
-        "SELECT "
-        "  id, "           // 0  方法配置 id
-        "  projectName, "  // 1  项目名称
-        "  batchCode, "    // 2  批次编码
-        "  updated_at, "   // 3  更新时间
-        "  methodData, "   // 4  ★ FourPL JSON
-        "  temperature, "  // 5  温度
-        "  timeSec, "      // 6  时间
-        "  C1, "           // 7  C1
-        "  T1, "           // 8  T1
-        "  C2, "           // 9  C2
-        "  T2 "            // 10  T2
-        "FROM qr_method_config "
-        "ORDER BY id DESC";
+    // === 2. 构造 SQL（字段见 kQrMethodConfigColumns） ===
+    const QString sql = QStringLiteral("SELECT %1 FROM qr_method_config ORDER BY id DESC")
+                            .arg(QLatin1String(kQrMethodConfigColumns));
     QSqlQuery q(db);
+    q.setForwardOnly(true);
 
     // === 3. 执行 SQL ===
     if (!q.exec(sql)) {
@@ -466,35 +685,10 @@ void DBWorker::doLoadQrMethodConfigs() {
         return;
     }
 
-    // === 4. 逐行读取结果，填充 QrMethodConfigRow ===
-    while (q.next()) {
-        QrMethodConfigRow r;
-
-        r.id = q.value(0).toInt();              // id
-        r.projectName = q.value(1).toString();  // projectName
-        r.batchCode = q.value(2).toString();    // batchCode
-        r.updatedAt = q.value(3).toString();    // updated_at
-        r.methodData = q.value(4).toString();   // ★ FourPL JSON
-        r.temperature = q.value(5).toDouble();
-        r.timeSec = q.value(6).toDouble();
-        r.C1 = q.value(7).toInt();   // C1
-        r.T1 = q.value(8).toInt();   // T1
-        r.C2 = q.value(9).toInt();   // C2
-        r.T2 = q.value(10).toInt();  // T2
-
-        // // === 调试日志（建议保留，定位 DB 问题非常有用） ===
-        qDebug() << "[DBWorker] method row:"
-                 << "id=" << r.id
-                 << "methodData.len=" << r.methodData.length()
-                 << "C1=" << r.C1
-                 << "T1=" << r.T1
-                 << "C2=" << r.C2
-                 << "T2=" << r.T2
-                 << "temperature=" << r.temperature
-                 << "time_Sec=" << r.timeSec;
-
-        rows.push_back(r);
-    }
+    // === 4. 逐行读取结果 ===
+    while (q.next())
+        rows.push_back(readQrMethodConfigRow(q));
+    qInfo() << "[DB] qr_method_config loaded" << rows.size() << "rows";
 
     // === 5. 发信号给 ViewModel（跨线程 QueuedConnection） ===
     emit qrMethodConfigsLoaded(rows);
@@ -522,8 +716,7 @@ void DBWorker::doDeleteQrMethodConfig(int id)  // DB线程：真正执行删除
                    << q.lastError().text()                   // 错误详情（每行注释）
                    << "id =" << id;                          // 打印 id（每行注释）
     }
-    doLoadQrMethodConfigs();
-    emit qrMethodConfigDeleted(ok, id);  // 通知结果（每行注释）
+    emit qrMethodConfigDeleted(ok, id);  // 通知结果：VM 只删这一行（每行注释）
 }
 
 // =====================
@@ -0,0 +1,217 @@
+#include "DbMaintenance.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QList>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariant>
+
+#include "AdcArchive.h"
+
+namespace {
+
+qint64 pragmaInt(QSqlDatabase& db, const char* sql) {
+    QSqlQuery q(db);
+    if (!q.exec(QString::fromLatin1(sql)) || !q.next())
+        return -1;
+    return q.value(0).toLongLong();
+}
+
+}  // namespace
+
+DbMaintenance::DbMaintenance(const Options& opt) : m_opt(opt) {}
+
+void DbMaintenance::applyPragmas(QSqlDatabase& db) {
+    QSqlQuery q(db);
+    // 只对还没建表的新库生效；旧库由 vacuumSome() 视大小转换
+    q.exec("PRAGMA auto_vacuum=INCREMENTAL;");
+    // 默认 1000 页就在提交时 checkpoint；调到 4096 页只作兜底，平时由空闲维护截断
+    q.exec("PRAGMA wal_autocheckpoint=4096;");
+}
+
+void DbMaintenance::restart() {
+    if (m_stage == Stage::Done)
+        m_stage = Stage::Archive;
+    m_archived = 0;
+    m_freed = 0;
+}
+
+bool DbMaintenance::runSlice(QSqlDatabase& db) {
+    switch (m_stage) {
+    case Stage::Integrity:
+        checkIntegrity(db);
+        m_stage = Stage::Archive;
+        return true;
+    case Stage::Archive:
+        if (!archiveSome(db))
+            m_stage = Stage::Vacuum;
+        return true;
+    case Stage::Vacuum:
+        if (!vacuumSome(db))
+            m_stage = Stage::Checkpoint;
+        return true;
+    case Stage::Checkpoint:
+        checkpoint(db);
+        m_stage = Stage::Done;
+        qInfo() << "[DBMaint] round done, archived =" << m_archived << "samples, freed =" << m_freed << "pages";
+        return false;
+    case Stage::Done:
+        break;
+    }
+    return false;
+}
+
+// ===== 完整性检查 =====
+// quick_check 不比对索引内容，耗时约为 integrity_check 的几分之一，足以发现页损坏
+bool DbMaintenance::checkIntegrity(QSqlDatabase& db) {
+    QElapsedTimer t;
+    t.start();
+    QSqlQuery q(db);
+    QStringList problems;
+    if (!q.exec("PRAGMA quick_check(20);")) {
+        problems << q.lastError().text();
+    } else {
+        while (q.next()) {
+            const QString line = q.value(0).toString();
+            if (line != QLatin1String("ok"))
+                problems << line;
+        }
+    }
+    m_integrityOk = problems.isEmpty();
+    m_integrityReport = m_integrityOk ? QStringLiteral("ok") : problems.join('\n');
+    if (m_integrityOk)
+        qInfo() << "[DBMaint] quick_check ok," << t.elapsed() << "ms";
+    else
+        qCritical() << "[DBMaint] quick_check FAILED:" << m_integrityReport;
+    return m_integrityOk;
+}
+
+// ===== 过期曲线归档 =====
+bool DbMaintenance::archiveSome(QSqlDatabase& db) {
+    if (m_opt.retentionDays <= 0 || m_opt.archiveDir.isEmpty())
+        return false;
+
+    const QString cutoff = QDateTime::currentDateTime()
+                               .addDays(-m_opt.retentionDays)
+                               .toString("yyyy-MM-dd HH:mm:ss");
+    QStringList samples;
+    {
+        // EXISTS 走 idx_adc_sample，不扫 adc_data 全表
+        QSqlQuery q(db);
+        q.prepare(R"SQL(
+SELECT p.sampleNo FROM project_info p
+WHERE p.detectedTime < :cutoff AND p.sampleNo <> ''
+  AND EXISTS(SELECT 1 FROM adc_data a WHERE a.sampleNo = p.sampleNo)
+GROUP BY p.sampleNo ORDER BY MIN(p.id) ASC LIMIT :n
+)SQL");
+        q.bindValue(":cutoff", cutoff);
+        q.bindValue(":n", m_opt.archiveBatch);
+        if (!q.exec()) {
+            qWarning() << "[DBMaint] select expired failed:" << q.lastError().text();
+            return false;
+        }
+        while (q.next())
+            samples << q.value(0).toString();
+    }
+    if (samples.isEmpty())
+        return false;
+
+    AdcArchive archive(m_opt.archiveDir);
+    for (const QString& sampleNo : samples) {
+        QList<QByteArray> rows;
+        {
+            QSqlQuery q(db);
+            q.setForwardOnly(true);
+            q.prepare("SELECT adcValues FROM adc_data WHERE sampleNo = ? ORDER BY id ASC");
+            q.addBindValue(sampleNo);
+            if (!q.exec())
+                return false;
+            while (q.next())
+                rows << q.value(0).toByteArray();
+        }
+
+        // 先落段文件再改库：中途掉电最多在段里多一条没人引用的记录
+        QString segment;
+        qint64 offset = 0;
+        QString err;
+        if (!archive.append(sampleNo, rows, segment, offset, err)) {
+            qWarning() << "[DBMaint] archive write failed:" << sampleNo << err;
+            return false;  // 卡满 / 只读：本轮不再尝试
+        }
+
+        db.transaction();
+        QSqlQuery ins(db);
+        ins.prepare(R"SQL(
+INSERT OR REPLACE INTO adc_archive(sampleNo, segment, offset, rows, archivedAt)
+VALUES(?, ?, ?, ?, datetime('now','localtime'))
+)SQL");
+        ins.addBindValue(sampleNo);
+        ins.addBindValue(segment);
+        ins.addBindValue(offset);
+        ins.addBindValue(rows.size());
+        QSqlQuery del(db);
+        del.prepare("DELETE FROM adc_data WHERE sampleNo = ?");
+        del.addBindValue(sampleNo);
+        if (!ins.exec() || !del.exec() || !db.commit()) {
+            qWarning() << "[DBMaint] archive commit failed:" << sampleNo << ins.lastError().text()
+                       << del.lastError().text();
+            db.rollback();
+            return false;
+        }
+        ++m_archived;
+    }
+    return samples.size() >= m_opt.archiveBatch;
+}
+
+// ===== 增量回收 =====
+bool DbMaintenance::vacuumSome(QSqlDatabase& db) {
+    const qint64 mode = pragmaInt(db, "PRAGMA auto_vacuum;");
+    if (mode == 0) {
+        // 旧库：auto_vacuum 只能靠一次完整 VACUUM 切换，需要一份库大小的临时空间
+        const qint64 bytes = pragmaInt(db, "PRAGMA page_count;") * pragmaInt(db, "PRAGMA page_size;");
+        if (bytes > m_opt.maxConvertBytes) {
+            qInfo() << "[DBMaint] auto_vacuum=NONE, db" << bytes / (1024 * 1024)
+                    << "MB too large to convert in place; skip";
+            return false;
+        }
+        QElapsedTimer t;
+        t.start();
+        QSqlQuery q(db);
+        const bool ok = q.exec("PRAGMA auto_vacuum=INCREMENTAL;") && q.exec("VACUUM;");
+        qInfo() << "[DBMaint] convert to auto_vacuum=INCREMENTAL" << (ok ? "ok" : "failed")
+                << t.elapsed() << "ms" << q.lastError().text();
+        return false;
+    }
+    if (mode != 2)
+        return false;
+
+    const qint64 freeBefore = pragmaInt(db, "PRAGMA freelist_count;");
+    if (freeBefore <= 0)
+        return false;
+    QSqlQuery q(db);
+    if (!q.exec(QStringLiteral("PRAGMA incremental_vacuum(%1);").arg(m_opt.vacuumPages))) {
+        qWarning() << "[DBMaint] incremental_vacuum failed:" << q.lastError().text();
+        return false;
+    }
+    // incremental_vacuum 每回收一页返回一行，需取完才真正执行完
+    while (q.next()) {
+    }
+    const qint64 freeAfter = pragmaInt(db, "PRAGMA freelist_count;");
+    m_freed += int(freeBefore - freeAfter);
+    return freeAfter > 0 && freeAfter < freeBefore;
+}
+
+// ===== WAL 截断 =====
+void DbMaintenance::checkpoint(QSqlDatabase& db) {
+    QSqlQuery q(db);
+    if (!q.exec("PRAGMA wal_checkpoint(TRUNCATE);") || !q.next()) {
+        qWarning() << "[DBMaint] wal_checkpoint failed:" << q.lastError().text();
+        return;
+    }
+    // busy / WAL 总帧数 / 已写回帧数
+    if (q.value(0).toInt() != 0)
+        qInfo() << "[DBMaint] wal_checkpoint busy, frames =" << q.value(1).toInt();
+}
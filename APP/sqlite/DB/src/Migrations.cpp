@@ -254,6 +254,34 @@ CREATE TABLE IF NOT EXISTS adc_data(
     avgValue   REAL NOT NULL DEFAULT 0.0
 );
 )SQL");
+    // 按样品取曲线（详情 / 导出带曲线）走索引，不再全表扫描
+    execOne(q, "CREATE INDEX IF NOT EXISTS idx_adc_sample ON adc_data(sampleNo, id);");
+    // 已移出主库的曲线：sampleNo → 归档段文件 + 偏移（见 AdcArchive）
+    execOne(q, R"SQL(
+CREATE TABLE IF NOT EXISTS adc_archive(
+    sampleNo    TEXT PRIMARY KEY,
+    segment     TEXT NOT NULL,
+    offset      INTEGER NOT NULL,
+    rows        INTEGER NOT NULL DEFAULT 0,
+    archivedAt  TEXT NOT NULL DEFAULT (datetime('now','localtime'))
+);
+)SQL");
+
+    // ===== upload_outbox：LabKey 上传发件箱 =====
+    execOne(q, R"SQL(
+CREATE TABLE IF NOT EXISTS upload_outbox(
+    id             INTEGER PRIMARY KEY AUTOINCREMENT,
+    payload        TEXT NOT NULL,
+    attempts       INTEGER NOT NULL DEFAULT 0,
+    nextAttemptAt  INTEGER NOT NULL DEFAULT 0,
+    lastError      TEXT,
+    createdAt      TEXT NOT NULL DEFAULT (datetime('now','localtime'))
+);
+)SQL");
+    // 服务端出错次数（断网不计）与死信时间：拒收 / 重试到上限的条目不再堵住后面的
+    execIgnore(q, "ALTER TABLE upload_outbox ADD COLUMN serverErrors INTEGER NOT NULL DEFAULT 0;");
+    execIgnore(q, "ALTER TABLE upload_outbox ADD COLUMN deadAt TEXT;");
+    execOne(q, "CREATE INDEX IF NOT EXISTS idx_outbox_due ON upload_outbox(nextAttemptAt);");
 
     qInfo() << "[MIGRATE] v1 done ✅";
 
@@ -281,5 +309,17 @@ CREATE TABLE IF NOT EXISTS qr_method_config(
     execOne(q, "CREATE INDEX IF NOT EXISTS idx_qmc_batch ON qr_method_config(batchCode);");
     execOne(q, "CREATE INDEX IF NOT EXISTS idx_qmc_upd   ON qr_method_config(updated_at);");
     migrateProjectInfo(db);
+    // 检测时的 C/T 峰位（曲线下标，-1 = 无）与本底：详情页 / Web 曲线直接用，不再重算
+    execIgnore(q, "ALTER TABLE project_info ADD COLUMN idxC INTEGER NOT NULL DEFAULT -1;");
+    execIgnore(q, "ALTER TABLE project_info ADD COLUMN idxT INTEGER NOT NULL DEFAULT -1;");
+    execIgnore(q, "ALTER TABLE project_info ADD COLUMN baseline REAL NOT NULL DEFAULT 0.0;");
+    // 结果日志（ResultJournal）：journalUid 每条结果唯一，回放时按它去重；
+    // journalSeq 日志截断后会重复，只留作排查用，不再唯一。放在重建之后，避免被旧表结构覆盖
+    execIgnore(q, "ALTER TABLE project_info ADD COLUMN journalSeq INTEGER;");
+    execIgnore(q, "ALTER TABLE project_info ADD COLUMN journalUid TEXT;");
+    execOne(q, "DROP INDEX IF EXISTS idx_project_info_journal;");
+    execOne(q, "CREATE INDEX IF NOT EXISTS idx_project_info_jseq ON project_info(journalSeq);");
+    execOne(q, "CREATE UNIQUE INDEX IF NOT EXISTS idx_project_info_juid ON project_info(journalUid) "
+               "WHERE journalUid IS NOT NULL;");
     return true;
 }
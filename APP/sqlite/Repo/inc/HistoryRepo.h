@@ -6,7 +6,9 @@
 
 class HistoryRepo {
 public:
-    static bool selectAll(QSqlDatabase db, QVector<HistoryRow>& out);  // 查询全部
+    // 键集分页：id < beforeId（<=0 表示从最新开始），按 id 降序取 limit 条
+    static bool selectPage(QSqlDatabase db, int beforeId, int limit, QVector<HistoryRow>& out);
+    static bool selectById(QSqlDatabase db, int id, HistoryRow& out);  // 查询单条
     static bool insert(QSqlDatabase db, const HistoryRow& row);        // 插入一条
     static bool deleteById(QSqlDatabase db, int id);                   // 删除指定 ID
 };
@@ -0,0 +1,38 @@
+#pragma once
+#include <QSqlDatabase>
+#include <QString>
+#include <QVariantMap>
+#include <QVector>
+
+// LabKey 上传发件箱（upload_outbox）：结果先落表，上传成功才删除
+// 服务器明确拒收、或服务端错误重试到上限的条目转入死信（deadAt 非空）：不再发送，留表待查
+namespace OutboxRepo {
+
+struct Item {
+    qint64 id = 0;
+    int attempts = 0;
+    int serverErrors = 0;  // 其中服务端出错（5xx 等）的次数，断网不算
+    QVariantMap record;    // LabKeyService::uploadRun 的入参
+};
+
+bool enqueue(QSqlDatabase& db, const QVariantMap& record);
+
+// 取已到重试时间的条目（不含死信），按 id 升序
+bool takeDue(QSqlDatabase& db, int limit, QVector<Item>& out);
+
+bool remove(QSqlDatabase& db, const QVector<qint64>& ids);
+
+// 失败：attempts+1（serverError 时 serverErrors 也 +1），下次时间 = now + min(baseSec * 2^attempts, maxSec)
+bool markFailed(QSqlDatabase& db, const QVector<qint64>& ids, const QString& err, int baseSec, int maxSec,
+                bool serverError);
+
+// 转入死信：不再参与发送
+bool markDead(QSqlDatabase& db, const QVector<qint64>& ids, const QString& err);
+
+// 距最近一条到期还有多少秒；0 = 已有到期的，-1 = 没有待发条目
+qint64 secondsUntilNextDue(QSqlDatabase& db);
+
+int pendingCount(QSqlDatabase& db);
+int deadCount(QSqlDatabase& db);
+
+}  // namespace OutboxRepo
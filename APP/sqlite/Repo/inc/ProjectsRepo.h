@@ -10,7 +10,11 @@ namespace ProjectsRepo {
 bool selectAll(QSqlDatabase& db, QVector<ProjectRow>& rows);
 bool deleteById(QSqlDatabase& db, int id);
 
-// 统一入口：位置占位符 13 个，兼容 snake/camel 列名
+// 统一入口：位置占位符 20 个（含 C/T/ratio 与峰位 idxC/idxT/baseline），兼容 snake/camel 列名
 bool insertProjectInfo(QSqlDatabase& db, const QVariantMap& data);
 
+// ResultJournal 结果落库：插入 project_info、打 journalUid/journalSeq、upload 进发件箱，同一事务
+// 按 journalUid 去重（旧日志条目没有 uid 时退回按 journalSeq）；已存在返回 true 且 insertedId = 0
+bool applyJournalResult(QSqlDatabase& db, const QVariantMap& info, const QVariantMap& upload, qint64& insertedId);
+
 }  // namespace ProjectsRepo
@@ -5,44 +5,84 @@
 #include <QSqlQuery>
 #include <QVariant>
 
-// =============================
-// 查询全部历史记录
-// =============================
-bool HistoryRepo::selectAll(QSqlDatabase db, QVector<HistoryRow>& out) {
-    QSqlQuery q(db);
-    if (!q.exec(R"(
+static const char* kHistoryColumns = R"(
         SELECT id, projectId, projectName,    -- ★ 新增字段
                sampleNo, sampleSource, sampleName,
                standardCurve, batchCode, detectedConc,
                referenceValue, result, detectedTime,
-               detectedUnit, detectedPerson, dilutionInfo
-        FROM project_info ORDER BY id DESC
-    )")) {
-        qWarning() << "HistoryRepo::selectAll failed:" << q.lastError().text();
+               detectedUnit, detectedPerson, dilutionInfo,
+               C, T, ratio, idxC, idxT, baseline
+        FROM project_info )";
+
+// 按 kHistoryColumns 的列顺序取一行
+static HistoryRow readHistoryRow(const QSqlQuery& q) {
+    HistoryRow r;
+    r.id = q.value(0).toInt();
+    r.projectId = q.value(1).toInt();
+    r.projectName = q.value(2).toString();  // ★ 新字段
+
+    r.sampleNo = q.value(3).toString();
+    r.sampleSource = q.value(4).toString();
+    r.sampleName = q.value(5).toString();
+    r.standardCurve = q.value(6).toString();
+    r.batchCode = q.value(7).toString();
+    r.detectedConc = q.value(8).toDouble();
+    r.referenceValue = q.value(9).toDouble();
+    r.result = q.value(10).toString();
+    r.detectedTime = q.value(11).toString();
+    r.detectedUnit = q.value(12).toString();
+    r.detectedPerson = q.value(13).toString();
+    r.dilutionInfo = q.value(14).toString();
+    r.valueC = q.value(15).toDouble();
+    r.valueT = q.value(16).toDouble();
+    r.ratio = q.value(17).toDouble();
+    r.idxC = q.value(18).toInt();
+    r.idxT = q.value(19).toInt();
+    r.baseline = q.value(20).toDouble();
+    return r;
+}
+
+// =============================
+// 键集分页：WHERE id < ? ORDER BY id DESC LIMIT ?
+// 走主键索引，翻到第几页代价都一样（不用 OFFSET）
+// =============================
+bool HistoryRepo::selectPage(QSqlDatabase db, int beforeId, int limit, QVector<HistoryRow>& out) {
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    if (beforeId > 0) {
+        q.prepare(QString::fromLatin1(kHistoryColumns) + "WHERE id < ? ORDER BY id DESC LIMIT ?");
+        q.addBindValue(beforeId);
+    } else {
+        q.prepare(QString::fromLatin1(kHistoryColumns) + "ORDER BY id DESC LIMIT ?");
+    }
+    q.addBindValue(limit);
+
+    if (!q.exec()) {
+        qWarning() << "HistoryRepo::selectPage failed:" << q.lastError().text();
         return false;
     }
 
-    while (q.next()) {
-        HistoryRow r;
-        r.id = q.value(0).toInt();
-        r.projectId = q.value(1).toInt();
-        r.projectName = q.value(2).toString();  // ★ 新字段
-
-        r.sampleNo = q.value(3).toString();
-        r.sampleSource = q.value(4).toString();
-        r.sampleName = q.value(5).toString();
-        r.standardCurve = q.value(6).toString();
-        r.batchCode = q.value(7).toString();
-        r.detectedConc = q.value(8).toDouble();
-        r.referenceValue = q.value(9).toDouble();
-        r.result = q.value(10).toString();
-        r.detectedTime = q.value(11).toString();
-        r.detectedUnit = q.value(12).toString();
-        r.detectedPerson = q.value(13).toString();
-        r.dilutionInfo = q.value(14).toString();
-
-        out.append(r);
+    out.reserve(out.size() + limit);
+    while (q.next())
+        out.append(readHistoryRow(q));
+    return true;
+}
+
+// =============================
+// 查询单条
+// =============================
+bool HistoryRepo::selectById(QSqlDatabase db, int id, HistoryRow& out) {
+    QSqlQuery q(db);
+    q.prepare(QString::fromLatin1(kHistoryColumns) + "WHERE id = ?");
+    q.addBindValue(id);
+
+    if (!q.exec()) {
+        qWarning() << "HistoryRepo::selectById failed:" << q.lastError().text();
+        return false;
     }
+    if (!q.next())
+        return false;
+    out = readHistoryRow(q);
     return true;
 }
 
@@ -57,8 +97,9 @@ INSERT INTO project_info (
     projectId, projectName, sampleNo, sampleSource, sampleName,
     standardCurve, batchCode, detectedConc,
     referenceValue, result, detectedTime,
-    detectedUnit, detectedPerson, dilutionInfo
-) VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?);
+    detectedUnit, detectedPerson, dilutionInfo,
+    C, T, ratio, idxC, idxT, baseline
+) VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?);
 )SQL");
 
     q.addBindValue(row.projectId);
@@ -75,6 +116,12 @@ INSERT INTO project_info (
     q.addBindValue(row.detectedUnit);
     q.addBindValue(row.detectedPerson);
     q.addBindValue(row.dilutionInfo);
+    q.addBindValue(row.valueC);
+    q.addBindValue(row.valueT);
+    q.addBindValue(row.ratio);
+    q.addBindValue(row.idxC);
+    q.addBindValue(row.idxT);
+    q.addBindValue(row.baseline);
 
     if (!q.exec()) {
         qWarning() << "HistoryRepo::insert failed:" << q.lastError().text();
@@ -126,6 +173,15 @@ bool HistoryRepo::deleteById(QSqlDatabase db, int id) {
         }
     }
 
+    // 4️⃣ 删归档索引（段文件只追加，不回收）
+    {
+        QSqlQuery q(db);
+        q.prepare("DELETE FROM adc_archive WHERE sampleNo = ?");
+        q.addBindValue(sampleNo);
+        if (!q.exec())
+            qWarning() << "⚠️ 删除 adc_archive 失败:" << q.lastError().text();
+    }
+
     qInfo() << "🗑 删除成功 → id =" << id
             << ", sampleNo =" << sampleNo
             << "（project_info + adc_data 已全部清理）";
@@ -0,0 +1,134 @@
+#include "OutboxRepo.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QVariant>
+
+namespace OutboxRepo {
+
+static inline void logSqlError(const char* tag, const QSqlQuery& q) {
+    qWarning() << "[OutboxRepo]" << tag << "error:" << q.lastError().text();
+}
+
+static QString idList(const QVector<qint64>& ids) {
+    QStringList parts;
+    parts.reserve(ids.size());
+    for (qint64 id : ids)
+        parts << QString::number(id);
+    return parts.join(',');
+}
+
+bool enqueue(QSqlDatabase& db, const QVariantMap& record) {
+    QSqlQuery q(db);
+    q.prepare("INSERT INTO upload_outbox(payload, attempts, nextAttemptAt) VALUES(?, 0, 0)");
+    q.addBindValue(QString::fromUtf8(
+        QJsonDocument(QJsonObject::fromVariantMap(record)).toJson(QJsonDocument::Compact)));
+    if (!q.exec()) {
+        logSqlError("enqueue", q);
+        return false;
+    }
+    return true;
+}
+
+bool takeDue(QSqlDatabase& db, int limit, QVector<Item>& out) {
+    out.clear();
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    q.prepare("SELECT id, attempts, serverErrors, payload FROM upload_outbox "
+              "WHERE deadAt IS NULL AND nextAttemptAt <= ? ORDER BY id ASC LIMIT ?");
+    q.addBindValue(QDateTime::currentSecsSinceEpoch());
+    q.addBindValue(limit);
+    if (!q.exec()) {
+        logSqlError("takeDue", q);
+        return false;
+    }
+    while (q.next()) {
+        Item it;
+        it.id = q.value(0).toLongLong();
+        it.attempts = q.value(1).toInt();
+        it.serverErrors = q.value(2).toInt();
+        it.record = QJsonDocument::fromJson(q.value(3).toString().toUtf8()).object().toVariantMap();
+        out.push_back(it);
+    }
+    return true;
+}
+
+bool remove(QSqlDatabase& db, const QVector<qint64>& ids) {
+    if (ids.isEmpty())
+        return true;
+    QSqlQuery q(db);
+    if (!q.exec(QStringLiteral("DELETE FROM upload_outbox WHERE id IN (%1)").arg(idList(ids)))) {
+        logSqlError("remove", q);
+        return false;
+    }
+    return true;
+}
+
+bool markFailed(QSqlDatabase& db, const QVector<qint64>& ids, const QString& err, int baseSec, int maxSec,
+                bool serverError) {
+    if (ids.isEmpty())
+        return true;
+    QSqlQuery q(db);
+    q.prepare(QStringLiteral(R"SQL(
+UPDATE upload_outbox
+SET nextAttemptAt = ? + MIN(?, ? * (1 << MIN(attempts, 16))),
+    attempts = attempts + 1,
+    serverErrors = serverErrors + ?,
+    lastError = ?
+WHERE id IN (%1)
+)SQL").arg(idList(ids)));
+    q.addBindValue(QDateTime::currentSecsSinceEpoch());
+    q.addBindValue(maxSec);
+    q.addBindValue(baseSec);
+    q.addBindValue(serverError ? 1 : 0);
+    q.addBindValue(err.left(200));
+    if (!q.exec()) {
+        logSqlError("markFailed", q);
+        return false;
+    }
+    return true;
+}
+
+bool markDead(QSqlDatabase& db, const QVector<qint64>& ids, const QString& err) {
+    if (ids.isEmpty())
+        return true;
+    QSqlQuery q(db);
+    q.prepare(QStringLiteral("UPDATE upload_outbox SET deadAt = datetime('now','localtime'), lastError = ? "
+                             "WHERE id IN (%1)")
+                  .arg(idList(ids)));
+    q.addBindValue(err.left(200));
+    if (!q.exec()) {
+        logSqlError("markDead", q);
+        return false;
+    }
+    return true;
+}
+
+qint64 secondsUntilNextDue(QSqlDatabase& db) {
+    QSqlQuery q(db);
+    if (!q.exec("SELECT MIN(nextAttemptAt) FROM upload_outbox WHERE deadAt IS NULL") || !q.next() ||
+        q.value(0).isNull())
+        return -1;
+    return qMax<qint64>(0, q.value(0).toLongLong() - QDateTime::currentSecsSinceEpoch());
+}
+
+int pendingCount(QSqlDatabase& db) {
+    QSqlQuery q(db);
+    if (!q.exec("SELECT COUNT(*) FROM upload_outbox WHERE deadAt IS NULL") || !q.next())
+        return 0;
+    return q.value(0).toInt();
+}
+
+int deadCount(QSqlDatabase& db) {
+    QSqlQuery q(db);
+    if (!q.exec("SELECT COUNT(*) FROM upload_outbox WHERE deadAt IS NOT NULL") || !q.next())
+        return 0;
+    return q.value(0).toInt();
+}
+
+}  // namespace OutboxRepo
@@ -5,6 +5,8 @@
 #include <QSqlQuery>
 #include <QVariant>
 
+#include "OutboxRepo.h"
+
 namespace ProjectsRepo {
 
 static inline void logSqlError(const char* tag, const QSqlQuery& q) {
@@ -69,8 +71,8 @@ bool insertProjectInfo(QSqlDatabase& db, const QVariantMap& data) {
         " projectId, projectName, sampleNo, sampleSource, sampleName, standardCurve,"
         " batchCode, detectedConc, referenceValue, result, detectedTime,"
         " detectedUnit, detectedPerson, dilutionInfo,"
-        " \"C\", \"T\", ratio"
-        ") VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)";
+        " \"C\", \"T\", ratio, idxC, idxT, baseline"
+        ") VALUES (?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?,?)";
 
     QSqlQuery q(db);
     if (!q.prepare(sql)) {
@@ -102,7 +104,12 @@ bool insertProjectInfo(QSqlDatabase& db, const QVariantMap& data) {
     q.addBindValue(t);
     q.addBindValue(r);
 
-    qInfo() << "[ProjectsRepo][DEBUG] bound fields =" << q.boundValues().size();  // 应该是 17
+    // ===== C/T 峰位与本底（calcTC 的 idxC / idxT / baseline），没有时 -1 =====
+    q.addBindValue(data.value("idxC", -1).toInt());
+    q.addBindValue(data.value("idxT", -1).toInt());
+    q.addBindValue(data.value("baseline", 0.0).toDouble());
+
+    qInfo() << "[ProjectsRepo][DEBUG] bound fields =" << q.boundValues().size();  // 应该是 20
 
     if (!q.exec()) {
         logSqlError("exec(insertProjectInfo)", q);
@@ -114,4 +121,63 @@ bool insertProjectInfo(QSqlDatabase& db, const QVariantMap& data) {
     return true;
 }
 
+// 日志序号只在一个日志文件内唯一：日志打不开或残尾被截掉后会从 1 重新数，所以去重只认 uid
+bool applyJournalResult(QSqlDatabase& db, const QVariantMap& info, const QVariantMap& upload, qint64& insertedId) {
+    insertedId = 0;
+    if (!db.isOpen()) {
+        qWarning() << "[ProjectsRepo] applyJournalResult: db not open";
+        return false;
+    }
+    const QString uid = info.value("journalUid").toString();
+    const qint64 seq = info.value("journalSeq").toLongLong();
+    {
+        QSqlQuery q(db);
+        if (!uid.isEmpty()) {
+            q.prepare("SELECT 1 FROM project_info WHERE journalUid = ?");
+            q.addBindValue(uid);
+        } else {
+            q.prepare("SELECT 1 FROM project_info WHERE journalSeq = ? AND journalUid IS NULL");
+            q.addBindValue(seq);
+        }
+        if (!q.exec()) {
+            logSqlError("applyJournalResult(lookup)", q);
+            return false;
+        }
+        if (q.next()) {
+            qInfo() << "[ProjectsRepo] journal result" << (uid.isEmpty() ? QString::number(seq) : uid)
+                    << "already applied";
+            return true;
+        }
+    }
+
+    if (!db.transaction())
+        return false;
+    bool ok = insertProjectInfo(db, info);
+    qint64 id = 0;
+    if (ok) {
+        QSqlQuery q(db);
+        ok = q.exec("SELECT last_insert_rowid()") && q.next();
+        if (ok)
+            id = q.value(0).toLongLong();
+    }
+    if (ok) {
+        QSqlQuery q(db);
+        q.prepare("UPDATE project_info SET journalSeq = ?, journalUid = ? WHERE id = ?");
+        q.addBindValue(seq);
+        q.addBindValue(uid.isEmpty() ? QVariant(QVariant::String) : QVariant(uid));
+        q.addBindValue(id);
+        ok = q.exec();
+        if (!ok)
+            logSqlError("applyJournalResult(mark)", q);
+    }
+    if (ok && !upload.isEmpty())
+        ok = OutboxRepo::enqueue(db, upload);
+    if (!ok || !db.commit()) {
+        db.rollback();
+        return false;
+    }
+    insertedId = id;
+    return true;
+}
+
 }  // namespace ProjectsRepo
@@ -3,6 +3,7 @@
 
 #include <QAbstractListModel>
 #include <QDebug>
+#include <QHash>
 #include <QVector>
 
 #include "DBWorker.h"
@@ -11,14 +12,21 @@
 /**
  * @brief 历史记录视图模型（连接 QML 与数据库）
  * 支持：
- *   - 加载历史记录
- *   - 导出 CSV
+ *   - 分页加载历史记录（canFetchMore / fetchMore，键集分页 id < ?）
+ *   - 流式导出 CSV / Bundle（可带曲线，分块执行，带进度，可取消）
  *   - 删除单条记录
+ *   - 单条插入 / 删除增量更新（不再整表重载）
  *   - 由 DBWorker 线程异步驱动
  */
 class HistoryViewModel : public QAbstractListModel {
     Q_OBJECT
     Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+    Q_PROPERTY(int pageSize READ pageSize WRITE setPageSize NOTIFY pageSizeChanged)
+    Q_PROPERTY(bool loading READ loading NOTIFY loadingChanged)
+    Q_PROPERTY(bool exporting READ exporting NOTIFY exportStateChanged)
+    Q_PROPERTY(qint64 exportWritten READ exportWritten NOTIFY exportStateChanged)
+    Q_PROPERTY(qint64 exportTotal READ exportTotal NOTIFY exportStateChanged)
+    Q_PROPERTY(double exportProgress READ exportProgress NOTIFY exportStateChanged)
 
 public:
     enum Role {
@@ -46,20 +54,63 @@ public:
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
     QVariant data(const QModelIndex& index, int role) const override;
     QHash<int, QByteArray> roleNames() const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    int pageSize() const { return m_pageSize; }
+    void setPageSize(int n);
+    bool loading() const { return m_pendingBefore >= 0; }
+
+    bool exporting() const { return m_exporting; }
+    qint64 exportWritten() const { return m_exportWritten; }
+    qint64 exportTotal() const { return m_exportTotal; }
+    double exportProgress() const;
 
     // === QML 可调用接口 ===
-    Q_INVOKABLE void refresh();                                 // 刷新历史记录
-    Q_INVOKABLE bool exportCsv(const QString& filePath) const;  // 导出 CSV 文件
+    Q_INVOKABLE void refresh();                                 // 重新加载第一页
+    Q_INVOKABLE bool exportCsv(const QString& filePath);  // 导出 CSV（= exportHistory(path, "csv", false)）
+    // format: "csv" / "bundle"；结果见 exportFinished
+    Q_INVOKABLE bool exportHistory(const QString& filePath, const QString& format = QStringLiteral("csv"),
+                                   bool includeTraces = false);
+    Q_INVOKABLE void cancelExport();
+    // 导出目录：优先已挂载的 U 盘（/dev/sd*），否则 SD 卡 export 目录
+    Q_INVOKABLE QString exportDir() const;
     Q_INVOKABLE bool deleteById(int id);                        // 按 id 删除记录
     Q_INVOKABLE QVariantMap getById(int id) const;              // ✅ 新增：QML可调用
     Q_INVOKABLE QVariantMap getRow(int row) const;
 
 signals:
     void countChanged();
+    void pageSizeChanged();
+    void loadingChanged();
+    void exportStateChanged();
+    void exportFinished(bool ok, const QString& path);
+
+private:
+    void onPageLoaded(const QVector<HistoryRow>& rows, int beforeId, bool hasMore);
+    void onRowInserted(const HistoryRow& row);
+    void onRowDeleted(int id);
+    void requestPage(int beforeId);
+
+    // id → 行号索引：存 key，行号 = key + m_rowShift
+    // 头部插入/删除只改 m_rowShift，再修正较短的一侧，代价 O(min(pos, n-pos))
+    int rowOf(int id) const;
+    void reindexAfterInsert(int pos);
+    void reindexAfterRemove(int pos);
 
 private:
     DBWorker* m_worker = nullptr;
-    QVector<HistoryRow> m_rows;
+    QVector<HistoryRow> m_rows;  // 已加载窗口（id 降序）
+    QHash<int, int> m_rowKey;
+    int m_rowShift = 0;
+
+    int m_pageSize = 50;
+    bool m_hasMore = false;
+    int m_pendingBefore = -1;  // 正在请求的游标（-1 = 空闲，0 = 第一页）
+
+    bool m_exporting = false;
+    qint64 m_exportWritten = 0;
+    qint64 m_exportTotal = -1;
 };
 
 #endif  // HISTORYVIEWMODEL_H
@@ -65,10 +65,14 @@ signals:
     void methodConfigsReady();  // 数据准备好（对标 projectsReady）
 
 private slots:
-    void onLoaded(const QVector<QrMethodConfigRow>& rows);  // 槽函数：DBWorker 加载完成
-    void onDeleted(bool ok, int id);                        // 槽函数：DBWorker 删除完成
+    void onLoaded(const QVector<QrMethodConfigRow>& rows);  // 槽函数：DBWorker 加载完成（整表重置）
+    void onUpserted(const QrMethodConfigRow& row);          // 槽函数：单行新增 / 覆盖（行级更新）
+    void onDeleted(bool ok, int id);                        // 槽函数：DBWorker 删除完成（行级删除）
 
 private:
+    static Item itemFromRow(const QrMethodConfigRow& r);  // DB 行 -> 缓存项
+    int indexOfRid(int rid) const;                        // 按 rid 找行号，找不到返回 -1
+
     DBWorker* m_worker = nullptr;  // DBWorker 指针（不拥有生命周期）
     QVector<Item> m_list;          // 缓存列表（对标 m_list）
 };
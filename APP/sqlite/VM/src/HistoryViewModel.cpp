@@ -2,30 +2,176 @@
 
 #include <QDateTime>
 #include <QFile>
-#include <QTextStream>
+#include <algorithm>
 
+#include "HistoryExporter.h"
 #include "HistoryRepo.h"
 
 HistoryViewModel::HistoryViewModel(DBWorker* worker, QObject* parent)
     : QAbstractListModel(parent), m_worker(worker) {
     if (m_worker) {
-        // 加载完成信号
+        // 一页加载完成
         connect(m_worker, &DBWorker::historyLoaded,
-                this, [this](const QVector<HistoryRow>& rows) {
-                    beginResetModel();
-                    m_rows = rows;
-                    endResetModel();
-                    emit countChanged();
-                    qInfo() << "[HistoryViewModel] got rows =" << m_rows.size();
-                });
+                this, &HistoryViewModel::onPageLoaded);
+
+        // 新增一条（检测完成落库）
+        connect(m_worker, &DBWorker::historyRowInserted,
+                this, &HistoryViewModel::onRowInserted);
 
         // 删除完成信号
         connect(m_worker, &DBWorker::historyDeleted,
                 this, [this](bool ok, int id) {
                     qInfo() << "[HistoryViewModel] historyDeleted id =" << id << ", ok =" << ok;
                     if (ok)
-                        refresh();
+                        onRowDeleted(id);
+                });
+
+        // 导出进度 / 完成
+        connect(m_worker, &DBWorker::exportProgress,
+                this, [this](qint64 written, qint64 total) {
+                    m_exportWritten = written;
+                    m_exportTotal = total;
+                    emit exportStateChanged();
                 });
+        connect(m_worker, &DBWorker::historyExported,
+                this, [this](bool ok, const QString& path) {
+                    m_exporting = false;
+                    emit exportStateChanged();
+                    emit exportFinished(ok, path);
+                });
+    }
+}
+
+// === 分页 ===
+bool HistoryViewModel::canFetchMore(const QModelIndex& parent) const {
+    if (parent.isValid())
+        return false;
+    return m_hasMore && m_pendingBefore < 0 && !m_rows.isEmpty();
+}
+
+void HistoryViewModel::fetchMore(const QModelIndex& parent) {
+    if (!canFetchMore(parent))
+        return;
+    requestPage(m_rows.last().id);
+}
+
+void HistoryViewModel::setPageSize(int n) {
+    n = qBound(10, n, 1000);
+    if (m_pageSize == n)
+        return;
+    m_pageSize = n;
+    emit pageSizeChanged();
+}
+
+void HistoryViewModel::requestPage(int beforeId) {
+    if (!m_worker)
+        return;
+    const bool wasLoading = loading();
+    m_pendingBefore = beforeId;
+    m_worker->postLoadHistory(beforeId, m_pageSize);
+    if (!wasLoading)
+        emit loadingChanged();
+}
+
+void HistoryViewModel::onPageLoaded(const QVector<HistoryRow>& rows, int beforeId, bool hasMore) {
+    // refresh() 之后仍在路上的旧页直接丢弃
+    if (beforeId != m_pendingBefore)
+        return;
+    m_pendingBefore = -1;
+    m_hasMore = hasMore;
+
+    if (beforeId == 0) {
+        beginResetModel();
+        m_rows = rows;
+        m_rowKey.clear();
+        m_rowKey.reserve(m_rows.size());
+        m_rowShift = 0;
+        for (int i = 0; i < m_rows.size(); ++i)
+            m_rowKey.insert(m_rows[i].id, i);
+        endResetModel();
+    } else if (!rows.isEmpty()) {
+        const int first = m_rows.size();
+        beginInsertRows(QModelIndex(), first, first + rows.size() - 1);
+        m_rows += rows;
+        for (int i = first; i < m_rows.size(); ++i)
+            m_rowKey.insert(m_rows[i].id, i - m_rowShift);
+        endInsertRows();
+    }
+
+    emit loadingChanged();
+    emit countChanged();
+    qInfo() << "[HistoryViewModel] page before =" << beforeId << "got" << rows.size()
+            << "rows, loaded =" << m_rows.size() << ", hasMore =" << m_hasMore;
+}
+
+void HistoryViewModel::onRowInserted(const HistoryRow& row) {
+    const int existing = rowOf(row.id);
+    if (existing >= 0) {
+        m_rows[existing] = row;
+        const QModelIndex idx = index(existing);
+        emit dataChanged(idx, idx);
+        return;
+    }
+
+    // 按 id 降序找插入位置（新记录通常在最前）
+    auto it = std::lower_bound(m_rows.begin(), m_rows.end(), row.id,
+                               [](const HistoryRow& r, int id) { return r.id > id; });
+    const int pos = int(it - m_rows.begin());
+    // 落在已加载窗口之后：交给后续 fetchMore
+    if (pos == m_rows.size() && m_hasMore)
+        return;
+
+    beginInsertRows(QModelIndex(), pos, pos);
+    m_rows.insert(pos, row);
+    reindexAfterInsert(pos);
+    endInsertRows();
+    emit countChanged();
+}
+
+void HistoryViewModel::onRowDeleted(int id) {
+    const int row = rowOf(id);
+    if (row < 0)
+        return;
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_rows.remove(row);
+    m_rowKey.remove(id);
+    reindexAfterRemove(row);
+    endRemoveRows();
+    emit countChanged();
+}
+
+// === id → 行号索引 ===
+int HistoryViewModel::rowOf(int id) const {
+    auto it = m_rowKey.constFind(id);
+    if (it == m_rowKey.constEnd())
+        return -1;
+    return it.value() + m_rowShift;
+}
+
+void HistoryViewModel::reindexAfterInsert(int pos) {
+    const int n = m_rows.size();
+    if (pos < n - pos) {
+        // 前半段短：整体后移一位，再把 pos 之前的行拉回来
+        ++m_rowShift;
+        for (int i = 0; i < pos; ++i)
+            m_rowKey[m_rows[i].id] = i - m_rowShift;
+        m_rowKey.insert(m_rows[pos].id, pos - m_rowShift);
+    } else {
+        for (int i = pos; i < n; ++i)
+            m_rowKey[m_rows[i].id] = i - m_rowShift;
+    }
+}
+
+void HistoryViewModel::reindexAfterRemove(int pos) {
+    const int n = m_rows.size();
+    if (pos < n - pos) {
+        --m_rowShift;
+        for (int i = 0; i < pos; ++i)
+            m_rowKey[m_rows[i].id] = i - m_rowShift;
+    } else {
+        for (int i = pos; i < n; ++i)
+            m_rowKey[m_rows[i].id] = i - m_rowShift;
     }
 }
 
@@ -97,74 +243,77 @@ QHash<int, QByteArray> HistoryViewModel::roleNames() const {
     return roles;
 }
 
-// === 刷新 ===
+// === 刷新（只取第一页，其余随滚动 fetchMore）===
 void HistoryViewModel::refresh() {
     if (!m_worker) {
         qWarning() << "[HistoryViewModel] refresh: worker null";
         return;
     }
-    m_worker->postLoadHistory();
+    requestPage(0);
 }
 
-// === 导出 CSV ===
-bool HistoryViewModel::exportCsv(const QString& filePath) const {
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qWarning() << "[HistoryViewModel] exportCsv open fail:" << filePath;
+// === 导出 ===
+// 模型里只有已加载的窗口，全表导出交给 DB 线程分块执行（进度见 exportProgress）
+bool HistoryViewModel::exportCsv(const QString& filePath) {
+    return exportHistory(filePath, QStringLiteral("csv"), false);
+}
+
+bool HistoryViewModel::exportHistory(const QString& filePath, const QString& format,
+                                     bool includeTraces) {
+    if (!m_worker) {
+        qWarning() << "[HistoryViewModel] exportHistory: worker null";
         return false;
     }
-
-    QTextStream out(&file);
-    out.setCodec("UTF-8");
-
-    // 表头
-    out << "ID,项目ID,样品编号,样品来源,样品名称,标准曲线,批次号,检测浓度,参考值,结果,检测时间,单位,检测人,稀释信息\n";
-
-    // 写数据
-    for (const auto& r : m_rows) {
-        // QString::replace() 非 const，必须用临时变量
-        QString sNo = r.sampleNo;
-        sNo.replace('"', "\"\"");
-        QString sSrc = r.sampleSource;
-        sSrc.replace('"', "\"\"");
-        QString sName = r.sampleName;
-        sName.replace('"', "\"\"");
-        QString sCurve = r.standardCurve;
-        sCurve.replace('"', "\"\"");
-        QString sBatch = r.batchCode;
-        sBatch.replace('"', "\"\"");
-        QString sRes = r.result;
-        sRes.replace('"', "\"\"");
-        QString sTime = r.detectedTime;
-        sTime.replace('"', "\"\"");
-        QString sUnit = r.detectedUnit;
-        sUnit.replace('"', "\"\"");
-        QString sPerson = r.detectedPerson;
-        sPerson.replace('"', "\"\"");
-        QString sDil = r.dilutionInfo;
-        sDil.replace('"', "\"\"");
-
-        out << r.id << ','
-            << r.projectId << ','
-            << '"' << sNo << '"' << ','
-            << '"' << sSrc << '"' << ','
-            << '"' << sName << '"' << ','
-            << '"' << sCurve << '"' << ','
-            << '"' << sBatch << '"' << ','
-            << r.detectedConc << ','
-            << r.referenceValue << ','
-            << '"' << sRes << '"' << ','
-            << '"' << sTime << '"' << ','
-            << '"' << sUnit << '"' << ','
-            << '"' << sPerson << '"' << ','
-            << '"' << sDil << '"' << '\n';
+    if (filePath.isEmpty()) {
+        qWarning() << "[HistoryViewModel] exportHistory: empty path";
+        return false;
+    }
+    if (m_exporting) {
+        qWarning() << "[HistoryViewModel] exportHistory: already exporting";
+        return false;
     }
+    const auto fmt = HistoryExporter::parseFormat(format);
+    m_exporting = true;
+    m_exportWritten = 0;
+    m_exportTotal = -1;
+    emit exportStateChanged();
 
-    file.close();
-    qInfo() << "[HistoryViewModel] exportCsv success ->" << filePath;
+    if (!m_worker->postExportHistory(filePath, static_cast<int>(fmt), includeTraces)) {
+        m_exporting = false;
+        emit exportStateChanged();
+        return false;
+    }
+    qInfo() << "[HistoryViewModel] export queued ->" << filePath << format << includeTraces;
     return true;
 }
 
+void HistoryViewModel::cancelExport() {
+    if (m_worker && m_exporting)
+        m_worker->cancelExport();
+}
+
+double HistoryViewModel::exportProgress() const {
+    if (m_exportTotal <= 0)
+        return m_exporting ? 0.0 : 1.0;
+    return qBound(0.0, double(m_exportWritten) / double(m_exportTotal), 1.0);
+}
+
+QString HistoryViewModel::exportDir() const {
+    QFile mounts("/proc/mounts");
+    if (mounts.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        while (!mounts.atEnd()) {
+            const QList<QByteArray> f = mounts.readLine().split(' ');
+            if (f.size() >= 2 && f[0].startsWith("/dev/sd"))
+                return QString::fromLocal8Bit(f[1]) + "/export";
+        }
+    }
+#ifndef LOCAL_BUILD
+    return QStringLiteral("/mnt/SDCARD/export");
+#else
+    return QStringLiteral("/tmp/export");
+#endif
+}
+
 // === 删除一条记录 ===
 bool HistoryViewModel::deleteById(int id) {
     if (!m_worker) {
@@ -182,25 +331,31 @@ bool HistoryViewModel::deleteById(int id) {
 QVariantMap HistoryViewModel::getById(int id) const {
     QVariantMap map;
 
-    for (const auto& r : m_rows) {
-        if (r.id == id) {
-            map["id"] = r.id;
-            map["projectId"] = r.projectId;
-            map["projectName"] = r.projectName;
-            map["sampleNo"] = r.sampleNo;
-            map["sampleSource"] = r.sampleSource;
-            map["sampleName"] = r.sampleName;
-            map["standardCurve"] = r.standardCurve;
-            map["batchCode"] = r.batchCode;
-            map["detectedConc"] = r.detectedConc;
-            map["referenceValue"] = r.referenceValue;
-            map["result"] = r.result;
-            map["detectedTime"] = r.detectedTime;
-            map["detectedUnit"] = r.detectedUnit;
-            map["detectedPerson"] = r.detectedPerson;
-            map["dilutionInfo"] = r.dilutionInfo;
-            break;
-        }
+    const int row = rowOf(id);
+    if (row >= 0) {
+        const HistoryRow& r = m_rows.at(row);
+        map["id"] = r.id;
+        map["projectId"] = r.projectId;
+        map["projectName"] = r.projectName;
+        map["sampleNo"] = r.sampleNo;
+        map["sampleSource"] = r.sampleSource;
+        map["sampleName"] = r.sampleName;
+        map["standardCurve"] = r.standardCurve;
+        map["batchCode"] = r.batchCode;
+        map["detectedConc"] = r.detectedConc;
+        map["referenceValue"] = r.referenceValue;
+        map["result"] = r.result;
+        map["detectedTime"] = r.detectedTime;
+        map["detectedUnit"] = r.detectedUnit;
+        map["detectedPerson"] = r.detectedPerson;
+        map["dilutionInfo"] = r.dilutionInfo;
+        // 检测时算出的 C/T 与峰位，详情页直接用来画标记
+        map["C"] = r.valueC;
+        map["T"] = r.valueT;
+        map["ratio"] = r.ratio;
+        map["idxC"] = r.idxC;
+        map["idxT"] = r.idxT;
+        map["baseline"] = r.baseline;
     }
 
     if (map.isEmpty())
@@ -14,8 +14,12 @@ QrMethodConfigViewModel::QrMethodConfigViewModel(DBWorker* worker, QObject* pare
                 this, &QrMethodConfigViewModel::onLoaded,    // 槽：更新本地列表
                 Qt::QueuedConnection);                       // 跨线程安全队列连接
 
+        connect(m_worker, &DBWorker::qrMethodConfigUpserted,  // 连接：单行保存完成信号
+                this, &QrMethodConfigViewModel::onUpserted,   // 槽：原地更新 / 插入一行
+                Qt::QueuedConnection);                        // 跨线程安全队列连接
+
         connect(m_worker, &DBWorker::qrMethodConfigDeleted,  // 连接：删除完成信号
-                this, &QrMethodConfigViewModel::onDeleted,   // 槽：根据结果刷新
+                this, &QrMethodConfigViewModel::onDeleted,   // 槽：移除对应行
                 Qt::QueuedConnection);                       // 跨线程安全队列连接
     }
 }
@@ -92,27 +96,37 @@ void QrMethodConfigViewModel::deleteById(int rid) {
     m_worker->postDeleteQrMethodConfig(rid);  // 发送删除任务
 }
 
+QrMethodConfigViewModel::Item QrMethodConfigViewModel::itemFromRow(const QrMethodConfigRow& r) {
+    Item item;                         // 构造一条缓存
+    item.rid = r.id;                   // id -> rid
+    item.projectName = r.projectName;  // projectName
+    item.batchCode = r.batchCode;      // batchCode
+    item.updatedAt = r.updatedAt;      // updated_at
+    item.temperature = r.temperature;
+    item.timeSec = r.timeSec;
+    item.C1 = r.C1;
+    item.T1 = r.T1;
+    item.C2 = r.C2;
+    item.T2 = r.T2;
+    item.methodData = r.methodData;
+    return item;
+}
+
+int QrMethodConfigViewModel::indexOfRid(int rid) const {
+    for (int i = 0; i < m_list.size(); ++i) {  // 配置表只有几十行，线性查找足够
+        if (m_list.at(i).rid == rid)
+            return i;
+    }
+    return -1;
+}
+
 void QrMethodConfigViewModel::onLoaded(const QVector<QrMethodConfigRow>& rows) {
-    beginResetModel();            // 通知视图：整体重置
+    beginResetModel();            // 通知视图：整体重置（只在首次加载 / 手动刷新时走这里）
     m_list.clear();               // 清空旧数据
     m_list.reserve(rows.size());  // 预分配空间
 
-    for (const auto& r : rows) {           // 遍历 DBWorker 返回行
-        Item item;                         // 构造一条缓存
-        item.rid = r.id;                   // id -> rid
-        item.projectName = r.projectName;  // projectName
-        item.batchCode = r.batchCode;      // batchCode
-        item.updatedAt = r.updatedAt;      // methodData
-        item.temperature = r.temperature;
-        item.timeSec = r.timeSec;
-        item.C1 = r.C1;
-        item.T1 = r.T1;
-        item.C2 = r.C2;
-        item.T2 = r.T2;
-        item.methodData = r.methodData;
-        qDebug() << "-----[QrMethodConfigVM] Loaded----" << item.projectName << item.batchCode << item.updatedAt << r.methodData << r.C1 << r.T1 << r.C2 << r.T2;
-        m_list.append(item);  // 加入列表
-    }
+    for (const auto& r : rows)          // 遍历 DBWorker 返回行
+        m_list.append(itemFromRow(r));  // 加入列表
 
     endResetModel();                                                    // 通知视图：重置结束
     emit countChanged();                                                // 通知 QML count 变化
@@ -120,10 +134,38 @@ void QrMethodConfigViewModel::onLoaded(const QVector<QrMethodConfigRow>& rows) {
     qInfo() << "[QrMethodConfigVM] Loaded" << m_list.size() << "rows";  // 打印加载条数
 }
 
+void QrMethodConfigViewModel::onUpserted(const QrMethodConfigRow& row) {
+    const int existing = indexOfRid(row.id);
+    if (existing >= 0) {  // 覆盖：原地改数据，委托不重建
+        m_list[existing] = itemFromRow(row);
+        const QModelIndex idx = index(existing);
+        emit dataChanged(idx, idx);
+        qInfo() << "[QrMethodConfigVM] updated rid =" << row.id;
+        return;
+    }
+
+    // 新增：按 id 降序找插入位置（和 doLoadQrMethodConfigs 的 ORDER BY 一致）
+    int pos = 0;
+    while (pos < m_list.size() && m_list.at(pos).rid > row.id)
+        ++pos;
+    beginInsertRows(QModelIndex(), pos, pos);
+    m_list.insert(pos, itemFromRow(row));
+    endInsertRows();
+    emit countChanged();
+    qInfo() << "[QrMethodConfigVM] inserted rid =" << row.id << "at" << pos;
+}
+
 void QrMethodConfigViewModel::onDeleted(bool ok, int id) {
     qInfo() << "[QrMethodConfigVM] delete result id =" << id << "ok =" << ok;  // 打印删除结果
-    if (ok)                                                                    // 删除成功
-        refresh();                                                             // 重新加载
+    if (!ok)
+        return;
+    const int row = indexOfRid(id);
+    if (row < 0)
+        return;
+    beginRemoveRows(QModelIndex(), row, row);  // 只移除这一行
+    m_list.remove(row);
+    endRemoveRows();
+    emit countChanged();
 }
 
 QVariantMap QrMethodConfigViewModel::get(int index) const {
@@ -5,6 +5,8 @@
 #include <string>
 #include <vector>
 
+#include "event_stream.h"
+
 struct sqlite3;
 
 namespace embedded {
@@ -25,10 +27,21 @@ struct NetworkInterfaceInfo {
 struct ServerConfig {
     std::string host;            ///< 监听地址，默认 0.0.0.0。
     int port = 8080;             ///< 监听端口。
-    std::string web_root;        ///< 静态资源目录。
+    std::string web_root;        ///< 静态资源目录（embedded_assets 为 false 时使用）。
     std::string browse_root;     ///< 文件浏览根目录（当前版本仅作为运行信息输出）。
     std::string db_path;         ///< SQLite 文件路径。
     std::string bind_interface;  ///< 绑定网卡名（可选）。
+    bool embedded_assets = true; ///< 使用编译进程序的页面资源（false = 从 web_root 读盘，便于现场调试页面）。
+
+    // ===== 线程池与准入控制（网页再多也不能挤占采集线程）=====
+    int worker_threads = 6;        ///< httplib 工作线程数（至少 max_stream_clients + 2）。
+    int max_queued_requests = 16;  ///< 线程全忙时的排队上限，超出直接断开连接（0 = 不限）。
+    int worker_nice = 10;          ///< 工作线程 nice 值（越大优先级越低）。
+    int max_curve_requests = 2;    ///< 曲线接口同时处理数，超出回 503 + Retry-After。
+    int max_query_requests = 4;    ///< 列表 / 详情接口同时处理数。
+    int max_stream_clients = 4;    ///< `/api/stream` 同时连接数（每个长期占一条工作线程）。
+    int db_readers = 2;            ///< 同时读库的请求数（共享只读连接池）。
+    int db_wait_ms = 300;          ///< 等待读库租约的最长时间，超时回 503。
 };
 
 /**
@@ -38,6 +51,8 @@ struct ServerConfig {
  * - 项目列表接口 `/api/project/list`
  * - 检测详情接口 `/api/detect/detail`
  * - 曲线接口 `/api/detect/curve`
+ * - 实时推送 `/api/stream`（SSE：采集批次 / 设备状态 / 新结果）
+ * - 批量导出 `/api/export`（CSV / Bundle，可带曲线，分块流式）
  * - 运行信息接口 `/api/server/runtime`
  * - 网卡信息接口 `/api/server/interfaces`
  */
@@ -101,6 +116,11 @@ public:
      */
     bool isRunning() const;
 
+    /**
+     * @brief SSE 事件源，应用侧通过它向 `/api/stream` 的所有客户端推送。
+     */
+    EventStream& events();
+
     /**
      * @brief 打开只读 DB 句柄（调用方负责 sqlite3_close）。
      */
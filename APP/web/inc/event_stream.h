@@ -0,0 +1,86 @@
+#ifndef EVENT_STREAM_H_
+#define EVENT_STREAM_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace embedded {
+
+/**
+ * @brief SSE 事件环形缓冲（一份数据，所有客户端共享）。
+ *
+ * - 生产者（GUI / 采集线程）publish 时就格式化成 SSE 文本，所有客户端共享同一份 shared_ptr。
+ * - 每个客户端只持有一个序号游标；落后超过环形容量时直接跳到最旧帧（记为 dropped）。
+ * - 每次唤醒时做合并：状态帧只留最新一帧，ADC 帧只留最近几帧，结果帧全部保留。
+ *   写得慢的客户端自然丢中间帧，不会拖慢生产者或其他客户端。
+ */
+class EventStream {
+public:
+    enum Kind {
+        Adc = 0,  ///< 采集批次（可丢）
+        Status,   ///< 设备状态快照（只需最新）
+        Result,   ///< 新检测结果（不丢）
+        Scan,     ///< 扫描开始 / 结束（不丢）
+        KindCount
+    };
+
+    using Text = std::shared_ptr<const std::string>;
+
+    explicit EventStream(std::size_t capacity = 256);
+
+    /**
+     * @brief 发布一帧（任意线程）。json 必须是单行 JSON。
+     */
+    void publish(Kind kind, const char* event, const std::string& json);
+
+    /**
+     * @brief 登记一个客户端；超过 max_clients 返回 false。
+     * @param cursor 返回起始游标（从当前最新帧之后开始）。
+     * @param initial 返回状态 / 扫描的最新快照，新客户端立即可见。
+     */
+    bool attach(std::size_t max_clients, std::uint64_t& cursor, std::vector<Text>& initial);
+    void detach();
+
+    /**
+     * @brief 取 cursor 之后的帧（合并后），最多阻塞 timeout。
+     * @param dropped 累加被跳过 / 合并掉的帧数。
+     * @return false 表示已关闭，客户端应断开。
+     */
+    bool wait(std::uint64_t& cursor, std::vector<Text>& out, std::uint64_t& dropped,
+              std::chrono::milliseconds timeout);
+
+    /**
+     * @brief 关闭：唤醒并结束所有客户端（服务器停止时调用）。
+     */
+    void close();
+    void reopen();
+
+    std::size_t clientCount() const;
+
+private:
+    struct Frame {
+        std::uint64_t seq = 0;
+        Kind kind = Adc;
+        Text text;
+    };
+
+    static constexpr std::size_t kMaxAdcPerWake = 8;
+
+    mutable std::mutex m_;
+    std::condition_variable cv_;
+    std::vector<Frame> ring_;
+    std::uint64_t next_seq_ = 1;
+    Text sticky_[KindCount];
+    bool closed_ = false;
+    std::size_t clients_ = 0;
+};
+
+}  // namespace embedded
+
+#endif  // EVENT_STREAM_H_
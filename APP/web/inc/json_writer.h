@@ -0,0 +1,75 @@
+#ifndef JSON_WRITER_H_
+#define JSON_WRITER_H_
+
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace embedded {
+
+/**
+ * @brief 流式 JSON 写入器（Web 接口响应用）。
+ *
+ * - 直接往一块复用的缓冲里追加，逗号 / 嵌套自动处理，不经过 ostringstream。
+ * - QString 直接按 UTF-16 → UTF-8 转义写入，不产生 toStdString / toUtf8 临时串。
+ * - 数字自己格式化，不受进程 locale 影响（小数点永远是 '.'）。
+ * - local() 返回本线程的实例：每次清空内容但保留容量，稳定后零分配。
+ *
+ * 用法：
+ *   auto& w = JsonWriter::local();
+ *   w.beginObject().key("code").value(0).key("data").beginArray() ... ;
+ *   res.set_content(w.data(), w.size(), "application/json; charset=utf-8");
+ */
+class JsonWriter {
+public:
+    /// 本线程复用实例（已 reset）
+    static JsonWriter& local();
+
+    void reset();
+    const char* data() const { return buf_.data(); }
+    std::size_t size() const { return buf_.size(); }
+    const std::string& str() const { return buf_; }
+
+    JsonWriter& beginObject();
+    JsonWriter& endObject();
+    JsonWriter& beginArray();
+    JsonWriter& endArray();
+
+    /// 键名必须是无需转义的 ASCII 字面量
+    JsonWriter& key(const char* k);
+
+    JsonWriter& value(int v) { return value(static_cast<long long>(v)); }
+    JsonWriter& value(long long v);
+    JsonWriter& value(std::size_t v) { return value(static_cast<unsigned long long>(v)); }
+    JsonWriter& value(unsigned long long v);
+    /// 定点小数（默认 3 位，与原 ostringstream fixed/precision(3) 输出一致）；非有限值写 null
+    JsonWriter& value(double v, int decimals = 3);
+    JsonWriter& value(bool v);
+    JsonWriter& null();
+
+    JsonWriter& string(const char* s, std::size_t n);
+    JsonWriter& string(const char* s);
+    JsonWriter& string(const std::string& s) { return string(s.data(), s.size()); }
+    JsonWriter& string(const QString& s);
+
+    /// 原样写入一个已是合法 JSON 的值
+    JsonWriter& raw(const char* s, std::size_t n);
+
+private:
+    void separate();
+    void appendUnsigned(unsigned long long v);
+    void appendUtf8Escaped(const char* s, std::size_t n);
+    void appendUtf16Escaped(const ushort* s, int n);
+
+    static constexpr int kMaxDepth = 31;
+
+    std::string buf_;
+    std::uint32_t hasItem_ = 0;  // 第 depth 位：该层已写过元素（下一个要先写逗号）
+    int depth_ = 0;
+    bool afterKey_ = false;
+};
+
+}  // namespace embedded
+
+#endif  // JSON_WRITER_H_
@@ -0,0 +1,115 @@
+#ifndef WEB_ADMISSION_H_
+#define WEB_ADMISSION_H_
+
+#include <QSqlDatabase>
+#include <QString>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "httplib.h"
+
+namespace embedded {
+
+/**
+ * @brief 固定大小、低优先级的 httplib 工作线程池。
+ *
+ * - 线程数 / 排队上限由 ServerConfig 决定，不再跟随 CPU 核数。
+ * - 每个工作线程首次执行任务时把自己的 nice 值调低（调度优先级低于采集线程）。
+ * - 排队已满时 enqueue 返回 false，httplib 直接关闭该连接。
+ */
+class PriorityThreadPool : public httplib::TaskQueue {
+public:
+    PriorityThreadPool(std::size_t threads, std::size_t max_queued, int nice_value);
+
+    bool enqueue(std::function<void()> fn) override;
+    void shutdown() override;
+
+private:
+    httplib::ThreadPool pool_;
+    int nice_;
+};
+
+/**
+ * @brief 单个接口的并发上限（非阻塞）。
+ *
+ * 超过上限时调用方立即返回 503 + Retry-After，而不是在线程池里排队占线程。
+ */
+class ConcurrencyGate {
+public:
+    explicit ConcurrencyGate(int limit) : limit_(limit) {}
+
+    class Ticket {
+    public:
+        explicit Ticket(ConcurrencyGate& gate);
+        ~Ticket();
+        Ticket(const Ticket&) = delete;
+        Ticket& operator=(const Ticket&) = delete;
+
+        bool admitted() const { return gate_ != nullptr; }
+
+    private:
+        ConcurrencyGate* gate_ = nullptr;
+    };
+
+    void setLimit(int limit) { limit_.store(limit); }
+    int inFlight() const { return inflight_.load(); }
+
+private:
+    std::atomic<int> limit_;
+    std::atomic<int> inflight_{0};
+};
+
+/**
+ * @brief Web 侧只读数据库连接池。
+ *
+ * QtSql 的连接只能在创建它的线程里使用，所以“池”由两部分组成：
+ * - 每个工作线程一条复用的连接（线程退出时自动 close + removeDatabase）；
+ * - 一个租约计数限制同时读库的请求数，避免网页查询和 DBWorker 抢 SD 卡。
+ */
+class ReaderPool {
+public:
+    void configure(const std::string& db_path, int max_readers,
+                   std::chrono::milliseconds max_wait);
+
+    class Lease {
+    public:
+        explicit Lease(ReaderPool& pool);
+        ~Lease();
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        /// 租约是否拿到且连接已打开
+        bool ok() const { return acquired_ && db_.isOpen(); }
+        /// 因并发已满而拿不到（应回 503），否则是打开失败
+        bool busy() const { return !acquired_; }
+        QSqlDatabase& db() { return db_; }
+        const QString& error() const { return err_; }
+
+    private:
+        ReaderPool& pool_;
+        bool acquired_ = false;
+        QSqlDatabase db_;
+        QString err_;
+    };
+
+private:
+    bool acquire();
+    void release();
+
+    std::mutex m_;
+    std::condition_variable cv_;
+    int max_readers_ = 2;
+    int in_use_ = 0;
+    std::chrono::milliseconds max_wait_{500};
+    std::string db_path_;
+    unsigned generation_ = 0;  // 每次 configure 递增，线程连接据此判断是否重开
+};
+
+}  // namespace embedded
+
+#endif  // WEB_ADMISSION_H_
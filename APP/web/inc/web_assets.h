@@ -0,0 +1,28 @@
+#ifndef WEB_ASSETS_H_
+#define WEB_ASSETS_H_
+
+#include <cstddef>
+
+namespace embedded {
+
+/**
+ * @brief 构建期嵌入的静态资源（由 cmakes/EmbedWebAssets.cmake 生成）。
+ */
+struct WebAsset {
+    const char* path;            ///< 原路径，如 /assets/app.css。
+    const char* hashed_path;     ///< 内容哈希路径（可 immutable 缓存）；html / sw.js 为 nullptr。
+    const char* mime;            ///< Content-Type。
+    const char* etag;            ///< 强 ETag（内容 SHA-256 前 16 位，含引号）。
+    const unsigned char* data;   ///< 原文。
+    std::size_t size;
+    const unsigned char* gz;     ///< gzip 版本（nullptr = 不压缩）。
+    std::size_t gz_size;
+};
+
+extern const WebAsset kWebAssets[];
+extern const std::size_t kWebAssetCount;
+extern const char* const kWebAssetsVersion;  ///< 全部资源的整体哈希。
+
+}  // namespace embedded
+
+#endif  // WEB_ASSETS_H_
@@ -0,0 +1,63 @@
+#ifndef WEB_EVENT_BRIDGE_H_
+#define WEB_EVENT_BRIDGE_H_
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+#include "DTO.h"
+#include "event_stream.h"
+
+class DBWorker;
+class DeviceStatusObject;
+class MainViewModel;
+
+/*
+ * WebEventBridge
+ *
+ * 作用：
+ *   把 Qt 侧的采集 / 设备状态 / 新结果信号转成 SSE 帧，投递到 EmbeddedWebServer::events()
+ *
+ * 特点：
+ *   - ADC 批次在 GUI 线程攒约 200ms，MinMax 抽稀到 ≤128 点再发（带起始下标，丢帧可续画）
+ *   - 设备状态只置脏标记，250ms 定时合并成一帧
+ *   - 新结果直接取 DBWorker::historyRowInserted 的行，无需回查数据库
+ *   - 所有 JSON 在这里格式化一次，所有客户端共享
+ */
+class WebEventBridge : public QObject {
+    Q_OBJECT
+public:
+    WebEventBridge(embedded::EventStream* events,
+                   MainViewModel* mainVm,
+                   DeviceStatusObject* status,
+                   DBWorker* db,
+                   QObject* parent = nullptr);
+
+private slots:
+    void onBatch(const QVector<double>& values);
+    void onAcquisitionStarted(const QString& sampleNo);
+    void onAcquisitionStopped();
+    void onHistoryRowInserted(const HistoryRow& row);
+    void markStatusDirty();
+
+private:
+    void flushAdc();
+    void flushStatus();
+
+private:
+    embedded::EventStream* m_events = nullptr;
+    DeviceStatusObject* m_status = nullptr;
+
+    // ===== ADC =====
+    QVector<double> m_pending;  // 本周期尚未发出的采样
+    qint64 m_sent = 0;          // 本次扫描已发出的采样数（= 下一帧的起始下标）
+    QString m_sampleNo;
+    QTimer m_adcTimer;
+
+    // ===== 设备状态 =====
+    bool m_statusDirty = false;
+    QTimer m_statusTimer;
+};
+
+#endif  // WEB_EVENT_BRIDGE_H_
@@ -8,29 +8,38 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <QByteArray>
 #include <QDebug>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QList>
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
-#include <QThread>
 #include <QVariant>
 #include <algorithm>
+#include <atomic>
 #include <cctype>
 #include <cerrno>
+#include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <set>
-#include <sstream>
 #include <thread>
 #include <utility>
 #include <vector>
 
+#include "AdcArchive.h"
+#include "CurveDecimator.h"
+#include "HistoryExporter.h"
 #include "httplib.h"
+#include "json_writer.h"
+#include "web_admission.h"
+#include "web_assets.h"
 
 #ifndef APP_DEFAULT_WEB_ROOT
 #define APP_DEFAULT_WEB_ROOT "/mnt/SDCARD/www"
@@ -46,112 +55,36 @@
 
 namespace {
 
-// ======================== 数据结构 ========================
-
-struct ProjectInfoData {
-    int id = 0;
-    int project_id = 0;
-    std::string project_name;
-    std::string sample_no;
-    std::string sample_source;
-    std::string sample_name;
-    std::string standard_curve;
-    std::string batch_code;
-    double detected_conc = 0.0;
-    double reference_value = 0.0;
-    std::string result;
-    std::string detected_time;
-    std::string detected_unit;
-    std::string detected_person;
-    std::string dilution_info;
-    double c_value = 0.0;
-    double t_value = 0.0;
-    double ratio_value = 0.0;
-};
-
-// ======================== Qt SQLite 工具 ========================
-
-static QString webDbConnectionName() {
-    return QString("web_sqlite_%1")
-        .arg(reinterpret_cast<quintptr>(QThread::currentThreadId()));
-}
-
-static QSqlDatabase openWebDatabase(const std::string& db_path, QString& err) {
-    const QString connName = webDbConnectionName();
-
-    if (QSqlDatabase::contains(connName)) {
-        QSqlDatabase db = QSqlDatabase::database(connName);
-        if (db.isOpen()) {
-            return db;
-        }
-    }
-
-    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connName);
-    db.setDatabaseName(QString::fromStdString(db_path));
-
-    if (!db.open()) {
-        err = db.lastError().text();
-        qCritical() << "[Web][DB] open failed:" << err;
-    }
-
-    return db;
-}
-
 // ======================== 工具函数 ========================
 
-std::string json_escape(const std::string& src) {
-    std::string out;
-    out.reserve(src.size() + 16);
-    for (unsigned char c : src) {
-        switch (c) {
-        case '"':
-            out += "\\\"";
-            break;
-        case '\\':
-            out += "\\\\";
-            break;
-        case '\b':
-            out += "\\b";
-            break;
-        case '\f':
-            out += "\\f";
-            break;
-        case '\n':
-            out += "\\n";
-            break;
-        case '\r':
-            out += "\\r";
-            break;
-        case '\t':
-            out += "\\t";
-            break;
-        default:
-            if (c < 0x20) {
-                char tmp[8];
-                std::snprintf(tmp, sizeof(tmp), "\\u%04x", c);
-                out += tmp;
-            } else {
-                out.push_back(static_cast<char>(c));
-            }
-            break;
-        }
-    }
-    return out;
-}
-
 void send_json(httplib::Response& res, int status, const std::string& body) {
     res.status = status;
     res.set_header("Cache-Control", "no-cache");
     res.set_content(body, "application/json; charset=utf-8");
 }
 
+// 写入器的内容只拷贝一次进响应，缓冲留给本线程下一次请求
+void send_json(httplib::Response& res, int status, const embedded::JsonWriter& w) {
+    res.status = status;
+    res.set_header("Cache-Control", "no-cache");
+    res.set_content(w.data(), w.size(), "application/json; charset=utf-8");
+}
+
 void send_json_error(httplib::Response& res, int http_status, int code,
                      const std::string& message) {
-    std::ostringstream oss;
-    oss << "{\"code\":" << code
-        << ",\"message\":\"" << json_escape(message)
-        << "\",\"data\":null}";
-    send_json(res, http_status, oss.str());
+    auto& w = embedded::JsonWriter::local();
+    w.beginObject()
+        .key("code").value(code)
+        .key("message").string(message)
+        .key("data").null()
+        .endObject();
+    send_json(res, http_status, w);
+}
+
+// 过载：503 + Retry-After（秒），前端按提示稍后重试
+void send_busy(httplib::Response& res, int retry_after_sec, const std::string& message) {
+    res.set_header("Retry-After", std::to_string(retry_after_sec));
+    send_json_error(res, 503, 1503, message);
 }
 
 int parse_int_safe(const std::string& s, int fallback) {
@@ -166,28 +99,48 @@ int parse_int_safe(const std::string& s, int fallback) {
 
 // ======================== 数据库查询 ========================
 
-bool query_project_detail(const std::string& db_path,
+// project_info 的列顺序，与 write_project_row 一一对应
+const char kProjectColumns[] =
+    "id, projectId, projectName, sampleNo, sampleSource, sampleName, "
+    "standardCurve, batchCode, detectedConc, referenceValue, result, detectedTime, "
+    "detectedUnit, detectedPerson, dilutionInfo, \"C\", \"T\", ratio ";
+
+// 直接从结果集写 JSON：QVariant 里的 QString 是共享的，不再转 std::string / 中间结构体
+void write_project_row(embedded::JsonWriter& w, const QSqlQuery& q) {
+    const double ratio = q.value(17).toDouble();
+    w.beginObject()
+        .key("id").value(q.value(0).toInt())
+        .key("projectId").value(q.value(1).toInt())
+        .key("projectName").string(q.value(2).toString())
+        .key("sampleNo").string(q.value(3).toString())
+        .key("sampleSource").string(q.value(4).toString())
+        .key("sampleName").string(q.value(5).toString())
+        .key("standardCurve").string(q.value(6).toString())
+        .key("batchCode").string(q.value(7).toString())
+        .key("detectedConc").value(q.value(8).toDouble())
+        .key("referenceValue").value(q.value(9).toDouble())
+        .key("result").string(q.value(10).toString())
+        .key("detectedTime").string(q.value(11).toString())
+        .key("detectedUnit").string(q.value(12).toString())
+        .key("detectedPerson").string(q.value(13).toString())
+        .key("dilutionInfo").string(q.value(14).toString())
+        .key("C").value(q.value(15).toDouble())
+        .key("T").value(q.value(16).toDouble())
+        .key("ratio").value(ratio)
+        .key("radio").value(ratio)
+        .endObject();
+}
+
+// 成功时 q 停在该样品最新一行
+bool query_project_detail(QSqlQuery& q,
                           const std::string& sample_no,
-                          ProjectInfoData& out,
                           std::string& err) {
-    QString qerr;
-    QSqlDatabase db = openWebDatabase(db_path, qerr);
-    if (!db.isOpen()) {
-        err = qerr.toStdString();
-        return false;
-    }
-
-    QSqlQuery q(db);
-    q.prepare(
-        "SELECT id, projectId, projectName, sampleNo, sampleSource, sampleName, "
-        "standardCurve, batchCode, detectedConc, referenceValue, result, detectedTime, "
-        "detectedUnit, detectedPerson, dilutionInfo, \"C\", \"T\", ratio "
-        "FROM project_info WHERE sampleNo = ? "
-        "ORDER BY id DESC LIMIT 1");
+    q.setForwardOnly(true);
+    q.prepare(QString("SELECT %1 FROM project_info WHERE sampleNo = ? "
+                      "ORDER BY id DESC LIMIT 1")
+                  .arg(QLatin1String(kProjectColumns)));
     q.addBindValue(QString::fromStdString(sample_no));
     qDebug() << "[Web][DB] query project detail:" << QString::fromStdString(sample_no);
-    qDebug() << q.lastQuery();
-    qDebug() << QString::fromStdString(db_path);
     if (!q.exec()) {
         err = q.lastError().text().toStdString();
         qDebug() << "[Web][DB] query project detail failed:" << q.lastError().text();
@@ -197,54 +150,8 @@ bool query_project_detail(const std::string& db_path,
         err = "not found";
         return false;
     }
-    qDebug() << "----[Web][DB] query project detail result:---";
-
-    out.id = q.value(0).toInt();
-    out.project_id = q.value(1).toInt();
-    out.project_name = q.value(2).toString().toStdString();
-    out.sample_no = q.value(3).toString().toStdString();
-    out.sample_source = q.value(4).toString().toStdString();
-    out.sample_name = q.value(5).toString().toStdString();
-    out.standard_curve = q.value(6).toString().toStdString();
-    out.batch_code = q.value(7).toString().toStdString();
-    out.detected_conc = q.value(8).toDouble();
-    out.reference_value = q.value(9).toDouble();
-    out.result = q.value(10).toString().toStdString();
-    out.detected_time = q.value(11).toString().toStdString();
-    out.detected_unit = q.value(12).toString().toStdString();
-    out.detected_person = q.value(13).toString().toStdString();
-    out.dilution_info = q.value(14).toString().toStdString();
-    out.c_value = q.value(15).toDouble();
-    out.t_value = q.value(16).toDouble();
-    out.ratio_value = q.value(17).toDouble();
-
     return true;
 }
-void append_project_json(std::ostringstream& oss, const ProjectInfoData& p) {
-    oss.setf(std::ios::fixed);
-    oss.precision(3);
-    oss << "{"
-        << "\"id\":" << p.id << ','
-        << "\"projectId\":" << p.project_id << ','
-        << "\"projectName\":\"" << json_escape(p.project_name) << "\","
-        << "\"sampleNo\":\"" << json_escape(p.sample_no) << "\","
-        << "\"sampleSource\":\"" << json_escape(p.sample_source) << "\","
-        << "\"sampleName\":\"" << json_escape(p.sample_name) << "\","
-        << "\"standardCurve\":\"" << json_escape(p.standard_curve) << "\","
-        << "\"batchCode\":\"" << json_escape(p.batch_code) << "\","
-        << "\"detectedConc\":" << p.detected_conc << ','
-        << "\"referenceValue\":" << p.reference_value << ','
-        << "\"result\":\"" << json_escape(p.result) << "\","
-        << "\"detectedTime\":\"" << json_escape(p.detected_time) << "\","
-        << "\"detectedUnit\":\"" << json_escape(p.detected_unit) << "\","
-        << "\"detectedPerson\":\"" << json_escape(p.detected_person) << "\","
-        << "\"dilutionInfo\":\"" << json_escape(p.dilution_info) << "\","
-        << "\"C\":" << p.c_value << ','
-        << "\"T\":" << p.t_value << ','
-        << "\"ratio\":" << p.ratio_value << ','
-        << "\"radio\":" << p.ratio_value
-        << "}";
-}
 // ======================== 路由注册 ========================
 std::string get_param(const httplib::Request& req, const char* name,
                       const std::string& fallback = "") {
@@ -253,40 +160,26 @@ std::string get_param(const httplib::Request& req, const char* name,
     }
     return fallback;
 }
-bool query_project_list(const std::string& db_path,
+// 成功时 q 已执行，调用方逐行 next() 写出
+bool query_project_list(QSqlDatabase& db,
+                        QSqlQuery& q,
                         const std::string& keyword,
                         int limit,
                         int offset,
                         long long& total,
-                        std::vector<ProjectInfoData>& out,
                         std::string& err) {
-    // ========= 1. 打开数据库（线程独立连接） =========
-    const QString connName =
-        QString("web_list_%1").arg(reinterpret_cast<quintptr>(QThread::currentThreadId()));
-
-    QSqlDatabase db;
-    if (QSqlDatabase::contains(connName)) {
-        db = QSqlDatabase::database(connName);
-    } else {
-        db = QSqlDatabase::addDatabase("QSQLITE", connName);
-        db.setDatabaseName(QString::fromStdString(db_path));
-    }
+    const QString like = "%" + QString::fromStdString(keyword) + "%";
 
-    if (!db.open()) {
-        err = db.lastError().text().toStdString();
-        return false;
-    }
-
-    // ========= 2. COUNT =========
+    // ========= 1. COUNT =========
     {
         QSqlQuery qc(db);
+        qc.setForwardOnly(true);
         if (keyword.empty()) {
             qc.prepare("SELECT COUNT(1) FROM project_info");
         } else {
             qc.prepare(
                 "SELECT COUNT(1) FROM project_info "
                 "WHERE sampleNo LIKE ? OR projectName LIKE ? OR sampleName LIKE ?");
-            const QString like = "%" + QString::fromStdString(keyword) + "%";
             qc.addBindValue(like);
             qc.addBindValue(like);
             qc.addBindValue(like);
@@ -299,76 +192,421 @@ bool query_project_list(const std::string& db_path,
         total = qc.value(0).toLongLong();
     }
 
-    // ========= 3. 数据查询 =========
-    QSqlQuery q(db);
+    // ========= 2. 数据查询（只向前游标，不缓存整页）=========
+    q.setForwardOnly(true);
     if (keyword.empty()) {
-        q.prepare(
-            "SELECT id, projectId, projectName, sampleNo, sampleSource, sampleName, "
-            "standardCurve, batchCode, detectedConc, referenceValue, result, detectedTime, "
-            "detectedUnit, detectedPerson, dilutionInfo, \"C\", \"T\", ratio "
-            "FROM project_info "
-            "ORDER BY id DESC LIMIT ? OFFSET ?");
-        q.addBindValue(limit);
-        q.addBindValue(offset);
+        q.prepare(QString("SELECT %1 FROM project_info "
+                          "ORDER BY id DESC LIMIT ? OFFSET ?")
+                      .arg(QLatin1String(kProjectColumns)));
     } else {
-        q.prepare(
-            "SELECT id, projectId, projectName, sampleNo, sampleSource, sampleName, "
-            "standardCurve, batchCode, detectedConc, referenceValue, result, detectedTime, "
-            "detectedUnit, detectedPerson, dilutionInfo, \"C\", \"T\", ratio "
-            "FROM project_info "
-            "WHERE sampleNo LIKE ? OR projectName LIKE ? OR sampleName LIKE ? "
-            "ORDER BY id DESC LIMIT ? OFFSET ?");
-        const QString like = "%" + QString::fromStdString(keyword) + "%";
+        q.prepare(QString("SELECT %1 FROM project_info "
+                          "WHERE sampleNo LIKE ? OR projectName LIKE ? OR sampleName LIKE ? "
+                          "ORDER BY id DESC LIMIT ? OFFSET ?")
+                      .arg(QLatin1String(kProjectColumns)));
         q.addBindValue(like);
         q.addBindValue(like);
         q.addBindValue(like);
-        q.addBindValue(limit);
-        q.addBindValue(offset);
     }
+    q.addBindValue(limit);
+    q.addBindValue(offset);
 
     if (!q.exec()) {
         err = q.lastError().text().toStdString();
         return false;
     }
+    return true;
+}
+
+// ======================== 曲线：版本 / 缓存 / 压缩 ========================
 
-    // ========= 4. 填充数据 =========
-    out.clear();
-    out.reserve(static_cast<size_t>(limit));
-
-    while (q.next()) {
-        ProjectInfoData p;
-        p.id = q.value(0).toInt();
-        p.project_id = q.value(1).toInt();
-        p.project_name = q.value(2).toString().toStdString();
-        p.sample_no = q.value(3).toString().toStdString();
-        p.sample_source = q.value(4).toString().toStdString();
-        p.sample_name = q.value(5).toString().toStdString();
-        p.standard_curve = q.value(6).toString().toStdString();
-        p.batch_code = q.value(7).toString().toStdString();
-        p.detected_conc = q.value(8).toDouble();
-        p.reference_value = q.value(9).toDouble();
-        p.result = q.value(10).toString().toStdString();
-        p.detected_time = q.value(11).toString().toStdString();
-        p.detected_unit = q.value(12).toString().toStdString();
-        p.detected_person = q.value(13).toString().toStdString();
-        p.dilution_info = q.value(14).toString().toStdString();
-        p.c_value = q.value(15).toDouble();
-        p.t_value = q.value(16).toDouble();
-        p.ratio_value = q.value(17).toDouble();
-
-        out.push_back(std::move(p));
+// adc_data 中某个样品的“版本”：行数 + 最大 id，曲线重写或删除后必然变化
+struct CurveVersion {
+    long long rows = 0;
+    long long max_id = 0;
+};
+
+bool query_curve_version(QSqlDatabase& db, const std::string& sample_no, CurveVersion& out) {
+    QSqlQuery q(db);
+    q.prepare("SELECT COUNT(1), IFNULL(MAX(id), 0) FROM adc_data WHERE sampleNo = ?");
+    q.addBindValue(QString::fromStdString(sample_no));
+    if (!q.exec() || !q.next()) {
+        return false;
     }
+    out.rows = q.value(0).toLongLong();
+    out.max_id = q.value(1).toLongLong();
+    if (out.rows == 0) {
+        // 已归档的曲线：行数 + 段内偏移同样唯一标识这一版
+        qint64 rows = 0;
+        qint64 offset = 0;
+        if (AdcArchive::lookup(db, QString::fromStdString(sample_no), rows, offset)) {
+            out.rows = rows;
+            out.max_id = offset;
+        }
+    }
+    return true;
+}
 
+bool load_curve_values(QSqlDatabase& db, const std::string& sample_no, std::vector<double>& out) {
+    QSqlQuery q(db);
+    q.setForwardOnly(true);
+    q.prepare("SELECT adcValues FROM adc_data WHERE sampleNo = ? ORDER BY id ASC");
+    q.addBindValue(QString::fromStdString(sample_no));
+    if (!q.exec()) {
+        return false;
+    }
+    QList<QByteArray> texts;
+    while (q.next())
+        texts << q.value(0).toByteArray();
+    if (texts.isEmpty())
+        AdcArchive::readTrace(db, QString::fromStdString(sample_no), texts);
+    for (const QByteArray& text : texts) {
+        const QJsonDocument doc = QJsonDocument::fromJson(text);
+        if (!doc.isArray())
+            continue;
+        const QJsonArray arr = doc.array();
+        out.reserve(out.size() + static_cast<size_t>(arr.size()));
+        for (const auto& v : arr) out.push_back(v.toDouble());
+    }
     return true;
 }
 
-void register_routes(httplib::Server& svr, embedded::ServerConfig& cfg) {
+// 该样品最近一条结果保存的 C/T 峰位（曲线下标），抽稀时必须保留；没有结果 / 未记录时为空
+std::vector<int> query_curve_pins(QSqlDatabase& db, const std::string& sample_no) {
+    std::vector<int> pins;
+    QSqlQuery q(db);
+    q.prepare("SELECT idxC, idxT FROM project_info WHERE sampleNo = ? ORDER BY id DESC LIMIT 1");
+    q.addBindValue(QString::fromStdString(sample_no));
+    if (!q.exec() || !q.next()) {
+        return pins;
+    }
+    for (int col = 0; col < 2; ++col) {
+        const int idx = q.value(col).toInt();
+        if (idx >= 0) {
+            pins.push_back(idx);
+        }
+    }
+    return pins;
+}
+
+uint64_t fnv1a64(const std::string& s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// 强 ETag：样品号 + 数据版本 + 表示形式（格式 / 抽稀参数 / 固定点 / 内容编码）
+std::string make_curve_etag(const std::string& sample_no, const CurveVersion& ver,
+                            char format, int points, int mode, const std::vector<int>& pins,
+                            bool deflated) {
+    std::string pin_key;
+    for (int p : pins) {
+        pin_key += std::to_string(p);
+        pin_key += ',';
+    }
+    char buf[128];
+    std::snprintf(buf, sizeof(buf), "\"%c1-%016llx-%llx-%llx-%d-%d-%08x%s\"",
+                  format, static_cast<unsigned long long>(fnv1a64(sample_no)),
+                  static_cast<unsigned long long>(ver.max_id),
+                  static_cast<unsigned long long>(ver.rows),
+                  points, mode, static_cast<unsigned>(fnv1a64(pin_key)),
+                  deflated ? "-z" : "");
+    return buf;
+}
+
+// If-None-Match：逗号分隔列表，支持 *，比较时忽略 W/ 前缀（RFC 7232 弱比较）
+bool etag_matches(const httplib::Request& req, const std::string& etag) {
+    if (!req.has_header("If-None-Match")) {
+        return false;
+    }
+    const std::string header = req.get_header_value("If-None-Match");
+    size_t pos = 0;
+    while (pos < header.size()) {
+        size_t end = header.find(',', pos);
+        if (end == std::string::npos)
+            end = header.size();
+        std::string tag = header.substr(pos, end - pos);
+        const size_t b = tag.find_first_not_of(" \t");
+        const size_t e = tag.find_last_not_of(" \t");
+        tag = (b == std::string::npos) ? std::string() : tag.substr(b, e - b + 1);
+        if (tag.compare(0, 2, "W/") == 0)
+            tag.erase(0, 2);
+        if (tag == "*" || tag == etag)
+            return true;
+        pos = end + 1;
+    }
+    return false;
+}
+
+// coding 为小写，如 "gzip" / "deflate"
+bool accepts_encoding(const httplib::Request& req, const char* coding) {
+    if (!req.has_header("Accept-Encoding")) {
+        return false;
+    }
+    std::string ae = req.get_header_value("Accept-Encoding");
+    std::transform(ae.begin(), ae.end(), ae.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    const size_t p = ae.find(coding);
+    if (p == std::string::npos)
+        return false;
+    // gzip;q=0 表示明确拒绝
+    const size_t q = ae.find("q=0", p);
+    const size_t comma = ae.find(',', p);
+    return !(q != std::string::npos && (comma == std::string::npos || q < comma) &&
+             (q + 3 >= ae.size() || ae[q + 3] != '.'));
+}
+
+// HTTP deflate = zlib 流（RFC 1950）；qCompress 输出多一个 4 字节长度前缀，去掉即可
+std::string deflate_body(const std::string& body) {
+    const QByteArray z = qCompress(reinterpret_cast<const uchar*>(body.data()),
+                                   static_cast<int>(body.size()), 6);
+    if (z.size() <= 4) {
+        return std::string();
+    }
+    return std::string(z.constData() + 4, static_cast<size_t>(z.size() - 4));
+}
+
+// 小于这个大小不值得压缩
+constexpr size_t kDeflateMinBytes = 512;
+
+void send_cacheable(httplib::Response& res, std::string body, const char* content_type,
+                    bool deflated, const std::string& etag) {
+    res.status = 200;
+    res.set_header("Cache-Control", "no-cache");  // 每次带 If-None-Match 回来验证
+    res.set_header("ETag", etag);
+    res.set_header("Vary", "Accept-Encoding");
+    if (deflated) {
+        res.set_header("Content-Encoding", "deflate");
+    }
+    res.set_content(std::move(body), content_type);
+}
+
+// ===== 二进制曲线（application/x-fq-curve）=====
+// 小端：
+//   0  "FQC1"                4 字节魔数
+//   4  u16 version = 1
+//   6  u16 flags             bit0 = 附带原始下标
+//   8  u32 pointCount        原始点数
+//   12 u32 n                 下发点数
+//   16 f32 min / max / avg   原始曲线统计
+//   28 f32 base / scale      y = base + q * scale
+//   36 i16 q[0]，随后 n-1 个 i16 差分（q 量化到 0..32767，差分不会溢出）
+//   若 bit0：u32 x[0]，随后 n-1 个 u32 差分
+constexpr int kCurveQuantLevels = 32767;
+constexpr size_t kCurveHeaderBytes = 36;
+
+void put_u16(std::string& out, uint16_t v) {
+    out.push_back(static_cast<char>(v & 0xff));
+    out.push_back(static_cast<char>((v >> 8) & 0xff));
+}
+
+void put_u32(std::string& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+}
+
+void put_f32(std::string& out, float f) {
+    uint32_t v = 0;
+    std::memcpy(&v, &f, sizeof(v));
+    put_u32(out, v);
+}
+
+std::string encode_curve_bin(const std::vector<double>& ys, const std::vector<int>& idx,
+                             double min_v, double max_v, double avg_v, bool with_x) {
+    const size_t n = idx.size();
+    double base = 0.0;
+    double top = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        const double v = ys[static_cast<size_t>(idx[i])];
+        if (i == 0 || v < base)
+            base = v;
+        if (i == 0 || v > top)
+            top = v;
+    }
+    const double scale = (top > base) ? (top - base) / kCurveQuantLevels : 1.0;
+
+    std::string out;
+    out.reserve(kCurveHeaderBytes + n * (with_x ? 6 : 2));
+    out.append("FQC1", 4);
+    put_u16(out, 1);
+    put_u16(out, with_x ? 1 : 0);
+    put_u32(out, static_cast<uint32_t>(ys.size()));
+    put_u32(out, static_cast<uint32_t>(n));
+    put_f32(out, static_cast<float>(min_v));
+    put_f32(out, static_cast<float>(max_v));
+    put_f32(out, static_cast<float>(avg_v));
+    put_f32(out, static_cast<float>(base));
+    put_f32(out, static_cast<float>(scale));
+
+    int prev = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const double v = ys[static_cast<size_t>(idx[i])];
+        int q = static_cast<int>(std::lround((v - base) / scale));
+        q = std::max(0, std::min(kCurveQuantLevels, q));
+        put_u16(out, static_cast<uint16_t>(static_cast<int16_t>(q - prev)));
+        prev = q;
+    }
+    if (with_x) {
+        uint32_t prev_x = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const uint32_t x = static_cast<uint32_t>(idx[i]);
+            put_u32(out, x - prev_x);
+            prev_x = x;
+        }
+    }
+    return out;
+}
+
+// ======================== 内嵌静态资源 ========================
+
+std::string escape_regex(const std::string& s) {
+    std::string out;
+    out.reserve(s.size() + 8);
+    for (char c : s) {
+        if (std::strchr(".^$|()[]{}*+?\\", c)) {
+            out.push_back('\\');
+        }
+        out.push_back(c);
+    }
+    return out;
+}
+
+// 哈希路径：内容变了 URL 就变，可以永久缓存；原路径：每次验证 ETag
+void register_embedded_assets(httplib::Server& svr) {
+    for (size_t i = 0; i < embedded::kWebAssetCount; ++i) {
+        const embedded::WebAsset* a = &embedded::kWebAssets[i];
+        // gzip 与原文是不同表示，强 ETag 需要区分
+        std::string etag_gz = a->etag;
+        etag_gz.insert(etag_gz.size() - 1, "-gz");
+
+        auto make_handler = [a, etag_gz](bool immutable) {
+            return [a, etag_gz, immutable](const httplib::Request& req, httplib::Response& res) {
+                const bool gzip = a->gz && accepts_encoding(req, "gzip");
+                const std::string etag = gzip ? etag_gz : std::string(a->etag);
+                res.set_header("Cache-Control", immutable ? "public, max-age=31536000, immutable"
+                                                          : "no-cache");
+                res.set_header("Vary", "Accept-Encoding");
+                res.set_header("ETag", etag);
+                if (etag_matches(req, etag)) {
+                    res.status = 304;
+                    return;
+                }
+                res.status = 200;
+                if (gzip) {
+                    res.set_header("Content-Encoding", "gzip");
+                    res.set_content(reinterpret_cast<const char*>(a->gz), a->gz_size, a->mime);
+                } else {
+                    res.set_content(reinterpret_cast<const char*>(a->data), a->size, a->mime);
+                }
+            };
+        };
+
+        svr.Get(escape_regex(a->path), make_handler(false));
+        if (a->hashed_path) {
+            svr.Get(escape_regex(a->hashed_path), make_handler(true));
+        }
+    }
+}
+
+// ======================== 实时推送（SSE）========================
+
+constexpr int kStreamKeepAliveSec = 15;
+
+void register_stream_route(httplib::Server& svr, embedded::EventStream* events,
+                           std::size_t max_clients) {
+    svr.Get("/api/stream", [events, max_clients](const httplib::Request&,
+                                                  httplib::Response& res) {
+        struct Client {
+            std::uint64_t cursor = 0;
+            std::uint64_t dropped = 0;
+            std::vector<embedded::EventStream::Text> initial;
+            std::vector<embedded::EventStream::Text> frames;
+            bool greeted = false;
+            std::atomic<bool> released{false};
+        };
+        auto client = std::make_shared<Client>();
+        if (!events->attach(max_clients, client->cursor, client->initial)) {
+            send_busy(res, 10, "实时推送连接数已满");
+            return;
+        }
+        qInfo() << "[Web][SSE] client attached, total =" << static_cast<int>(events->clientCount());
+
+        res.set_header("Cache-Control", "no-cache");
+        res.set_header("X-Accel-Buffering", "no");
+        res.set_chunked_content_provider(
+            "text/event-stream",
+            [events, client](size_t, httplib::DataSink& sink) {
+                if (!client->greeted) {
+                    client->greeted = true;
+                    static const char kRetry[] = "retry: 3000\n\n";
+                    if (!sink.write(kRetry, sizeof(kRetry) - 1))
+                        return false;
+                    for (const auto& t : client->initial) {
+                        if (!sink.write(t->data(), t->size()))
+                            return false;
+                    }
+                    client->initial.clear();
+                }
+
+                const std::uint64_t dropped_before = client->dropped;
+                if (!events->wait(client->cursor, client->frames, client->dropped,
+                                  std::chrono::seconds(kStreamKeepAliveSec))) {
+                    sink.done();  // 服务器停止
+                    return true;
+                }
+                if (client->dropped != dropped_before) {
+                    // 告诉前端中间丢了帧（曲线按 ADC 帧里的起始下标续画）
+                    const std::string gap = "event: gap\ndata: {\"dropped\":" +
+                                            std::to_string(client->dropped - dropped_before) +
+                                            "}\n\n";
+                    if (!sink.write(gap.data(), gap.size()))
+                        return false;
+                }
+                if (client->frames.empty()) {
+                    static const char kPing[] = ": ping\n\n";  // 保活，同时探测断开的客户端
+                    return sink.write(kPing, sizeof(kPing) - 1);
+                }
+                for (const auto& t : client->frames) {
+                    if (!sink.write(t->data(), t->size()))
+                        return false;
+                }
+                return true;
+            },
+            [events, client](bool) {
+                if (!client->released.exchange(true)) {
+                    events->detach();
+                    qInfo() << "[Web][SSE] client detached, total ="
+                            << static_cast<int>(events->clientCount());
+                }
+            });
+    });
+}
+
+// ======================== 准入控制 ========================
+
+// 同一时刻允许的重接口数量 + 共享只读连接；超过就 503，绝不排队抢采集线程的 CPU
+struct RouteLimits {
+    embedded::ReaderPool readers;
+    embedded::ConcurrencyGate curve{2};
+    embedded::ConcurrencyGate query{4};
+    embedded::ConcurrencyGate exports{1};  // 导出一次只允许一个
+
+    void configure(const embedded::ServerConfig& cfg) {
+        readers.configure(cfg.db_path, cfg.db_readers,
+                          std::chrono::milliseconds(cfg.db_wait_ms));
+        curve.setLimit(cfg.max_curve_requests);
+        query.setLimit(cfg.max_query_requests);
+    }
+};
+
+void register_routes(httplib::Server& svr, RouteLimits& lim) {
     svr.Get("/api/health", [](const httplib::Request&, httplib::Response& res) {
         send_json(res, 200,
                   "{\"code\":0,\"message\":\"成功\",\"data\":{\"status\":\"up\"}}");
     });
 
-    svr.Get("/api/detect/detail", [&cfg](const httplib::Request& req,
+    svr.Get("/api/detect/detail", [&lim](const httplib::Request& req,
                                          httplib::Response& res) {
         const auto sample_no = req.get_param_value("sampleNo");
         if (sample_no.empty()) {
@@ -376,25 +614,40 @@ void register_routes(httplib::Server& svr, embedded::ServerConfig& cfg) {
             return;
         }
 
-        ProjectInfoData p;
+        embedded::ConcurrencyGate::Ticket ticket(lim.query);
+        if (!ticket.admitted()) {
+            send_busy(res, 1, "服务器繁忙，请稍后重试");
+            return;
+        }
+        embedded::ReaderPool::Lease lease(lim.readers);
+        if (!lease.ok()) {
+            if (lease.busy()) {
+                send_busy(res, 1, "服务器繁忙，请稍后重试");
+            } else {
+                send_json_error(res, 500, 1500, "数据库打开失败");
+            }
+            return;
+        }
+
+        QSqlQuery q(lease.db());
         std::string err;
-        if (!query_project_detail(cfg.db_path, sample_no, p, err)) {
+        if (!query_project_detail(q, sample_no, err)) {
             send_json_error(res, 404, 1404, "样品不存在");
             return;
         }
 
-        std::ostringstream oss;
-        oss << "{\"code\":0,\"message\":\"成功\",\"data\":";
-        append_project_json(oss, p);
-        oss << '}';
-        send_json(res, 200, oss.str());
+        auto& w = embedded::JsonWriter::local();
+        w.beginObject().key("code").value(0).key("message").string("成功").key("data");
+        write_project_row(w, q);
+        w.endObject();
+        send_json(res, 200, w);
     });
-    svr.Get("/api/project/list", [&cfg](const httplib::Request& req, httplib::Response& res) {
+    svr.Get("/api/project/list", [&lim](const httplib::Request& req, httplib::Response& res) {
         int limit = parse_int_safe(get_param(req, "limit", "20"), 20);
         if (limit < 1) {
             limit = 1;
-        } else if (limit > 100) {
-            limit = 100;
+        } else if (limit > 500) {
+            limit = 500;
         }
         int page = parse_int_safe(get_param(req, "page", "1"), 1);
         if (page < 1) {
@@ -403,25 +656,42 @@ void register_routes(httplib::Server& svr, embedded::ServerConfig& cfg) {
         const int offset = (page - 1) * limit;
 
         const std::string keyword = get_param(req, "keyword", "");
-        std::vector<ProjectInfoData> items;
         long long total = 0;
         std::string db_err;
-        if (!query_project_list(cfg.db_path, keyword, limit, offset, total, items, db_err)) {
+        embedded::ConcurrencyGate::Ticket ticket(lim.query);
+        if (!ticket.admitted()) {
+            send_busy(res, 1, "服务器繁忙，请稍后重试");
+            return;
+        }
+        embedded::ReaderPool::Lease lease(lim.readers);
+        if (!lease.ok()) {
+            if (lease.busy()) {
+                send_busy(res, 1, "服务器繁忙，请稍后重试");
+            } else {
+                send_json_error(res, 500, 1500, "数据库打开失败");
+            }
+            return;
+        }
+        QSqlQuery q(lease.db());
+        if (!query_project_list(lease.db(), q, keyword, limit, offset, total, db_err)) {
             send_json_error(res, 500, 1500, "项目列表查询失败");
             return;
         }
 
-        std::ostringstream oss;
-        oss << "{\"code\":0,\"message\":\"成功\",\"data\":{\"page\":" << page
-            << ",\"pageSize\":" << limit << ",\"total\":" << total << ",\"items\":[";
-        for (size_t i = 0; i < items.size(); ++i) {
-            if (i > 0) {
-                oss << ',';
-            }
-            append_project_json(oss, items[i]);
+        auto& w = embedded::JsonWriter::local();
+        w.beginObject()
+            .key("code").value(0)
+            .key("message").string("成功")
+            .key("data").beginObject()
+            .key("page").value(page)
+            .key("pageSize").value(limit)
+            .key("total").value(total)
+            .key("items").beginArray();
+        while (q.next()) {
+            write_project_row(w, q);
         }
-        oss << "]}}";
-        send_json(res, 200, oss.str());
+        w.endArray().endObject().endObject();
+        send_json(res, 200, w);
     });
     svr.Get("/", [](const httplib::Request&, httplib::Response& res) {
         res.set_redirect("/projects.html");
@@ -438,79 +708,228 @@ void register_routes(httplib::Server& svr, embedded::ServerConfig& cfg) {
         res.set_redirect(redirect_to);
     });
 
-    svr.Get("/api/detect/curve", [&cfg](const httplib::Request& req, httplib::Response& res) {
-        const std::string sample_no = get_param(req, "sampleNo", "");
-        if (sample_no.empty()) {
-            send_json_error(res, 400, 1004, "sampleNo不能为空");
-            return;
-        }
+    // ===== 曲线：JSON（/api/detect/curve）与紧凑二进制（/api/detect/curve.bin）=====
+    // 两者共用：?sampleNo=&points=N&mode=minmax|lttb，强 ETag + If-None-Match→304，按需 deflate
+    auto curve_handler = [&lim](bool binary) {
+        return [&lim, binary](const httplib::Request& req, httplib::Response& res) {
+            const std::string sample_no = get_param(req, "sampleNo", "");
+            if (sample_no.empty()) {
+                send_json_error(res, 400, 1004, "sampleNo不能为空");
+                return;
+            }
 
-        QList<double> adc_values;
-        std::string db_err;
-        QString qerr;
-        QSqlDatabase db = openWebDatabase(cfg.db_path, qerr);
-        if (!db.isOpen()) {
-            send_json_error(res, 404, 1404, "数据库打开失败");
-            return;
-        }
+            // 曲线解析 / 抽稀 / 压缩都吃 CPU：并发封顶，超出直接 503
+            embedded::ConcurrencyGate::Ticket ticket(lim.curve);
+            if (!ticket.admitted()) {
+                send_busy(res, 2, "曲线请求过多，请稍后重试");
+                return;
+            }
+            embedded::ReaderPool::Lease lease(lim.readers);
+            if (!lease.ok()) {
+                if (lease.busy()) {
+                    send_busy(res, 1, "服务器繁忙，请稍后重试");
+                } else {
+                    send_json_error(res, 500, 1500, "数据库打开失败");
+                }
+                return;
+            }
+            QSqlDatabase& db = lease.db();
+
+            // ===== 可选抽稀：?points=N&mode=minmax|lttb =====
+            int points = parse_int_safe(get_param(req, "points", "0"), 0);
+            if (points < 0) {
+                points = 0;
+            } else if (points > 4096) {
+                points = 4096;
+            }
+            const CurveDecimator::Mode mode =
+                CurveDecimator::parseMode(get_param(req, "mode", "").c_str());
+
+            // ===== 先只查版本：命中缓存时不读、不解析曲线 =====
+            CurveVersion ver;
+            if (!query_curve_version(db, sample_no, ver)) {
+                send_json_error(res, 404, 1404, "获取曲线失败");
+                return;
+            }
+            if (ver.rows == 0) {
+                send_json_error(res, 404, 1404, "曲线数据为空");
+                return;
+            }
+            // 检测时保存的 C/T 峰位：抽稀不能把峰顶抽掉；结果晚于曲线落库时 ETag 随之变化
+            const std::vector<int> pins = query_curve_pins(db, sample_no);
+            const char format = binary ? 'b' : 'j';
+            const bool deflate = accepts_encoding(req, "deflate");
+            const std::string etag_plain =
+                make_curve_etag(sample_no, ver, format, points, static_cast<int>(mode), pins, false);
+            const std::string etag_z =
+                make_curve_etag(sample_no, ver, format, points, static_cast<int>(mode), pins, true);
+            // 客户端持有未压缩版本（小曲线不压缩）同样有效
+            const bool hit_z = deflate && etag_matches(req, etag_z);
+            if (hit_z || etag_matches(req, etag_plain)) {
+                res.status = 304;
+                res.set_header("ETag", hit_z ? etag_z : etag_plain);
+                res.set_header("Cache-Control", "no-cache");
+                res.set_header("Vary", "Accept-Encoding");
+                return;
+            }
 
-        QSqlQuery q(db);
-        q.prepare(
-            "SELECT  adcValues FROM adc_data WHERE sampleNo = ? ORDER BY id ASC");
-        q.addBindValue(QString::fromStdString(sample_no));
-        if (!q.exec()) {
-            send_json_error(res, 404, 1404, "获取曲线失败");
-            return;
-        }
-        // if (!q.next()) {
-        //     send_json_error(res, 404, 1404, "111111");
-        //     return;
-        // }
-        while (q.next()) {
-            QString json = q.value(0).toString();
-            QJsonDocument doc = QJsonDocument::fromJson(json.toUtf8());
-            if (!doc.isArray())
-                continue;
+            std::vector<double> ys;
+            if (!load_curve_values(db, sample_no, ys)) {
+                send_json_error(res, 404, 1404, "获取曲线失败");
+                return;
+            }
+            if (ys.empty()) {
+                send_json_error(res, 404, 1404, "曲线数据为空");
+                return;
+            }
 
-            QJsonArray arr = doc.array();
-            for (auto v : arr) adc_values.append(v.toDouble());
-        }
-        // adc_values = q.value(0).value<QVector<double>>();
-        if (adc_values.empty()) {
-            send_json_error(res, 404, 1404, "曲线数据为空");
-            return;
-        }
+            double min_v = 0.0;
+            double max_v = 0.0;
+            double sum = 0.0;
+            for (size_t i = 0; i < ys.size(); ++i) {
+                const double v = ys[i];
+                if (i == 0 || v < min_v) {
+                    min_v = v;
+                }
+                if (i == 0 || v > max_v) {
+                    max_v = v;
+                }
+                sum += v;
+            }
+            const double avg_v = sum / static_cast<double>(ys.size());
 
-        double min_v = 0.0;
-        double max_v = 0.0;
-        double sum = 0.0;
-        for (size_t i = 0; i < adc_values.size(); ++i) {
-            const double v = adc_values[i];
-            if (i == 0 || v < min_v) {
-                min_v = v;
+            const std::vector<int> idx =
+                CurveDecimator::decimate(ys.data(), static_cast<int>(ys.size()), points, mode, pins);
+            const bool decimated = idx.size() < ys.size();
+
+            std::string body;
+            const char* content_type = "application/json; charset=utf-8";
+            if (binary) {
+                body = encode_curve_bin(ys, idx, min_v, max_v, avg_v, decimated);
+                content_type = "application/x-fq-curve";
+            } else {
+                auto& w = embedded::JsonWriter::local();
+                w.beginObject()
+                    .key("code").value(0)
+                    .key("message").string("成功")
+                    .key("data").beginObject()
+                    .key("sampleNo").string(sample_no)
+                    .key("pointCount").value(ys.size())
+                    .key("xAxisName").string("数据点")
+                    .key("yAxisName").string("电压值")
+                    .key("stats").beginObject()
+                    .key("min").value(min_v)
+                    .key("max").value(max_v)
+                    .key("avg").value(avg_v)
+                    .endObject()
+                    .key("adcValues").beginArray();
+                for (size_t i = 0; i < idx.size(); ++i) {
+                    w.value(ys[static_cast<size_t>(idx[i])]);
+                }
+                w.endArray();
+                // 抽稀后附带原始下标，前端按原始 X 绘制
+                if (decimated) {
+                    w.key("xValues").beginArray();
+                    for (size_t i = 0; i < idx.size(); ++i) {
+                        w.value(idx[i]);
+                    }
+                    w.endArray();
+                }
+                w.endObject().endObject();
+                body.assign(w.data(), w.size());
             }
-            if (i == 0 || v > max_v) {
-                max_v = v;
+
+            bool deflated = false;
+            if (deflate && body.size() >= kDeflateMinBytes) {
+                std::string z = deflate_body(body);
+                if (!z.empty() && z.size() < body.size()) {
+                    body.swap(z);
+                    deflated = true;
+                }
             }
-            sum += v;
+            send_cacheable(res, std::move(body), content_type, deflated,
+                           deflated ? etag_z : etag_plain);
+        };
+    };
+    svr.Get("/api/detect/curve", curve_handler(false));
+    svr.Get("/api/detect/curve.bin", curve_handler(true));
+
+    // ===== 批量导出：?format=csv|bundle&traces=1&from=&to=（detectedTime，含端点）=====
+    // 分块响应：每块重新租一次读连接，块之间不占库；总行数放在 X-Export-Rows
+    svr.Get("/api/export", [&lim](const httplib::Request& req, httplib::Response& res) {
+        struct Job {
+            std::unique_ptr<embedded::ConcurrencyGate::Ticket> ticket;
+            std::unique_ptr<HistoryExporter> exporter;
+        };
+        auto job = std::make_shared<Job>();
+        job->ticket.reset(new embedded::ConcurrencyGate::Ticket(lim.exports));
+        if (!job->ticket->admitted()) {
+            send_busy(res, 30, "已有导出任务在进行");
+            return;
         }
 
-        std::ostringstream oss;
-        oss.setf(std::ios::fixed);
-        oss.precision(3);
-        oss << "{\"code\":0,\"message\":\"成功\",\"data\":{\"sampleNo\":\""
-            << json_escape(sample_no) << "\",\"pointCount\":" << adc_values.size()
-            << ",\"xAxisName\":\"数据点\",\"yAxisName\":\"电压值\""
-            << ",\"stats\":{\"min\":" << min_v << ",\"max\":" << max_v
-            << ",\"avg\":" << (sum / static_cast<double>(adc_values.size())) << "},\"adcValues\":[";
-        for (size_t i = 0; i < adc_values.size(); ++i) {
-            if (i > 0) {
-                oss << ',';
+        HistoryExporter::Options opt;
+        opt.format = HistoryExporter::parseFormat(QString::fromStdString(get_param(req, "format", "csv")));
+        opt.includeTraces = get_param(req, "traces", "0") == "1";
+        opt.chunkRows = opt.includeTraces ? 50 : 500;
+        opt.fromTime = QString::fromStdString(get_param(req, "from", ""));
+        opt.toTime = QString::fromStdString(get_param(req, "to", ""));
+        job->exporter.reset(new HistoryExporter(opt));
+
+        {
+            embedded::ReaderPool::Lease lease(lim.readers);
+            QString qerr;
+            if (!lease.ok() || !job->exporter->prepare(lease.db(), qerr)) {
+                if (lease.busy()) {
+                    send_busy(res, 1, "服务器繁忙，请稍后重试");
+                } else {
+                    send_json_error(res, 500, 1500, "导出查询失败");
+                }
+                return;
             }
-            oss << adc_values[i];
         }
-        oss << "]}}";
-        send_json(res, 200, oss.str());
+
+        char name[64];
+        const std::time_t now = std::time(nullptr);
+        std::tm tmv;
+        localtime_r(&now, &tmv);
+        std::strftime(name, sizeof(name), "history_%Y%m%d_%H%M%S", &tmv);
+        res.set_header("Content-Disposition",
+                       std::string("attachment; filename=\"") + name + "." +
+                           HistoryExporter::fileSuffix(opt.format) + "\"");
+        res.set_header("X-Export-Rows", std::to_string(job->exporter->totalRows()));
+        res.set_header("Cache-Control", "no-store");
+
+        res.set_chunked_content_provider(
+            HistoryExporter::contentType(opt.format),
+            [&lim, job](size_t, httplib::DataSink& sink) {
+                struct Sink : ExportSink {
+                    explicit Sink(httplib::DataSink& s) : s_(s) {}
+                    bool write(const char* data, qint64 size) override {
+                        return s_.write(data, static_cast<size_t>(size));
+                    }
+                    httplib::DataSink& s_;
+                } out(sink);
+
+                embedded::ReaderPool::Lease lease(lim.readers);
+                if (!lease.ok()) {
+                    if (!lease.busy())
+                        return false;
+                    // 读连接都在忙：让出一会儿，httplib 会再来要下一块
+                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                    return true;
+                }
+                QString qerr;
+                if (!job->exporter->step(lease.db(), out, qerr)) {
+                    qWarning() << "[Web][Export] aborted:" << qerr;
+                    return false;
+                }
+                if (job->exporter->finished()) {
+                    qInfo() << "[Web][Export] done, rows =" << job->exporter->rowsWritten();
+                    sink.done();
+                }
+                return true;
+            });
     });
 }
 
@@ -524,6 +943,8 @@ struct EmbeddedWebServer::Impl {
     explicit Impl(ServerConfig c) : cfg(std::move(c)) {}
     ServerConfig cfg;
     httplib::Server server;
+    EventStream events;
+    RouteLimits limits;
     std::thread worker;
     bool started = false;
 };
@@ -554,32 +975,53 @@ bool EmbeddedWebServer::start(std::string& err) {
             << "port =" << cfg.port
             << "web_root =" << cfg.web_root.c_str();
 
-    // 1️⃣ 挂载静态目录
-    if (!impl_->server.set_mount_point("/", cfg.web_root)) {
+    // 1️⃣ 静态资源：默认用编译进程序的版本（内存 + 预压缩），不读 SD 卡
+    if (cfg.embedded_assets && kWebAssetCount > 0) {
+        register_embedded_assets(impl_->server);
+        qInfo() << "[Web] embedded assets:" << static_cast<int>(kWebAssetCount)
+                << "version =" << kWebAssetsVersion;
+    } else if (!impl_->server.set_mount_point("/", cfg.web_root)) {
         err = "挂载静态目录失败";
         return false;
     }
 
-    // 2️⃣ 注册路由
+    // 2️⃣ 工作线程池：固定大小 + 低优先级；SSE 长连接之外至少留两条线程给普通请求
+    const int min_threads = cfg.max_stream_clients + 2;
+    const int threads = std::max(cfg.worker_threads, min_threads);
+    const std::size_t max_queued = static_cast<std::size_t>(std::max(cfg.max_queued_requests, 0));
+    const int nice_value = cfg.worker_nice;
+    impl_->server.new_task_queue = [threads, max_queued, nice_value] {
+        return new PriorityThreadPool(static_cast<std::size_t>(threads), max_queued, nice_value);
+    };
+    impl_->limits.configure(cfg);
+    qInfo() << "[Web] workers =" << threads << "nice =" << nice_value
+            << "queue =" << static_cast<int>(max_queued)
+            << "curve/query/stream limit =" << cfg.max_curve_requests << cfg.max_query_requests
+            << cfg.max_stream_clients << "db readers =" << cfg.db_readers;
+
+    // 3️⃣ 注册路由
     qDebug() << "[Web] register routes";
-    register_routes(impl_->server, cfg);
+    register_routes(impl_->server, impl_->limits);
+    impl_->events.reopen();
+    register_stream_route(impl_->server, &impl_->events,
+                          static_cast<std::size_t>(std::max(cfg.max_stream_clients, 0)));
     qDebug() << "[Web] routes registered";
 
-    // 3️⃣ 先 bind（关键）
+    // 4️⃣ 先 bind（关键）
     if (!impl_->server.bind_to_port(cfg.host.c_str(), cfg.port)) {
         err = "bind 端口失败，可能已被占用";
         qCritical() << "[Web] bind failed";
         return false;
     }
 
-    // 4️⃣ listen 放线程
+    // 5️⃣ listen 放线程
     impl_->worker = std::thread([this]() {
         qInfo() << "[Web] listening...";
         impl_->server.listen_after_bind();
         qWarning() << "[Web] listen thread exit";
     });
 
-    // 5️⃣ 等待 server ready
+    // 6️⃣ 等待 server ready
     impl_->server.wait_until_ready();
 
     impl_->started = true;
@@ -589,6 +1031,7 @@ bool EmbeddedWebServer::start(std::string& err) {
 void EmbeddedWebServer::stop() {
     if (!impl_)
         return;
+    impl_->events.close();  // 先放掉阻塞在 SSE 等待里的工作线程
     impl_->server.stop();
     if (impl_->worker.joinable()) {
         impl_->worker.join();
@@ -600,4 +1043,8 @@ bool EmbeddedWebServer::isRunning() const {
     return impl_ && impl_->started;
 }
 
+EventStream& EmbeddedWebServer::events() {
+    return impl_->events;
+}
+
 }  // namespace embedded
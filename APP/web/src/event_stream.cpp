@@ -0,0 +1,121 @@
+#include "event_stream.h"
+
+#include <algorithm>
+
+namespace embedded {
+
+EventStream::EventStream(std::size_t capacity)
+    : ring_(std::max<std::size_t>(capacity, 16)) {
+}
+
+void EventStream::publish(Kind kind, const char* event, const std::string& json) {
+    std::string text;
+    text.reserve(json.size() + 48);
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        const std::uint64_t seq = next_seq_++;
+        text.append("id: ").append(std::to_string(seq));
+        text.append("\nevent: ").append(event);
+        text.append("\ndata: ").append(json).append("\n\n");
+
+        Frame& f = ring_[seq % ring_.size()];
+        f.seq = seq;
+        f.kind = kind;
+        f.text = std::make_shared<const std::string>(std::move(text));
+        if (kind == Status || kind == Scan) {
+            sticky_[kind] = f.text;
+        }
+    }
+    cv_.notify_all();
+}
+
+bool EventStream::attach(std::size_t max_clients, std::uint64_t& cursor,
+                         std::vector<Text>& initial) {
+    std::lock_guard<std::mutex> lk(m_);
+    if (closed_ || clients_ >= max_clients) {
+        return false;
+    }
+    ++clients_;
+    cursor = next_seq_ - 1;
+    initial.clear();
+    if (sticky_[Scan])
+        initial.push_back(sticky_[Scan]);
+    if (sticky_[Status])
+        initial.push_back(sticky_[Status]);
+    return true;
+}
+
+void EventStream::detach() {
+    std::lock_guard<std::mutex> lk(m_);
+    if (clients_ > 0) {
+        --clients_;
+    }
+}
+
+bool EventStream::wait(std::uint64_t& cursor, std::vector<Text>& out, std::uint64_t& dropped,
+                       std::chrono::milliseconds timeout) {
+    out.clear();
+    {
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait_for(lk, timeout, [&] { return closed_ || next_seq_ - 1 > cursor; });
+        if (closed_) {
+            return false;
+        }
+
+        const std::uint64_t head = next_seq_ - 1;
+        if (head <= cursor) {
+            return true;  // 超时，无新帧
+        }
+        const std::uint64_t oldest = next_seq_ > ring_.size() ? next_seq_ - ring_.size() : 1;
+        std::uint64_t from = cursor + 1;
+        if (from < oldest) {
+            dropped += oldest - from;  // 落后超过环形容量
+            from = oldest;
+        }
+
+        // 从新到旧扫描做合并，再反转回时间顺序
+        bool have_status = false;
+        std::size_t adc_kept = 0;
+        for (std::uint64_t s = head; s >= from; --s) {
+            const Frame& f = ring_[s % ring_.size()];
+            bool keep = true;
+            if (f.kind == Status) {
+                keep = !have_status;
+                have_status = true;
+            } else if (f.kind == Adc) {
+                keep = adc_kept < kMaxAdcPerWake;
+                ++adc_kept;
+            }
+            if (keep) {
+                out.push_back(f.text);
+            } else {
+                ++dropped;
+            }
+            if (s == from)
+                break;
+        }
+        cursor = head;
+    }
+    std::reverse(out.begin(), out.end());
+    return true;
+}
+
+void EventStream::close() {
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        closed_ = true;
+    }
+    cv_.notify_all();
+}
+
+void EventStream::reopen() {
+    std::lock_guard<std::mutex> lk(m_);
+    closed_ = false;
+}
+
+std::size_t EventStream::clientCount() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return clients_;
+}
+
+}  // namespace embedded
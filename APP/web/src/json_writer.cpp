@@ -0,0 +1,284 @@
+#include "json_writer.h"
+
+#include <cmath>
+#include <cstdio>
+
+namespace embedded {
+
+namespace {
+
+constexpr std::size_t kInitialCapacity = 16 * 1024;
+
+const char kHex[] = "0123456789abcdef";
+
+const unsigned long long kPow10[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL,
+    1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+};
+
+inline void append_control_escape(std::string& out, unsigned c) {
+    switch (c) {
+    case '\b': out += "\\b"; break;
+    case '\f': out += "\\f"; break;
+    case '\n': out += "\\n"; break;
+    case '\r': out += "\\r"; break;
+    case '\t': out += "\\t"; break;
+    default: {
+        const char esc[6] = {'\\', 'u', '0', '0', kHex[(c >> 4) & 0xF], kHex[c & 0xF]};
+        out.append(esc, sizeof(esc));
+        break;
+    }
+    }
+}
+
+}  // namespace
+
+JsonWriter& JsonWriter::local() {
+    thread_local JsonWriter w;
+    w.reset();
+    return w;
+}
+
+void JsonWriter::reset() {
+    if (buf_.capacity() < kInitialCapacity) {
+        buf_.reserve(kInitialCapacity);
+    }
+    buf_.clear();
+    hasItem_ = 0;
+    depth_ = 0;
+    afterKey_ = false;
+}
+
+// 值之前：对象里键名后直接写；数组 / 对象里非首个元素先补逗号
+void JsonWriter::separate() {
+    if (afterKey_) {
+        afterKey_ = false;
+        return;
+    }
+    const std::uint32_t bit = 1u << depth_;
+    if (hasItem_ & bit) {
+        buf_ += ',';
+    }
+    hasItem_ |= bit;
+}
+
+JsonWriter& JsonWriter::beginObject() {
+    separate();
+    buf_ += '{';
+    if (depth_ < kMaxDepth) {
+        ++depth_;
+    }
+    hasItem_ &= ~(1u << depth_);
+    return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+    buf_ += '}';
+    if (depth_ > 0) {
+        --depth_;
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::beginArray() {
+    separate();
+    buf_ += '[';
+    if (depth_ < kMaxDepth) {
+        ++depth_;
+    }
+    hasItem_ &= ~(1u << depth_);
+    return *this;
+}
+
+JsonWriter& JsonWriter::endArray() {
+    buf_ += ']';
+    if (depth_ > 0) {
+        --depth_;
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(const char* k) {
+    separate();
+    buf_ += '"';
+    buf_ += k;
+    buf_ += "\":";
+    afterKey_ = true;
+    return *this;
+}
+
+// ======================== 数字 ========================
+
+void JsonWriter::appendUnsigned(unsigned long long v) {
+    char tmp[24];
+    int pos = sizeof(tmp);
+    do {
+        tmp[--pos] = static_cast<char>('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+    buf_.append(tmp + pos, sizeof(tmp) - pos);
+}
+
+JsonWriter& JsonWriter::value(long long v) {
+    separate();
+    if (v < 0) {
+        buf_ += '-';
+        appendUnsigned(0ULL - static_cast<unsigned long long>(v));
+    } else {
+        appendUnsigned(static_cast<unsigned long long>(v));
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(unsigned long long v) {
+    separate();
+    appendUnsigned(v);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double v, int decimals) {
+    separate();
+    if (!std::isfinite(v)) {
+        buf_ += "null";
+        return *this;
+    }
+    if (decimals < 0) {
+        decimals = 0;
+    } else if (decimals > 9) {
+        decimals = 9;
+    }
+
+    const double scaled = std::fabs(v) * static_cast<double>(kPow10[decimals]) + 0.5;
+    if (scaled >= 9.0e18) {
+        // 超出整数定点范围（实际数据不会出现），退回科学计数法
+        char tmp[32];
+        const int n = std::snprintf(tmp, sizeof(tmp), "%.17g", v);
+        for (int i = 0; i < n; ++i) {
+            buf_ += (tmp[i] == ',') ? '.' : tmp[i];
+        }
+        return *this;
+    }
+
+    const unsigned long long n = static_cast<unsigned long long>(scaled);
+    if (v < 0 && n != 0) {
+        buf_ += '-';
+    }
+    appendUnsigned(n / kPow10[decimals]);
+    if (decimals > 0) {
+        unsigned long long frac = n % kPow10[decimals];
+        char tmp[10];
+        for (int i = decimals - 1; i >= 0; --i) {
+            tmp[i] = static_cast<char>('0' + frac % 10);
+            frac /= 10;
+        }
+        buf_ += '.';
+        buf_.append(tmp, static_cast<std::size_t>(decimals));
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool v) {
+    separate();
+    buf_ += v ? "true" : "false";
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separate();
+    buf_ += "null";
+    return *this;
+}
+
+// ======================== 字符串 ========================
+
+void JsonWriter::appendUtf8Escaped(const char* s, std::size_t n) {
+    std::size_t run = 0;  // 连续无需转义的字节整段追加
+    for (std::size_t i = 0; i < n; ++i) {
+        const unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        buf_.append(s + run, i - run);
+        run = i + 1;
+        if (c == '"') {
+            buf_ += "\\\"";
+        } else if (c == '\\') {
+            buf_ += "\\\\";
+        } else {
+            append_control_escape(buf_, c);
+        }
+    }
+    buf_.append(s + run, n - run);
+}
+
+void JsonWriter::appendUtf16Escaped(const ushort* s, int n) {
+    for (int i = 0; i < n; ++i) {
+        unsigned cp = s[i];
+        if (cp < 0x80) {
+            if (cp >= 0x20 && cp != '"' && cp != '\\') {
+                buf_ += static_cast<char>(cp);
+            } else if (cp == '"') {
+                buf_ += "\\\"";
+            } else if (cp == '\\') {
+                buf_ += "\\\\";
+            } else {
+                append_control_escape(buf_, cp);
+            }
+            continue;
+        }
+        if (cp >= 0xD800 && cp <= 0xDBFF && i + 1 < n && s[i + 1] >= 0xDC00 && s[i + 1] <= 0xDFFF) {
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (s[i + 1] - 0xDC00);
+            ++i;
+        } else if (cp >= 0xD800 && cp <= 0xDFFF) {
+            cp = 0xFFFD;  // 孤立代理项
+        }
+
+        char u8[4];
+        std::size_t len;
+        if (cp < 0x800) {
+            u8[0] = static_cast<char>(0xC0 | (cp >> 6));
+            u8[1] = static_cast<char>(0x80 | (cp & 0x3F));
+            len = 2;
+        } else if (cp < 0x10000) {
+            u8[0] = static_cast<char>(0xE0 | (cp >> 12));
+            u8[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            u8[2] = static_cast<char>(0x80 | (cp & 0x3F));
+            len = 3;
+        } else {
+            u8[0] = static_cast<char>(0xF0 | (cp >> 18));
+            u8[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            u8[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            u8[3] = static_cast<char>(0x80 | (cp & 0x3F));
+            len = 4;
+        }
+        buf_.append(u8, len);
+    }
+}
+
+JsonWriter& JsonWriter::string(const char* s, std::size_t n) {
+    separate();
+    buf_ += '"';
+    appendUtf8Escaped(s, n);
+    buf_ += '"';
+    return *this;
+}
+
+JsonWriter& JsonWriter::string(const char* s) {
+    return s ? string(s, std::char_traits<char>::length(s)) : null();
+}
+
+JsonWriter& JsonWriter::string(const QString& s) {
+    separate();
+    buf_ += '"';
+    appendUtf16Escaped(s.utf16(), s.size());
+    buf_ += '"';
+    return *this;
+}
+
+JsonWriter& JsonWriter::raw(const char* s, std::size_t n) {
+    separate();
+    buf_.append(s, n);
+    return *this;
+}
+
+}  // namespace embedded
@@ -0,0 +1,166 @@
+#include "web_admission.h"
+
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <QDebug>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+#include <cerrno>
+#include <cstring>
+
+namespace embedded {
+
+// ======================== 低优先级线程池 ========================
+
+PriorityThreadPool::PriorityThreadPool(std::size_t threads, std::size_t max_queued,
+                                       int nice_value)
+    : pool_(threads, max_queued), nice_(nice_value) {
+}
+
+bool PriorityThreadPool::enqueue(std::function<void()> fn) {
+    const int nice_value = nice_;
+    return pool_.enqueue([nice_value, fn]() {
+        // 每个线程只设一次；Linux 上 nice 值按线程（tid）生效
+        thread_local bool lowered = false;
+        if (!lowered) {
+            lowered = true;
+            const pid_t tid = static_cast<pid_t>(::syscall(SYS_gettid));
+            if (::setpriority(PRIO_PROCESS, static_cast<id_t>(tid), nice_value) != 0) {
+                qWarning() << "[Web] setpriority failed:" << std::strerror(errno);
+            }
+        }
+        fn();
+    });
+}
+
+void PriorityThreadPool::shutdown() {
+    pool_.shutdown();
+}
+
+// ======================== 接口并发闸门 ========================
+
+ConcurrencyGate::Ticket::Ticket(ConcurrencyGate& gate) {
+    const int limit = gate.limit_.load();
+    int cur = gate.inflight_.load();
+    while (limit <= 0 || cur < limit) {
+        if (gate.inflight_.compare_exchange_weak(cur, cur + 1)) {
+            gate_ = &gate;
+            return;
+        }
+    }
+}
+
+ConcurrencyGate::Ticket::~Ticket() {
+    if (gate_) {
+        gate_->inflight_.fetch_sub(1);
+    }
+}
+
+// ======================== 只读连接池 ========================
+
+namespace {
+
+// 线程私有连接：线程池线程退出（server.stop）时析构，连接随之释放
+struct ThreadReader {
+    QString name;
+    unsigned generation = 0;
+    bool added = false;
+
+    void drop() {
+        if (!added)
+            return;
+        {
+            QSqlDatabase db = QSqlDatabase::database(name, false);
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(name);
+        added = false;
+    }
+
+    ~ThreadReader() { drop(); }
+};
+
+QSqlDatabase thread_reader(const std::string& db_path, unsigned generation, QString& err) {
+    thread_local ThreadReader tr;
+    if (tr.added && tr.generation != generation) {
+        tr.drop();  // 服务器重启 / 库路径变化
+    }
+    if (!tr.added) {
+        tr.name = QString("web_reader_%1")
+                      .arg(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", tr.name);
+        db.setDatabaseName(QString::fromStdString(db_path));
+        db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=2000");
+        tr.added = true;
+        tr.generation = generation;
+    }
+
+    QSqlDatabase db = QSqlDatabase::database(tr.name, false);
+    if (!db.isOpen()) {
+        if (!db.open()) {
+            err = db.lastError().text();
+            qCritical() << "[Web][DB] open failed:" << err;
+            return db;
+        }
+        // Web 侧只读：防止误写，也让 SQLite 少拿锁
+        QSqlQuery(db).exec("PRAGMA query_only=1");
+    }
+    return db;
+}
+
+}  // namespace
+
+void ReaderPool::configure(const std::string& db_path, int max_readers,
+                           std::chrono::milliseconds max_wait) {
+    std::lock_guard<std::mutex> lk(m_);
+    db_path_ = db_path;
+    max_readers_ = max_readers > 0 ? max_readers : 1;
+    max_wait_ = max_wait;
+    ++generation_;
+}
+
+bool ReaderPool::acquire() {
+    std::unique_lock<std::mutex> lk(m_);
+    if (!cv_.wait_for(lk, max_wait_, [this] { return in_use_ < max_readers_; })) {
+        return false;
+    }
+    ++in_use_;
+    return true;
+}
+
+void ReaderPool::release() {
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        --in_use_;
+    }
+    cv_.notify_one();
+}
+
+ReaderPool::Lease::Lease(ReaderPool& pool) : pool_(pool) {
+    if (!pool_.acquire()) {
+        err_ = "reader pool busy";
+        return;
+    }
+    acquired_ = true;
+
+    std::string path;
+    unsigned generation = 0;
+    {
+        std::lock_guard<std::mutex> lk(pool_.m_);
+        path = pool_.db_path_;
+        generation = pool_.generation_;
+    }
+    db_ = thread_reader(path, generation, err_);
+}
+
+ReaderPool::Lease::~Lease() {
+    db_ = QSqlDatabase();  // 先放掉句柄引用，连接本身留给本线程复用
+    if (acquired_) {
+        pool_.release();
+    }
+}
+
+}  // namespace embedded
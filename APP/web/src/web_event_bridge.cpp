@@ -0,0 +1,171 @@
+#include "web_event_bridge.h"
+
+#include <QDebug>
+#include <vector>
+
+#include "CurveDecimator.h"
+#include "DBWorker.h"
+#include "DeviceStatusObject.h"
+#include "MainViewModel.h"
+#include "json_writer.h"
+
+namespace {
+
+constexpr int kAdcFlushMs = 200;
+constexpr int kAdcMaxPoints = 128;
+constexpr int kStatusFlushMs = 250;
+
+}  // namespace
+
+WebEventBridge::WebEventBridge(embedded::EventStream* events,
+                               MainViewModel* mainVm,
+                               DeviceStatusObject* status,
+                               DBWorker* db,
+                               QObject* parent)
+    : QObject(parent), m_events(events), m_status(status) {
+    m_adcTimer.setInterval(kAdcFlushMs);
+    connect(&m_adcTimer, &QTimer::timeout, this, &WebEventBridge::flushAdc);
+
+    m_statusTimer.setInterval(kStatusFlushMs);
+    connect(&m_statusTimer, &QTimer::timeout, this, &WebEventBridge::flushStatus);
+
+    if (mainVm) {
+        connect(mainVm, &MainViewModel::newDataBatch, this, &WebEventBridge::onBatch);
+        connect(mainVm, &MainViewModel::acquisitionStarted, this, &WebEventBridge::onAcquisitionStarted);
+        connect(mainVm, &MainViewModel::acquisitionStopped, this, &WebEventBridge::onAcquisitionStopped);
+    }
+    if (db) {
+        connect(db, &DBWorker::historyRowInserted, this, &WebEventBridge::onHistoryRowInserted,
+                Qt::QueuedConnection);
+    }
+    if (m_status) {
+        // ===== 任一字段变化只置脏，定时合并 =====
+        const char* const kSignals[] = {
+            SIGNAL(currentTempChanged()), SIGNAL(targetTempChanged()),
+            SIGNAL(powerOnHomeChanged()), SIGNAL(cardHomeChanged()),
+            SIGNAL(incubStateChanged()), SIGNAL(motorStateChanged()),
+            SIGNAL(incubPos1Changed()), SIGNAL(incubPos2Changed()), SIGNAL(incubPos3Changed()),
+            SIGNAL(incubPos4Changed()), SIGNAL(incubPos5Changed()), SIGNAL(incubPos6Changed()),
+            SIGNAL(incubRemain1Changed()), SIGNAL(incubRemain2Changed()), SIGNAL(incubRemain3Changed()),
+            SIGNAL(incubRemain4Changed()), SIGNAL(incubRemain5Changed()), SIGNAL(incubRemain6Changed()),
+        };
+        for (const char* sig : kSignals)
+            connect(m_status, sig, this, SLOT(markStatusDirty()));
+        m_statusDirty = true;
+        m_statusTimer.start();
+    }
+}
+
+// ======================== ADC ========================
+
+void WebEventBridge::onBatch(const QVector<double>& values) {
+    if (values.isEmpty())
+        return;
+    m_pending += values;
+    if (!m_adcTimer.isActive())
+        m_adcTimer.start();
+}
+
+void WebEventBridge::onAcquisitionStarted(const QString& sampleNo) {
+    m_pending.clear();
+    m_sent = 0;
+    m_sampleNo = sampleNo;
+
+    auto& w = embedded::JsonWriter::local();
+    w.beginObject().key("state").string("started").key("sampleNo").string(sampleNo).endObject();
+    m_events->publish(embedded::EventStream::Scan, "scan", w.str());
+}
+
+void WebEventBridge::onAcquisitionStopped() {
+    flushAdc();
+    m_adcTimer.stop();
+
+    auto& w = embedded::JsonWriter::local();
+    w.beginObject()
+        .key("state").string("stopped")
+        .key("sampleNo").string(m_sampleNo)
+        .key("n").value(static_cast<long long>(m_sent))
+        .endObject();
+    m_events->publish(embedded::EventStream::Scan, "scan", w.str());
+}
+
+void WebEventBridge::flushAdc() {
+    if (m_pending.isEmpty()) {
+        m_adcTimer.stop();  // 采集空闲时不空转
+        return;
+    }
+    const int n = m_pending.size();
+    const std::vector<int> idx =
+        CurveDecimator::decimate(m_pending.constData(), n, kAdcMaxPoints,
+                                 CurveDecimator::Mode::MinMax);
+
+    auto& w = embedded::JsonWriter::local();
+    w.beginObject()
+        .key("offset").value(static_cast<long long>(m_sent))
+        .key("n").value(n)
+        .key("x").beginArray();
+    for (int i : idx) {
+        w.value(static_cast<long long>(m_sent + i));
+    }
+    w.endArray().key("y").beginArray();
+    for (int i : idx) {
+        w.value(m_pending[i], 6);
+    }
+    w.endArray().endObject();
+
+    m_events->publish(embedded::EventStream::Adc, "adc", w.str());
+    m_sent += n;
+    m_pending.clear();
+}
+
+// ======================== 设备状态 ========================
+
+void WebEventBridge::markStatusDirty() {
+    m_statusDirty = true;
+}
+
+void WebEventBridge::flushStatus() {
+    if (!m_statusDirty || !m_status)
+        return;
+    m_statusDirty = false;
+
+    auto& w = embedded::JsonWriter::local();
+    w.beginObject()
+        .key("currentTemp").value(static_cast<double>(m_status->currentTemp()), 1)
+        .key("targetTemp").value(static_cast<double>(m_status->targetTemp()), 1)
+        .key("incubState").value(m_status->incubState())
+        .key("motorState").value(m_status->motorState())
+        .key("powerOnHome").value(m_status->powerOnHome())
+        .key("cardHome").value(m_status->cardHome());
+
+    const bool pos[DeviceStatusSnapshot::kSlotCount] = {
+        m_status->incubPos1(), m_status->incubPos2(), m_status->incubPos3(),
+        m_status->incubPos4(), m_status->incubPos5(), m_status->incubPos6()};
+    w.key("incubPos").beginArray();
+    for (bool p : pos) {
+        w.value(p);
+    }
+    w.endArray().key("incubRemain").beginArray();
+    for (int i = 0; i < DeviceStatusSnapshot::kSlotCount; ++i) {
+        w.value(m_status->incubRemain(i));
+    }
+    w.endArray().endObject();
+
+    m_events->publish(embedded::EventStream::Status, "status", w.str());
+}
+
+// ======================== 新结果 ========================
+
+void WebEventBridge::onHistoryRowInserted(const HistoryRow& row) {
+    auto& w = embedded::JsonWriter::local();
+    w.beginObject()
+        .key("id").value(row.id)
+        .key("sampleNo").string(row.sampleNo)
+        .key("projectName").string(row.projectName)
+        .key("result").string(row.result)
+        .key("detectedConc").value(row.detectedConc)
+        .key("detectedUnit").string(row.detectedUnit)
+        .key("detectedTime").string(row.detectedTime)
+        .endObject();
+    m_events->publish(embedded::EventStream::Result, "result", w.str());
+}
@@ -0,0 +1,69 @@
+// 曲线二进制接口 /api/detect/curve.bin 的解码（格式见 embedded_web_server.cpp encode_curve_bin）
+// 浏览器自动处理 Content-Encoding: deflate 与 ETag/304 缓存验证
+
+const MAGIC = "FQC1";
+const HEADER_BYTES = 36;
+
+export function decodeCurve(buffer) {
+  const view = new DataView(buffer);
+  if (buffer.byteLength < HEADER_BYTES) {
+    throw new Error("曲线数据长度不足");
+  }
+  const magic = String.fromCharCode(view.getUint8(0), view.getUint8(1), view.getUint8(2), view.getUint8(3));
+  if (magic !== MAGIC || view.getUint16(4, true) !== 1) {
+    throw new Error("曲线数据格式不支持");
+  }
+  const flags = view.getUint16(6, true);
+  const pointCount = view.getUint32(8, true);
+  const n = view.getUint32(12, true);
+  const stats = {
+    min: view.getFloat32(16, true),
+    max: view.getFloat32(20, true),
+    avg: view.getFloat32(24, true),
+  };
+  const base = view.getFloat32(28, true);
+  const scale = view.getFloat32(32, true);
+  const hasX = (flags & 1) !== 0;
+  if (buffer.byteLength < HEADER_BYTES + n * (hasX ? 6 : 2)) {
+    throw new Error("曲线数据被截断");
+  }
+
+  const values = new Array(n);
+  let off = HEADER_BYTES;
+  let q = 0;
+  for (let i = 0; i < n; i += 1, off += 2) {
+    q += view.getInt16(off, true);
+    values[i] = base + q * scale;
+  }
+
+  let xs = null;
+  if (hasX) {
+    xs = new Array(n);
+    let x = 0;
+    for (let i = 0; i < n; i += 1, off += 4) {
+      x += view.getUint32(off, true);
+      xs[i] = x;
+    }
+  }
+  return { pointCount, stats, values, xs };
+}
+
+// points = 0 表示取全部原始点（导出用）
+export async function fetchCurve(sampleNo, points = 0) {
+  const params = new URLSearchParams({ sampleNo });
+  if (points > 0) {
+    params.set("points", String(points));
+  }
+  const res = await fetch(`/api/detect/curve.bin?${params.toString()}`);
+  if (!res.ok) {
+    let message = `HTTP ${res.status}`;
+    try {
+      const payload = await res.json();
+      message = payload.message || message;
+    } catch (_) {
+      // 错误体不是 JSON 时保留 HTTP 状态
+    }
+    throw new Error(message);
+  }
+  return decodeCurve(await res.arrayBuffer());
+}
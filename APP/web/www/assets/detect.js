@@ -1,3 +1,5 @@
+import { fetchCurve } from "./curve.js";
+
 const refs = {
   sampleNoInput: document.getElementById("sampleNoInput"),
   loadBtn: document.getElementById("loadBtn"),
@@ -9,6 +11,8 @@ const refs = {
 
 const state = {
   points: [],
+  xs: null,
+  total: 0,
   xAxisName: "数据点",
   yAxisName: "电压值",
 };
@@ -145,9 +149,12 @@ function drawCurve(points) {
   ctx.textAlign = "center";
   ctx.textBaseline = "top";
   const hasMultiplePoints = points.length > 1;
+  // 抽稀后的曲线带原始下标 xValues，X 轴仍按原始点数计算
+  const xs = state.xs && state.xs.length === points.length ? state.xs : null;
+  const total = xs ? Math.max(state.total, 1) : points.length;
   for (let i = 0; i <= xTicks; i += 1) {
     const x = margin.left + (plotW * i) / xTicks;
-    const idx = hasMultiplePoints ? Math.round(((points.length - 1) * i) / xTicks) + 1 : 1;
+    const idx = hasMultiplePoints ? Math.round(((total - 1) * i) / xTicks) + 1 : 1;
     ctx.fillText(String(idx), x, margin.top + plotH + 8);
   }
 
@@ -170,7 +177,8 @@ function drawCurve(points) {
   if (hasMultiplePoints) {
     ctx.beginPath();
     for (let i = 0; i < points.length; i += 1) {
-      const x = margin.left + (plotW * i) / (points.length - 1);
+      const xi = xs ? xs[i] : i;
+      const x = margin.left + (plotW * xi) / (total - 1);
       const y = margin.top + ((yMax - points[i]) / (yMax - yMin)) * plotH;
       if (i === 0) {
         ctx.moveTo(x, y);
@@ -190,6 +198,12 @@ function drawCurve(points) {
   ctx.fill();
 }
 
+// 曲线按画布物理像素宽度抽稀，设备端只下发需要绘制的点
+function curveTargetPoints() {
+  const dpr = window.devicePixelRatio || 1;
+  return Math.max(320, Math.floor(refs.canvas.clientWidth * dpr));
+}
+
 async function loadData() {
   refs.error.textContent = "";
   const sampleNo = (refs.sampleNoInput.value || "").trim();
@@ -200,27 +214,27 @@ async function loadData() {
   refs.sampleNoInput.value = sampleNo;
 
   try {
-    const [detailRes, curveRes] = await Promise.all([
+    const [detailRes, curve] = await Promise.all([
       fetch(`/api/detect/detail?sampleNo=${encodeURIComponent(sampleNo)}`),
-      fetch(`/api/detect/curve?sampleNo=${encodeURIComponent(sampleNo)}`),
+      fetchCurve(sampleNo, curveTargetPoints()).catch((err) => {
+        throw new Error(err.message || "曲线接口失败");
+      }),
     ]);
 
     const detailPayload = await detailRes.json();
-    const curvePayload = await curveRes.json();
 
     if (!detailRes.ok || detailPayload.code !== 0) {
       throw new Error(detailPayload.message || "详情接口失败");
     }
-    if (!curveRes.ok || curvePayload.code !== 0) {
-      throw new Error(curvePayload.message || "曲线接口失败");
-    }
 
     renderDetail(detailPayload.data);
-    renderStats(curvePayload.data.pointCount, curvePayload.data.stats);
+    renderStats(curve.pointCount, curve.stats);
 
-    state.points = curvePayload.data.adcValues || [];
-    state.xAxisName = curvePayload.data.xAxisName || "数据点";
-    state.yAxisName = curvePayload.data.yAxisName || "电压值";
+    state.points = curve.values;
+    state.xs = curve.xs;
+    state.total = curve.pointCount || state.points.length;
+    state.xAxisName = "数据点";
+    state.yAxisName = "电压值";
     drawCurve(state.points);
   } catch (err) {
     refs.error.textContent = `加载失败：${err.message}`;
@@ -251,3 +265,63 @@ if (urlSampleNo) {
 if (urlSampleNo) {
   void loadData();
 }
+
+// ===== 实时推送：正在采集的曲线边测边画，出结果后换成完整曲线 =====
+const live = {
+  sampleNo: "",
+  active: false,
+  drawQueued: false,
+};
+
+function queueLiveDraw() {
+  if (live.drawQueued) return;
+  live.drawQueued = true;
+  requestAnimationFrame(() => {
+    live.drawQueued = false;
+    drawCurve(state.points);
+  });
+}
+
+function followingLive() {
+  const input = (refs.sampleNoInput.value || "").trim();
+  return !input || input === live.sampleNo;
+}
+
+function connectStream() {
+  if (typeof EventSource === "undefined") return;
+  const es = new EventSource("/api/stream");
+
+  es.addEventListener("scan", (ev) => {
+    const msg = JSON.parse(ev.data);
+    live.sampleNo = msg.sampleNo || "";
+    live.active = msg.state === "started";
+    if (live.active && followingLive()) {
+      refs.sampleNoInput.value = live.sampleNo;
+      state.points = [];
+      state.xs = [];
+      state.total = 0;
+      queueLiveDraw();
+    }
+  });
+
+  es.addEventListener("adc", (ev) => {
+    if (!live.active || !followingLive()) return;
+    const msg = JSON.parse(ev.data);
+    if (!state.xs) state.xs = [];
+    for (let i = 0; i < msg.y.length; i += 1) {
+      state.xs.push(msg.x[i]);
+      state.points.push(msg.y[i]);
+    }
+    state.total = msg.offset + msg.n;
+    queueLiveDraw();
+  });
+
+  es.addEventListener("result", (ev) => {
+    const msg = JSON.parse(ev.data);
+    if (msg.sampleNo && msg.sampleNo === (refs.sampleNoInput.value || "").trim()) {
+      void loadData();
+    }
+  });
+}
+
+connectStream();
@@ -1,3 +1,5 @@
+import { fetchCurve } from "./curve.js";
+
 const PAGE_SIZE = 20;
 
 const state = {
@@ -14,6 +16,7 @@ const refs = {
   searchBtn: document.getElementById("searchBtn"),
   resetBtn: document.getElementById("resetBtn"),
   exportBtn: document.getElementById("exportBtn"),
+  exportAllBtn: document.getElementById("exportAllBtn"),
   summary: document.getElementById("summaryText"),
   selectedInfo: document.getElementById("selectedInfo"),
   tableWrap: document.getElementById("projectTableWrap"),
@@ -367,12 +370,12 @@ async function exportSelected() {
     const curvePayloads = await Promise.all(
       projectRows.map(async (p) => {
         const sampleNo = p.sampleNo || "";
-        const res = await fetch(`/api/detect/curve?sampleNo=${encodeURIComponent(sampleNo)}`);
-        const payload = await res.json();
-        if (!res.ok || payload.code !== 0) {
-          throw new Error(`样品 ${sampleNo} 曲线查询失败：${payload.message || `HTTP ${res.status}`}`);
+        try {
+          const curve = await fetchCurve(sampleNo);
+          return curve.values.map((v) => Number(v.toFixed(3)));
+        } catch (err) {
+          throw new Error(`样品 ${sampleNo} 曲线查询失败：${err.message}`);
         }
-        return payload.data?.adcValues || [];
       })
     );
 
@@ -442,6 +445,11 @@ if (refs.selectPageCheckbox) {
   });
 }
 
+// 全表导出由设备端分块流式生成，浏览器直接下载
+refs.exportAllBtn.addEventListener("click", () => {
+  window.location.href = "/api/export?format=csv";
+});
+
 refs.exportBtn.addEventListener("click", () => {
   void exportSelected();
 });
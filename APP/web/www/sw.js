@@ -1,4 +1,4 @@
-const CACHE_NAME = "embedded-web-cache-v13";
+const CACHE_NAME = "embedded-web-cache-v14";  // 内嵌构建时自动替换为资源整体哈希，无需手改
 const CORE_ASSETS = [
   "/",
   "/index.html",
@@ -9,6 +9,7 @@ const CORE_ASSETS = [
   "/assets/app.css",
   "/assets/projects.js",
   "/assets/detect.js",
+  "/assets/curve.js",
 ];
 
 self.addEventListener("install", (event) => {
@@ -0,0 +1,36 @@
+#ifndef RTNL_MONITOR_H
+#define RTNL_MONITOR_H
+
+#include <string>
+
+/**
+ * @brief rtnetlink 监听（链路 up/down、IPv4 地址增删）+ 接口状态查询
+ *
+ * 代替 "ip link show" / "ip -4 addr show" 轮询：
+ *  - open() 订阅 RTMGRP_LINK | RTMGRP_IPV4_IFADDR，fd() 可交给 QSocketNotifier
+ *  - drain() 读完当前所有消息，返回其中是否有关于 ifname 的
+ *  - isRunning() / ipv4Address() 用 ioctl 即时查询，不起进程
+ */
+class RtnlMonitor {
+public:
+    RtnlMonitor() = default;
+    ~RtnlMonitor();
+    RtnlMonitor(const RtnlMonitor&) = delete;
+    RtnlMonitor& operator=(const RtnlMonitor&) = delete;
+
+    bool open();
+    void close();
+    int fd() const { return m_fd; }
+
+    bool drain(const std::string& ifname);
+
+    // IFF_UP 且 IFF_RUNNING（载波正常）
+    static bool isRunning(const std::string& ifname);
+    // 点分十进制，无地址返回空串
+    static std::string ipv4Address(const std::string& ifname);
+
+private:
+    int m_fd = -1;
+};
+
+#endif  // RTNL_MONITOR_H
@@ -5,6 +5,9 @@
 #include <QString>
 #include <QVariantList>
 
+#include <atomic>
+
+#include "WifiLinkWatcher.h"
 #include "WorkerQueue.h"
 #include "wifiManage.h"
 /**
@@ -19,6 +22,8 @@ class WiFiController : public QObject {
     Q_OBJECT
 public:
     explicit WiFiController(QObject* parent = nullptr);
+    // 启动链路监听；构造时不碰 wpa_supplicant / rtnetlink
+    void start();
 
     // ===== QML / 上层接口 =====
     Q_INVOKABLE void turnOn();
@@ -41,6 +46,8 @@ signals:
     void connectFailed(const QString& reason);
     void scanFinished(const QVariantList& list);
     void defaultWifiResult(const bool wifi_state);
+    // wlan0 是否真正在线（已关联 + 链路 up + 有 IPv4），由事件驱动
+    void linkStateChanged(bool connected);
 
 private:
     // WiFi 任务类型
@@ -65,10 +72,16 @@ private:
 
     // 真正执行任务（后台线程调用）
     void executeTask(const Task& task);
+    void onDhcpNeeded();
 
 private:
+    static constexpr int kDhcpRetryMs = 10000;
+
     WiFiManage m_wifi;     // 你已有的 WiFi 实现
-    WorkerQueue m_worker;  // 后台任务队列
+    WifiLinkWatcher m_link;
+    std::atomic<bool> m_dhcpQueued{false};
+    bool m_started = false;
+    WorkerQueue m_worker;  // 后台任务队列（最后构造、最先析构）
 };
 
 #endif  // WIFI_CONTROLLER_H
@@ -0,0 +1,62 @@
+#ifndef WIFI_LINK_WATCHER_H
+#define WIFI_LINK_WATCHER_H
+
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QSocketNotifier>
+#include <QTimer>
+
+#include "RtnlMonitor.h"
+#include "WpaCtrl.h"
+
+/**
+ * @brief wlan0 在线状态（事件驱动）
+ *
+ * 代替定时轮询 wpa_cli status / ip addr：
+ *  - wpa_supplicant 监视连接：CTRL-EVENT-CONNECTED / DISCONNECTED / TERMINATING
+ *  - rtnetlink：wlan0 链路 up/down、IPv4 地址增删
+ *  - 控制目录的 inotify：wpa_supplicant 启动 / 重启后自动重新 attach
+ * 任何一路有事件才重新判定（COMPLETED + 链路 RUNNING + 有 IPv4），没有事件时不占 CPU。
+ * 运行在所属线程的事件循环里（主线程）。STATUS 查询是异步的：发出后由 QSocketNotifier 收回复，
+ * 同一时刻只有一个查询在途，期间再来的 refresh() 合并成回复后的一次；其余判定只是几次 ioctl。
+ */
+class WifiLinkWatcher : public QObject {
+    Q_OBJECT
+public:
+    explicit WifiLinkWatcher(QObject* parent = nullptr);
+
+    void start();
+    bool connected() const { return m_connected; }
+    // 重新判定一次（事件之外的补充入口，例如 DHCP 失败后的延时重试）
+    void refresh();
+
+signals:
+    void connectedChanged(bool connected);
+    // 已关联但没拿到地址：由 WiFiController 在后台跑 DHCP
+    void dhcpNeeded();
+
+private:
+    void tryAttach();
+    void detach();
+    void onWpaReadable();
+    void onRtnlReadable();
+    void onCmdReadable();
+    void onStatusTimeout();
+    void evaluate(bool completed);
+
+    static constexpr int kStatusTimeoutMs = 500;
+
+    WpaCtrl m_mon;  // attach 的事件连接
+    WpaCtrl m_cmd;  // STATUS 查询（异步）
+    RtnlMonitor m_rtnl;
+    QSocketNotifier* m_wpaNotifier = nullptr;
+    QSocketNotifier* m_rtnlNotifier = nullptr;
+    QSocketNotifier* m_cmdNotifier = nullptr;
+    QTimer m_statusTimer;         // 在途 STATUS 的超时
+    bool m_statusPending = false;
+    bool m_refreshQueued = false;  // 在途期间又要求判定
+    QFileSystemWatcher m_dirWatcher;
+    bool m_connected = false;
+};
+
+#endif  // WIFI_LINK_WATCHER_H
@@ -0,0 +1,71 @@
+#ifndef WPA_CTRL_H
+#define WPA_CTRL_H
+
+#include <mutex>
+#include <string>
+
+/**
+ * @brief wpa_supplicant 控制接口客户端（UNIX 数据报套接字，协议同 wpa_ctrl.c）
+ *
+ * 代替 popen("wpa_cli ...")：
+ *  - request()：发命令收回复，一次往返几十微秒，没有 fork/exec
+ *  - attach()：本连接注册为监视器，之后 wpa_supplicant 主动推送
+ *              "<N>CTRL-EVENT-CONNECTED ..." 之类事件，fd() 可交给 poll / QSocketNotifier
+ *
+ * 命令连接与事件连接请分别用两个实例，避免回复和事件交错。
+ * request() 内部加锁，可被多个线程调用。
+ *
+ * 超时：协议里回复不带请求编号，超时后晚到的回复会被下一条命令当成自己的。
+ * 所以一次超时后换一个新的本地套接字（dup2 到原 fd 号上，fd() 不变，已 attach 的自动重新 ATTACH），
+ * 旧回复发往已删除的地址，直接被丢掉。
+ */
+class WpaCtrl {
+public:
+    static constexpr const char* kDefaultDir = "/tmp/lock/wpa_supplicant";
+
+    enum class WaitResult { Event, Timeout, Error };
+
+    WpaCtrl() = default;
+    ~WpaCtrl();
+    WpaCtrl(const WpaCtrl&) = delete;
+    WpaCtrl& operator=(const WpaCtrl&) = delete;
+
+    bool open(const std::string& ifname, const std::string& ctrlDir = kDefaultDir);
+    void close();
+    bool isOpen() const { return m_fd >= 0; }
+    int fd() const { return m_fd; }
+
+    // 发送命令并等待回复；wpa_supplicant 不在 / 超时返回 false
+    bool request(const std::string& cmd, std::string& reply, int timeoutMs = 2000);
+    // 异步用法：只发命令，回复在 fd() 可读时用 readReply() 取（配合 QSocketNotifier，不阻塞调用线程）
+    bool sendRequest(const std::string& cmd);
+    // 非阻塞取一条回复（跳过夹带的事件）；没有回复返回 false
+    bool readReply(std::string& reply);
+    // 回复为 "OK" 的命令
+    bool command(const std::string& cmd, int timeoutMs = 2000);
+
+    bool attach();
+    // 非阻塞读取一条事件，去掉 "<N>" 优先级前缀；无数据返回 false
+    bool readEvent(std::string& event);
+    // 阻塞等待一条事件（poll，不轮询）；套接字出错 / 被关闭（POLLERR / POLLHUP）返回 Error，不会空转到超时
+    WaitResult waitEvent(std::string& event, int timeoutMs);
+
+    // SET_NETWORK 字符串参数：加引号（wpa_supplicant 取到最后一个引号为止，口令中可含引号）
+    static std::string quote(const std::string& s);
+    // SSID 含引号 / 控制字符时改用十六进制写法
+    static std::string ssidValue(const std::string& ssid);
+
+private:
+    bool requestLocked(const std::string& cmd, std::string& reply, int timeoutMs);
+    bool connectSocket(int& fd, std::string& localPath) const;
+    void reopenLocked();
+
+    int m_fd = -1;
+    std::string m_ifname;
+    std::string m_ctrlDir;
+    std::string m_localPath;
+    bool m_attached = false;
+    std::mutex m_mutex;
+};
+
+#endif  // WPA_CTRL_H
@@ -4,10 +4,12 @@
 #include <sys/socket.h>
 
 #include <atomic>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
 
+#include "WpaCtrl.h"
 #include "linux/wireless.h"
 class WiFiManage {
 private:
@@ -19,6 +21,22 @@ private:
     std::string findNetworkId(const std::string& ssid);
     // Remove a network by ID
     void removeNetwork(const std::string& networkId);
+
+    // wpa_supplicant 控制接口：命令连接按需（重）连
+    bool ensureCtrl();
+    bool wpaRequest(const std::string& cmd, std::string& reply, int timeoutMs = 2000);
+    bool wpaCommand(const std::string& cmd);
+    std::string statusField(const std::string& key);
+    // select_network 后等 CTRL-EVENT-CONNECTED（事件驱动，不再 sleep 轮询 status）
+    int selectAndWait(const std::string& networkId, const std::string& ssid);
+    bool scanViaWpa(std::unordered_map<std::string, int>& wlanMap);
+    void scanViaWext(std::unordered_map<std::string, int>& wlanMap);
+
+    static constexpr int kConnectTimeoutSec = 10;
+    static constexpr int kScanTimeoutSec = 6;  // 页面 8 s 超时兜底
+
+    WpaCtrl m_ctrl;
+    std::mutex m_ctrlMutex;  // GUI 线程（currentSSID）与任务线程共用 m_ctrl
     std::atomic_bool m_wdRunning{false};
     std::atomic_bool m_wdArmed{false};
     std::thread m_wdThread;
@@ -0,0 +1,129 @@
+#include "RtnlMonitor.h"
+
+#include <arpa/inet.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace {
+
+// ioctl 用的临时 UDP 套接字
+struct IfSock {
+    int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    ~IfSock() {
+        if (fd >= 0)
+            ::close(fd);
+    }
+};
+
+bool fillIfreq(const std::string& ifname, ifreq& ifr) {
+    if (ifname.size() >= IFNAMSIZ)
+        return false;
+    memset(&ifr, 0, sizeof(ifr));
+    memcpy(ifr.ifr_name, ifname.c_str(), ifname.size());
+    return true;
+}
+
+}  // namespace
+
+RtnlMonitor::~RtnlMonitor() {
+    close();
+}
+
+bool RtnlMonitor::open() {
+    close();
+    const int fd = ::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+    if (fd < 0)
+        return false;
+    sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR;
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        return false;
+    }
+    m_fd = fd;
+    return true;
+}
+
+void RtnlMonitor::close() {
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool RtnlMonitor::drain(const std::string& ifname) {
+    if (m_fd < 0)
+        return false;
+    const unsigned int wanted = ::if_nametoindex(ifname.c_str());
+    bool relevant = false;
+    alignas(nlmsghdr) char buf[8192];
+
+    for (;;) {
+        const ssize_t n = ::recv(m_fd, buf, sizeof(buf), 0);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            // ENOBUFS：内核队列溢出丢了消息，保守地当作有变化
+            if (errno == ENOBUFS)
+                relevant = true;
+            break;
+        }
+        if (n == 0)
+            break;
+
+        int len = int(n);
+        for (const nlmsghdr* h = reinterpret_cast<const nlmsghdr*>(buf); NLMSG_OK(h, len);
+             h = NLMSG_NEXT(h, len)) {
+            unsigned int index = 0;
+            switch (h->nlmsg_type) {
+            case RTM_NEWLINK:
+            case RTM_DELLINK:
+                index = unsigned(static_cast<const ifinfomsg*>(NLMSG_DATA(h))->ifi_index);
+                break;
+            case RTM_NEWADDR:
+            case RTM_DELADDR:
+                index = static_cast<const ifaddrmsg*>(NLMSG_DATA(h))->ifa_index;
+                break;
+            default:
+                continue;
+            }
+            // 接口尚未出现时 wanted 为 0：任何链路消息都可能是它
+            if (wanted == 0 || index == wanted)
+                relevant = true;
+        }
+    }
+    return relevant;
+}
+
+bool RtnlMonitor::isRunning(const std::string& ifname) {
+    ifreq ifr;
+    IfSock s;
+    if (s.fd < 0 || !fillIfreq(ifname, ifr) || ::ioctl(s.fd, SIOCGIFFLAGS, &ifr) < 0)
+        return false;
+    return (ifr.ifr_flags & IFF_UP) && (ifr.ifr_flags & IFF_RUNNING);
+}
+
+std::string RtnlMonitor::ipv4Address(const std::string& ifname) {
+    ifreq ifr;
+    IfSock s;
+    if (s.fd < 0 || !fillIfreq(ifname, ifr))
+        return std::string();
+    ifr.ifr_addr.sa_family = AF_INET;
+    if (::ioctl(s.fd, SIOCGIFADDR, &ifr) < 0)
+        return std::string();  // EADDRNOTAVAIL：没有 IPv4
+    char text[INET_ADDRSTRLEN] = {0};
+    const sockaddr_in* sin = reinterpret_cast<const sockaddr_in*>(&ifr.ifr_addr);
+    if (!::inet_ntop(AF_INET, &sin->sin_addr, text, sizeof(text)))
+        return std::string();
+    return text;
+}
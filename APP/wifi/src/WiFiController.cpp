@@ -1,10 +1,41 @@
 #include "WiFiController.h"
 
 #include <QDebug>
-#include <QProcess>
+#include <QTimer>
+
+#include "RtnlMonitor.h"
 
 WiFiController::WiFiController(QObject* parent)
     : QObject(parent) {
+    QObject::connect(&m_link, &WifiLinkWatcher::connectedChanged, this, [this](bool on) {
+        qInfo() << "[WiFi] link" << (on ? "up" : "down");
+        emit linkStateChanged(on);
+    });
+    QObject::connect(&m_link, &WifiLinkWatcher::dhcpNeeded, this, &WiFiController::onDhcpNeeded);
+}
+
+// 开始监听链路（首帧之后由启动编排调用，重复调用无副作用）
+void WiFiController::start() {
+    if (m_started)
+        return;
+    m_started = true;
+    m_link.start();
+}
+
+// 已关联无地址：后台跑一次 DHCP；排队中的不重复投递
+void WiFiController::onDhcpNeeded() {
+    if (m_dhcpQueued.exchange(true))
+        return;
+    m_worker.post([this]() {
+        m_wifi.autoDhcpIfNeeded();
+        m_dhcpQueued = false;
+        if (!m_wifi.isWifiConnected()) {
+            // 没拿到地址也不会再有新事件：稍后回主线程再判定一次
+            QMetaObject::invokeMethod(this, [this]() {
+                QTimer::singleShot(kDhcpRetryMs, &m_link, &WifiLinkWatcher::refresh);
+            }, Qt::QueuedConnection);
+        }
+    });
 }
 
 // ===== QML 接口实现 =====
@@ -134,19 +165,15 @@ void WiFiController::executeTask(const Task& task) {
 }
 
 QString WiFiController::currentIp() {
-    QProcess p;
-    p.start("/bin/sh", {"-c",
-                        // 优先 wlan0，没有再 eth1
-                        "ip -4 addr show wlan0 | grep 'inet ' | awk '{print $2}' | cut -d/ -f1 || "
-                        "ip -4 addr show eth1  | grep 'inet ' | awk '{print $2}' | cut -d/ -f1"});
-    p.waitForFinished(1000);
-
-    QString ip = QString::fromLocal8Bit(p.readAllStandardOutput()).trimmed();
-    return ip;
+    // 优先 wlan0，没有再 eth1
+    std::string ip = RtnlMonitor::ipv4Address("wlan0");
+    if (ip.empty())
+        ip = RtnlMonitor::ipv4Address("eth1");
+    return QString::fromStdString(ip);
 }
 bool WiFiController::isWifiConnected() {
-    return m_wifi.isWifiConnected();
+    return m_link.connected();
 }
 void WiFiController::autoDhcpIfNeeded() {
     return m_wifi.autoDhcpIfNeeded();
-}
\ No newline at end of file
+}
@@ -0,0 +1,172 @@
+#include "WifiLinkWatcher.h"
+
+#include <QDebug>
+#include <QDir>
+#include <cstring>
+#include <sstream>
+
+namespace {
+const char kIface[] = "wlan0";
+
+bool startsWith(const std::string& s, const char* prefix) {
+    return s.compare(0, strlen(prefix), prefix) == 0;
+}
+}  // namespace
+
+WifiLinkWatcher::WifiLinkWatcher(QObject* parent)
+    : QObject(parent) {
+    m_statusTimer.setSingleShot(true);
+    m_statusTimer.setInterval(kStatusTimeoutMs);
+    connect(&m_statusTimer, &QTimer::timeout, this, &WifiLinkWatcher::onStatusTimeout);
+}
+
+void WifiLinkWatcher::start() {
+    if (m_rtnl.open()) {
+        m_rtnlNotifier = new QSocketNotifier(m_rtnl.fd(), QSocketNotifier::Read, this);
+        connect(m_rtnlNotifier, &QSocketNotifier::activated, this, &WifiLinkWatcher::onRtnlReadable);
+    } else {
+        qWarning() << "[WiFi] rtnetlink open failed, link changes come only from wpa events";
+    }
+
+    // 控制目录先建好再盯（wpa_supplicant 对已存在的目录不报错），启动 / 重启时会在里面建套接字
+    const QString dir = QString::fromLatin1(WpaCtrl::kDefaultDir);
+    QDir().mkpath(dir);
+    m_dirWatcher.addPath(dir);
+    connect(&m_dirWatcher, &QFileSystemWatcher::directoryChanged, this, [this]() {
+        // 崩溃重启时收不到 TERMINATING：旧连接 PING 不通就重连
+        //（走监视连接同步问：命令连接上可能有在途的异步 STATUS；本地 IPC，正常几十微秒）
+        std::string pong;
+        if (m_mon.isOpen() && !(m_mon.request("PING", pong, 200) && pong.compare(0, 4, "PONG") == 0))
+            detach();
+        tryAttach();
+        refresh();
+    });
+
+    tryAttach();
+    refresh();
+}
+
+void WifiLinkWatcher::tryAttach() {
+    if (m_mon.isOpen())
+        return;
+    if (!m_mon.open(kIface) || !m_mon.attach()) {
+        m_mon.close();
+        return;
+    }
+    if (m_cmd.open(kIface)) {
+        m_cmdNotifier = new QSocketNotifier(m_cmd.fd(), QSocketNotifier::Read, this);
+        connect(m_cmdNotifier, &QSocketNotifier::activated, this, &WifiLinkWatcher::onCmdReadable);
+    }
+    m_wpaNotifier = new QSocketNotifier(m_mon.fd(), QSocketNotifier::Read, this);
+    connect(m_wpaNotifier, &QSocketNotifier::activated, this, &WifiLinkWatcher::onWpaReadable);
+    qInfo() << "[WiFi] attached to wpa_supplicant events";
+}
+
+void WifiLinkWatcher::detach() {
+    if (m_wpaNotifier) {
+        m_wpaNotifier->setEnabled(false);
+        m_wpaNotifier->deleteLater();
+        m_wpaNotifier = nullptr;
+    }
+    if (m_cmdNotifier) {
+        m_cmdNotifier->setEnabled(false);
+        m_cmdNotifier->deleteLater();
+        m_cmdNotifier = nullptr;
+    }
+    m_statusTimer.stop();
+    m_statusPending = false;
+    m_mon.close();
+    m_cmd.close();
+}
+
+void WifiLinkWatcher::onWpaReadable() {
+    bool changed = false;
+    bool terminating = false;
+    std::string ev;
+    while (m_mon.readEvent(ev)) {
+        if (startsWith(ev, "CTRL-EVENT-CONNECTED") || startsWith(ev, "CTRL-EVENT-DISCONNECTED"))
+            changed = true;
+        else if (startsWith(ev, "CTRL-EVENT-TERMINATING"))
+            terminating = true;
+    }
+    if (terminating) {
+        qInfo() << "[WiFi] wpa_supplicant terminating";
+        detach();
+        changed = true;
+    }
+    if (changed)
+        refresh();
+}
+
+void WifiLinkWatcher::onRtnlReadable() {
+    if (!m_rtnl.drain(kIface))
+        return;
+    tryAttach();  // wlan0 刚被拉起时 wpa_supplicant 往往也刚启动
+    refresh();
+}
+
+// 发出 STATUS，不等回复；回复到了在 onCmdReadable() 里判定
+void WifiLinkWatcher::refresh() {
+    if (m_statusPending) {
+        m_refreshQueued = true;
+        return;
+    }
+    if (!m_cmd.isOpen() || !m_cmd.sendRequest("STATUS")) {
+        evaluate(false);
+        return;
+    }
+    m_statusPending = true;
+    m_statusTimer.start();
+}
+
+void WifiLinkWatcher::onCmdReadable() {
+    std::string status;
+    bool got = false;
+    for (std::string r; m_cmd.readReply(r);) {
+        status.swap(r);
+        got = true;
+    }
+    // 超时之后晚到的回复：已按未关联判定过，丢弃
+    if (!got || !m_statusPending)
+        return;
+    m_statusPending = false;
+    m_statusTimer.stop();
+
+    bool completed = false;
+    std::istringstream iss(status);
+    std::string line;
+    while (std::getline(iss, line)) {
+        if (line == "wpa_state=COMPLETED") {
+            completed = true;
+            break;
+        }
+    }
+    evaluate(completed);
+
+    if (m_refreshQueued) {
+        m_refreshQueued = false;
+        refresh();
+    }
+}
+
+void WifiLinkWatcher::onStatusTimeout() {
+    qWarning() << "[WiFi] STATUS no reply in" << kStatusTimeoutMs << "ms";
+    m_statusPending = false;
+    evaluate(false);
+    if (m_refreshQueued) {
+        m_refreshQueued = false;
+        refresh();
+    }
+}
+
+void WifiLinkWatcher::evaluate(bool completed) {
+    const bool linkUp = completed && RtnlMonitor::isRunning(kIface);
+    const bool hasIp = linkUp && !RtnlMonitor::ipv4Address(kIface).empty();
+    if (linkUp && !hasIp)
+        emit dhcpNeeded();
+
+    if (hasIp == m_connected)
+        return;
+    m_connected = hasIp;
+    emit connectedChanged(m_connected);
+}
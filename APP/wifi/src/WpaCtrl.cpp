@@ -0,0 +1,251 @@
+#include "WpaCtrl.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const size_t kMaxReply = 8192;  // SCAN_RESULTS 回复较长
+std::atomic<int> g_counter{0};
+
+// 回复行首为 '<' 的是事件，不是命令回复
+inline bool isEvent(const char* buf, ssize_t n) {
+    return n > 0 && buf[0] == '<';
+}
+
+int remainingMs(std::chrono::steady_clock::time_point deadline) {
+    const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+    return left.count() > 0 ? int(left.count()) : 0;
+}
+
+}  // namespace
+
+WpaCtrl::~WpaCtrl() {
+    close();
+}
+
+bool WpaCtrl::open(const std::string& ifname, const std::string& ctrlDir) {
+    close();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ifname = ifname;
+    m_ctrlDir = ctrlDir;
+    return connectSocket(m_fd, m_localPath);
+}
+
+// 新建套接字：绑定唯一的本地路径并连到 ctrlDir/ifname
+bool WpaCtrl::connectSocket(int& fdOut, std::string& localPath) const {
+    const int fd = ::socket(PF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return false;
+
+    // 客户端也要绑定一个路径，wpa_supplicant 才能把回复发回来
+    sockaddr_un local;
+    memset(&local, 0, sizeof(local));
+    local.sun_family = AF_UNIX;
+    snprintf(local.sun_path, sizeof(local.sun_path), "/tmp/fq_wpa_%d-%d", int(::getpid()), g_counter++);
+    ::unlink(local.sun_path);
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) < 0) {
+        ::close(fd);
+        return false;
+    }
+
+    sockaddr_un dest;
+    memset(&dest, 0, sizeof(dest));
+    dest.sun_family = AF_UNIX;
+    snprintf(dest.sun_path, sizeof(dest.sun_path), "%s/%s", m_ctrlDir.c_str(), m_ifname.c_str());
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&dest), sizeof(dest)) < 0) {
+        ::close(fd);
+        ::unlink(local.sun_path);
+        return false;
+    }
+
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    fdOut = fd;
+    localPath = local.sun_path;
+    return true;
+}
+
+// 超时后换本地地址：晚到的回复发往已删除的旧路径，不会被下一条命令收到
+// 新套接字 dup2 到原 fd 号上，外面挂在 fd() 上的 QSocketNotifier / poll 不受影响
+void WpaCtrl::reopenLocked() {
+    int fd = -1;
+    std::string path;
+    if (!connectSocket(fd, path))
+        return;  // wpa_supplicant 不在了：保留旧连接，下一次 send 会直接失败
+    ::dup2(fd, m_fd);
+    ::fcntl(m_fd, F_SETFD, FD_CLOEXEC);
+    ::close(fd);
+    ::unlink(m_localPath.c_str());
+    m_localPath = path;
+
+    if (m_attached) {
+        // 新地址还不是监视器；ATTACH 再超时就不再重试（m_attached 已清掉，不会递归）
+        m_attached = false;
+        std::string reply;
+        m_attached = requestLocked("ATTACH", reply, 500) && reply.compare(0, 2, "OK") == 0;
+    }
+}
+
+void WpaCtrl::close() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_fd < 0)
+        return;
+    if (m_attached) {
+        m_attached = false;  // 先清：DETACH 超时换地址时不要再 ATTACH 回去
+        std::string reply;
+        requestLocked("DETACH", reply, 200);
+    }
+    ::close(m_fd);
+    m_fd = -1;
+    ::unlink(m_localPath.c_str());
+    m_localPath.clear();
+}
+
+bool WpaCtrl::request(const std::string& cmd, std::string& reply, int timeoutMs) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return requestLocked(cmd, reply, timeoutMs);
+}
+
+bool WpaCtrl::requestLocked(const std::string& cmd, std::string& reply, int timeoutMs) {
+    reply.clear();
+    if (m_fd < 0)
+        return false;
+    if (::send(m_fd, cmd.data(), cmd.size(), 0) < 0)
+        return false;  // ECONNREFUSED：wpa_supplicant 已退出
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    char buf[kMaxReply];
+    for (;;) {
+        pollfd pfd{m_fd, POLLIN, 0};
+        const int r = ::poll(&pfd, 1, remainingMs(deadline));
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r == 0)
+            break;  // 超时
+        if (r < 0 || (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)))
+            return false;
+
+        const ssize_t n = ::recv(m_fd, buf, sizeof(buf), 0);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR)
+                continue;
+            return false;
+        }
+        if (isEvent(buf, n))
+            continue;  // 已 attach 的连接上夹带的事件，丢弃
+        reply.assign(buf, size_t(n));
+        return true;
+    }
+
+    reopenLocked();
+    return false;
+}
+
+bool WpaCtrl::command(const std::string& cmd, int timeoutMs) {
+    std::string reply;
+    return request(cmd, reply, timeoutMs) && reply.compare(0, 2, "OK") == 0;
+}
+
+bool WpaCtrl::sendRequest(const std::string& cmd) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_fd >= 0 && ::send(m_fd, cmd.data(), cmd.size(), 0) >= 0;
+}
+
+bool WpaCtrl::readReply(std::string& reply) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_fd < 0)
+        return false;
+    char buf[kMaxReply];
+    for (;;) {
+        const ssize_t n = ::recv(m_fd, buf, sizeof(buf), 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        if (isEvent(buf, n))
+            continue;
+        reply.assign(buf, size_t(n));
+        return true;
+    }
+}
+
+bool WpaCtrl::attach() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::string reply;
+    if (!requestLocked("ATTACH", reply, 2000) || reply.compare(0, 2, "OK") != 0)
+        return false;
+    m_attached = true;
+    return true;
+}
+
+bool WpaCtrl::readEvent(std::string& event) {
+    if (m_fd < 0)
+        return false;
+    char buf[kMaxReply];
+    const ssize_t n = ::recv(m_fd, buf, sizeof(buf), 0);
+    if (n <= 0)
+        return false;
+    const char* p = buf;
+    const char* end = buf + n;
+    if (p < end && *p == '<') {
+        const char* gt = static_cast<const char*>(memchr(p, '>', size_t(end - p)));
+        if (gt)
+            p = gt + 1;
+    }
+    event.assign(p, size_t(end - p));
+    return true;
+}
+
+WpaCtrl::WaitResult WpaCtrl::waitEvent(std::string& event, int timeoutMs) {
+    if (m_fd < 0)
+        return WaitResult::Error;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    for (;;) {
+        if (readEvent(event))
+            return WaitResult::Event;
+        pollfd pfd{m_fd, POLLIN, 0};
+        const int r = ::poll(&pfd, 1, remainingMs(deadline));
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r == 0)
+            return WaitResult::Timeout;
+        // POLLHUP 时 recv 立即返回 0，不退出就会一直空转到超时
+        if (r < 0 || (pfd.revents & (POLLERR | POLLHUP | POLLNVAL)))
+            return WaitResult::Error;
+    }
+}
+
+std::string WpaCtrl::quote(const std::string& s) {
+    return "\"" + s + "\"";
+}
+
+std::string WpaCtrl::ssidValue(const std::string& ssid) {
+    bool plain = true;
+    for (unsigned char c : ssid) {
+        if (c < 0x20 || c == '"' || c == 0x7F) {
+            plain = false;
+            break;
+        }
+    }
+    if (plain)
+        return quote(ssid);
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(ssid.size() * 2);
+    for (unsigned char c : ssid) {
+        hex += digits[c >> 4];
+        hex += digits[c & 0x0F];
+    }
+    return hex;
+}
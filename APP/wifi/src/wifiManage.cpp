@@ -3,7 +3,9 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <limits>
@@ -13,10 +15,13 @@
 #include <string>
 #include <vector>
 
+#include "RtnlMonitor.h"
 #include "qdebug.h"
 
 #define WIFI_LOG
 
+static const char kIface[] = "wlan0";
+
 // =====================
 // 仅 cpp 内部用的小工具（不改你类的接口）
 // =====================
@@ -43,20 +48,6 @@ static std::string _execCmdRaw(const std::string& command) {
     return result;
 }
 
-static bool _wpaPingOk(WiFiManage* /*self*/) {
-    std::string out = _execCmdRaw("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 ping 2>/dev/null");
-    return out.find("PONG") != std::string::npos;
-}
-
-static bool _wlan0LinkLowerUp(WiFiManage* /*self*/) {
-    std::string lk = _execCmdRaw("ip link show dev wlan0 2>/dev/null");
-    if (lk.find("LOWER_UP") == std::string::npos)
-        return false;
-    if (lk.find("UP") == std::string::npos)
-        return false;
-    return true;
-}
-
 static void _cleanupWlan0NetState(WiFiManage* /*self*/) {
     _execCmdRaw("pkill -f \"udhcpc.*-i wlan0\" 2>/dev/null || true");
     _execCmdRaw("ip route del default dev wlan0 2>/dev/null || true");
@@ -64,7 +55,36 @@ static void _cleanupWlan0NetState(WiFiManage* /*self*/) {
 }
 
 static void _cleanupWpaCtrlStale(WiFiManage* /*self*/) {
-    _execCmdRaw("rm -f /tmp/lock/wpa_supplicant/wlan0 2>/dev/null || true");
+    ::unlink((std::string(WpaCtrl::kDefaultDir) + "/" + kIface).c_str());
+}
+
+// SCAN_RESULTS 中 SSID 按 printf 规则转义（\xNN、\\、\"）
+static std::string _unescapeSsid(const std::string& in) {
+    std::string out;
+    out.reserve(in.size());
+    for (size_t i = 0; i < in.size(); ++i) {
+        if (in[i] != '\\' || i + 1 >= in.size()) {
+            out += in[i];
+            continue;
+        }
+        const char n = in[++i];
+        if (n == 'x' && i + 2 < in.size()) {
+            out += char(std::strtol(in.substr(i + 1, 2).c_str(), nullptr, 16));
+            i += 2;
+        } else if (n == 'n') {
+            out += '\n';
+        } else {
+            out += n;
+        }
+    }
+    return out;
+}
+
+// dBm → 0..100，与页面的信号格阈值（40/60/80）匹配
+static int _signalPercent(int dbm) {
+    if (dbm >= 0)
+        return std::min(dbm, 100);  // 驱动已给百分比
+    return std::max(0, std::min(100, 2 * (dbm + 100)));
 }
 
 // Helper function to execute a command and capture the output
@@ -115,23 +135,67 @@ void WiFiManage::parseResults(iw_event* event, int length, std::unordered_map<st
     }
 }
 
+// ===== wpa_supplicant 控制接口 =====
+bool WiFiManage::ensureCtrl() {
+    if (m_ctrl.isOpen())
+        return true;
+    return m_ctrl.open(kIface);
+}
+
+bool WiFiManage::wpaRequest(const std::string& cmd, std::string& reply, int timeoutMs) {
+    std::lock_guard<std::mutex> lock(m_ctrlMutex);
+    if (!ensureCtrl())
+        return false;
+    if (m_ctrl.request(cmd, reply, timeoutMs))
+        return true;
+    // wpa_supplicant 重启过：旧连接作废，重连一次
+    m_ctrl.close();
+    return ensureCtrl() && m_ctrl.request(cmd, reply, timeoutMs);
+}
+
+bool WiFiManage::wpaCommand(const std::string& cmd) {
+    std::string reply;
+    return wpaRequest(cmd, reply) && reply.compare(0, 2, "OK") == 0;
+}
+
+std::string WiFiManage::statusField(const std::string& key) {
+    std::string status;
+    if (!wpaRequest("STATUS", status))
+        return "";
+    std::istringstream iss(status);
+    std::string line;
+    const std::string prefix = key + "=";
+    while (std::getline(iss, line)) {
+        if (line.compare(0, prefix.size(), prefix) == 0)
+            return line.substr(prefix.size());
+    }
+    return "";
+}
+
 // Check if a network with the given SSID already exists
 std::string WiFiManage::findNetworkId(const std::string& ssid) {
-    std::string networks = executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 list_networks");
+    std::string networks;
+    if (!wpaRequest("LIST_NETWORKS", networks))
+        return "";
     std::istringstream iss(networks);
     std::string line;
+    std::getline(iss, line);  // 表头
     while (std::getline(iss, line)) {
-        if (line.find(ssid) != std::string::npos) {
-            return line.substr(0, line.find_first_of(" "));
-        }
+        // network id \t ssid \t bssid \t flags
+        const size_t t1 = line.find('\t');
+        if (t1 == std::string::npos)
+            continue;
+        const size_t t2 = line.find('\t', t1 + 1);
+        if (_unescapeSsid(line.substr(t1 + 1, t2 == std::string::npos ? std::string::npos : t2 - t1 - 1)) == ssid)
+            return line.substr(0, t1);
     }
     return "";
 }
 
 // Remove a network by ID
 void WiFiManage::removeNetwork(const std::string& networkId) {
-    executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 remove_network " + networkId);
-    executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 save_config");
+    wpaCommand("REMOVE_NETWORK " + networkId);
+    wpaCommand("SAVE_CONFIG");
 }
 
 void WiFiManage::statrt_uchcpc(int timeout, int num_retries) {
@@ -157,7 +221,8 @@ void WiFiManage::turnOnWiFi() {
     executeCommand("ifconfig wlan0 up 2>/dev/null || true");
 
     // ★如果控制接口已经能 PONG，说明 wpa_supplicant 已经起来了 -> 不要重复启动
-    if (_wpaPingOk(this)) {
+    std::string pong;
+    if (wpaRequest("PING", pong, 500) && pong.compare(0, 4, "PONG") == 0) {
 #ifdef WIFI_LOG
         qDebug("[WiFi] wpa_supplicant already alive (PONG), skip start");
 #endif
@@ -165,17 +230,15 @@ void WiFiManage::turnOnWiFi() {
     }
 
     // 准备启动前：清理可能的残留（ctrl socket + wlan0 残留网络状态）
+    {
+        std::lock_guard<std::mutex> lock(m_ctrlMutex);
+        m_ctrl.close();
+    }
     _cleanupWpaCtrlStale(this);
     _cleanupWlan0NetState(this);
 
-    // 启动 wpa_supplicant（只启动一次）
+    // 启动 wpa_supplicant（只启动一次；-B 在控制接口建好后才返回）
     executeCommand("wpa_supplicant -D wext -c /etc/wpa_supplicant.conf -i wlan0 -B 2>/dev/null || true");
-
-#ifdef WIFI_LOG
-    // 如果你希望：只有保存过网络才认为“会自动连接”，否则就不再做额外动作
-    //  bool has = this->hasSavedWiFiNetwork();
-    // qDebug("[WiFi] hasSavedWiFiNetwork=%d", has ? 1 : 0);
-#endif
 }
 
 // Turn off WiFi (bring down the wlan0 interface)
@@ -184,14 +247,15 @@ void WiFiManage::turnOffWiFi() {
     qDebug("关闭WiFi");
 #endif
     // 1) 先断开并清理 wlan0（避免残留 inet / 默认路由误判）
-    try {
-        executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 disconnect 2>/dev/null || true");
-    } catch (...) {
-    }
+    wpaCommand("DISCONNECT");
 
     _cleanupWlan0NetState(this);
 
     // 2) 关 wlan0 + 停 wpa_supplicant + 清 ctrl socket
+    {
+        std::lock_guard<std::mutex> lock(m_ctrlMutex);
+        m_ctrl.close();
+    }
     executeCommand("ifconfig wlan0 down 2>/dev/null || true");
     executeCommand("killall wpa_supplicant 2>/dev/null || true");
     _cleanupWpaCtrlStale(this);
@@ -206,95 +270,114 @@ void WiFiManage::disconnectWiFi() {
     qDebug("断开WiFi");
 #endif
     // disconnect 语义：不断电 WiFi 模块也行，但你这里需求是“断开后走 eth1”
-    try {
-        executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 disconnect 2>/dev/null || true");
-    } catch (...) {
-    }
+    wpaCommand("DISCONNECT");
 
     _cleanupWlan0NetState(this);
 
     executeCommand("ifconfig eth1 up 2>/dev/null || true; udhcpc -i eth1 -n -q -T 3 -t 8 2>/dev/null || true");
 }
 
-int WiFiManage::connectToWiFi(const std::string& ssid) {
-    std::string networkId = findNetworkId(ssid);
-    if (!networkId.empty()) {
-#ifdef WIFI_LOG
-        qDebug("Network found. Network ID: %s", networkId.c_str());
-#endif
-        std::string enable = executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 enable_network all");
-        if (enable.find("OK") == std::string::npos) {
-#ifdef WIFI_LOG
-            qDebug("连接WiFi失败: 启用网络失败");
-#endif
-            removeNetwork(networkId);
-            return -1;
-        }
+// ===== 选网并等待关联结果 =====
+int WiFiManage::selectAndWait(const std::string& networkId, const std::string& ssid) {
+    // 先 attach 再 select，避免错过 CONNECTED 事件
+    WpaCtrl mon;
+    const bool monitoring = mon.open(kIface) && mon.attach();
 
-        std::string select = executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 select_network " + networkId);
-        if (select.find("OK") == std::string::npos) {
+    if (!wpaCommand("SELECT_NETWORK " + networkId)) {
 #ifdef WIFI_LOG
-            qDebug("连接WiFi失败: 选择网络失败");
+        qDebug("连接WiFi失败: 选择网络失败");
 #endif
-            removeNetwork(networkId);
-            return -1;
-        }
-        executeCommand("ip addr flush dev wlan0");
-        int n = 10;
-        while (n > 0) {
-            std::string selects = executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 status ");
-            if (selects.find("wpa_state=COMPLETED") != std::string::npos) {
-                executeCommand("udhcpc -i wlan0 -n -q -T 3 -t 8");  //
+        removeNetwork(networkId);
+        return -1;
+    }
+    executeCommand("ip addr flush dev wlan0");
+
+    bool ok = false;
+    if (monitoring) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(kConnectTimeoutSec);
+        std::string ev;
+        for (;;) {
+            const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            if (left.count() <= 0 || mon.waitEvent(ev, int(left.count())) != WpaCtrl::WaitResult::Event)
+                break;  // 超时，或监视连接断了（下面按 STATUS 兜底判定）
+            if (ev.compare(0, 20, "CTRL-EVENT-CONNECTED") == 0) {
+                ok = true;
+                break;
+            }
+            // 认证连续失败（多为密码错误）/ wpa_supplicant 退出：不必等满
+            if (ev.compare(0, 29, "CTRL-EVENT-SSID-TEMP-DISABLED") == 0 ||
+                ev.compare(0, 22, "CTRL-EVENT-TERMINATING") == 0) {
 #ifdef WIFI_LOG
-                qDebug("连接WiFi成功 %s", ssid.c_str());
+                qDebug("[WiFi] %s", ev.c_str());
 #endif
-                return 0;
-            }
-            if (selects.find("wpa_state=INTERFACE_DISABLED") != std::string::npos ||
-                selects.find("wpa_state=INACTIVE") != std::string::npos) {
                 break;
             }
-            n--;
+        }
+    } else {
+        // 监视连接建不起来时退回查询 STATUS
+        for (int n = 0; n < kConnectTimeoutSec && !ok; ++n) {
+            const std::string st = statusField("wpa_state");
+            ok = st == "COMPLETED";
+            if (ok || st == "INTERFACE_DISABLED" || st == "INACTIVE")
+                break;
             sleep(1);
         }
+    }
+    if (!ok)
+        ok = statusField("wpa_state") == "COMPLETED";  // 事件可能早于 attach
+
+    if (ok) {
+        executeCommand("udhcpc -i wlan0 -n -q -T 3 -t 8");
 #ifdef WIFI_LOG
-        qDebug("连接WiFi失败: 选择网络失败");
+        qDebug("连接WiFi成功 %s", ssid.c_str());
 #endif
-        removeNetwork(networkId);
-        return -1;
-    } else {
-        return -1;
+        return 0;
     }
+#ifdef WIFI_LOG
+    qDebug("连接WiFi失败: %s 未关联", ssid.c_str());
+#endif
+    removeNetwork(networkId);
+    return -1;
+}
 
+int WiFiManage::connectToWiFi(const std::string& ssid) {
+    std::string networkId = findNetworkId(ssid);
+    if (networkId.empty())
+        return -1;
 #ifdef WIFI_LOG
-    qDebug("连接WiFi成功 %s", ssid.c_str());
+    qDebug("Network found. Network ID: %s", networkId.c_str());
 #endif
-    return 0;
+    if (!wpaCommand("ENABLE_NETWORK all")) {
+#ifdef WIFI_LOG
+        qDebug("连接WiFi失败: 启用网络失败");
+#endif
+        removeNetwork(networkId);
+        return -1;
+    }
+    return selectAndWait(networkId, ssid);
 }
 
 int WiFiManage::connectToWiFi(const std::string& ssid, const std::string& password) {
 #ifdef WIFI_LOG
-    qDebug("连接WiFi: %s 密码: %s", ssid.c_str(), password.c_str());
+    qDebug("连接WiFi: %s", ssid.c_str());
 #endif
     std::string networkId = findNetworkId(ssid);
     if (!networkId.empty()) {
 #ifdef WIFI_LOG
         qDebug("Network found. Network ID: %s", networkId.c_str());
 #endif
-        if (!password.empty()) {
-            std::string setPSK = executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 set_network " + networkId +
-                                                " psk '\"" + password + "\"'");
-            if (setPSK.find("OK") == std::string::npos) {
+        if (!password.empty() &&
+            !wpaCommand("SET_NETWORK " + networkId + " psk " + WpaCtrl::quote(password))) {
 #ifdef WIFI_LOG
-                qDebug("连接WiFi失败: 设置密码失败");
+            qDebug("连接WiFi失败: 设置密码失败");
 #endif
-                removeNetwork(networkId);
-                return -2;
-            }
-            executeCommand(" ");
+            removeNetwork(networkId);
+            return -2;
         }
     } else {
-        networkId = executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 add_network");
+        if (!wpaRequest("ADD_NETWORK", networkId) || networkId.compare(0, 4, "FAIL") == 0)
+            networkId.clear();
         networkId = networkId.substr(0, networkId.find_first_of("\n"));
 
         if (networkId.empty()) {
@@ -304,9 +387,7 @@ int WiFiManage::connectToWiFi(const std::string& ssid, const std::string& passwo
             return -1;
         }
 
-        std::string setSSID = executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 set_network " + networkId +
-                                             " ssid '\"" + ssid + "\"'");
-        if (setSSID.find("OK") == std::string::npos) {
+        if (!wpaCommand("SET_NETWORK " + networkId + " ssid " + WpaCtrl::ssidValue(ssid))) {
 #ifdef WIFI_LOG
             qDebug("连接WiFi失败: 设置SSID失败");
 #endif
@@ -314,9 +395,7 @@ int WiFiManage::connectToWiFi(const std::string& ssid, const std::string& passwo
             return -1;
         }
 
-        std::string setPSK = executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 set_network " + networkId +
-                                            " psk '\"" + password + "\"'");
-        if (setPSK.find("OK") == std::string::npos) {
+        if (!wpaCommand("SET_NETWORK " + networkId + " psk " + WpaCtrl::quote(password))) {
 #ifdef WIFI_LOG
             qDebug("连接WiFi失败: 设置密码失败");
 #endif
@@ -324,8 +403,7 @@ int WiFiManage::connectToWiFi(const std::string& ssid, const std::string& passwo
             return -2;
         }
 
-        std::string enable = executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 enable_network all");
-        if (enable.find("OK") == std::string::npos) {
+        if (!wpaCommand("ENABLE_NETWORK all")) {
 #ifdef WIFI_LOG
             qDebug("连接WiFi失败: 启用网络失败");
 #endif
@@ -333,52 +411,68 @@ int WiFiManage::connectToWiFi(const std::string& ssid, const std::string& passwo
             return -1;
         }
 
-        executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 save_config");
+        wpaCommand("SAVE_CONFIG");
     }
 
-    std::string select = executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 select_network " + networkId);
-    if (select.find("OK") == std::string::npos) {
-#ifdef WIFI_LOG
-        qDebug("连接WiFi失败: 选择网络失败");
-#endif
-        removeNetwork(networkId);
-        return -1;
-    }
+    return selectAndWait(networkId, ssid);
+}
 
-    executeCommand("ip addr flush dev wlan0");
+// ===== 扫描：优先走 wpa_supplicant（SCAN + 等 SCAN-RESULTS 事件）=====
+bool WiFiManage::scanViaWpa(std::unordered_map<std::string, int>& wlanMap) {
+    WpaCtrl mon;
+    if (!mon.open(kIface) || !mon.attach())
+        return false;
 
-    int n = 10;
-    while (n > 0) {
-        std::string selects = executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 status ");
-        if (selects.find("wpa_state=COMPLETED") != std::string::npos) {
-            executeCommand("udhcpc -i wlan0 -n -q -T 3 -t 8");
-#ifdef WIFI_LOG
-            qDebug("连接WiFi成功 %s", ssid.c_str());
-#endif
-            return 0;
-        }
-        if (selects.find("wpa_state=INTERFACE_DISABLED") != std::string::npos ||
-            selects.find("wpa_state=INACTIVE") != std::string::npos) {
+    std::string reply;
+    if (!wpaRequest("SCAN", reply))
+        return false;
+    // FAIL-BUSY：已有扫描在跑，等它的结果即可
+    if (reply.compare(0, 2, "OK") != 0 && reply.compare(0, 9, "FAIL-BUSY") != 0)
+        return false;
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(kScanTimeoutSec);
+    std::string ev;
+    for (;;) {
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (left.count() <= 0 || mon.waitEvent(ev, int(left.count())) != WpaCtrl::WaitResult::Event)
+            break;  // 超时 / 监视连接出错也读一次缓存结果
+        if (ev.compare(0, 23, "CTRL-EVENT-SCAN-RESULTS") == 0 ||
+            ev.compare(0, 22, "CTRL-EVENT-SCAN-FAILED") == 0)
             break;
-        }
-        n--;
-        sleep(1);
     }
 
-#ifdef WIFI_LOG
-    qDebug("连接WiFi失败: 选择网络失败");
-#endif
-    removeNetwork(networkId);
-    return -1;
+    if (!wpaRequest("SCAN_RESULTS", reply, 3000))
+        return false;
+    std::istringstream iss(reply);
+    std::string line;
+    std::getline(iss, line);  // 表头
+    while (std::getline(iss, line)) {
+        // bssid \t frequency \t signal level \t flags \t ssid
+        std::vector<std::string> f;
+        size_t pos = 0;
+        for (int i = 0; i < 4; ++i) {
+            const size_t t = line.find('\t', pos);
+            if (t == std::string::npos)
+                break;
+            f.push_back(line.substr(pos, t - pos));
+            pos = t + 1;
+        }
+        if (f.size() < 4)
+            continue;
+        const std::string ssid = _unescapeSsid(line.substr(pos));
+        if (ssid.empty())
+            continue;  // 隐藏网络
+        const int signal = _signalPercent(std::atoi(f[2].c_str()));
+        auto it = wlanMap.find(ssid);
+        if (it == wlanMap.end() || it->second < signal)
+            wlanMap[ssid] = signal;  // 同名多 AP 取最强
+    }
+    return true;
 }
 
-// Scan for available WiFi networks
-void WiFiManage::scanWiFi(std::unordered_map<std::string, int>& wlanMap) {
-#ifdef WIFI_LOG
-    qDebug("扫描WiFi");
-#endif
-    wlanMap.clear();
-
+// 旧路径：wext ioctl（wpa_supplicant 未运行时）
+void WiFiManage::scanViaWext(std::unordered_map<std::string, int>& wlanMap) {
     struct iwreq wrq1;
     memset(&wrq1, 0, sizeof(struct iwreq));
 
@@ -412,11 +506,6 @@ void WiFiManage::scanWiFi(std::unordered_map<std::string, int>& wlanMap) {
         int r = ioctl(scansock, SIOCGIWSCAN, &scanwrq);
         if (r == 0) {
             parseResults((iw_event*)scanwrq.u.data.pointer, scanwrq.u.data.length, wlanMap);
-#ifdef WIFI_LOG
-            for (auto&& i : wlanMap) {
-                qDebug("WiFi SSID: %s Signal: %d", i.first.c_str(), i.second);
-            }
-#endif
             break;
         } else {
 #ifdef WIFI_LOG
@@ -430,12 +519,30 @@ void WiFiManage::scanWiFi(std::unordered_map<std::string, int>& wlanMap) {
     close(scansock);
 }
 
+// Scan for available WiFi networks
+void WiFiManage::scanWiFi(std::unordered_map<std::string, int>& wlanMap) {
+#ifdef WIFI_LOG
+    qDebug("扫描WiFi");
+#endif
+    wlanMap.clear();
+    if (!scanViaWpa(wlanMap)) {
+        wlanMap.clear();
+        scanViaWext(wlanMap);
+    }
+#ifdef WIFI_LOG
+    for (auto&& i : wlanMap) {
+        qDebug("WiFi SSID: %s Signal: %d", i.first.c_str(), i.second);
+    }
+#endif
+}
+
 // Show the current WiFi connection status
 void WiFiManage::showCurrentWiFi() {
 #ifdef WIFI_LOG
     qDebug("显示当前WiFi连接状态");
 #endif
-    std::string status = executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 status");
+    std::string status;
+    wpaRequest("STATUS", status);
 #ifdef WIFI_LOG
     qDebug("%s", status.c_str());
 #endif
@@ -443,42 +550,20 @@ void WiFiManage::showCurrentWiFi() {
 
 // Get the currently connected WiFi SSID
 std::string WiFiManage::getCurrentWiFiSSID() {
-    std::string status = executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 status");
-    std::istringstream iss(status);
-    std::string line;
-    while (std::getline(iss, line)) {
-        if (line.find("ssid=") == 0) {
-            return line.substr(5);
-        }
-    }
-    return "";
+    return _unescapeSsid(statusField("ssid"));
 }
 
 bool WiFiManage::isWifiConnected() {
     // 1) wpa_state 必须 COMPLETED
-    std::string st;
-    try {
-        st = executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 status 2>/dev/null");
-    } catch (...) {
-        return false;
-    }
-
-    if (st.find("wpa_state=COMPLETED") == std::string::npos)
+    if (statusField("wpa_state") != "COMPLETED")
         return false;
 
     // 2) 必须真实链路 UP（避免 wlan0 DOWN 但 inet 残留导致误判）
-    if (!_wlan0LinkLowerUp(this))
+    if (!RtnlMonitor::isRunning(kIface))
         return false;
 
-    // 3) 必须真的有 inet 地址（ip addr 上）
-    std::string ip;
-    try {
-        ip = executeCommand("ip -4 addr show dev wlan0 2>/dev/null || /sbin/ip -4 addr show dev wlan0 2>/dev/null || /usr/sbin/ip -4 addr show dev wlan0 2>/dev/null");
-    } catch (...) {
-        return false;
-    }
-
-    return (ip.find("inet ") != std::string::npos);
+    // 3) 必须真的有 inet 地址
+    return !RtnlMonitor::ipv4Address(kIface).empty();
 }
 
 // =====================
@@ -488,41 +573,17 @@ bool WiFiManage::hasSavedWiFiNetwork() {
     // wpa_supplicant 刚起来时 control socket 可能还没 ready，做几次重试
     for (int i = 0; i < 5; ++i) {
         std::string out;
-        try {
-            out = executeCommand("wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 list_networks 2>/dev/null");
-        } catch (...) {
-            out.clear();
-        }
-
-        if (!out.empty()) {
+        if (wpaRequest("LIST_NETWORKS", out)) {
             std::istringstream iss(out);
             std::string line;
-            int lineNo = 0;
-            int netCnt = 0;
-
+            std::getline(iss, line);  // 表头
             while (std::getline(iss, line)) {
-                if (line.empty())
-                    continue;
-
-                // 有的会多一行：Selected interface 'wlan0'
-                if (line.find("Selected interface") != std::string::npos)
-                    continue;
-
-                lineNo++;
-                // 表头行
-                if (lineNo == 1 && line.find("network id") != std::string::npos)
-                    continue;
-
-                // 只要出现一行记录，就认为存在已保存网络
                 // 典型：0\tSSID\tany\t[CURRENT]
-                if (!line.empty()) {
-                    netCnt++;
-                }
+                if (!line.empty())
+                    return true;
             }
-
-            return (netCnt > 0);
+            return false;
         }
-
         usleep(200 * 1000);
     }
 
@@ -530,32 +591,15 @@ bool WiFiManage::hasSavedWiFiNetwork() {
 }
 bool WiFiManage::needDhcp() {
     // 1) wpa 必须 COMPLETED
-    std::string st;
-    try {
-        st = executeCommand(
-            "wpa_cli -p /tmp/lock/wpa_supplicant -i wlan0 status 2>/dev/null");
-    } catch (...) {
-        return false;
-    }
-
-    if (st.find("wpa_state=COMPLETED") == std::string::npos)
+    if (statusField("wpa_state") != "COMPLETED")
         return false;
 
     // 2) 真实链路 UP
-    if (!_wlan0LinkLowerUp(this))
+    if (!RtnlMonitor::isRunning(kIface))
         return false;
 
-    // 3) 是否已有 IPv4
-    std::string ip;
-    try {
-        ip = executeCommand(
-            "ip -4 addr show dev wlan0 2>/dev/null");
-    } catch (...) {
-        return false;
-    }
-
-    // 没有 inet，才需要 dhcpc
-    return (ip.find("inet ") == std::string::npos);
+    // 3) 没有 IPv4，才需要 dhcpc
+    return RtnlMonitor::ipv4Address(kIface).empty();
 }
 void WiFiManage::autoDhcpIfNeeded() {
     if (!needDhcp())
@@ -576,4 +620,4 @@ void WiFiManage::autoDhcpIfNeeded() {
         qDebug("[WiFi] DHCP failed");
         // ❗这里什么都不要做，等下一次状态变化
     }
-}
\ No newline at end of file
+}
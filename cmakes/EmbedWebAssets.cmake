@@ -0,0 +1,196 @@
+# 文件: cmakes/EmbedWebAssets.cmake
+#
+# 构建期把 APP/web/www 打进可执行文件（cmake -P 脚本模式运行）
+#   - assets/ 下的 js / css / 图片按内容哈希改名（app.css → app.<hash>.css），
+#     页面与 ES module 里的引用同步改写，哈希名可以 Cache-Control: immutable
+#   - html / sw.js 保留原路径（no-cache + ETag），sw.js 的缓存版本号自动换成整体哈希
+#   - 每个文件同时保存原文与 gzip -9 -n 版本，运行时零压缩
+#
+# 参数：
+#   WWW_DIR   - 静态资源目录（绝对路径）
+#   OUT_CPP   - 生成的 .cpp 路径
+#   GZIP_EXE  - gzip 可执行文件（为空则只嵌入原文）
+
+if(NOT WWW_DIR OR NOT OUT_CPP)
+    message(FATAL_ERROR "EmbedWebAssets: WWW_DIR / OUT_CPP 必须指定")
+endif()
+
+get_filename_component(_out_dir "${OUT_CPP}" DIRECTORY)
+set(_stage "${_out_dir}/web_assets_stage")
+file(REMOVE_RECURSE "${_stage}")
+file(MAKE_DIRECTORY "${_stage}")
+
+file(GLOB_RECURSE _files RELATIVE "${WWW_DIR}"
+    "${WWW_DIR}/*.html" "${WWW_DIR}/*.js" "${WWW_DIR}/*.css"
+    "${WWW_DIR}/*.png" "${WWW_DIR}/*.jpg" "${WWW_DIR}/*.svg" "${WWW_DIR}/*.ico")
+list(SORT _files)
+
+# ---------- 1. 分类：文本 / 可哈希 ----------
+set(_hashable "")
+foreach(_f IN LISTS _files)
+    get_filename_component(_name "${_f}" NAME)
+    if(NOT _f MATCHES "\\.html$" AND NOT _name STREQUAL "sw.js")
+        list(APPEND _hashable "${_f}")
+    endif()
+    if(_f MATCHES "\\.(html|js|css|svg)$")
+        file(READ "${WWW_DIR}/${_f}" _orig_${_f})
+    endif()
+endforeach()
+
+# 把 _src_var 变量里对 _hashable 的引用改成当前哈希名（按变量名传，避免宏展开正文）
+function(_rewrite_refs _src_rel _src_var _out)
+    set(_c "${${_src_var}}")
+    get_filename_component(_src_dir "${_src_rel}" DIRECTORY)
+    foreach(_h IN LISTS _hashable)
+        if(DEFINED _hashed_${_h})
+            string(REPLACE "/${_h}\"" "/${_hashed_${_h}}\"" _c "${_c}")
+            get_filename_component(_h_dir "${_h}" DIRECTORY)
+            if(_h_dir STREQUAL _src_dir)
+                get_filename_component(_h_name "${_h}" NAME)
+                get_filename_component(_hh_name "${_hashed_${_h}}" NAME)
+                string(REPLACE "\"./${_h_name}\"" "\"./${_hh_name}\"" _c "${_c}")
+            endif()
+        endif()
+    endforeach()
+    set(${_out} "${_c}" PARENT_SCOPE)
+endfunction()
+
+# ---------- 2. 哈希不动点：被引用文件的哈希变化会传导到引用者 ----------
+foreach(_pass RANGE 3)
+    foreach(_h IN LISTS _hashable)
+        if(DEFINED _orig_${_h})
+            _rewrite_refs("${_h}" _orig_${_h} _c)
+            string(SHA256 _sum "${_c}")
+        else()
+            file(SHA256 "${WWW_DIR}/${_h}" _sum)
+        endif()
+        string(SUBSTRING "${_sum}" 0 10 _short)
+        get_filename_component(_dir "${_h}" DIRECTORY)
+        get_filename_component(_we "${_h}" NAME_WLE)
+        get_filename_component(_ext "${_h}" LAST_EXT)
+        if(_dir)
+            set(_hashed_${_h} "${_dir}/${_we}.${_short}${_ext}")
+        else()
+            set(_hashed_${_h} "${_we}.${_short}${_ext}")
+        endif()
+    endforeach()
+endforeach()
+
+# 整体版本号（替换 sw.js 里的缓存名）
+set(_all "")
+foreach(_h IN LISTS _hashable)
+    string(APPEND _all "${_hashed_${_h}};")
+endforeach()
+foreach(_f IN LISTS _files)
+    if(_f MATCHES "\\.html$")
+        string(APPEND _all "${_orig_${_f}}")
+    endif()
+endforeach()
+string(SHA256 _build_sum "${_all}")
+string(SUBSTRING "${_build_sum}" 0 10 _build_hash)
+
+# ---------- 3. 写出改写后的文件并压缩 ----------
+function(_c_array _file _var_out _len_out)
+    file(READ "${_file}" _hex HEX)
+    string(LENGTH "${_hex}" _n)
+    math(EXPR _n "${_n} / 2")
+    if(_n EQUAL 0)
+        set(_arr "0x00")
+    else()
+        string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," _arr "${_hex}")
+        string(REGEX REPLACE "((0x[0-9a-f][0-9a-f],){16})" "\\1\n    " _arr "${_arr}")
+    endif()
+    set(${_var_out} "${_arr}" PARENT_SCOPE)
+    set(${_len_out} "${_n}" PARENT_SCOPE)
+endfunction()
+
+function(_mime _f _out)
+    if(_f MATCHES "\\.html$")
+        set(_m "text/html; charset=utf-8")
+    elseif(_f MATCHES "\\.js$")
+        set(_m "application/javascript; charset=utf-8")
+    elseif(_f MATCHES "\\.css$")
+        set(_m "text/css; charset=utf-8")
+    elseif(_f MATCHES "\\.png$")
+        set(_m "image/png")
+    elseif(_f MATCHES "\\.jpg$")
+        set(_m "image/jpeg")
+    elseif(_f MATCHES "\\.svg$")
+        set(_m "image/svg+xml")
+    else()
+        set(_m "image/x-icon")
+    endif()
+    set(${_out} "${_m}" PARENT_SCOPE)
+endfunction()
+
+set(_arrays "")
+set(_table "")
+set(_idx 0)
+foreach(_f IN LISTS _files)
+    set(_staged "${_stage}/${_f}")
+    get_filename_component(_staged_dir "${_staged}" DIRECTORY)
+    file(MAKE_DIRECTORY "${_staged_dir}")
+
+    if(DEFINED _orig_${_f})
+        _rewrite_refs("${_f}" _orig_${_f} _c)
+        get_filename_component(_name "${_f}" NAME)
+        if(_name STREQUAL "sw.js")
+            string(REGEX REPLACE "embedded-web-cache-v[0-9A-Za-z]+"
+                   "embedded-web-cache-${_build_hash}" _c "${_c}")
+        endif()
+        file(WRITE "${_staged}" "${_c}")
+    else()
+        configure_file("${WWW_DIR}/${_f}" "${_staged}" COPYONLY)
+    endif()
+
+    file(SHA256 "${_staged}" _sum)
+    string(SUBSTRING "${_sum}" 0 16 _etag)
+
+    _c_array("${_staged}" _raw _raw_len)
+    string(APPEND _arrays "static const unsigned char k_raw_${_idx}[] = {\n    ${_raw}\n};\n")
+
+    set(_gz_ref "nullptr")
+    set(_gz_len 0)
+    if(GZIP_EXE)
+        execute_process(COMMAND "${GZIP_EXE}" -9 -n -c "${_staged}"
+                        OUTPUT_FILE "${_staged}.gz"
+                        RESULT_VARIABLE _rc)
+        if(_rc EQUAL 0)
+            _c_array("${_staged}.gz" _gz _gz_len)
+            # 压缩不划算（图片等）就不要了
+            if(_gz_len LESS _raw_len)
+                string(APPEND _arrays "static const unsigned char k_gz_${_idx}[] = {\n    ${_gz}\n};\n")
+                set(_gz_ref "k_gz_${_idx}")
+            else()
+                set(_gz_len 0)
+            endif()
+        endif()
+    endif()
+
+    if(DEFINED _hashed_${_f})
+        set(_hashed_path "\"/${_hashed_${_f}}\"")
+    else()
+        set(_hashed_path "nullptr")
+    endif()
+    _mime("${_f}" _m)
+    string(APPEND _table
+        "    {\"/${_f}\", ${_hashed_path}, \"${_m}\", \"\\\"${_etag}\\\"\",\n"
+        "     k_raw_${_idx}, ${_raw_len}, ${_gz_ref}, ${_gz_len}},\n")
+    math(EXPR _idx "${_idx} + 1")
+endforeach()
+
+# ---------- 4. 生成 .cpp（内容不变时不改时间戳，避免重复编译）----------
+set(_src "// 自动生成：cmakes/EmbedWebAssets.cmake，请勿手改\n")
+string(APPEND _src "#include \"web_assets.h\"\n\nnamespace embedded {\n\n${_arrays}\n")
+if(_idx EQUAL 0)
+    string(APPEND _src "const WebAsset kWebAssets[] = {\n    {nullptr, nullptr, nullptr, nullptr, nullptr, 0, nullptr, 0},\n};\n")
+else()
+    string(APPEND _src "const WebAsset kWebAssets[] = {\n${_table}};\n")
+endif()
+string(APPEND _src "const size_t kWebAssetCount = ${_idx};\n")
+string(APPEND _src "const char* const kWebAssetsVersion = \"${_build_hash}\";\n\n}  // namespace embedded\n")
+
+file(WRITE "${OUT_CPP}.tmp" "${_src}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different "${OUT_CPP}.tmp" "${OUT_CPP}")
+file(REMOVE "${OUT_CPP}.tmp")
+message(STATUS "EmbedWebAssets: ${_idx} files, version ${_build_hash}")
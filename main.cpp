@@ -10,13 +10,13 @@
 #include <QProcess>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
+#include <QQuickWindow>
 #include <QThread>
 #include <QVariantList>
+#include <memory>
 // 自定义组件
-#include "APP/MyQmlComponents/MyCurveLoader/CurveLoader.h"
-#include "APP/MyQmlComponents/MyLineSeries/MyLineSeries.h"
 #include "APP/MyQmlComponents/MyPlotView/PlotView.h"
-#include "APP/MyQmlComponents/MySeriesFeeder/SeriesFeeder.h"
+#include "APP/MyQmlComponents/MyLiveFeeder/LiveFeeder.h"
 // 工程组件
 #include "CardWatcherStd.h"
 #include "DecodeWorker.h"
@@ -43,6 +43,7 @@
 // 扫码
 #include "APP/Scanner/QrImageProvider.h"
 #include "APP/Scanner/QrScanner.h"
+#include "AsyncLog.h"
 #include "DeviceManager.h"
 // 状态对象
 #include <WiFiController.h>
@@ -58,10 +59,15 @@
 #include "DeviceStatusObject.h"
 #include "LabKeyClient.h"
 #include "LabKeyService.h"
+#include "LogControl.h"
 #include "QrMethodConfigViewModel.h"  // 新增：方法配置表的 ViewModel 头文件（每行注释）
 #include "QrRepoModel.h"
+#include "ResultApplier.h"
+#include "ResultJournal.h"
+#include "StartupOrchestrator.h"
 #include "TaskQueueWorker.h"
 #include "embedded_web_server.h"
+#include "web_event_bridge.h"
 namespace {
 
 std::atomic<bool> g_stop_requested{false};
@@ -149,6 +155,14 @@ static void setupQtDpi() {
 }
 
 int main(int argc, char* argv[]) {
+    // 启动编排：计时从 main 开始
+    StartupOrchestrator boot;
+    // 日志尽早接管：之后的 qDebug 都走异步写线程
+#ifndef LOCAL_BUILD
+    AsyncLog::instance().install("/mnt/SDCARD/app/log");
+#else
+    AsyncLog::instance().install("/home/pribolab/Project/FluorescenceQuant/debugDir/log");
+#endif
     setupQtDpi();
     qputenv("QT_IM_MODULE", QByteArray("qtvirtualkeyboard"));
     qDebug() << "---------------version : 1.0.6--------------";
@@ -201,10 +215,9 @@ int main(int argc, char* argv[]) {
     // ======================
     qmlRegisterType<MotorController>("Motor", 1, 0, "MotorController");
     qmlRegisterType<ProjectsViewModel>("App", 1, 0, "ProjectsViewModel");
-    qmlRegisterType<SeriesFeeder>("App", 1, 0, "SeriesFeeder");
     qmlRegisterType<QrScanner>("App", 1, 0, "QrScanner");
-    qmlRegisterType<MyLineSeries>("App", 1, 0, "MyLineSeries");
-    qmlRegisterType<CurveLoader>("App", 1, 0, "CurveLoader");
+    qmlRegisterType<PlotView>("App", 1, 0, "PlotView");
+    qmlRegisterType<LiveFeeder>("App", 1, 0, "LiveFeeder");
     qmlRegisterType<DeviceService>("App", 1, 0, "DeviceService");
 
     // ======================
@@ -219,9 +232,15 @@ int main(int argc, char* argv[]) {
     ensureDir(dbDir);
     QString dbPath = dbDir + "/app.db";
 
+    // ======================
+    // 启动步骤
+    //   Pool：不碰 GUI 对象的文件 IO，和主线程并行
+    //   Main：engine.load 之前必须就绪的
+    //   Deferred：首帧之后再做（打印机 USB、WiFi、OTA、Web 服务）
+    // ======================
     /* 1. 启动后台任务线程 */
     TaskQueueWorker worker;
-    worker.start();
+    boot.add("task-worker", StartupOrchestrator::Main, {}, [&] { worker.start(); });
     LabKeyService* labkeyService = new LabKeyService(&app);
 
     // ======================
@@ -232,7 +251,7 @@ int main(int argc, char* argv[]) {
     CardWatcherStd cardWatcher(&keysProxy, dev.toStdString());
     cardWatcher.setWatchedCode(KEY_PROG1);
     cardWatcher.setDebounceMs(20);
-    cardWatcher.start();
+    boot.add("card-watcher", StartupOrchestrator::Main, {}, [&] { cardWatcher.start(); });
     // ======================
     // DBWorker + QThread
     // ======================
@@ -242,7 +261,8 @@ int main(int argc, char* argv[]) {
     db->moveToThread(dbThread);
     QObject::connect(dbThread, &QThread::started, db, &DBWorker::initialize);
     QObject::connect(dbThread, &QThread::finished, db, &DBWorker::deleteLater);
-    dbThread->start();
+    // ready 回调里要 replay 日志：日志必须先打开
+    boot.add("db-thread", StartupOrchestrator::Main, {"journal-open"}, [&] { dbThread->start(); });
 
     // ======================
     // ViewModel 初始化
@@ -257,6 +277,15 @@ int main(int argc, char* argv[]) {
     PrinterDeviceController printerCtrl(&settingsVm);
     QrRepoModel* qrRepoModel = new QrRepoModel(db);
     mainVm.setMethodConfigVm(qrMethodConfigVm);
+    // 采集期间 DB 线程不做归档 / 回收 / checkpoint
+    QObject::connect(&mainVm, &MainViewModel::acquisitionStarted, db,
+                     [db](const QString&) { db->setInstrumentBusy(true); }, Qt::DirectConnection);
+    QObject::connect(&mainVm, &MainViewModel::acquisitionStopped, db,
+                     [db]() { db->setInstrumentBusy(false); }, Qt::DirectConnection);
+    // ==== 结果日志：先 fsync 日志，再由 applier 落库 + 上传 ====
+    ResultJournal* resultJournal = new ResultJournal(dbDir + "/journal", &app);
+    boot.add("journal-open", StartupOrchestrator::Pool, {}, [&] { resultJournal->open(); });
+    new ResultApplier(resultJournal, db, labkeyService, &app);
     // ==== 绑定 DB ====
     settingsVm.bindWorker(db);
     userVm.bindWorker(db);
@@ -268,13 +297,17 @@ int main(int argc, char* argv[]) {
         db->postLoadProjects();
         db->postLoadHistory();
         db->postLoadQrMethodConfigs();
+        resultJournal->replay();  // 上次掉电前未落库的结果
+        labkeyService->openOutbox(dbPath);  // 补发离线期间积压的上传
     });
 
     // ======================
-    // 打印机
+    // 打印机：首帧后起线程，USB 初始化作为第一个任务在打印线程里做
     // ======================
-    PrinterManager::instance().initPrinter();
-    printerCtrl.start();
+    boot.add("printer", StartupOrchestrator::Deferred, {}, [&] {
+        printerCtrl.start();
+        PrinterManager::instance().postPrint([]() { PrinterManager::instance().initPrinter(); });
+    });
     // ======================
     // QrScanner
     // ======================
@@ -287,30 +320,33 @@ int main(int argc, char* argv[]) {
     // ======================
     // 加载 QSS
     // ======================
-    QFile qss(":/styles/main.qss");
-    if (qss.open(QIODevice::ReadOnly))
-        app.setStyleSheet(qss.readAll());
-    // === 创建 WiFiController 实例 ===
-    // 生命周期由 main 管理，整个应用唯一
-    WiFiController wifiController;
-    OtaManager otaManager;
+    QByteArray qssText;
+    boot.add("qss-read", StartupOrchestrator::Pool, {}, [&] {
+        QFile qss(":/styles/main.qss");
+        if (qss.open(QIODevice::ReadOnly))
+            qssText = qss.readAll();
+    });
+    boot.add("qss-apply", StartupOrchestrator::Main, {"qss-read"}, [&] {
+        if (!qssText.isEmpty())
+            app.setStyleSheet(QString::fromUtf8(qssText));
+    });
+    // === WiFiController / OtaManager / Web Server ===
+    // 都只在系统页和联网时才用到：首帧之后再建，QML 里对应页面等它们就绪才加载
+    WiFiController* wifiController = nullptr;  // 父对象 app，整个应用唯一
+    OtaManager* otaManager = nullptr;          // 工作线程在第一次升级请求时才起
 
     DeviceManager* deviceMgr = new DeviceManager(&app);
-    deviceMgr->start();
-
-    // ===============================
-    // 创建 Web Server
-    // ===============================
-    // -- --Web 配置-- --
-    embedded::ServerConfig cfg =
-        embedded::EmbeddedWebServer::defaultConfig();
+    boot.add("device-manager", StartupOrchestrator::Main, {}, [&] { deviceMgr->start(); });
 
-    embedded::EmbeddedWebServer web(cfg);
-
-    new NetWebGuard(&wifiController, &web, &app);
+    // Web 守护会在析构时 stop() 服务：声明在服务之后，先于服务析构
+    std::unique_ptr<embedded::EmbeddedWebServer> web;
+    std::unique_ptr<NetWebGuard> webGuard;
+    std::unique_ptr<WebEventBridge> webBridge;
+    boot.run();
     // ======================
     // QML 引擎
     // ======================
+    LogControl logControl;  // 工程师菜单里的日志分类开关
     QQmlApplicationEngine engine;
     engine.rootContext()->setContextProperty("mainViewModel", &mainVm);
     engine.rootContext()->setContextProperty("settingsVm", &settingsVm);
@@ -324,10 +360,34 @@ int main(int argc, char* argv[]) {
     engine.rootContext()->setContextProperty("deviceService", deviceMgr->service());
     engine.rootContext()->setContextProperty("dbWorker", qrRepoModel);
     engine.rootContext()->setContextProperty("labkeyService", labkeyService);
-    engine.rootContext()->setContextProperty("wifiController", &wifiController);
-    engine.rootContext()->setContextProperty("otaManager", &otaManager);
+    engine.rootContext()->setContextProperty("resultJournal", resultJournal);
+    // 推迟创建的服务先占位为 null，创建后再替换
+    engine.rootContext()->setContextProperty("wifiController", static_cast<QObject*>(nullptr));
+    engine.rootContext()->setContextProperty("otaManager", static_cast<QObject*>(nullptr));
+    engine.rootContext()->setContextProperty("logControl", &logControl);
     engine.addImageProvider("qr", new QrImageProvider(&qrScanner));
 
+    // ======================
+    // 首帧之后：WiFi 监听、OTA、Web 服务（Web 随 WiFi 上线再起）
+    // ======================
+    boot.add("wifi-link", StartupOrchestrator::Deferred, {}, [&] {
+        wifiController = new WiFiController(&app);
+        engine.rootContext()->setContextProperty("wifiController", wifiController);
+        wifiController->start();
+    });
+    boot.add("ota", StartupOrchestrator::Deferred, {}, [&] {
+        otaManager = new OtaManager(&app);
+        engine.rootContext()->setContextProperty("otaManager", otaManager);
+    });
+    boot.add("web-guard", StartupOrchestrator::Deferred, {"wifi-link"}, [&] {
+        web.reset(new embedded::EmbeddedWebServer(embedded::EmbeddedWebServer::defaultConfig()));
+        webGuard.reset(new NetWebGuard(wifiController, web.get()));
+        // -- --实时推送（/api/stream）-- --
+        auto* devService = qobject_cast<DeviceService*>(deviceMgr->service());
+        webBridge.reset(new WebEventBridge(&web->events(), &mainVm,
+                                           devService ? devService->status() : nullptr, db));
+    });
+
     QUrl url(QStringLiteral("qrc:/qml/main.qml"));
     QObject::connect(
         &engine, &QQmlApplicationEngine::objectCreated,
@@ -339,6 +399,16 @@ int main(int argc, char* argv[]) {
         Qt::QueuedConnection);
 
     engine.load(url);
-
-    return app.exec();
+    QQuickWindow* rootWindow = engine.rootObjects().isEmpty()
+                                   ? nullptr
+                                   : qobject_cast<QQuickWindow*>(engine.rootObjects().first());
+    // 启动基准（tests/bench/boot_bench.sh）：时间线打完就退出
+    if (qEnvironmentVariableIsSet("FQ_BOOT_BENCH"))
+        QObject::connect(&boot, &StartupOrchestrator::finished, &app, &QCoreApplication::quit,
+                         Qt::QueuedConnection);
+    boot.startDeferred(rootWindow);
+
+    const int rc = app.exec();
+    AsyncLog::instance().shutdown();  // 刷完缓冲；之后的析构日志回到默认输出
+    return rc;
 }
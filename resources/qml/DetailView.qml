@@ -1,7 +1,6 @@
 import QtQuick 2.12
 import QtQuick.Controls 2.12
-import QtCharts 2.3
-import App 1.0   // CurveLoader 注册所在模块
+import App 1.0   // PlotView 注册所在模块
 
 Item {
     id: root
@@ -13,8 +12,6 @@ Item {
    // ===== 自动缩放 Y 轴 =====
     property real yMin: 0
     property real yMax: 1
-    // C++ 曲线加载器
-    CurveLoader { id: loader }
 
     // ========================= 组件加载 =========================
     Component.onCompleted: {
@@ -42,20 +39,20 @@ function loadCurve() {
         // ⚠️ 强烈建议加这个，否则你现在的 inf 报错还会继续
         if (!adcList || adcList.length === 0) {
             console.log("[CURVE] adcList empty, skip draw")
-            axisY.min = 0
-            axisY.max = 1
+            plot.clear()
             return
         }
 
-        yMin = Math.min.apply(null, adcList)
-        yMax = Math.max.apply(null, adcList)
+        plot.setSamples(adcList)
+        yMin = plot.yMin
+        yMax = plot.yMax
 
         console.log("[CURVE] yMin =", yMin, "yMax =", yMax)
 
-        axisY.min = yMin
-        axisY.max = yMax
-
-        feeder.buildAndReplace(adcList)
+        // C/T 峰位与本底标记：用检测时随记录保存的值，不按当前项目参数重算
+        //（旧记录没有峰位，idxC 为 -1，不画标记）
+        if (record.idxC !== undefined && record.idxC >= 0)
+            plot.setPeaks(record.idxC, record.idxT, record.baseline)
 
         root.visible = false
         root.visible = true
@@ -89,60 +86,75 @@ function loadCurve() {
     }
 
     // ========================= 曲线图区域 =========================
-    ChartView {
+    // 场景图曲线（PlotView），不依赖 QtCharts / OpenGL
+    Rectangle {
         id: chart
-        objectName: "chartView"   // C++ 可用，不依赖 qt_chart
-        legend.font.pixelSize: 20 
-        legend.visible: true
+        color: "#ffffff"
         anchors {
             top: parent.top
             topMargin: 60
             left: parent.left
-            
             right: parent.right
             bottom: parent.bottom
         }
-        // X 轴
-        ValueAxis {
-            id: axisX
-            min: 0
-            max: adcList.length > 0 ? adcList.length : 5000
-            tickCount: 10
-            titleText: "数据点"
-            
-            labelsFont.pixelSize: 20     // ★ 刻度字体
-            titleFont.pixelSize: 20      // ★ 轴标题字体
+
+        // Y 轴刻度（最小 / 最大）
+        Label {
+            anchors.left: parent.left
+            anchors.leftMargin: 8
+            anchors.top: plot.top
+            text: plot.yMax.toFixed(2)
+            font.pixelSize: 20
+        }
+        Label {
+            anchors.left: parent.left
+            anchors.leftMargin: 8
+            anchors.bottom: plot.bottom
+            text: plot.yMin.toFixed(2)
+            font.pixelSize: 20
+        }
+        Label {
+            anchors.left: parent.left
+            anchors.leftMargin: 8
+            anchors.verticalCenter: plot.verticalCenter
+            text: "电压值"
+            font.pixelSize: 20
         }
 
-        // Y 轴
-        ValueAxis {
-            id: axisY
-            min:  yMin
-            max: yMax
-            tickCount: 8
-            titleText: "电压值"
-            
-            labelsFont.pixelSize: 20
-            titleFont.pixelSize: 20
+        PlotView {
+            id: plot
+            anchors {
+                fill: parent
+                leftMargin: 100
+                rightMargin: 20
+                topMargin: 20
+                bottomMargin: 50
+            }
+            lineColor: '#1a5995'
+            lineWidth: 1.5
         }
 
-        // QML 的曲线不绘制（占位，让坐标轴显示）
-        LineSeries {
-            id: dummyCurve
-            name: "占位曲线"
-            axisX: axisX
-            axisY: axisY
-            color:  '#1a5995'
-            //fvisible: true
+        // X 轴刻度
+        Label {
+            anchors.left: plot.left
+            anchors.top: plot.bottom
+            anchors.topMargin: 6
+            text: "0"
+            font.pixelSize: 20
+        }
+        Label {
+            anchors.horizontalCenter: plot.horizontalCenter
+            anchors.top: plot.bottom
+            anchors.topMargin: 6
+            text: "数据点"
+            font.pixelSize: 20
+        }
+        Label {
+            anchors.right: plot.right
+            anchors.top: plot.bottom
+            anchors.topMargin: 6
+            text: Math.round(plot.xMax)
+            font.pixelSize: 20
         }
-        SeriesFeeder {
-            id: feeder
-            series: dummyCurve       
-        }      
-        backgroundColor: "#ffffff"
-        plotAreaColor: "#ffffff"
     }
-
-
-    
 }
@@ -0,0 +1,325 @@
+// qml/HistoryPage.qml
+// 历史记录页（带选中删除），由 main.qml 第一次切到该页时通过 Loader 创建
+import QtQuick 2.12
+import QtQuick.Controls 2.12
+import QtQuick.Layouts 1.12
+
+Item {
+    id: historyPage
+
+    // 列宽 & 行高
+    property int rowHeight: 44
+    property int w_pname: 140
+    property int w_sel: 44
+    property int w_id: 80
+    property int w_pid: 0
+    property int w_no: 120
+    property int w_src: 120
+    property int w_name: 140
+    property int w_curve: 120
+    property int w_batch: 100
+    property int w_conc: 100
+    property int w_ref: 100
+    property int w_res: 100
+    property int w_time: 160
+    property int w_unit: 100
+    property int w_person: 120
+    property int w_dilution: 120
+    property int totalWidth: w_sel + w_id + w_pid + w_no + w_src + w_name + w_curve +
+                            w_batch + w_conc + w_ref + w_res + w_time +
+                            w_unit + w_person + w_dilution+ w_pname
+    function selectAll() {
+        var arr = []
+        for (var i = 0; i < historyVm.count; ++i) {
+            var row = historyVm.getRow(i)
+            arr.push(row.id)
+        }
+        selectedIds = arr
+    }
+
+    function unselectAll() {
+        selectedIds = []
+    }
+    // 选中集合
+    property var selectedIds: []
+
+    function isSelected(recId) {
+        return selectedIds.indexOf(recId) !== -1
+    }
+    function setSelected(recId, on) {
+        var arr = selectedIds.slice(0)
+        var pos = arr.indexOf(recId)
+        if (on && pos === -1) arr.push(recId)
+        if (!on && pos !== -1) arr.splice(pos, 1)
+        selectedIds = arr
+    }
+    function toggleSelected(recId) { setSelected(recId, !isSelected(recId)) }
+    function selectAllOnPage(on) {
+        // 遍历当前可见的 model
+        for (var i = 0; i < listView.count; ++i) {
+            var it = listView.itemAtIndex(i)
+            if (it && it.modelId !== undefined)
+                setSelected(it.modelId, on)
+        }
+    }
+    function deleteSelected() {
+        if (selectedIds.length === 0) return
+        for (var i = 0; i < selectedIds.length; ++i) {
+            if (historyVm && historyVm.deleteById)
+                historyVm.deleteById(selectedIds[i])
+        }
+        selectedIds = []
+        // 删除结果由 historyDeleted 逐行移除，无需整表刷新
+    }
+
+    ColumnLayout {
+        anchors.fill: parent
+        spacing: 8
+
+        // === 顶部栏 ===
+        RowLayout {
+            Layout.fillWidth: true
+            spacing: 12
+
+            Item { Layout.fillWidth: true }  // 左右分隔
+
+            // --- 左侧一组操作按钮 ---
+            RowLayout {
+                spacing: 10
+                Button { text: "刷新"; onClicked: historyVm.refresh() }
+
+                Button {
+                    text: "全选"
+                    onClicked: {
+                    historyPage.selectAll()
+                    }
+                }
+
+                 Button {
+                        text: "反选"
+                        onClicked: {
+                        historyPage.unselectAll()
+                        }
+                    }
+                Button {
+                    text: "删除选中"
+                    enabled: historyPage.selectedIds.length > 0 && userVm.roleName !== "operator"
+                    onClicked: historyPage.deleteSelected()
+                }
+                Button {
+                    // 导出中再点一次 = 取消
+                    text: historyVm.exporting
+                          ? "导出中 " + Math.round(historyVm.exportProgress * 100) + "%（取消）"
+                          : "导出 CSV"
+                    onClicked: {
+                        if (historyVm.exporting) {
+                            historyVm.cancelExport()
+                            return
+                        }
+                        let name = "history_" + Qt.formatDateTime(new Date(), "yyyyMMdd_hhmmss") + ".csv"
+                        let filePath = historyVm.exportDir() + "/" + name
+                        historyVm.exportHistory(filePath, "csv", false)
+                        console.log("[CSV] 导出:", filePath)
+                    }
+                }
+                Button {
+                    text: "导出含曲线"
+                    enabled: !historyVm.exporting
+                    onClicked: {
+                        let name = "history_" + Qt.formatDateTime(new Date(), "yyyyMMdd_hhmmss") + ".fqx"
+                        let filePath = historyVm.exportDir() + "/" + name
+                        historyVm.exportHistory(filePath, "bundle", true)
+                        console.log("[FQX] 导出:", filePath)
+                    }
+                }
+                // ✅ 新增：详细信息按钮
+                Button {
+                    text: "详细信息"
+                    enabled: historyPage.selectedIds.length === 1
+                    onClicked: {
+                        if (historyPage.selectedIds.length === 1) {
+                            let id = historyPage.selectedIds[0]
+                            win.selectedHistoryItem = historyVm.getById(id)
+                            win.currentPage = 4  // 跳到详细信息页////
+                        } else {
+                            console.log("⚠️ 请选择一条记录查看详细信息")
+                        }
+                    }
+                }
+                Button {
+                    text: "打印"
+                    enabled: historyPage.selectedIds.length >= 1    // ★ 可多选，合成一个打印作业
+
+                    onClicked: {
+                        let recs = []
+                        for (let i = 0; i < historyPage.selectedIds.length; ++i)
+                            recs.push(historyVm.getById(historyPage.selectedIds[i]))   // ⭐ 已经包含全部信息
+                        printerCtrl.printRecords(recs)
+                        console.log("🖨️ 打印记录条数 =", recs.length)
+                    }
+                }
+
+            }
+        }
+
+
+        // === 表格主体 ===
+        Rectangle {
+            id: his_table
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            radius: 8
+            color: "#ffffff"
+            border.color: "#d1d5db"
+            border.width: 1
+            clip: true
+
+            // === 表头（固定） ===
+            Rectangle {
+                id: headerBar
+                anchors.top: parent.top
+                anchors.left: parent.left
+                anchors.right: parent.right
+                height: historyPage.rowHeight
+                color: "#f3f4f6"
+                border.color: "#d1d5db"
+                border.width: 1
+                clip: true
+
+                Row {
+                    id: headerRow
+                    x: -bodyFlick.contentX              // 跟随内容横向滚动
+                    width: historyPage.totalWidth
+                    height: parent.height
+                    spacing: 0
+
+                    // 选择列（全选）
+                    Rectangle {
+                        width: historyPage.w_sel; height: parent.height; color: "transparent"
+                    }
+                    Rectangle { width: historyPage.w_id;
+                          height: parent.height; color: "transparent";
+                          Text {
+                            anchors.centerIn: parent;
+                            text: "ID";
+                            font.bold: true
+                            font.pixelSize: 14
+
+                            }
+                    }
+                    Rectangle { width: 0;                      height: parent.height; color: "transparent"; visible: false }
+                    Rectangle { width: historyPage.w_pname;    height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "项目名称"; font.bold: true }}
+                    Rectangle { width: historyPage.w_no;       height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "样品编号"; font.bold: true } }
+                    Rectangle { width: historyPage.w_src;      height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "样品来源"; font.bold: true } }
+                    Rectangle { width: historyPage.w_name;     height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "样品名称"; font.bold: true } }
+                    Rectangle { width: historyPage.w_curve;    height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "标准曲线"; font.bold: true } }
+                    Rectangle { width: historyPage.w_batch;    height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "批次";     font.bold: true } }
+                    Rectangle { width: historyPage.w_conc;     height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "浓度";     font.bold: true } }
+                    Rectangle { width: historyPage.w_ref;      height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "参考";     font.bold: true } }
+                    Rectangle { width: historyPage.w_res;      height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "结果";     font.bold: true } }
+                    Rectangle { width: historyPage.w_time;     height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "检测时间"; font.bold: true } }
+                    Rectangle { width: historyPage.w_unit;     height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "单位";     font.bold: true } }
+                    Rectangle { width: historyPage.w_person;   height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "检测人";   font.bold: true } }
+                    Rectangle { width: historyPage.w_dilution; height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "稀释倍数"; font.bold: true } }
+                }
+            }
+
+            // === 内容区 ===
+            Flickable {
+                id: bodyFlick
+                anchors.top: headerBar.bottom
+                anchors.left: parent.left
+                anchors.right: parent.right
+                anchors.bottom: parent.bottom
+                clip: true
+
+                contentWidth: historyPage.totalWidth
+                contentHeight: listView.contentHeight
+
+                ListView {
+                    id: listView
+                    x: 0
+                    y: 0
+                    width: historyPage.totalWidth
+                    height: bodyFlick.height
+                    clip: true
+                    boundsBehavior: Flickable.StopAtBounds
+                    spacing: 0
+                    model: (typeof historyVm !== "undefined" && historyVm) ? historyVm : 0
+
+                    delegate: Rectangle {
+                        // 把 model 中的 id 单独存到属性，避免和 QML 的 id 关键字混淆
+                        property var modelId: id
+
+                        width: historyPage.totalWidth
+                        height: historyPage.rowHeight
+                        color: historyPage.isSelected(modelId) ? "#dbeafe" :
+                            (index % 2 === 0 ? "#ffffff" : "#f9fafb")
+                        border.color: "#e5e7eb"
+                        border.width: 1
+
+                        Row {
+                            width: parent.width
+                            height: parent.height
+                            spacing: 0
+
+                            // 选择列
+                            Rectangle {
+                                width: historyPage.w_sel; height: parent.height; color: "transparent"
+                                CheckBox {
+                                    anchors.centerIn: parent
+                                    checked: historyPage.isSelected(modelId)
+                                    onClicked: historyPage.toggleSelected(modelId)
+                                }
+                            }
+
+                            // 其余列
+                            Rectangle { width: historyPage.w_id;       height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: modelId } }
+                           // Rectangle { width: historyPage.w_pid;      height: parent.height; color: "transparent"; Text { anchors.centerIn: parent; text: projectId } }
+                            Rectangle { width: historyPage.w_pid;      height:parent.height;  visible: false}
+                            Rectangle { width: historyPage.w_pname;    height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: projectName }}
+                            Rectangle { width: historyPage.w_no;       height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: sampleNo } }
+                            Rectangle { width: historyPage.w_src;      height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: sampleSource } }
+                            Rectangle { width: historyPage.w_name;     height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: sampleName } }
+                            Rectangle { width: historyPage.w_curve;    height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: standardCurve } }
+                            Rectangle { width: historyPage.w_batch;    height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: batchCode } }
+                            Rectangle { width: historyPage.w_conc;     height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: Number(detectedConc).toFixed(2) } }
+                            Rectangle { width: historyPage.w_ref;      height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: Number(referenceValue).toFixed(2) } }
+                            Rectangle {
+                                width: historyPage.w_res; height: parent.height; color: "transparent"
+                                HeaderText { anchors.centerIn: parent; text: result; color: result === "合格" ? "green" : "red" }
+                            }
+                            Rectangle { width: historyPage.w_time;     height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: detectedTime } }
+                            Rectangle { width: historyPage.w_unit;     height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: detectedUnit } }
+                            Rectangle { width: historyPage.w_person;   height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: detectedPerson } }
+                            Rectangle { width: historyPage.w_dilution; height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: dilutionInfo } }
+                        }
+
+                        MouseArea {
+                            anchors.fill: parent
+                            onClicked: historyPage.toggleSelected(modelId)
+                        }
+                    }
+
+                    // 无数据占位
+                    Rectangle {
+                        anchors.fill: parent
+                        visible: listView.count === 0
+                        color: "transparent"
+                        Text { anchors.centerIn: parent; text: "暂无数据"; color: "#909399" }
+                    }
+                }
+
+                // 滚动条
+                ScrollBar.vertical: ScrollBar { policy: ScrollBar.AsNeeded }
+                ScrollBar.horizontal: ScrollBar { policy: ScrollBar.AsNeeded }
+            }
+        }
+    }
+
+    Component.onCompleted: {
+        if (typeof historyVm !== "undefined" && historyVm && historyVm.refresh)
+            historyVm.refresh()
+    }
+
+}
@@ -0,0 +1,31 @@
+// qml/LazyPage.qml
+// 延迟创建的页面：第一次显示时才实例化，离开后空闲 unloadAfterMs 毫秒自动卸载（0 = 常驻）
+import QtQuick 2.12
+
+Loader {
+    id: lazy
+
+    property bool shown: false        // 页面当前是否处于显示状态（由外部绑定）
+    property int unloadAfterMs: 0     // 隐藏多久后卸载，释放内存和页面里的定时器
+
+    active: false
+
+    // 弹层类页面用：创建后显示（页面自己把 visible 置 false 即为关闭）
+    function open() {
+        active = true
+        if (item)
+            item.visible = true
+    }
+
+    onShownChanged: if (shown) active = true
+    Component.onCompleted: if (shown) active = true
+
+    Timer {
+        interval: Math.max(lazy.unloadAfterMs, 1)
+        running: lazy.unloadAfterMs > 0 && lazy.active && !lazy.shown
+        onTriggered: {
+            console.log("[QML] 卸载空闲页面", lazy.source)
+            lazy.active = false
+        }
+    }
+}
@@ -50,6 +50,7 @@ ApplicationWindow {
     
 
     property bool testRunning: false     // 防止重复检测
+    property bool testAborted: false     // 扫描中途被操作员中止
     property bool motorMoving: false     // 电机运行标志
     property var originCheckTimer: Timer // 定时器对象引用
     
@@ -71,6 +72,13 @@ ApplicationWindow {
         }
     }
 
+    Connections {
+        target: historyVm
+        onExportFinished: {
+            console.log(ok ? "导出完成:" : "导出失败:", path)
+        }
+    }
+
     // =====================================================
     // 登录遮罩层
     // =====================================================
@@ -352,6 +360,14 @@ Timer {
     }
 }
 
+// ===== 实时曲线喂数：采集批次 → livePlot（限帧、流式判峰）=====
+LiveFeeder {
+    id: liveFeeder
+    source: mainViewModel
+    plot: livePlot
+    maxFps: 20
+}
+
 function doStartTest() {
     // === 启动 ADS1115 连续采集 ===]
       var curNo = tfSampleId.text
@@ -365,19 +381,44 @@ function doStartTest() {
     }
     mainViewModel.setCurrentSample(tfSampleId.text)
     mainViewModel.startReading()
+    testAborted = false
+    liveFeeder.start()                    // 实时曲线：直接吃采集批次
     console.log("🧪[" + nowStr() + "] 启动连续采集")
     console.log("▶ 请求开始检测，等待电机停止")
     deviceService.motorStart_2()
     waitMotorStopTimer.start()
 }
+// 操作员看到实时曲线异常（如试纸条无峰）时提前中止：
+// 立即停止采集，电机走完本次行程后不再计算与保存结果
+function abortTest() {
+    if (!liveFeeder.running)
+        return
+    console.log("⛔[" + nowStr() + "] 操作员中止检测")
+    testAborted = true
+    mainViewModel.stopReading()
+    liveFeeder.stop()
+    // 丢掉这次的半条曲线：重测沿用同一样品编号时 getAdcData 不会把两次扫描拼在一起
+    mainViewModel.discardSample(tfSampleId.text)
+    overlayText = "已中止，等待电机停止..."
+}
 function doStartTestInternal()
 {
     console.log("✅[" + nowStr() + "] 电机停止 → 停止采集")
 
     // === 停止采集 ===
     mainViewModel.stopReading()
+    liveFeeder.stop()
     console.log("⏹[" + nowStr() + "] 停止采集")
 
+    // === 扫描中途已中止：不计算、不落库 ===
+    if (testAborted) {
+        overlayText = "检测已中止，结果未保存"
+        overlayBusy = false
+        overlayVisible = true
+        testRunning = false
+        return
+    }
+
     // === 回原点 ===
     uvadcList = mainViewModel.getAdcData(tfSampleId.text)
     var res = mainViewModel.calcTC(uvadcList,projectPage.selectedId)          // 调用 C++ 函数
@@ -433,7 +474,10 @@ function doStartTestInternal()
                 "dilutionInfo": dilution,
                 "C": C_net,
                 "T": T_net,
-                "ratio": ratio
+                "ratio": ratio,
+                "idxC": (res.idxC !== undefined ? res.idxC : -1),   // 峰位随结果保存，详情 / Web 不再重算
+                "idxT": (res.hasT && res.idxT !== undefined ? res.idxT : -1),
+                "baseline": Number(res.baseline || 0)
                 }
             var uploadRecord = {
                 // ===== root =====
@@ -455,11 +499,10 @@ function doStartTestInternal()
                 "DilutionFactor": Number(dilution)
             }
         
-        labkeyService.uploadRun(uploadRecord)
-        console.log("[DEBUG] 即将写入数据库:", JSON.stringify(record))
+        console.log("[DEBUG] 即将写入结果日志:", JSON.stringify(record))
 
-        // === 写入数据库 ===
-        var ok = projectsVm.insertProjectInfo(record)
+        // === 写入结果日志（落库、上传由 ResultApplier 在后台完成）===
+        var ok = resultJournal.submit(record, uploadRecord)
         console.log(ok ? "[DB] 插入成功 ✅" : "[DB] 插入失败 ❌")
         var concStr = (isFinite(conc) ? conc.toFixed(3) : "0.00")
         // === 界面提示完成 ===
@@ -469,7 +512,7 @@ function doStartTestInternal()
         overlayBusy = false
         overlayVisible = true
         testRunning = false
-        historyVm.refresh()
+        // 历史列表由 DBWorker::historyRowInserted 增量插入，无需整表刷新
         if(settingsVm.autoPrint)
         {
             console.log( " 启动打印 ✅" )
@@ -812,7 +855,7 @@ function doStartTestInternal()
                                 Button {
                                     text: "孵育设置"
                                     width: (parent.width - 40) / 3
-                                     onClicked: incubationPage.visible = true
+                                     onClicked: incubationPage.open()
                                 }
                             }
 
@@ -971,7 +1014,7 @@ function doStartTestInternal()
                                 Button { text: "刷新"; onClicked: qrMethodConfigVm.refresh() }
                                 Button {
                                             text: "扫描二维码"
-                                            onClicked: scanPage.visible = true                                     
+                                            onClicked: scanPage.open()                                     
                                            }
                                     Button {
                                         text: "删除"
@@ -988,7 +1031,6 @@ function doStartTestInternal()
                                                 console.log("执行删除 → ID =", projectPage.selectedId)
                                                 qrMethodConfigVm.deleteById(projectPage.selectedId)
                                                 projectPage.selectedId = -1
-                                                qrMethodConfigVm.refresh()
                                             }
                                         }
                                     }
@@ -1246,313 +1288,12 @@ function doStartTestInternal()
                         }
                     }         
                     // ===== 2 历史记录页（带选中删除）=====
-                    Item {
-                        id: historyPage
-                         Layout.fillWidth: true
-                         Layout.fillHeight: true
-
-                        // 列宽 & 行高
-                        property int rowHeight: 44
-                        property int w_pname: 140
-                        property int w_sel: 44
-                        property int w_id: 80
-                        property int w_pid: 0
-                        property int w_no: 120
-                        property int w_src: 120
-                        property int w_name: 140
-                        property int w_curve: 120
-                        property int w_batch: 100
-                        property int w_conc: 100
-                        property int w_ref: 100
-                        property int w_res: 100
-                        property int w_time: 160
-                        property int w_unit: 100
-                        property int w_person: 120
-                        property int w_dilution: 120
-                        property int totalWidth: w_sel + w_id + w_pid + w_no + w_src + w_name + w_curve +
-                                                w_batch + w_conc + w_ref + w_res + w_time +
-                                                w_unit + w_person + w_dilution+ w_pname
-                        function selectAll() {
-                            var arr = []
-                            for (var i = 0; i < historyVm.count; ++i) {
-                                var row = historyVm.getRow(i)
-                                arr.push(row.id)
-                            }
-                            selectedIds = arr
-                        }
-
-                        function unselectAll() {
-                            selectedIds = []
-                        }
-                        // 选中集合
-                        property var selectedIds: []
-
-                        function isSelected(recId) {
-                            return selectedIds.indexOf(recId) !== -1
-                        }
-                        function setSelected(recId, on) {
-                            var arr = selectedIds.slice(0)
-                            var pos = arr.indexOf(recId)
-                            if (on && pos === -1) arr.push(recId)
-                            if (!on && pos !== -1) arr.splice(pos, 1)
-                            selectedIds = arr
-                        }
-                        function toggleSelected(recId) { setSelected(recId, !isSelected(recId)) }
-                        function selectAllOnPage(on) {
-                            // 遍历当前可见的 model
-                            for (var i = 0; i < listView.count; ++i) {
-                                var it = listView.itemAtIndex(i)
-                                if (it && it.modelId !== undefined)
-                                    setSelected(it.modelId, on)
-                            }
-                        }
-                        function deleteSelected() {
-                            if (selectedIds.length === 0) return
-                            for (var i = 0; i < selectedIds.length; ++i) {
-                                if (historyVm && historyVm.deleteById)
-                                    historyVm.deleteById(selectedIds[i])
-                            }
-                            selectedIds = []
-                            if (historyVm && historyVm.refresh) historyVm.refresh()
-                        }
-
-                        ColumnLayout {
-                            anchors.fill: parent
-                            spacing: 8
-
-                            // === 顶部栏 ===
-                            RowLayout {
-                                Layout.fillWidth: true
-                                spacing: 12
-
-                                Item { Layout.fillWidth: true }  // 左右分隔
-
-                                // --- 左侧一组操作按钮 ---
-                                RowLayout {
-                                    spacing: 10
-                                    Button { text: "刷新"; onClicked: historyVm.refresh() }
-
-                                    Button {
-                                        text: "全选"
-                                        onClicked: {
-                                        historyPage.selectAll()
-                                        }
-                                    }
-
-                                     Button {
-                                            text: "反选"
-                                            onClicked: {
-                                            historyPage.unselectAll()
-                                            }
-                                        }
-                                    Button {
-                                        text: "删除选中"
-                                        enabled: historyPage.selectedIds.length > 0 && userVm.roleName !== "operator"
-                                        onClicked: historyPage.deleteSelected()
-                                    }
-                                    Button {
-                                        text: "导出 CSV"
-                                        onClicked: {
-                                            // let name = "history_" + new Date().toLocaleString().replace(/[ :\/]/g, "_") + ".csv"
-                                            // let filePath = "/mnt/SDCARD/export/" + name
-                                            // historyVm.exportCsv(filePath)
-                                            // console.log("[CSV] 导出:", filePath)
-                                        }
-                                    }
-                                    // ✅ 新增：详细信息按钮
-                                    Button {
-                                        text: "详细信息"
-                                        enabled: historyPage.selectedIds.length === 1
-                                        onClicked: {
-                                            if (historyPage.selectedIds.length === 1) {
-                                                let id = historyPage.selectedIds[0]
-                                                selectedHistoryItem = historyVm.getById(id)
-                                                currentPage = 4  // 跳到详细信息页////
-                                            } else {
-                                                console.log("⚠️ 请选择一条记录查看详细信息")
-                                            }
-                                        }
-                                    }
-                                    Button {
-                                        text: "打印"
-                                        enabled: historyPage.selectedIds.length === 1    // ★ 只能选中 1 条时启用
-
-                                        onClicked: {
-                                            if (historyPage.selectedIds.length === 1) {
-
-                                                let id = historyPage.selectedIds[0]
-                                                let rec = historyVm.getById(id)      // ⭐ 已经包含全部信息
-                                                printerCtrl.printRecord(rec)       // ⭐ 直接打印，无需 projectId 查询 DB
-                                                console.log("🖨️ 打印记录：项目编号 =", rec.projectId)                                     
-                                            } else {
-                                                console.log("⚠️ 请选择一条记录进行打印")
-                                            }
-                                        }
-                                    }
-
-                                }
-                            }
-
-
-                            // === 表格主体 ===
-                            Rectangle {
-                                id: his_table
-                                Layout.fillWidth: true
-                                Layout.fillHeight: true
-                                radius: 8
-                                color: "#ffffff"
-                                border.color: "#d1d5db"
-                                border.width: 1
-                                clip: true
-
-                                // === 表头（固定） ===
-                                Rectangle {
-                                    id: headerBar
-                                    anchors.top: parent.top
-                                    anchors.left: parent.left
-                                    anchors.right: parent.right
-                                    height: historyPage.rowHeight
-                                    color: "#f3f4f6"
-                                    border.color: "#d1d5db"
-                                    border.width: 1
-                                    clip: true
-
-                                    Row {
-                                        id: headerRow
-                                        x: -bodyFlick.contentX              // 跟随内容横向滚动
-                                        width: historyPage.totalWidth
-                                        height: parent.height
-                                        spacing: 0
-
-                                        // 选择列（全选）
-                                        Rectangle {
-                                            width: historyPage.w_sel; height: parent.height; color: "transparent"
-                                        }
-                                        Rectangle { width: historyPage.w_id; 
-                                              height: parent.height; color: "transparent"; 
-                                              Text { 
-                                                anchors.centerIn: parent;
-                                                text: "ID";       
-                                                font.bold: true 
-                                                font.pixelSize: 14
-                
-                                                } 
-                                        }
-                                        Rectangle { width: 0;                      height: parent.height; color: "transparent"; visible: false }
-                                        Rectangle { width: historyPage.w_pname;    height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "项目名称"; font.bold: true }}
-                                        Rectangle { width: historyPage.w_no;       height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "样品编号"; font.bold: true } }
-                                        Rectangle { width: historyPage.w_src;      height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "样品来源"; font.bold: true } }
-                                        Rectangle { width: historyPage.w_name;     height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "样品名称"; font.bold: true } }
-                                        Rectangle { width: historyPage.w_curve;    height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "标准曲线"; font.bold: true } }
-                                        Rectangle { width: historyPage.w_batch;    height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "批次";     font.bold: true } }
-                                        Rectangle { width: historyPage.w_conc;     height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "浓度";     font.bold: true } }
-                                        Rectangle { width: historyPage.w_ref;      height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "参考";     font.bold: true } }
-                                        Rectangle { width: historyPage.w_res;      height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "结果";     font.bold: true } }
-                                        Rectangle { width: historyPage.w_time;     height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "检测时间"; font.bold: true } }
-                                        Rectangle { width: historyPage.w_unit;     height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "单位";     font.bold: true } }
-                                        Rectangle { width: historyPage.w_person;   height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "检测人";   font.bold: true } }
-                                        Rectangle { width: historyPage.w_dilution; height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: "稀释倍数"; font.bold: true } }
-                                    }
-                                }
-
-                                // === 内容区 ===
-                                Flickable {
-                                    id: bodyFlick
-                                    anchors.top: headerBar.bottom
-                                    anchors.left: parent.left
-                                    anchors.right: parent.right
-                                    anchors.bottom: parent.bottom
-                                    clip: true
-
-                                    contentWidth: historyPage.totalWidth
-                                    contentHeight: listView.contentHeight
-
-                                    ListView {
-                                        id: listView
-                                        x: 0
-                                        y: 0
-                                        width: historyPage.totalWidth
-                                        height: bodyFlick.height
-                                        clip: true
-                                        boundsBehavior: Flickable.StopAtBounds
-                                        spacing: 0
-                                        model: (typeof historyVm !== "undefined" && historyVm) ? historyVm : 0
-
-                                        delegate: Rectangle {
-                                            // 把 model 中的 id 单独存到属性，避免和 QML 的 id 关键字混淆
-                                            property var modelId: id
-
-                                            width: historyPage.totalWidth
-                                            height: historyPage.rowHeight
-                                            color: historyPage.isSelected(modelId) ? "#dbeafe" :
-                                                (index % 2 === 0 ? "#ffffff" : "#f9fafb")
-                                            border.color: "#e5e7eb"
-                                            border.width: 1
-
-                                            Row {
-                                                width: parent.width
-                                                height: parent.height
-                                                spacing: 0
-
-                                                // 选择列
-                                                Rectangle {
-                                                    width: historyPage.w_sel; height: parent.height; color: "transparent"
-                                                    CheckBox {
-                                                        anchors.centerIn: parent
-                                                        checked: historyPage.isSelected(modelId)
-                                                        onClicked: historyPage.toggleSelected(modelId)
-                                                    }
-                                                }
-
-                                                // 其余列
-                                                Rectangle { width: historyPage.w_id;       height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: modelId } }
-                                               // Rectangle { width: historyPage.w_pid;      height: parent.height; color: "transparent"; Text { anchors.centerIn: parent; text: projectId } }
-                                                Rectangle { width: historyPage.w_pid;      height:parent.height;  visible: false}
-                                                Rectangle { width: historyPage.w_pname;    height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: projectName }}
-                                                Rectangle { width: historyPage.w_no;       height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: sampleNo } }
-                                                Rectangle { width: historyPage.w_src;      height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: sampleSource } }
-                                                Rectangle { width: historyPage.w_name;     height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: sampleName } }
-                                                Rectangle { width: historyPage.w_curve;    height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: standardCurve } }
-                                                Rectangle { width: historyPage.w_batch;    height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: batchCode } }
-                                                Rectangle { width: historyPage.w_conc;     height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: Number(detectedConc).toFixed(2) } }
-                                                Rectangle { width: historyPage.w_ref;      height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: Number(referenceValue).toFixed(2) } }
-                                                Rectangle {
-                                                    width: historyPage.w_res; height: parent.height; color: "transparent"
-                                                    HeaderText { anchors.centerIn: parent; text: result; color: result === "合格" ? "green" : "red" }
-                                                }
-                                                Rectangle { width: historyPage.w_time;     height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: detectedTime } }
-                                                Rectangle { width: historyPage.w_unit;     height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: detectedUnit } }
-                                                Rectangle { width: historyPage.w_person;   height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: detectedPerson } }
-                                                Rectangle { width: historyPage.w_dilution; height: parent.height; color: "transparent"; HeaderText { anchors.centerIn: parent; text: dilutionInfo } }
-                                            }
-
-                                            MouseArea {
-                                                anchors.fill: parent
-                                                onClicked: historyPage.toggleSelected(modelId)
-                                            }
-                                        }
-
-                                        // 无数据占位
-                                        Rectangle {
-                                            anchors.fill: parent
-                                            visible: listView.count === 0
-                                            color: "transparent"
-                                            Text { anchors.centerIn: parent; text: "暂无数据"; color: "#909399" }
-                                        }
-                                    }
-
-                                    // 滚动条
-                                    ScrollBar.vertical: ScrollBar { policy: ScrollBar.AsNeeded }
-                                    ScrollBar.horizontal: ScrollBar { policy: ScrollBar.AsNeeded }
-                                }
-                            }
-                        }
-
-                        Component.onCompleted: {
-                            if (typeof historyVm !== "undefined" && historyVm && historyVm.refresh)
-                                historyVm.refresh()
-                        }
-
+                    LazyPage {
+                        id: historyLoader
+                        Layout.fillWidth: true
+                        Layout.fillHeight: true
+                        source: "qrc:/qml/HistoryPage.qml"
+                        shown: currentPage === 2
                     }
                     // ===== 3 系统设置页 =====
                     Item {
@@ -1879,6 +1620,69 @@ function doStartTestInternal()
                                                         });
                                                     }
                                                 }
+
+                                                // =========================
+                                                // ⑩ 日志分类（工程师 / 管理员可见，运行时生效，不落库）
+                                                // =========================
+                                                Column {
+                                                    id: logCatSection
+                                                    width: contentColumn.width - 20
+                                                    spacing: 10
+                                                    visible: userVm.roleName === "admin" || userVm.roleName === "engineer"
+                                                    property int dropped: 0
+
+                                                    Row {
+                                                        spacing: 20
+                                                        leftPadding: 40
+                                                        height: 44
+
+                                                        Label {
+                                                            text: "日志分类"
+                                                            font.pixelSize: 20
+                                                            color: "#1f2937"
+                                                            anchors.verticalCenter: parent.verticalCenter
+                                                        }
+                                                        Button {
+                                                            text: "刷新"
+                                                            onClicked: {
+                                                                logCatRepeater.model = logControl.categories()
+                                                                logCatSection.dropped = logControl.droppedCount()
+                                                            }
+                                                        }
+                                                        Label {
+                                                            text: "丢弃 " + logCatSection.dropped + " 条 · " + logControl.logFile
+                                                            font.pixelSize: 16
+                                                            color: "#6b7280"
+                                                            anchors.verticalCenter: parent.verticalCenter
+                                                        }
+                                                    }
+
+                                                    onVisibleChanged: if (visible) {
+                                                        logCatRepeater.model = logControl.categories()
+                                                        dropped = logControl.droppedCount()
+                                                    }
+
+                                                    Repeater {
+                                                        id: logCatRepeater
+                                                        model: []
+                                                        delegate: Loader {
+                                                            sourceComponent: rowItemComp
+                                                            onLoaded: {
+                                                                let row = item;
+                                                                let lbl = row.children[0];
+                                                                let sw = row.children[1];
+                                                                let cat = modelData;
+
+                                                                lbl.text = "[" + cat.name + "]  限速 " +
+                                                                           (cat.limit > 0 ? cat.limit + " 条/秒" : "不限");
+                                                                sw.checked = cat.enabled;
+                                                                sw.onToggled.connect(function () {
+                                                                    logControl.setEnabled(cat.name, sw.checked);
+                                                                });
+                                                            }
+                                                        }
+                                                    }
+                                                }
                                             }
                                         }
                                     }
@@ -1891,9 +1695,16 @@ function doStartTestInternal()
                                     //         color: "#6b7280"
                                     //           }
                                     // }
-                                      WifiPage  {
-                                                    id: wifiPage
-                                                }
+                                    // 1️⃣ WiFi：进入时才创建，离开 1 分钟后卸载；wifiController 首帧后才建，建好前不加载
+                                    LazyPage {
+                                        id: wifiPage
+                                        Layout.fillWidth: true
+                                        Layout.fillHeight: true
+                                        source: "qrc:/qml/WifiPage.qml"
+                                        shown: currentPage === 3 && systemPage.sysIndex === 1
+                                               && wifiController !== null
+                                        unloadAfterMs: 60000
+                                    }
                                     // 2️⃣ 厂家信息
                                     Item {
                                         id: manufacturerInfoPage
@@ -1960,10 +1771,16 @@ function doStartTestInternal()
                                             }
                                         }
                                     }
-                                    // 3️⃣ 关于仪器
-                                OtaPage {
-                                            id: otaPage
-                                        }
+                                    // 3️⃣ 关于仪器（页面里有 1s 刷新 IP 的定时器，不显示时卸载）
+                                    LazyPage {
+                                        id: otaPage
+                                        Layout.fillWidth: true
+                                        Layout.fillHeight: true
+                                        source: "qrc:/qml/OtaPage.qml"
+                                        shown: currentPage === 3 && systemPage.sysIndex === 3
+                                               && otaManager !== null && wifiController !== null
+                                        unloadAfterMs: 60000
+                                    }
                                     // 4️⃣ 恢复出厂
                                     Item {
                                         Label {
@@ -2034,6 +1851,7 @@ function doStartTestInternal()
                     anchors.horizontalCenter: parent.horizontalCenter
                     anchors.verticalCenter: parent.verticalCenter
                     anchors.verticalCenterOffset: overlayPopup2.centerYOffset
+                    height: overlayPopup2Content.height + 48
                 }
 
                 // 内容布局
@@ -2051,6 +1869,25 @@ function doStartTestInternal()
                         anchors.horizontalCenter: parent.horizontalCenter
                     }
 
+                    // ===== 实时曲线（采集中显示；中止后保留到下一次开始，便于查看中止原因）=====
+                    PlotView {
+                        id: livePlot
+                        visible: liveFeeder.running || testAborted
+                        width: parent.width
+                        height: visible ? 200 : 0
+                        lineWidth: 1.5
+                    }
+
+                    Label {
+                        visible: livePlot.visible
+                        text: "采样点: " + liveFeeder.sampleCount
+                              + (liveFeeder.peakC >= 0 ? "   C峰: " + liveFeeder.peakC : "   C峰: --")
+                              + (liveFeeder.peakT >= 0 ? "   T峰: " + liveFeeder.peakT : "   T峰: --")
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        font.pixelSize: 14
+                        color: textSub
+                    }
+
                     Label {
                         text: overlayText
                         wrapMode: Text.WordWrap
@@ -2070,6 +1907,33 @@ function doStartTestInternal()
                         color: textSub
                     }
 
+                    Button {
+                        id: overlayPopup2AbortBtn
+                        visible: liveFeeder.running && !testAborted
+                        text: "中止检测"
+                        width: 200
+                        height: 44
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        font.pixelSize: 18
+                        onClicked: abortTest()
+
+                        contentItem: Text {
+                            text: overlayPopup2AbortBtn.text
+                            font: overlayPopup2AbortBtn.font
+                            color: "white"
+                            horizontalAlignment: Text.AlignHCenter
+                            verticalAlignment: Text.AlignVCenter
+                        }
+                        background: Rectangle {
+                            implicitWidth: 200
+                            implicitHeight: 44
+                            radius: 10
+                            color: "#e53935"
+                            border.color: "#c62828"
+                            border.width: 1
+                        }
+                    }
+
                     Button {
                         id: overlayPopup2OkBtn
                         visible: !overlayBusy
@@ -2324,15 +2188,20 @@ function doStartTestInternal()
             }
         }
     }
-    CameraScannerPage {
+    // ===== 弹层页：第一次打开时创建，关闭后空闲一段时间卸载 =====
+    LazyPage {
         id: scanPage
-        visible: false
         anchors.fill: parent
+        source: "qrc:/qml/CameraScannerPage.qml"
+        shown: item ? item.visible : false
+        unloadAfterMs: 30000
     }
-    IncubationManagerPage  {
-    id: incubationPage
-    visible: false
-    anchors.fill: parent
+    LazyPage {
+        id: incubationPage
+        anchors.fill: parent
+        source: "qrc:/qml/IncubationManagerPage.qml"
+        shown: item ? item.visible : false
+        unloadAfterMs: 60000
     }
 
 }
@@ -0,0 +1,130 @@
+// SHA-256 基准：同一份源码编两次，bench_sha256_evp（FQ_SHA256_OPENSSL）/ bench_sha256_builtin（内置压缩函数）
+//   先用标准向量校验结果，再测不同分段大小的 update() 吞吐和 hashFile() 吞吐
+//   参数 --quick：数据量缩小到 1/16，ctest 里只用来确认两条路径都算得对
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "TestCheck.h"
+#include "sha256.h"
+
+namespace {
+
+#ifdef FQ_SHA256_OPENSSL
+const char kBackend[] = "evp";
+#else
+const char kBackend[] = "builtin";
+#endif
+
+double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+std::vector<unsigned char> pseudoRandom(size_t n, uint32_t seed) {
+    std::vector<unsigned char> out(n);
+    for (size_t i = 0; i < n; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        out[i] = static_cast<unsigned char>(seed >> 16);
+    }
+    return out;
+}
+
+// 按 chunk 分段喂 total 字节，返回 MB/s
+double benchUpdate(const std::vector<unsigned char>& data, size_t chunk, size_t total, std::string& hex) {
+    SHA256 sha;
+    const auto t0 = std::chrono::steady_clock::now();
+    size_t done = 0;
+    size_t off = 0;
+    while (done < total) {
+        if (off + chunk > data.size())
+            off = 0;
+        sha.update(data.data() + off, chunk);
+        off += chunk;
+        done += chunk;
+    }
+    hex = sha.finalize();
+    return double(total) / (1024.0 * 1024.0) / secondsSince(t0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+    const size_t total = quick ? (4u << 20) : (64u << 20);
+    std::printf("backend = %s, %zu MB per case\n", kBackend, total >> 20);
+
+    // ===== 1. 标准向量（FIPS 180-2）=====
+    {
+        SHA256 sha;
+        CHECK(sha.calculateSHA256FromString("abc") ==
+              "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+        CHECK(sha.calculateSHA256FromString("") ==
+              "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+        CHECK(sha.calculateSHA256FromString("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+              "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+        // 一百万个 'a'，分 1000 段喂：跨块边界的缓冲路径
+        const std::string a1000(1000, 'a');
+        for (int i = 0; i < 1000; ++i)
+            sha.update(a1000);
+        CHECK(sha.finalize() == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+    }
+
+    // ===== 2. update() 吞吐：小块（逐包校验）/ 中块 / 下载写盘的大块 =====
+    const std::vector<unsigned char> data = pseudoRandom(4u << 20, 7);
+    std::string ref;
+    const size_t chunks[] = {64, 1000, 16 * 1024, 1024 * 1024};
+    for (size_t chunk : chunks) {
+        std::string hex;
+        // n 取 chunk 的整数倍；能整除 total 的分段喂的是同一段字节流，结果必须一致
+        const size_t n = total / chunk * chunk;
+        const double mbps = benchUpdate(data, chunk, n, hex);
+        std::printf("update  chunk %8zu B : %8.1f MB/s\n", chunk, mbps);
+        if (n == total) {
+            if (ref.empty())
+                ref = hex;
+            CHECK(hex == ref);  // 分段方式不影响结果
+        }
+    }
+    std::printf("digest of %zu MB stream = %s\n", total >> 20, ref.c_str());
+
+    // ===== 3. hashFile()：mmap 64 KB 窗口顺序读 =====
+    {
+        char path[] = "/tmp/bench_sha256_XXXXXX";
+        const int fd = ::mkstemp(path);
+        CHECK(fd >= 0);
+        if (fd >= 0) {
+            size_t written = 0;
+            while (written < total) {
+                const ssize_t w = ::write(fd, data.data(), std::min(data.size(), total - written));
+                if (w <= 0)
+                    break;
+                written += size_t(w);
+            }
+            ::close(fd);
+            CHECK(written == total);
+
+            std::string hex;
+            const auto t0 = std::chrono::steady_clock::now();
+            CHECK(SHA256::hashFile(path, hex));
+            const double sec = secondsSince(t0);
+            std::printf("hashFile %zu MB (page cache) : %8.1f MB/s\n", total >> 20,
+                        double(total) / (1024.0 * 1024.0) / sec);
+
+            // 同一段数据整体喂一次，文件路径算的必须一样
+            SHA256 sha;
+            for (size_t off = 0; off < total; off += data.size())
+                sha.update(data.data(), std::min(data.size(), total - off));
+            CHECK(hex == sha.finalize());
+            ::unlink(path);
+        }
+    }
+
+    return testResult();
+}
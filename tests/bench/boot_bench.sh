@@ -0,0 +1,75 @@
+#!/bin/sh
+# 启动基准：在板子上反复冷启动程序，统计首帧时间和 RSS，分阶段启动与串行对照组各跑一遍
+#
+# 用法（先停掉开机自启的实例）：
+#   boot_bench.sh <程序路径> [每组次数，默认 5]
+#
+# 每次运行带 FQ_BOOT_BENCH=1：启动时间线打完后程序自己退出，并往 stdout 打一行
+#   FQ_BOOT_BENCH mode=staged first_frame_ms=... first_frame_rss_kb=... done_ms=... done_rss_kb=...
+# 对照组再加 FQ_BOOT_SERIAL=1（见 StartupOrchestrator.h）。
+# root 运行时每次启动前 drop_caches，测的是冷缓存；否则是热缓存，结果里会注明。
+# 输出每项的中位数 / 最小 / 最大，以及两组首帧时间中位数之差。
+
+set -u
+
+APP=${1:?usage: boot_bench.sh <app> [runs]}
+RUNS=${2:-5}
+TIMEOUT_S=60
+OUT=$(mktemp "${TMPDIR:-/tmp}/boot_bench.XXXXXX")
+trap 'rm -f "$OUT" "$OUT".*' EXIT
+
+CACHE=warm
+if [ "$(id -u)" = 0 ] && [ -w /proc/sys/vm/drop_caches ]; then
+    CACHE=cold
+fi
+
+run_once() {
+    mode=$1
+    if [ "$CACHE" = cold ]; then
+        sync
+        echo 3 > /proc/sys/vm/drop_caches
+    fi
+    if [ "$mode" = serial ]; then
+        FQ_BOOT_BENCH=1 FQ_BOOT_SERIAL=1 timeout "$TIMEOUT_S" "$APP" 2>/dev/null
+    else
+        FQ_BOOT_BENCH=1 timeout "$TIMEOUT_S" "$APP" 2>/dev/null
+    fi | grep '^FQ_BOOT_BENCH ' >> "$OUT.$mode"
+}
+
+# 取 key=value 里的 value，输出 "中位数 最小 最大"
+stats() {
+    file=$1
+    key=$2
+    sed -n "s/.* $key=\([-0-9]*\).*/\1/p" "$file" | sort -n | awk '
+        { v[NR] = $1 }
+        END {
+            if (NR == 0) { print "- - -"; exit }
+            m = (NR % 2) ? v[(NR + 1) / 2] : int((v[NR / 2] + v[NR / 2 + 1]) / 2)
+            print m, v[1], v[NR]
+        }'
+}
+
+for mode in staged serial; do
+    : > "$OUT.$mode"
+    i=1
+    while [ "$i" -le "$RUNS" ]; do
+        run_once "$mode"
+        i=$((i + 1))
+    done
+done
+
+echo "boot bench: $APP, $RUNS runs per mode, $CACHE cache"
+printf '%-7s %5s  %-22s %-22s %-22s %-22s\n' mode ok \
+    "first_frame_ms" "first_frame_rss_kb" "done_ms" "done_rss_kb"
+printf '%-7s %5s  %-22s %-22s %-22s %-22s\n' "" "" "med min max" "med min max" "med min max" "med min max"
+for mode in staged serial; do
+    printf '%-7s %5s  %-22s %-22s %-22s %-22s\n' "$mode" "$(wc -l < "$OUT.$mode")/$RUNS" \
+        "$(stats "$OUT.$mode" first_frame_ms)" "$(stats "$OUT.$mode" first_frame_rss_kb)" \
+        "$(stats "$OUT.$mode" done_ms)" "$(stats "$OUT.$mode" done_rss_kb)"
+done
+
+staged=$(stats "$OUT.staged" first_frame_ms | cut -d' ' -f1)
+serial=$(stats "$OUT.serial" first_frame_ms | cut -d' ' -f1)
+if [ "$staged" != "-" ] && [ "$serial" != "-" ]; then
+    echo "first frame: staged ${staged} ms vs serial ${serial} ms ($((serial - staged)) ms earlier)"
+fi
@@ -0,0 +1,162 @@
+#ifndef LOCALHTTPSERVER_H
+#define LOCALHTTPSERVER_H
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/*
+ * LocalHttpServer
+ *
+ * 测试夹具：127.0.0.1 上的单线程 HTTP/1.1 文件服务器，端口由系统分配
+ *
+ *   - GET 已登记路径：200 + 全文；带 "Range: bytes=N-" 时 206 + 剩余部分
+ *   - 未登记路径：404
+ *   - dropNextAfter(n)：下一次响应只发 n 字节正文就断开，用来模拟断流续传
+ *   - 每个连接只处理一个请求（Connection: close）
+ */
+class LocalHttpServer {
+public:
+    LocalHttpServer() {
+        m_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int on = 1;
+        ::setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        if (::bind(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(m_fd, 8) != 0) {
+            std::perror("LocalHttpServer bind/listen");
+            return;
+        }
+        socklen_t len = sizeof(addr);
+        ::getsockname(m_fd, reinterpret_cast<sockaddr*>(&addr), &len);
+        m_port = ntohs(addr.sin_port);
+        m_thread = std::thread([this]() { loop(); });
+    }
+
+    ~LocalHttpServer() {
+        m_stop = true;
+        ::shutdown(m_fd, SHUT_RDWR);
+        ::close(m_fd);
+        if (m_thread.joinable())
+            m_thread.join();
+    }
+
+    void serve(const std::string& path, const std::string& body) {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_files[path] = body;
+    }
+
+    void dropNextAfter(size_t bytes) { m_dropAfter = long(bytes); }
+
+    std::string url(const std::string& path) const {
+        return "http://127.0.0.1:" + std::to_string(m_port) + path;
+    }
+
+    int requestCount() const { return m_requests.load(); }
+    int rangeRequestCount() const { return m_rangeRequests.load(); }
+
+private:
+    void loop() {
+        while (!m_stop) {
+            const int c = ::accept4(m_fd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (c < 0)
+                break;
+            handle(c);
+            ::close(c);
+        }
+    }
+
+    void handle(int c) {
+        std::string req;
+        char buf[2048];
+        while (req.find("\r\n\r\n") == std::string::npos) {
+            const ssize_t n = ::recv(c, buf, sizeof(buf), 0);
+            if (n <= 0)
+                return;
+            req.append(buf, size_t(n));
+        }
+        ++m_requests;
+
+        const size_t sp1 = req.find(' ');
+        const size_t sp2 = req.find(' ', sp1 + 1);
+        const std::string path = req.substr(sp1 + 1, sp2 - sp1 - 1);
+
+        long from = 0;
+        const size_t r = req.find("Range: bytes=");
+        if (r != std::string::npos) {
+            from = std::atol(req.c_str() + r + 13);
+            ++m_rangeRequests;
+        }
+
+        std::string body;
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            const auto it = m_files.find(path);
+            if (it != m_files.end()) {
+                body = it->second;
+                found = true;
+            }
+        }
+
+        std::string head;
+        if (!found) {
+            head = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+            sendAll(c, head.data(), head.size());
+            return;
+        }
+        if (from > long(body.size())) {
+            head = "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+            sendAll(c, head.data(), head.size());
+            return;
+        }
+        const size_t total = body.size();
+        if (from > 0) {
+            body = body.substr(size_t(from));
+            head = "HTTP/1.1 206 Partial Content\r\nContent-Range: bytes " + std::to_string(from) + "-" +
+                   std::to_string(total - 1) + "/" + std::to_string(total) + "\r\n";
+        } else {
+            head = "HTTP/1.1 200 OK\r\n";
+        }
+        head += "Content-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+        sendAll(c, head.data(), head.size());
+
+        const long drop = m_dropAfter.exchange(-1);
+        const size_t n = (drop >= 0 && size_t(drop) < body.size()) ? size_t(drop) : body.size();
+        sendAll(c, body.data(), n);
+    }
+
+    static void sendAll(int c, const char* p, size_t n) {
+        while (n > 0) {
+            const ssize_t w = ::send(c, p, n, MSG_NOSIGNAL);
+            if (w <= 0)
+                return;
+            p += w;
+            n -= size_t(w);
+        }
+    }
+
+    int m_fd = -1;
+    int m_port = 0;
+    std::thread m_thread;
+    std::atomic<bool> m_stop{false};
+    std::atomic<long> m_dropAfter{-1};
+    std::atomic<int> m_requests{0};
+    std::atomic<int> m_rangeRequests{0};
+    std::mutex m_mutex;
+    std::map<std::string, std::string> m_files;
+};
+
+#endif  // LOCALHTTPSERVER_H
@@ -0,0 +1,44 @@
+#ifndef TESTCHECK_H
+#define TESTCHECK_H
+
+#include <cstdio>
+
+/*
+ * 测试用的最小断言：不依赖 QtTest，失败打印位置并计数，main 末尾 return testResult()
+ *
+ *   CHECK(cond)            条件不成立记一次失败，继续往下跑
+ *   CHECK_EQ(actual, want) 同上，按 long long 打印两边的值
+ */
+inline int& testFailures() {
+    static int n = 0;
+    return n;
+}
+
+#define CHECK(cond)                                                               \
+    do {                                                                          \
+        if (!(cond)) {                                                            \
+            std::fprintf(stderr, "FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);  \
+            ++testFailures();                                                     \
+        }                                                                         \
+    } while (0)
+
+#define CHECK_EQ(actual, want)                                                            \
+    do {                                                                                  \
+        const long long a_ = (long long)(actual);                                         \
+        const long long w_ = (long long)(want);                                           \
+        if (a_ != w_) {                                                                   \
+            std::fprintf(stderr, "FAIL %s:%d: %s = %lld, want %lld\n", __FILE__, __LINE__, \
+                         #actual, a_, w_);                                                \
+            ++testFailures();                                                             \
+        }                                                                                 \
+    } while (0)
+
+inline int testResult() {
+    if (testFailures() == 0)
+        std::printf("PASS\n");
+    else
+        std::printf("%d check(s) failed\n", testFailures());
+    return testFailures() == 0 ? 0 : 1;
+}
+
+#endif  // TESTCHECK_H
@@ -0,0 +1,92 @@
+// CurveDecimator：每条路径的结果都必须是 首点 ∪ pinned ∪ 末点 的超集，且严格升序
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "CurveDecimator.h"
+#include "TestCheck.h"
+
+namespace {
+
+bool strictlyIncreasing(const std::vector<int>& v) {
+    for (size_t i = 1; i < v.size(); ++i) {
+        if (v[i] <= v[i - 1])
+            return false;
+    }
+    return true;
+}
+
+bool containsAll(const std::vector<int>& out, const std::vector<int>& want) {
+    for (int w : want) {
+        if (!std::binary_search(out.begin(), out.end(), w))
+            return false;
+    }
+    return true;
+}
+
+// 两个高斯峰 + 小幅波纹，近似一条试纸条扫描曲线
+std::vector<double> makeCurve(int n) {
+    std::vector<double> y(static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) {
+        const double c = std::exp(-std::pow((i - n * 0.3) / (n * 0.02), 2.0));
+        const double t = 0.6 * std::exp(-std::pow((i - n * 0.7) / (n * 0.02), 2.0));
+        y[static_cast<size_t>(i)] = 100.0 + 900.0 * c + 900.0 * t + 5.0 * std::sin(i * 0.37);
+    }
+    return y;
+}
+
+}  // namespace
+
+int main() {
+    const int n = 3000;
+    const std::vector<double> y = makeCurve(n);
+    std::vector<float> yf(y.begin(), y.end());
+    const std::vector<int> pins = {900, 2100, 1, n - 2};
+    std::vector<int> want = pins;
+    want.push_back(0);
+    want.push_back(n - 1);
+
+    // ===== LTTB：包括桶数不足（threshold < 3）的早返回 =====
+    for (int threshold : {0, 1, 2, 3, 4, 50, 400, n - 1}) {
+        const std::vector<int> out = CurveDecimator::lttb(yf.data(), n, threshold, pins);
+        CHECK(strictlyIncreasing(out));
+        CHECK(containsAll(out, want));
+    }
+    CHECK_EQ(CurveDecimator::lttb(yf.data(), n, n, pins).size(), n);
+    CHECK_EQ(CurveDecimator::lttb(yf.data(), n, 2).size(), 2);
+
+    // ===== MinMax =====
+    for (int width : {1, 2, 10, 320}) {
+        const std::vector<int> out = CurveDecimator::minMax(yf.data(), n, width, pins);
+        CHECK(strictlyIncreasing(out));
+        CHECK(containsAll(out, want));
+    }
+
+    // ===== decimate 入口（double 输入、两种模式）=====
+    for (CurveDecimator::Mode mode : {CurveDecimator::Mode::Lttb, CurveDecimator::Mode::MinMax}) {
+        for (int target : {2, 100, 800}) {
+            const std::vector<int> out = CurveDecimator::decimate(y.data(), n, target, mode, pins);
+            CHECK(strictlyIncreasing(out));
+            CHECK(containsAll(out, want));
+            CHECK(out.size() < static_cast<size_t>(n));
+        }
+    }
+
+    // ===== 越界 / 重复的固定点被忽略，不影响结果 =====
+    {
+        const std::vector<int> bad = {-5, 900, 900, n, n + 100};
+        const std::vector<int> out = CurveDecimator::lttb(yf.data(), n, 2, bad);
+        CHECK((out == std::vector<int>{0, 900, n - 1}));
+    }
+
+    // ===== 全局最高点在 MinMax 抽稀后仍在（不靠 pinned 也保留峰形）=====
+    {
+        const int top = int(std::max_element(yf.begin(), yf.end()) - yf.begin());
+        const std::vector<int> out = CurveDecimator::minMax(yf.data(), n, 100);
+        CHECK(std::binary_search(out.begin(), out.end(), top));
+    }
+
+    CHECK_EQ(CurveDecimator::parseMode("LTTB") == CurveDecimator::Mode::Lttb, 1);
+    CHECK_EQ(CurveDecimator::parseMode("bogus", CurveDecimator::Mode::Lttb) == CurveDecimator::Mode::Lttb, 1);
+    return testResult();
+}
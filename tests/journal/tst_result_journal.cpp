@@ -0,0 +1,208 @@
+// ResultJournal 回放 / 落库幂等测试
+//   - 提交 → 重开日志 → 未应用的结果原样回放（带同一个 journalUid）
+//   - 同一条结果落库两次只插一行，发件箱也只进一条
+//   - 日志损坏被截掉、序号从 1 重新数之后，新结果不会被旧行的 journalSeq 误判成“已应用”
+//   - 日志打不开时直接交出的结果同样能落库
+//   - 旧日志条目没有 uid 时退回按 journalSeq 去重
+#include <QCoreApplication>
+#include <QFile>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QVariantMap>
+#include <QVector>
+#include <QElapsedTimer>
+
+#include "Migrations.h"
+#include "OutboxRepo.h"
+#include "ProjectsRepo.h"
+#include "ResultJournal.h"
+#include "TestCheck.h"
+
+namespace {
+
+struct Committed {
+    qint64 seq;
+    QVariantMap record;
+    QVariantMap upload;
+};
+
+// 收集 committed()（写线程发出，排队到主线程）
+class Collector : public QObject {
+public:
+    explicit Collector(ResultJournal* j) {
+        connect(j, &ResultJournal::committed, this,
+                [this](qint64 seq, const QVariantMap& r, const QVariantMap& u) { got.append({seq, r, u}); });
+    }
+    bool waitFor(int n, int timeoutMs = 3000) {
+        QElapsedTimer t;
+        t.start();
+        while (got.size() < n && t.elapsed() < timeoutMs) {
+            QCoreApplication::processEvents();
+            QThread::msleep(2);
+        }
+        return got.size() >= n;
+    }
+    QVector<Committed> got;
+};
+
+QVariantMap makeRecord(const QString& sampleNo) {
+    QVariantMap m;
+    m["projectId"] = 1;
+    m["projectName"] = "AFB1";
+    m["sampleNo"] = sampleNo;
+    m["sampleSource"] = "";
+    m["sampleName"] = "";
+    m["standardCurve"] = "";
+    m["batchCode"] = "B01";
+    m["detectedConc"] = 1.5;
+    m["referenceValue"] = 5.0;
+    m["result"] = "合格";
+    m["detectedTime"] = "2026-01-01 00:00:00";
+    m["detectedUnit"] = "μg/kg";
+    m["detectedPerson"] = "test";
+    m["dilutionInfo"] = "1倍";
+    m["C"] = 1000.0;
+    m["T"] = 500.0;
+    m["ratio"] = 0.5;
+    return m;
+}
+
+QVariantMap makeUpload(const QString& sampleNo) {
+    QVariantMap u;
+    u["sampleNo"] = sampleNo;
+    return u;
+}
+
+int rowCount(QSqlDatabase& db, const QString& where = QString()) {
+    QSqlQuery q(db);
+    q.exec("SELECT COUNT(*) FROM project_info" + (where.isEmpty() ? QString() : " WHERE " + where));
+    return q.next() ? q.value(0).toInt() : -1;
+}
+
+// 与 DBTasks::applyJournalResult 一样把 seq 放进 info 再落库
+bool apply(QSqlDatabase& db, const Committed& c, qint64& insertedId) {
+    QVariantMap info = c.record;
+    info.insert("journalSeq", c.seq);
+    return ProjectsRepo::applyJournalResult(db, info, c.upload, insertedId);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+    QTemporaryDir tmp;
+    CHECK(tmp.isValid());
+    const QString jdir = tmp.path() + "/journal";
+
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "tst_journal");
+    db.setDatabaseName(tmp.path() + "/test.db");
+    CHECK(db.open());
+    CHECK(migrateAllToV1(db));
+
+    // ===== 1. 提交 3 条，每条都带 uid，落库一次 =====
+    QVector<Committed> first;
+    {
+        ResultJournal j(jdir);
+        CHECK(j.open());
+        Collector c(&j);
+        for (int i = 0; i < 3; ++i)
+            j.submit(makeRecord(QString("S%1").arg(i)), makeUpload(QString("S%1").arg(i)));
+        CHECK(c.waitFor(3));
+        first = c.got;
+        CHECK_EQ(first.size(), 3);
+        for (const Committed& e : first)
+            CHECK(!e.record.value("journalUid").toString().isEmpty());
+        CHECK(first[0].record.value("journalUid") != first[1].record.value("journalUid"));
+
+        for (const Committed& e : first) {
+            qint64 id = 0;
+            CHECK(apply(db, e, id));
+            CHECK(id > 0);
+        }
+        CHECK_EQ(rowCount(db), 3);
+        CHECK_EQ(OutboxRepo::pendingCount(db), 3);
+
+        // 只有第一条写上“已应用”，模拟另外两条落库后掉电
+        j.markApplied(first[0].seq);
+        QElapsedTimer t;
+        t.start();
+        while (j.pendingCount() != 2 && t.elapsed() < 3000)
+            QThread::msleep(2);
+        CHECK_EQ(j.pendingCount(), 2);
+    }
+
+    // ===== 2. 重开：回放剩下两条，uid 不变，再落库不重复插 =====
+    {
+        ResultJournal j(jdir);
+        CHECK(j.open());
+        CHECK_EQ(j.pendingCount(), 2);
+        Collector c(&j);
+        j.replay();
+        CHECK(c.waitFor(2));
+        CHECK_EQ(c.got.size(), 2);
+        for (const Committed& e : c.got) {
+            bool found = false;
+            for (const Committed& o : first)
+                found = found || (o.seq == e.seq && o.record.value("journalUid") == e.record.value("journalUid"));
+            CHECK(found);
+            qint64 id = -1;
+            CHECK(apply(db, e, id));
+            CHECK_EQ(id, 0);
+        }
+        CHECK_EQ(rowCount(db), 3);
+        CHECK_EQ(OutboxRepo::pendingCount(db), 3);
+    }
+
+    // ===== 3. 日志头被写坏：读回时整段截掉，序号从 1 重新数 =====
+    {
+        QFile f(jdir + "/results.jnl");
+        CHECK(f.open(QIODevice::ReadWrite));
+        f.write("XXXX");
+        f.close();
+    }
+    {
+        ResultJournal j(jdir);
+        CHECK(j.open());
+        CHECK_EQ(j.pendingCount(), 0);
+        Collector c(&j);
+        j.submit(makeRecord("S-after-truncate"), makeUpload("S-after-truncate"));
+        CHECK(c.waitFor(1));
+        CHECK_EQ(c.got.value(0).seq, 1);  // 与第 1 步的 seq 1 撞号
+        qint64 id = 0;
+        CHECK(apply(db, c.got.value(0), id));
+        CHECK(id > 0);
+        CHECK_EQ(rowCount(db), 4);
+        CHECK_EQ(rowCount(db, "journalSeq = 1"), 2);
+    }
+
+    // ===== 4. 日志打不开：submit 直接交出，同样带 uid、能落库 =====
+    {
+        ResultJournal j(tmp.path() + "/no-such-dir/" + QString(300, 'x'));
+        CHECK(!j.open());
+        Collector c(&j);
+        j.submit(makeRecord("S-no-journal"), QVariantMap());
+        CHECK(c.waitFor(1));
+        CHECK(!c.got.value(0).record.value("journalUid").toString().isEmpty());
+        qint64 id = 0;
+        CHECK(apply(db, c.got.value(0), id));
+        CHECK(id > 0);
+        CHECK_EQ(rowCount(db), 5);
+        CHECK_EQ(OutboxRepo::pendingCount(db), 4);  // 空 upload 不进发件箱
+    }
+
+    // ===== 5. 升级前写下的日志条目没有 uid：按 journalSeq 去重 =====
+    {
+        Committed legacy{99, makeRecord("S-legacy"), QVariantMap()};
+        qint64 id = 0;
+        CHECK(apply(db, legacy, id));
+        CHECK(id > 0);
+        CHECK(apply(db, legacy, id));
+        CHECK_EQ(id, 0);
+        CHECK_EQ(rowCount(db, "journalSeq = 99"), 1);
+    }
+
+    db.close();
+    return testResult();
+}
@@ -0,0 +1,217 @@
+// 增量升级：本地 HTTP 夹具下载补丁（含断流续传）→ 按清单重建 payload；以及畸形补丁不越界
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QVector>
+#include <QtEndian>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "DeltaPatch.h"
+#include "LocalHttpServer.h"
+#include "OtaDownloader.h"
+#include "TestCheck.h"
+
+namespace {
+
+QByteArray pseudoRandom(int n, quint32 seed) {
+    QByteArray out(n, '\0');
+    for (int i = 0; i < n; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        out[i] = char(seed >> 16);
+    }
+    return out;
+}
+
+struct Triple {
+    qint64 add;
+    qint64 copy;
+    qint64 seek;
+};
+
+// 按 DeltaPatch.h 的 .fqp 格式拼补丁；diff / extra 由调用方给出
+QByteArray buildPatch(qint64 newSize, const QVector<Triple>& ctrl, const QByteArray& diff,
+                      const QByteArray& extra) {
+    QByteArray rawCtrl(ctrl.size() * 24, '\0');
+    uchar* c = reinterpret_cast<uchar*>(rawCtrl.data());
+    for (int i = 0; i < ctrl.size(); ++i) {
+        qToLittleEndian<qint64>(ctrl[i].add, c + i * 24);
+        qToLittleEndian<qint64>(ctrl[i].copy, c + i * 24 + 8);
+        qToLittleEndian<qint64>(ctrl[i].seek, c + i * 24 + 16);
+    }
+    const QByteArray zc = qCompress(rawCtrl);
+    const QByteArray zd = qCompress(diff);
+    const QByteArray ze = qCompress(extra);
+
+    uchar head[28];
+    memcpy(head, "FQPATCH1", 8);
+    qToLittleEndian<qint64>(newSize, head + 8);
+    qToLittleEndian<quint32>(quint32(zc.size()), head + 16);
+    qToLittleEndian<quint32>(quint32(zd.size()), head + 20);
+    qToLittleEndian<quint32>(quint32(ze.size()), head + 24);
+    return QByteArray(reinterpret_cast<const char*>(head), 28) + zc + zd + ze;
+}
+
+// 最简单的合法补丁：公共长度逐字节做差，多出的部分放 extra
+QByteArray makePatch(const QByteArray& oldData, const QByteArray& newData) {
+    const int common = qMin(oldData.size(), newData.size());
+    QByteArray diff(common, '\0');
+    for (int i = 0; i < common; ++i)
+        diff[i] = char(uchar(newData[i]) - uchar(oldData[i]));
+    const QByteArray extra = newData.mid(common);
+    return buildPatch(newData.size(), {{common, extra.size(), 0}}, diff, extra);
+}
+
+bool writeFile(const QString& path, const QByteArray& data) {
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile f(path);
+    return f.open(QIODevice::WriteOnly | QIODevice::Truncate) && f.write(data) == data.size();
+}
+
+QByteArray readFile(const QString& path) {
+    QFile f(path);
+    return f.open(QIODevice::ReadOnly) ? f.readAll() : QByteArray();
+}
+
+bool patchFails(const QByteArray& oldData, const QByteArray& patch) {
+    QByteArray out;
+    QString err;
+    const bool ok = DeltaPatch::bspatch(oldData, patch, out, err);
+    if (!ok)
+        std::printf("  rejected as expected: %s\n", qPrintable(err));
+    return !ok;
+}
+
+}  // namespace
+
+int main() {
+    QTemporaryDir tmp;
+    CHECK(tmp.isValid());
+    const QString baseDir = tmp.path() + "/base";
+    const QString deltaDir = tmp.path() + "/delta";
+    const QString outDir = tmp.path() + "/out";
+    const QString dlDir = tmp.path() + "/dl";
+    QDir().mkpath(outDir);
+    QDir().mkpath(dlDir);
+
+    // ===== 当前版本 payload 与目标版本 =====
+    const QByteArray oldApp = pseudoRandom(300 * 1024, 1);
+    QByteArray newApp = oldApp;
+    for (int i = 0; i < newApp.size(); i += 4096)
+        newApp[i] = char(newApp[i] ^ 0x5A);
+    newApp += pseudoRandom(20 * 1024, 2);
+    const QByteArray sameLib = pseudoRandom(8 * 1024, 3);
+    const QByteArray newQml = "import QtQuick 2.12\nItem {}\n";
+    CHECK(writeFile(baseDir + "/bin/FluorescenceQuant", oldApp));
+    CHECK(writeFile(baseDir + "/lib/libsame.so", sameLib));
+    CHECK(writeFile(baseDir + "/lib/libold.so", "old"));
+
+    const QByteArray patch = makePatch(oldApp, newApp);
+
+    // ===== 1. 本地 HTTP 下载补丁：第一次响应中途断开，同一次 download() 内 Range 续传 =====
+    LocalHttpServer http;
+    http.serve("/delta/FluorescenceQuant.fqp", std::string(patch.constData(), size_t(patch.size())));
+    http.dropNextAfter(size_t(patch.size() / 3));
+
+    std::atomic<bool> abort{false};
+    OtaDownloader downloader(&abort);
+    QString sha;
+    QString err;
+    const QString dest = dlDir + "/FluorescenceQuant.fqp";
+    const bool downloaded = downloader.download(QString::fromStdString(http.url("/delta/FluorescenceQuant.fqp")),
+                                                dest, "1.0.7-delta", OtaDownloader::ProgressFn(), sha, err);
+    CHECK(downloaded);
+    if (!downloaded)
+        std::printf("download error: %s\n", qPrintable(err));
+    CHECK(readFile(dest) == patch);
+    CHECK(sha == DeltaPatch::dataSha256(patch));
+    CHECK_EQ(http.requestCount(), 2);
+    CHECK_EQ(http.rangeRequestCount(), 1);
+    CHECK(!QFile::exists(dest + ".part"));
+
+    // 不存在的路径：HTTP 404 直接失败，不重试
+    {
+        QString sha404;
+        QString err404;
+        CHECK(!downloader.download(QString::fromStdString(http.url("/missing.fqp")), dlDir + "/missing",
+                                   "k", OtaDownloader::ProgressFn(), sha404, err404));
+        CHECK(err404.contains("404"));
+    }
+
+    // ===== 2. 组增量包目录并按清单重建 =====
+    CHECK(writeFile(deltaDir + "/patches/bin/FluorescenceQuant.fqp", readFile(dest)));
+    CHECK(writeFile(deltaDir + "/files/qml/New.qml", newQml));
+    QJsonArray files;
+    files.append(QJsonObject{{"path", "bin/FluorescenceQuant"},
+                             {"op", "patch"},
+                             {"src", "patches/bin/FluorescenceQuant.fqp"},
+                             {"base_sha256", DeltaPatch::dataSha256(oldApp)},
+                             {"sha256", DeltaPatch::dataSha256(newApp)}});
+    files.append(QJsonObject{{"path", "qml/New.qml"},
+                             {"op", "add"},
+                             {"src", "files/qml/New.qml"},
+                             {"sha256", DeltaPatch::dataSha256(newQml)}});
+    files.append(QJsonObject{{"path", "lib/libold.so"}, {"op", "delete"}});
+    files.append(QJsonObject{{"path", "lib/libsame.so"}, {"op", "same"}, {"sha256", DeltaPatch::dataSha256(sameLib)}});
+    CHECK(writeFile(deltaDir + "/manifest.json",
+                    QJsonDocument(QJsonObject{{"from", "1.0.6"}, {"to", "1.0.7"}, {"files", files}}).toJson()));
+
+    err.clear();
+    const bool applied = DeltaPatch::applyManifest(deltaDir, baseDir, outDir, err);
+    CHECK(applied);
+    if (!applied)
+        std::printf("apply error: %s\n", qPrintable(err));
+    CHECK(readFile(outDir + "/bin/FluorescenceQuant") == newApp);
+    CHECK(readFile(outDir + "/qml/New.qml") == newQml);
+    CHECK(readFile(outDir + "/lib/libsame.so") == sameLib);
+    CHECK(!QFile::exists(outDir + "/lib/libold.so"));
+
+    // 基准不对：拒绝
+    {
+        const QString otherBase = tmp.path() + "/base2";
+        const QString out2 = tmp.path() + "/out2";
+        QDir().mkpath(out2);
+        CHECK(writeFile(otherBase + "/bin/FluorescenceQuant", newApp));
+        CHECK(writeFile(otherBase + "/lib/libsame.so", sameLib));
+        QString e;
+        CHECK(!DeltaPatch::applyManifest(deltaDir, otherBase, out2, e));
+        CHECK(e.contains("base file differs"));
+    }
+
+    // ===== 3. 畸形控制流：只许报错，不许越界 / 溢出 =====
+    const qint64 kMax = std::numeric_limits<qint64>::max();
+    const qint64 kMin = std::numeric_limits<qint64>::min();
+    const QByteArray small = pseudoRandom(64, 4);
+    const QByteArray diff64(64, '\0');
+    CHECK(patchFails(small, buildPatch(64, {{kMax, 0, 0}}, diff64, QByteArray())));
+    CHECK(patchFails(small, buildPatch(64, {{-1, 0, 0}}, diff64, QByteArray())));
+    CHECK(patchFails(small, buildPatch(64, {{32, kMax, 0}}, diff64, QByteArray(32, 'x'))));
+    CHECK(patchFails(small, buildPatch(64, {{0, -5, 0}}, diff64, QByteArray())));
+    CHECK(patchFails(small, buildPatch(64, {{16, 0, kMax}, {16, 0, kMax}}, diff64, QByteArray())));
+    CHECK(patchFails(small, buildPatch(64, {{16, 0, kMin}, {16, 0, 0}}, diff64, QByteArray())));
+    CHECK(patchFails(small, buildPatch(64, {{128, 0, 0}}, diff64, QByteArray())));     // diff 不够
+    CHECK(patchFails(small, buildPatch(64, {{32, 32, 0}}, diff64, QByteArray(8, 'x'))));  // extra 不够
+    CHECK(patchFails(small, buildPatch(64, {{32, 0, 0}}, diff64, QByteArray())));      // 提前结束
+    CHECK(patchFails(small, buildPatch(-1, {{0, 0, 0}}, diff64, QByteArray())));
+    CHECK(patchFails(small, QByteArray("FQPATCH1")));
+
+    // 合法的小补丁（含回退 seek）仍然能过
+    {
+        const QByteArray oldData = "abcdefgh";
+        const QByteArray want = "abcdabcd";
+        QByteArray d(8, '\0');
+        QByteArray out;
+        QString e;
+        CHECK(DeltaPatch::bspatch(oldData, buildPatch(8, {{4, 0, -4}, {4, 0, 0}}, d, QByteArray()), out, e));
+        CHECK(out == want);
+    }
+
+    return testResult();
+}
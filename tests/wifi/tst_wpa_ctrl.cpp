@@ -0,0 +1,259 @@
+// WpaCtrl 对着假的 wpa_supplicant 控制套接字（UNIX 数据报）跑
+//   - 请求 / 回复，attach 后的事件，回复前夹带的事件
+//   - 命令超时后晚到的回复不能被下一条命令收到；已 attach 的连接换地址后仍能收到事件
+//   - waitEvent：超时返回 Timeout，套接字被关闭（POLLHUP）立即返回 Error，不空转
+//   - wpa_supplicant 退出后请求直接失败
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TestCheck.h"
+#include "WpaCtrl.h"
+
+namespace {
+
+/*
+ * 假 wpa_supplicant：在 dir/ifname 上收命令，按表回复
+ *   PING → PONG，ATTACH / DETACH → OK 并登记 / 注销监视器，其余查 reply 表（查不到回 UNKNOWN COMMAND）
+ *   setDelay(cmd, ms)：该命令延迟回复，用来制造超时后晚到的回复
+ *   setEventBeforeReply(ev)：回复前先给请求方发一条事件
+ *   pushEvent(ev)：给所有监视器发 "<2>ev"
+ */
+class FakeWpaSupplicant {
+public:
+    FakeWpaSupplicant(const std::string& dir, const std::string& ifname) {
+        m_path = dir + "/" + ifname;
+        m_fd = ::socket(PF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", m_path.c_str());
+        ::unlink(m_path.c_str());
+        if (::bind(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            std::perror("FakeWpaSupplicant bind");
+            return;
+        }
+        m_thread = std::thread([this]() { loop(); });
+    }
+
+    ~FakeWpaSupplicant() { stop(); }
+
+    void stop() {
+        if (m_stop.exchange(true))
+            return;
+        if (m_thread.joinable())
+            m_thread.join();
+        ::close(m_fd);
+        ::unlink(m_path.c_str());
+    }
+
+    void setReply(const std::string& cmd, const std::string& reply) {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_replies[cmd] = reply;
+    }
+    void setDelay(const std::string& cmd, int ms) {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_delays[cmd] = ms;
+    }
+    void setEventBeforeReply(const std::string& ev) {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        m_eventBeforeReply = ev;
+    }
+    void pushEvent(const std::string& ev) {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        const std::string msg = "<2>" + ev;
+        for (const sockaddr_un& a : m_monitors)
+            ::sendto(m_fd, msg.data(), msg.size(), 0, reinterpret_cast<const sockaddr*>(&a), sizeof(a));
+    }
+    int monitorCount() {
+        std::lock_guard<std::mutex> lk(m_mutex);
+        return int(m_monitors.size());
+    }
+    int lateRepliesLost() const { return m_lateLost.load(); }
+
+private:
+    void loop() {
+        char buf[4096];
+        while (!m_stop) {
+            pollfd pfd{m_fd, POLLIN, 0};
+            if (::poll(&pfd, 1, 20) <= 0)
+                continue;
+            sockaddr_un from;
+            socklen_t len = sizeof(from);
+            const ssize_t n = ::recvfrom(m_fd, buf, sizeof(buf), 0, reinterpret_cast<sockaddr*>(&from), &len);
+            if (n <= 0)
+                continue;
+            handle(std::string(buf, size_t(n)), from);
+        }
+    }
+
+    void handle(const std::string& cmd, const sockaddr_un& from) {
+        std::string reply;
+        std::string ev;
+        int delay = 0;
+        {
+            std::lock_guard<std::mutex> lk(m_mutex);
+            if (cmd == "PING") {
+                reply = "PONG\n";
+            } else if (cmd == "ATTACH") {
+                m_monitors.push_back(from);
+                reply = "OK\n";
+            } else if (cmd == "DETACH") {
+                for (size_t i = 0; i < m_monitors.size(); ++i) {
+                    if (std::strcmp(m_monitors[i].sun_path, from.sun_path) == 0) {
+                        m_monitors.erase(m_monitors.begin() + long(i));
+                        break;
+                    }
+                }
+                reply = "OK\n";
+            } else {
+                const auto it = m_replies.find(cmd);
+                reply = it != m_replies.end() ? it->second : "UNKNOWN COMMAND\n";
+            }
+            const auto d = m_delays.find(cmd);
+            if (d != m_delays.end())
+                delay = d->second;
+            ev.swap(m_eventBeforeReply);
+        }
+        if (delay > 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+        const sockaddr* to = reinterpret_cast<const sockaddr*>(&from);
+        if (!ev.empty()) {
+            const std::string msg = "<2>" + ev;
+            ::sendto(m_fd, msg.data(), msg.size(), 0, to, sizeof(from));
+        }
+        // 客户端超时后已换地址：旧路径不存在，回复发不出去
+        if (::sendto(m_fd, reply.data(), reply.size(), 0, to, sizeof(from)) < 0 && delay > 0)
+            ++m_lateLost;
+    }
+
+    std::string m_path;
+    int m_fd = -1;
+    std::thread m_thread;
+    std::atomic<bool> m_stop{false};
+    std::atomic<int> m_lateLost{0};
+    std::mutex m_mutex;
+    std::map<std::string, std::string> m_replies;
+    std::map<std::string, int> m_delays;
+    std::string m_eventBeforeReply;
+    std::vector<sockaddr_un> m_monitors;
+};
+
+long long msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+}
+
+}  // namespace
+
+int main() {
+    char tmpl[] = "/tmp/tst_wpa_XXXXXX";
+    const char* dir = ::mkdtemp(tmpl);
+    CHECK(dir != nullptr);
+    if (!dir)
+        return testResult();
+
+    FakeWpaSupplicant wpa(dir, "wlan0");
+    wpa.setReply("STATUS", "bssid=00:11:22:33:44:55\nssid=lab\nwpa_state=COMPLETED\n");
+    wpa.setReply("SLOW", "SLOW-REPLY\n");
+    wpa.setDelay("SLOW", 300);
+
+    // ===== 1. 请求 / 回复 =====
+    WpaCtrl cmd;
+    CHECK(cmd.open("wlan0", dir));
+    std::string reply;
+    CHECK(cmd.request("PING", reply, 1000));
+    CHECK(reply == "PONG\n");
+    CHECK(cmd.request("STATUS", reply, 1000));
+    CHECK(reply.find("wpa_state=COMPLETED") != std::string::npos);
+    CHECK(!cmd.command("NOPE", 1000));
+
+    // ===== 2. 超时后晚到的回复不会错配给下一条命令 =====
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        CHECK(!cmd.request("SLOW", reply, 100));
+        CHECK(msSince(t0) < 250);
+        std::this_thread::sleep_for(std::chrono::milliseconds(350));  // 晚到的回复此时已发出
+        CHECK_EQ(wpa.lateRepliesLost(), 1);
+        CHECK(cmd.request("STATUS", reply, 1000));
+        CHECK(reply.find("wpa_state=COMPLETED") != std::string::npos);
+        CHECK(cmd.request("PING", reply, 1000));
+        CHECK(reply == "PONG\n");
+    }
+
+    // ===== 3. 异步用法：sendRequest + readReply =====
+    {
+        CHECK(cmd.sendRequest("STATUS"));
+        pollfd pfd{cmd.fd(), POLLIN, 0};
+        CHECK_EQ(::poll(&pfd, 1, 1000), 1);
+        CHECK(cmd.readReply(reply));
+        CHECK(reply.find("wpa_state=COMPLETED") != std::string::npos);
+        CHECK(!cmd.readReply(reply));  // 没有更多
+    }
+
+    // ===== 4. 监视连接：事件去掉 "<N>" 前缀，回复前夹带的事件被跳过 =====
+    WpaCtrl mon;
+    CHECK(mon.open("wlan0", dir));
+    CHECK(mon.attach());
+    CHECK_EQ(wpa.monitorCount(), 1);
+    std::string ev;
+    CHECK(mon.waitEvent(ev, 50) == WpaCtrl::WaitResult::Timeout);
+    wpa.pushEvent("CTRL-EVENT-CONNECTED - Connection to 00:11:22:33:44:55 completed");
+    CHECK(mon.waitEvent(ev, 1000) == WpaCtrl::WaitResult::Event);
+    CHECK(ev.compare(0, 20, "CTRL-EVENT-CONNECTED") == 0);
+
+    wpa.setEventBeforeReply("CTRL-EVENT-SCAN-STARTED");
+    CHECK(mon.request("PING", reply, 1000));
+    CHECK(reply == "PONG\n");
+
+    // 监视连接超时换地址后自动重新 ATTACH，事件照常到达
+    {
+        const int fdBefore = mon.fd();
+        CHECK(!mon.request("SLOW", reply, 100));
+        CHECK_EQ(mon.fd(), fdBefore);  // fd 号不变，外面的 QSocketNotifier 继续有效
+        std::this_thread::sleep_for(std::chrono::milliseconds(350));
+        CHECK_EQ(wpa.monitorCount(), 2);  // 旧地址没 DETACH（真 wpa_supplicant 发送失败时自己摘掉）
+        while (mon.waitEvent(ev, 0) == WpaCtrl::WaitResult::Event) {
+        }
+        wpa.pushEvent("CTRL-EVENT-DISCONNECTED bssid=00:11:22:33:44:55 reason=3");
+        CHECK(mon.waitEvent(ev, 1000) == WpaCtrl::WaitResult::Event);
+        CHECK(ev.compare(0, 23, "CTRL-EVENT-DISCONNECTED") == 0);
+    }
+
+    // ===== 5. 套接字被关闭：POLLHUP 立即返回 Error，不空转到超时 =====
+    {
+        WpaCtrl dead;
+        CHECK(dead.open("wlan0", dir));
+        CHECK(dead.attach());
+        ::shutdown(dead.fd(), SHUT_RDWR);
+        const auto t0 = std::chrono::steady_clock::now();
+        CHECK(dead.waitEvent(ev, 2000) == WpaCtrl::WaitResult::Error);
+        CHECK(msSince(t0) < 200);
+    }
+
+    // ===== 6. wpa_supplicant 退出：请求直接失败，重新 open 也失败 =====
+    mon.close();
+    wpa.stop();
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        CHECK(!cmd.request("PING", reply, 1000));
+        CHECK(msSince(t0) < 200);
+        WpaCtrl again;
+        CHECK(!again.open("wlan0", dir));
+    }
+    cmd.close();
+    ::rmdir(dir);
+
+    return testResult();
+}